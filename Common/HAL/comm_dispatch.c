@@ -0,0 +1,116 @@
+#include "comm_dispatch.h"
+#include "../MCAL/cpu.h"
+
+/*******************************************************************************
+ *                         Private Variables                                   *
+ *******************************************************************************/
+
+typedef struct {
+    uint32_t count;
+    uint32_t rejected;
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint64_t totalCycles;   /* averaged when read, not on every run */
+} COMM_HandlerAccount;
+
+static const COMM_CommandHandler *handlerTable;
+static COMM_Sender handlerSender;
+static COMM_HandlerAccount accounts[COMM_COMMAND_SLOTS];
+static uint32_t unknownFrames;      /* IDs outside the protocol table */
+
+/*******************************************************************************
+ *                         Functions Definitions                               *
+ *******************************************************************************/
+
+void COMM_DispatchInit(const COMM_CommandHandler *handlers, COMM_Sender from)
+{
+    handlerTable = handlers;
+    handlerSender = from;
+    CPU_CycleCounterInit();
+    COMM_DispatchResetProfile();
+}
+
+COMM_CheckResult COMM_Dispatch(const COMM_FrameView *frame)
+{
+    COMM_CheckResult check = COMM_CheckPayload(frame->cmd, frame->payload, frame->len,
+                                               handlerSender);
+    if (COMM_GetCommandInfo(frame->cmd) == NULL)
+    {
+        unknownFrames++;
+        COMM_SendReply(frame->seq, CMD_UNKNOWN, NULL, 0);
+        return check;
+    }
+
+    COMM_HandlerAccount *account = &accounts[COMM_COMMAND_INDEX(frame->cmd)];
+    COMM_CommandHandler handler = handlerTable[COMM_COMMAND_INDEX(frame->cmd)];
+    if (check == COMM_CHECK_OK && handler == NULL)
+    {
+        check = COMM_CHECK_UNKNOWN;
+    }
+    if (check != COMM_CHECK_OK)
+    {
+        account->rejected++;
+        COMM_SendReply(frame->seq, (check == COMM_CHECK_MALFORMED) ? CMD_FAIL : CMD_UNKNOWN,
+                       NULL, 0);
+        return check;
+    }
+
+    uint32_t start = CPU_Cycles();
+    handler(frame);
+    uint32_t cycles = CPU_Cycles() - start;
+
+    if (account->count == 0 || cycles < account->minCycles)
+    {
+        account->minCycles = cycles;
+    }
+    if (cycles > account->maxCycles)
+    {
+        account->maxCycles = cycles;
+    }
+    account->totalCycles += cycles;
+    account->count++;
+    return COMM_CHECK_OK;
+}
+
+void COMM_DispatchGetProfile(uint8_t cmd, COMM_Profile *profile)
+{
+    profile->cmd = cmd;
+    if (COMM_GetCommandInfo(cmd) == NULL)
+    {
+        profile->count = 0;
+        profile->rejected = unknownFrames;
+        profile->minCycles = profile->avgCycles = profile->maxCycles = 0;
+        return;
+    }
+    const COMM_HandlerAccount *account = &accounts[COMM_COMMAND_INDEX(cmd)];
+    profile->count = account->count;
+    profile->rejected = account->rejected;
+    profile->minCycles = account->minCycles;
+    profile->maxCycles = account->maxCycles;
+    profile->avgCycles = (account->count != 0)
+                       ? (uint32_t)(account->totalCycles / account->count) : 0;
+}
+
+void COMM_DispatchResetProfile(void)
+{
+    for (uint8_t i = 0; i < COMM_COMMAND_SLOTS; i++)
+    {
+        accounts[i] = (COMM_HandlerAccount){ 0 };
+    }
+    unknownFrames = 0;
+}
+
+void COMM_DispatchProfileHandler(const COMM_FrameView *frame)
+{
+    // A CMD_PROFILE reply (COMM_PROFILE_LEN) is no query
+    if (frame->len != COMM_PROFILE_QUERY_LEN)
+    {
+        COMM_SendReply(frame->seq, CMD_FAIL, NULL, 0);
+        return;
+    }
+    COMM_Profile profile;
+    uint8_t payload[COMM_PROFILE_LEN];
+    COMM_DispatchGetProfile(frame->payload[0], &profile);
+    COMM_EncodeProfile(&profile, payload);
+    COMM_SendReply(frame->seq, CMD_PROFILE, payload, sizeof(payload));
+}
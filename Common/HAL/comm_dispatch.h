@@ -0,0 +1,49 @@
+#ifndef COMM_DISPATCH_H_
+#define COMM_DISPATCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "comm_interface.h"
+
+/*******************************************************************************
+ *                         Command Dispatch                                    *
+ *******************************************************************************/
+
+/*
+ * Runs the handler of a received frame from a table indexed by command ID
+ * (COMM_COMMAND_INDEX), so finding it costs the same for every command.
+ * What a handler may expect of its payload is the protocol table's row
+ * (comm_protocol.h): COMM_Dispatch checks the frame with COMM_CheckPayload
+ * first and answers a refused one itself, CMD_FAIL for a malformed payload
+ * and CMD_UNKNOWN for anything else, like a command without a handler.
+ *
+ * Every command is accounted: handler runs, refused frames and the core
+ * cycles (CPU_Cycles) of each run with its reply, min/avg/max. The peer
+ * reads them with CMD_PROFILE [cmd], see COMM_DispatchProfileHandler.
+ */
+
+/* Acts on a checked frame and sends its reply (if any), echoing frame->seq */
+typedef void (*COMM_CommandHandler)(const COMM_FrameView *frame);
+
+/*
+ * Use handlers[COMM_COMMAND_SLOTS] (NULL: no handler) for frames from `from`
+ * and clear the counters. The table is not copied.
+ */
+void COMM_DispatchInit(const COMM_CommandHandler *handlers, COMM_Sender from);
+
+/* Check frame, run its handler and account for it. Does not release it */
+COMM_CheckResult COMM_Dispatch(const COMM_FrameView *frame);
+
+/*
+ * Counters of cmd since COMM_DispatchInit / COMM_DispatchResetProfile.
+ * Frames with an ID outside the protocol table all count as `rejected` of
+ * every such ID.
+ */
+void COMM_DispatchGetProfile(uint8_t cmd, COMM_Profile *profile);
+
+void COMM_DispatchResetProfile(void);
+
+/* Handler for CMD_PROFILE [cmd]: replies CMD_PROFILE with cmd's counters */
+void COMM_DispatchProfileHandler(const COMM_FrameView *frame);
+
+#endif /* COMM_DISPATCH_H_ */
@@ -1,4 +1,237 @@
 #include "comm_interface.h"
+#include "../Utils/crc16.h"
+#include "../MCAL/cpu.h"
+#include "../MCAL/tick.h"
+#include <string.h>
+
+/*******************************************************************************
+ *                         Private Variables                                   *
+ *******************************************************************************/
+
+static uint8_t txSeq;
+static COMM_Parser rxParser;
+
+/* Frame handed out by COMM_PeekFrame and not released yet */
+static COMM_FrameView heldView;
+static bool viewHeld;
+
+#if UART_USE_INTERRUPTS
+/* Bytes at the front of the RX ring already searched for the delimiter */
+static uint16_t scanned;
+static bool ringHunting;        /* dropping an overlong frame up to its delimiter */
+#endif
+
+/* Replies to recent requests, sent again when a request is repeated */
+static COMM_CachedReply replyCache[COMM_REPLY_CACHE];
+static uint8_t replyNext;           /* oldest entry, overwritten next */
+static uint8_t lastCmd, lastSeq;    /* newest frame received: the request being answered */
+static uint8_t rxNewestSeq;         /* highest SEQ received, retransmissions do not move it */
+static bool rxSeqKnown;             /* rxNewestSeq is set, none since the handshake otherwise */
+
+/* Frame-level counters, the byte and line-error counts live in the UART driver */
+static uint32_t framesIn, framesOut, crcErrors;
+static uint32_t retries, timeouts, maxRttMs;
+
+/* Flow control is only possible when received bytes wait in a ring */
+#define COMM_FLOW_ENABLED   (COMM_FLOW_CONTROL && UART_USE_INTERRUPTS)
+
+/* Flow control byte counts, from the last COMM_FlowReset, wrapping at 16 bits */
+static bool flowStarted;        /* handshake done, the peer gets grants */
+static bool creditActive;       /* the peer grants us credit, respect it */
+static uint16_t creditLimit;    /* sentBytes may not pass this */
+static uint16_t sentBytes;
+static uint16_t consumedBytes;  /* RX ring bytes processed by this side */
+static uint16_t grantedLimit;   /* last limit granted to the peer */
+
+/* Link supervision: handshake done, and when the newest valid frame arrived */
+static bool linkUp;
+static bool linkResponder;      /* this side answered the last handshake (HMI) */
+static bool peerRestarted;      /* the initiator sent READY again mid-session */
+static uint32_t lastFrameTicks;
+
+/* COMM_FEATURE_* both sides announced in the last handshake */
+static uint8_t linkFeatures;
+
+/* Rates offered in the handshake, bit n of the capability mask = entry n */
+static const uint32_t baudRates[] = { 115200, 230400, 460800, 921600, 1000000 };
+#define BAUD_RATE_COUNT  (sizeof(baudRates) / sizeof(baudRates[0]))
+
+/*******************************************************************************
+ *                         Flow Control                                        *
+ *******************************************************************************/
+
+/* Signed distance, correct across the 16-bit wrap while counts stay < 32K apart */
+static int16_t COMM_FlowAhead(uint16_t a, uint16_t b)
+{
+    return (int16_t)(uint16_t)(a - b);
+}
+
+static void COMM_FlowGrant(const uint8_t *payload, uint8_t len)
+{
+    if (!COMM_FLOW_ENABLED || len != COMM_CREDIT_LEN)
+    {
+        return;
+    }
+    /* The same grant may be seen twice (peeked while waiting, then consumed) */
+    uint16_t limit = (uint16_t)((payload[0] << 8) | payload[1]);
+    if (!creditActive || COMM_FlowAhead(limit, creditLimit) > 0)
+    {
+        creditLimit = limit;
+        creditActive = true;
+    }
+}
+
+static void COMM_FlowSendGrant(void)
+{
+    uint8_t payload[COMM_CREDIT_LEN];
+    grantedLimit = (uint16_t)(consumedBytes + COMM_FLOW_WINDOW);
+    payload[0] = (uint8_t)(grantedLimit >> 8);
+    payload[1] = (uint8_t)grantedLimit;
+    (void)COMM_SendFrame(CMD_CREDIT, payload, sizeof(payload));
+}
+
+/* Receiver side: count processed bytes, grant again once enough room came free */
+static void COMM_FlowConsumed(uint16_t bytes)
+{
+    consumedBytes = (uint16_t)(consumedBytes + bytes);
+    if (flowStarted &&
+        COMM_FlowAhead((uint16_t)(consumedBytes + COMM_FLOW_WINDOW), grantedLimit) >= COMM_FLOW_UPDATE)
+    {
+        COMM_FlowSendGrant();
+    }
+}
+
+/*
+ * Look for grants among the bytes still waiting in the RX ring, without
+ * consuming them: run a copy of the receive parser over them.
+ */
+static void COMM_FlowPeekGrants(void)
+{
+    COMM_Parser scan = rxParser;
+    uint8_t *data;
+    uint16_t offset = viewHeld ? heldView.size : 0;    /* a held view is unstuffed already */
+    uint16_t span;
+
+    while ((span = UART_RxPeek(offset, &data)) > 0)
+    {
+        for (uint16_t i = 0; i < span; i++)
+        {
+            if (COMM_ParseByte(&scan, data[i]) == COMM_PARSE_FRAME && scan.frame.cmd == CMD_CREDIT)
+            {
+                COMM_FlowGrant(scan.frame.payload, scan.frame.len);
+            }
+        }
+        offset += span;
+    }
+}
+
+/* Sender side: hold a frame of size bytes back until the peer has room for it */
+static void COMM_FlowWait(uint8_t size)
+{
+    uint32_t deadline = 0;
+    bool waiting = false;
+
+    while (creditActive && COMM_FlowAhead(creditLimit, (uint16_t)(sentBytes + size)) < 0)
+    {
+        if (!waiting)
+        {
+            deadline = Tick_Deadline(COMM_FLOW_WAIT_MS);
+            waiting = true;
+        }
+        else if (Tick_Expired(deadline))
+        {
+            creditActive = false;   /* peer reset or lost its grants, stop limiting */
+            break;
+        }
+        COMM_FlowPeekGrants();
+        CPU_Idle();
+    }
+    sentBytes = (uint16_t)(sentBytes + size);
+}
+
+void COMM_FlowReset(void)
+{
+    sentBytes = 0;
+    consumedBytes = 0;
+    creditActive = false;
+    /* A peer without CMD_CREDIT would answer every grant with CMD_UNKNOWN */
+    flowStarted = COMM_FLOW_ENABLED && (linkFeatures & COMM_FEATURE_CREDIT);
+    if (flowStarted)
+    {
+        COMM_FlowSendGrant();
+    }
+}
+
+uint16_t COMM_FlowCredit(void)
+{
+    if (!creditActive)
+    {
+        return 0xFFFF;
+    }
+    int16_t credit = COMM_FlowAhead(creditLimit, sentBytes);
+    return (credit > 0) ? (uint16_t)credit : 0;
+}
+
+/*******************************************************************************
+ *                         Reply Cache                                         *
+ *******************************************************************************/
+
+static void COMM_ForgetReplies(void)
+{
+    for (uint8_t i = 0; i < COMM_REPLY_CACHE; i++)
+    {
+        replyCache[i].used = false;
+    }
+    replyNext = 0;
+    rxSeqKnown = false;
+}
+
+static bool COMM_InReplyWindow(uint8_t seq)
+{
+    return (uint8_t)(rxNewestSeq - seq) < COMM_REPLY_WINDOW;
+}
+
+/*
+ * Every received frame, heartbeats included, before it is handed out. A SEQ
+ * ahead of the newest drops the replies that fall out of the window, so one
+ * for a SEQ about to be used again is gone before its new request is seen.
+ */
+static void COMM_TrackSeq(uint8_t seq)
+{
+    lastSeq = seq;
+    if (rxSeqKnown && (int8_t)(seq - rxNewestSeq) <= 0)
+    {
+        return;     /* a retransmission, or a frame overtaken */
+    }
+    rxNewestSeq = seq;
+    rxSeqKnown = true;
+    for (uint8_t i = 0; i < COMM_REPLY_CACHE; i++)
+    {
+        if (replyCache[i].used && !COMM_InReplyWindow(replyCache[i].seq))
+        {
+            replyCache[i].used = false;
+        }
+    }
+}
+
+/*******************************************************************************
+ *                         Link Watch                                          *
+ *******************************************************************************/
+
+/*
+ * Every valid frame keeps the link alive. Control sends READY with its caps
+ * only from the handshake, and never again once its status went out, so the
+ * responder seeing one mid-session knows Control restarted, without waiting
+ * for the timeout (the new READY may even arrive intact at the old rate).
+ */
+static void COMM_LinkWatch(uint8_t cmd, uint8_t len)
+{
+    lastFrameTicks = GetTicks();
+    if (linkUp && linkResponder && cmd == CMD_READY && len >= 1)
+    {
+        peerRestarted = true;
+    }
+}
 
 /*******************************************************************************
  *                         Functions Definitions                               *
@@ -7,36 +240,1167 @@
 void COMM_Init(void)
 {
     UART_Init();
+    COMM_ParserReset(&rxParser);
+    viewHeld = false;
+#if UART_USE_INTERRUPTS
+    scanned = 0;
+    ringHunting = false;
+#endif
+    flowStarted = false;
+    creditActive = false;
+    linkUp = false;
+    linkFeatures = COMM_FEATURES;
+    txSeq = 0;
+    COMM_ForgetReplies();
+    COMM_ResetStats();
+}
+
+/* Header for a frame, returns the CRC over CMD, SEQ and LEN */
+static uint16_t COMM_BuildHeader(uint8_t *header, uint8_t cmd, uint8_t seq, uint8_t len)
+{
+    header[0] = cmd;
+    header[1] = seq;
+    header[2] = len;
+    return CRC16_Compute(CRC16_INIT, header, COMM_HEADER_SIZE);
+}
+
+/*
+ * COBS stuffing of one piece of a frame, in place. piece holds the frame
+ * bytes [start, start + len), next is the index of the first 0x00 after it
+ * (or the frame length). Going backwards, each 0x00 is replaced by the
+ * distance to the next one; returns the first 0x00 at or after start.
+ */
+static uint8_t COMM_CobsStuff(uint8_t *piece, uint8_t len, uint8_t start, uint8_t next)
+{
+    for (uint8_t i = len; i > 0; i--)
+    {
+        if (piece[i - 1] == 0)
+        {
+            uint8_t at = (uint8_t)(start + i - 1);
+            piece[i - 1] = (uint8_t)(next - at);
+            next = at;
+        }
+    }
+    return next;
+}
+
+uint8_t COMM_EncodeFrame(uint8_t *wire, uint8_t cmd, uint8_t seq,
+                         const uint8_t *payload, uint8_t len)
+{
+    /* The frame is built one byte in, behind its code byte, and stuffed there */
+    uint8_t *frame = &wire[COMM_COBS_OVERHEAD];
+
+    if (len > COMM_MAX_PAYLOAD)
+    {
+        len = COMM_MAX_PAYLOAD;
+    }
+
+    uint16_t crc = COMM_BuildHeader(frame, cmd, seq, len);
+    if (len > 0)
+    {
+        memcpy(&frame[COMM_HEADER_SIZE], payload, len);
+        crc = CRC16_Compute(crc, payload, len);
+    }
+    frame[COMM_HEADER_SIZE + len] = (uint8_t)(crc >> 8);
+    frame[COMM_HEADER_SIZE + len + 1] = (uint8_t)(crc & 0xFF);
+
+    uint8_t frameLen = (uint8_t)(COMM_HEADER_SIZE + len + COMM_CRC_SIZE);
+    wire[0] = (uint8_t)(COMM_CobsStuff(frame, frameLen, 0, frameLen) + 1);
+    frame[frameLen] = COMM_DELIMITER;
+    return (uint8_t)COMM_WIRE_SIZE(len);
+}
+
+static void COMM_Transmit(uint8_t seq, uint8_t cmd, const uint8_t *payload, uint8_t len)
+{
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+    uint8_t size = COMM_EncodeFrame(wire, cmd, seq, payload, len);
+
+    if (cmd != CMD_CREDIT)
+    {
+        COMM_FlowWait(size);
+    }
+    UART_SendBuffer(wire, size);
+    framesOut++;
+}
+
+void COMM_SendReply(uint8_t seq, uint8_t cmd, const uint8_t *payload, uint8_t len)
+{
+    if (len > COMM_MAX_PAYLOAD)
+    {
+        len = COMM_MAX_PAYLOAD;
+    }
+    /* Heartbeats are answered again anyway, they would only push replies out */
+    if (seq == lastSeq && lastCmd != CMD_HEARTBEAT && COMM_InReplyWindow(seq))
+    {
+        COMM_CachedReply *entry = &replyCache[replyNext];
+        replyNext = (uint8_t)((replyNext + 1) % COMM_REPLY_CACHE);
+        entry->used = true;
+        entry->request = lastCmd;
+        entry->seq = seq;
+        entry->cmd = cmd;
+        entry->len = len;
+        if (len > 0)
+        {
+            memcpy(entry->payload, payload, len);
+        }
+    }
+    COMM_Transmit(seq, cmd, payload, len);
+}
+
+void COMM_ResendFrame(uint8_t seq, uint8_t cmd, const uint8_t *payload, uint8_t len)
+{
+    COMM_Transmit(seq, cmd, payload, len);
+}
+
+bool COMM_ReplayReply(uint8_t cmd, uint8_t seq)
+{
+    for (uint8_t i = 0; i < COMM_REPLY_CACHE; i++)
+    {
+        const COMM_CachedReply *entry = &replyCache[i];
+        if (entry->used && entry->seq == seq && entry->request == cmd && COMM_InReplyWindow(seq))
+        {
+            COMM_Transmit(entry->seq, entry->cmd, entry->payload, entry->len);
+            return true;
+        }
+    }
+    return false;
+}
+
+uint8_t COMM_SendFrame(uint8_t cmd, const uint8_t *payload, uint8_t len)
+{
+    uint8_t seq = txSeq++;
+    COMM_Transmit(seq, cmd, payload, len);
+    return seq;
 }
 
 void COMM_SendCommand(uint8_t cmd)
 {
-    UART_SendByte(cmd);
+    (void)COMM_SendFrame(cmd, NULL, 0);
+}
+
+uint8_t COMM_SendFrameAsync(uint8_t cmd, const uint8_t *payload, uint8_t len,
+                            COMM_TxCallback done)
+{
+    uint8_t header[COMM_COBS_OVERHEAD + COMM_HEADER_SIZE];
+    uint8_t trailer[COMM_CRC_SIZE + 1];
+    uint8_t seq = txSeq++;
+
+    if (len > COMM_MAX_PAYLOAD)
+    {
+        len = COMM_MAX_PAYLOAD;
+    }
+
+    /* Stuffing would have to rewrite the caller's bytes, copy instead */
+    if (len > 0 && memchr(payload, COMM_DELIMITER, len) != NULL)
+    {
+        COMM_Transmit(seq, cmd, payload, len);
+        if (done)
+        {
+            done();
+        }
+        return seq;
+    }
+
+    uint16_t crc = COMM_BuildHeader(&header[COMM_COBS_OVERHEAD], cmd, seq, len);
+    crc = CRC16_Compute(crc, payload, len);
+    trailer[0] = (uint8_t)(crc >> 8);
+    trailer[1] = (uint8_t)(crc & 0xFF);
+
+    /* A payload without 0x00 goes out unchanged, only header and CRC are stuffed */
+    uint8_t frameLen = (uint8_t)(COMM_HEADER_SIZE + len + COMM_CRC_SIZE);
+    uint8_t next = COMM_CobsStuff(trailer, COMM_CRC_SIZE, (uint8_t)(COMM_HEADER_SIZE + len), frameLen);
+    next = COMM_CobsStuff(&header[COMM_COBS_OVERHEAD], COMM_HEADER_SIZE, 0, next);
+    header[0] = (uint8_t)(next + 1);
+    trailer[COMM_CRC_SIZE] = COMM_DELIMITER;
+
+    COMM_FlowWait((uint8_t)COMM_WIRE_SIZE(len));
+
+    /* Header and trailer are copied into the TX ring; the trailer waits
+       behind the DMA transfer, the UART driver keeps the order */
+    UART_SendBuffer(header, sizeof(header));
+    UART_SendBufferAsync(payload, len, done);
+    UART_SendBuffer(trailer, sizeof(trailer));
+    framesOut++;
+    return seq;
+}
+
+bool COMM_TxBusy(void)
+{
+    return UART_TxAsyncBusy();
+}
+
+void COMM_SetRxCallback(COMM_RxCallback received)
+{
+    UART_SetRxCallback(received);
+}
+
+void COMM_ParserReset(COMM_Parser *parser)
+{
+    parser->state = COMM_RX_START;
+    parser->run = 0;
+    parser->index = 0;
+}
+
+/* One unstuffed byte into the frame, false once the frame cannot be valid */
+static bool COMM_ParseFrameByte(COMM_Parser *parser, uint8_t byte)
+{
+    uint8_t at = parser->index++;
+
+    if (at < COMM_HEADER_SIZE)
+    {
+        if (at == 0)
+        {
+            parser->frame.cmd = byte;
+        }
+        else if (at == 1)
+        {
+            parser->frame.seq = byte;
+        }
+        else if (byte > COMM_MAX_PAYLOAD)
+        {
+            /* Reject before a single payload byte could overrun the buffer */
+            return false;
+        }
+        else
+        {
+            parser->frame.len = byte;
+        }
+        parser->crc = CRC16_Update(parser->crc, byte);
+        return true;
+    }
+
+    at -= COMM_HEADER_SIZE;
+    if (at < parser->frame.len)
+    {
+        parser->frame.payload[at] = byte;
+        parser->crc = CRC16_Update(parser->crc, byte);
+        return true;
+    }
+
+    at -= parser->frame.len;
+    if (at == 0)
+    {
+        parser->rxCrc = (uint16_t)byte << 8;
+        return true;
+    }
+    if (at == 1)
+    {
+        parser->rxCrc |= byte;
+        return true;
+    }
+    return false;   /* more bytes than LEN announced */
+}
+
+COMM_ParseResult COMM_ParseByte(COMM_Parser *parser, uint8_t byte)
+{
+    if (byte == COMM_DELIMITER)
+    {
+        /* End of a frame, whatever happened before: always in sync again here */
+        COMM_RxState state = parser->state;
+        bool complete = (parser->run == 0) &&
+                        (parser->index >= COMM_HEADER_SIZE) &&
+                        (parser->index == COMM_HEADER_SIZE + parser->frame.len + COMM_CRC_SIZE) &&
+                        (parser->rxCrc == parser->crc);
+        COMM_ParserReset(parser);
+
+        if (state != COMM_RX_DATA)
+        {
+            return COMM_PARSE_BUSY;     /* idle delimiter, or error already reported */
+        }
+        return complete ? COMM_PARSE_FRAME : COMM_PARSE_ERROR;
+    }
+
+    switch (parser->state)
+    {
+        case COMM_RX_HUNT:
+            return COMM_PARSE_BUSY;
+
+        case COMM_RX_START:
+            parser->crc = CRC16_INIT;
+            parser->index = 0;
+            parser->zeroPending = false;
+            /* The first byte is a code byte, handled as in any block */
+            parser->state = COMM_RX_DATA;
+            /* fall through */
+
+        case COMM_RX_DATA:
+        default:
+            if (parser->run > 0)
+            {
+                parser->run--;
+                if (COMM_ParseFrameByte(parser, byte))
+                {
+                    return COMM_PARSE_BUSY;
+                }
+            }
+            else
+            {
+                /* Code byte: the previous block ended in a 0x00 unless it was a full 0xFF block */
+                if (!parser->zeroPending || COMM_ParseFrameByte(parser, 0))
+                {
+                    parser->run = (uint8_t)(byte - 1);
+                    parser->zeroPending = (byte != 0xFF);
+                    return COMM_PARSE_BUSY;
+                }
+            }
+            parser->state = COMM_RX_HUNT;
+            return COMM_PARSE_ERROR;
+    }
 }
 
-void COMM_SendMessage(const uint8_t *msg)
+/* Link parser plus the frame counters, true once a frame is complete */
+static bool COMM_Feed(uint8_t byte)
 {
-    while(*msg != '\0')
+    switch (COMM_ParseByte(&rxParser, byte))
     {
-        UART_SendByte(*msg);
-        msg++;
+        case COMM_PARSE_FRAME:
+            framesIn++;
+            COMM_LinkWatch(rxParser.frame.cmd, rxParser.frame.len);
+            if (rxParser.frame.cmd == CMD_CREDIT)
+            {
+                COMM_FlowGrant(rxParser.frame.payload, rxParser.frame.len);
+                return false;
+            }
+            lastCmd = rxParser.frame.cmd;
+            COMM_TrackSeq(rxParser.frame.seq);
+            return true;
+        case COMM_PARSE_ERROR:
+            crcErrors++;
+            return false;
+        default:
+            return false;
+    }
+}
+
+bool COMM_PollFrame(COMM_Frame *frame)
+{
+    uint8_t byte;
+    while (UART_TryReceiveByte(&byte))
+    {
+        COMM_FlowConsumed(1);
+        if (COMM_Feed(byte))
+        {
+            *frame = rxParser.frame;
+            return true;
+        }
+    }
+    return false;
+}
+
+void COMM_ReceiveFrame(COMM_Frame *frame)
+{
+    for (;;)
+    {
+        uint8_t byte = UART_ReceiveByte();
+        COMM_FlowConsumed(1);
+        if (COMM_Feed(byte))
+        {
+            *frame = rxParser.frame;
+            return;
+        }
     }
-    UART_SendByte(COMM_END_MARKER);
 }
 
 uint8_t COMM_ReceiveCommand(void)
 {
-    return UART_ReceiveByte();
+    COMM_Frame frame;
+    COMM_ReceiveFrame(&frame);
+    return frame.cmd;
+}
+
+bool COMM_TryReceiveCommand(uint8_t *cmd)
+{
+    COMM_Frame frame;
+    if (!COMM_PollFrame(&frame))
+    {
+        return false;
+    }
+    *cmd = frame.cmd;
+    return true;
+}
+
+COMM_Status COMM_ReceiveFrameUntil(COMM_Frame *frame, uint32_t deadlineMs)
+{
+    for (;;)
+    {
+        if (COMM_PollFrame(frame))
+        {
+            return COMM_OK;
+        }
+        if (Tick_Expired(deadlineMs))
+        {
+            return COMM_TIMEOUT;
+        }
+        CPU_Idle();
+    }
+}
+
+COMM_Status COMM_ReceiveCommandUntil(uint8_t *cmd, uint32_t deadlineMs)
+{
+    COMM_Frame frame;
+    if (COMM_ReceiveFrameUntil(&frame, deadlineMs) != COMM_OK)
+    {
+        return COMM_TIMEOUT;
+    }
+    *cmd = frame.cmd;
+    return COMM_OK;
+}
+
+COMM_Status COMM_WaitForCommand(uint8_t cmd, uint32_t timeoutMs)
+{
+    uint32_t deadline = Tick_Deadline(timeoutMs);
+    uint8_t received;
+    while (COMM_ReceiveCommandUntil(&received, deadline) == COMM_OK)
+    {
+        if (received == cmd)
+        {
+            return COMM_OK;
+        }
+    }
+    return COMM_TIMEOUT;
+}
+
+/*******************************************************************************
+ *                         Frame Views                                         *
+ *******************************************************************************/
+
+#if UART_USE_INTERRUPTS
+
+/* Payload of a frame that straddles the end of the RX ring */
+static uint8_t wrapBuffer[COMM_MAX_PAYLOAD];
+
+/* Give count bytes at the front of the RX ring back to the ISR */
+static void COMM_RingDrop(uint16_t count)
+{
+    UART_RxRelease(count);
+    COMM_FlowConsumed(count);
+}
+
+/* Byte at offset in the RX ring, the caller has checked it arrived */
+static uint8_t *COMM_RingAt(uint16_t offset)
+{
+    uint8_t *data;
+    (void)UART_RxPeek(offset, &data);
+    return data;
+}
+
+/* Copy count ring bytes starting at offset, one memcpy per contiguous span */
+static void COMM_RingCopy(uint8_t *out, uint16_t offset, uint16_t count)
+{
+    while (count > 0)
+    {
+        uint8_t *data;
+        uint16_t span = UART_RxPeek(offset, &data);
+        if (span > count)
+        {
+            span = count;
+        }
+        memcpy(out, data, span);
+        out += span;
+        offset += span;
+        count -= span;
+    }
+}
+
+/* CRC over count ring bytes starting at offset, without copying them */
+static uint16_t COMM_RingCrc(uint16_t offset, uint16_t count)
+{
+    uint16_t crc = CRC16_INIT;
+    while (count > 0)
+    {
+        uint8_t *data;
+        uint16_t span = UART_RxPeek(offset, &data);
+        if (span > count)
+        {
+            span = count;
+        }
+        crc = CRC16_Compute(crc, data, span);
+        offset += span;
+        count -= span;
+    }
+    return crc;
+}
+
+/* Offset of the first delimiter at or after scanned, -1 if none arrived yet */
+static int16_t COMM_RingFindDelimiter(void)
+{
+    uint8_t *data;
+    uint16_t span;
+
+    while ((span = UART_RxPeek(scanned, &data)) > 0)
+    {
+        const uint8_t *zero = memchr(data, COMM_DELIMITER, span);
+        if (zero)
+        {
+            return (int16_t)(scanned + (zero - data));
+        }
+        scanned += span;
+    }
+    return -1;
+}
+
+/*
+ * Unstuff the count bytes before the delimiter in place. Each block gives
+ * back as many bytes as it takes (the code byte becomes the 0x00 it stood
+ * for), so the write position never passes the read position. Returns the
+ * frame length, -1 if a block runs past the delimiter.
+ */
+static int16_t COMM_RingUnstuff(uint16_t count)
+{
+    uint16_t in = 0;
+    uint16_t out = 0;
+
+    while (in < count)
+    {
+        uint8_t code = *COMM_RingAt(in++);
+        for (uint8_t k = 1; k < code; k++)
+        {
+            if (in >= count)
+            {
+                return -1;
+            }
+            *COMM_RingAt(out++) = *COMM_RingAt(in++);
+        }
+        if (code != 0xFF && in < count)
+        {
+            *COMM_RingAt(out++) = 0;
+        }
+    }
+    return (int16_t)out;
+}
+
+/*
+ * Frames are whatever lies between two delimiters: nothing is consumed until
+ * the delimiter is there, each byte is searched once, and a bad frame is
+ * dropped whole. Resynchronizing never needs more than the next 0x00.
+ */
+static bool COMM_ScanRing(COMM_FrameView *view)
+{
+    for (;;)
+    {
+        int16_t end = COMM_RingFindDelimiter();
+        if (end < 0)
+        {
+            /* No delimiter within a frame's length: noise, drop it as it comes */
+            if (scanned >= COMM_MAX_WIRE_SIZE)
+            {
+                if (!ringHunting)
+                {
+                    crcErrors++;
+                    ringHunting = true;
+                }
+                COMM_RingDrop(scanned);
+                scanned = 0;
+            }
+            return false;
+        }
+
+        uint16_t size = (uint16_t)(end + 1);
+        scanned = 0;
+        if (end == 0 || ringHunting)
+        {
+            /* idle delimiter, or the end of the dropped noise */
+            ringHunting = false;
+            COMM_RingDrop(size);
+            continue;
+        }
+
+        int16_t frameLen = COMM_RingUnstuff((uint16_t)end);
+        uint8_t len = (frameLen >= COMM_HEADER_SIZE) ? *COMM_RingAt(2) : 0;
+        if (frameLen < COMM_HEADER_SIZE + COMM_CRC_SIZE || len > COMM_MAX_PAYLOAD ||
+            frameLen != COMM_HEADER_SIZE + len + COMM_CRC_SIZE ||
+            COMM_RingCrc(0, (uint16_t)(COMM_HEADER_SIZE + len)) !=
+                (uint16_t)((*COMM_RingAt(COMM_HEADER_SIZE + len) << 8) |
+                           *COMM_RingAt(COMM_HEADER_SIZE + len + 1)))
+        {
+            crcErrors++;
+            COMM_RingDrop(size);
+            continue;
+        }
+
+        view->cmd = *COMM_RingAt(0);
+        view->seq = *COMM_RingAt(1);
+        view->len = len;
+        view->size = (uint8_t)size;
+        framesIn++;
+        COMM_LinkWatch(view->cmd, len);
+        uint8_t *payload;
+        if (UART_RxPeek(COMM_HEADER_SIZE, &payload) < len)
+        {
+            COMM_RingCopy(wrapBuffer, COMM_HEADER_SIZE, len);
+            payload = wrapBuffer;
+        }
+        view->payload = payload;
+        if (view->cmd == CMD_CREDIT)
+        {
+            /* Flow control is handled here, the caller never sees it */
+            COMM_FlowGrant(view->payload, len);
+            COMM_RingDrop(size);
+            continue;
+        }
+        lastCmd = view->cmd;
+        COMM_TrackSeq(view->seq);
+        return true;
+    }
+}
+
+#else /* polled driver: no ring to leave the frame in */
+
+static COMM_Frame polledFrame;
+
+static bool COMM_ScanRing(COMM_FrameView *view)
+{
+    if (!COMM_PollFrame(&polledFrame))
+    {
+        return false;
+    }
+    view->cmd = polledFrame.cmd;
+    view->seq = polledFrame.seq;
+    view->len = polledFrame.len;
+    view->payload = polledFrame.payload;
+    view->size = 0;
+    return true;
+}
+
+#endif /* UART_USE_INTERRUPTS */
+
+bool COMM_PeekFrame(COMM_FrameView *view)
+{
+    if (!viewHeld)
+    {
+        if (!COMM_ScanRing(&heldView))
+        {
+            return false;
+        }
+        viewHeld = true;
+    }
+    *view = heldView;
+    return true;
+}
+
+COMM_Status COMM_PeekFrameUntil(COMM_FrameView *view, uint32_t deadlineMs)
+{
+    for (;;)
+    {
+        if (COMM_PeekFrame(view))
+        {
+            return COMM_OK;
+        }
+        if (Tick_Expired(deadlineMs))
+        {
+            return COMM_TIMEOUT;
+        }
+        CPU_Idle();
+    }
+}
+
+void COMM_ReleaseFrame(const COMM_FrameView *view)
+{
+    /* A second release of the same view must not drop the next frame */
+    if (viewHeld)
+    {
+        viewHeld = false;
+#if UART_USE_INTERRUPTS
+        COMM_RingDrop(view->size);
+#endif
+    }
+}
+
+COMM_Status COMM_ReceiveMessage(uint8_t *cmd, uint8_t *buffer, uint8_t capacity,
+                                uint8_t *len, uint32_t deadlineMs)
+{
+    COMM_FrameView view;
+    if (COMM_PeekFrameUntil(&view, deadlineMs) != COMM_OK)
+    {
+        return COMM_TIMEOUT;
+    }
+
+    uint8_t stored = (view.len < capacity) ? view.len : capacity;
+    memcpy(buffer, view.payload, stored);
+    *cmd = view.cmd;
+    *len = stored;
+    COMM_ReleaseFrame(&view);
+    return (stored < view.len) ? COMM_TRUNCATED : COMM_OK;
+}
+
+/*******************************************************************************
+ *                         Link Statistics                                     *
+ *******************************************************************************/
+
+void COMM_GetStats(COMM_Stats *stats)
+{
+    UART_Stats uart;
+    UART_GetStats(&uart);
+
+    stats->bytesIn = uart.bytesIn;
+    stats->bytesOut = uart.bytesOut;
+    stats->framesIn = framesIn;
+    stats->framesOut = framesOut;
+    stats->crcErrors = crcErrors;
+    stats->framingErrors = uart.framingErrors;
+    stats->overrunErrors = uart.overrunErrors;
+    stats->retries = retries;
+    stats->timeouts = timeouts;
+    stats->maxRttMs = maxRttMs;
+}
+
+void COMM_ResetStats(void)
+{
+    UART_ResetStats();
+    framesIn = framesOut = crcErrors = 0;
+    retries = timeouts = maxRttMs = 0;
+}
+
+void COMM_CountRetry(void)
+{
+    retries++;
+}
+
+void COMM_CountTimeout(void)
+{
+    timeouts++;
+}
+
+void COMM_CountRtt(uint32_t rttMs)
+{
+    if (rttMs > maxRttMs)
+    {
+        maxRttMs = rttMs;
+    }
+}
+
+static uint8_t *COMM_Put32(uint8_t *out, uint32_t value)
+{
+    out[0] = (uint8_t)(value >> 24);
+    out[1] = (uint8_t)(value >> 16);
+    out[2] = (uint8_t)(value >> 8);
+    out[3] = (uint8_t)value;
+    return out + 4;
+}
+
+static uint8_t *COMM_Put16(uint8_t *out, uint32_t value)
+{
+    if (value > 0xFFFF)
+    {
+        value = 0xFFFF;
+    }
+    out[0] = (uint8_t)(value >> 8);
+    out[1] = (uint8_t)value;
+    return out + 2;
+}
+
+static uint32_t COMM_Get32(const uint8_t **in)
+{
+    const uint8_t *p = *in;
+    *in = p + 4;
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint32_t COMM_Get16(const uint8_t **in)
+{
+    const uint8_t *p = *in;
+    *in = p + 2;
+    return ((uint32_t)p[0] << 8) | p[1];
+}
+
+void COMM_EncodeStats(const COMM_Stats *stats, uint8_t *payload)
+{
+    payload = COMM_Put32(payload, stats->bytesIn);
+    payload = COMM_Put32(payload, stats->bytesOut);
+    payload = COMM_Put32(payload, stats->framesIn);
+    payload = COMM_Put32(payload, stats->framesOut);
+    payload = COMM_Put16(payload, stats->crcErrors);
+    payload = COMM_Put16(payload, stats->framingErrors);
+    payload = COMM_Put16(payload, stats->overrunErrors);
+    payload = COMM_Put16(payload, stats->retries);
+    payload = COMM_Put16(payload, stats->timeouts);
+    (void)COMM_Put16(payload, stats->maxRttMs);
+}
+
+bool COMM_DecodeStats(const uint8_t *payload, uint8_t len, COMM_Stats *stats)
+{
+    if (len != COMM_STATS_LEN)
+    {
+        return false;
+    }
+    stats->bytesIn = COMM_Get32(&payload);
+    stats->bytesOut = COMM_Get32(&payload);
+    stats->framesIn = COMM_Get32(&payload);
+    stats->framesOut = COMM_Get32(&payload);
+    stats->crcErrors = COMM_Get16(&payload);
+    stats->framingErrors = COMM_Get16(&payload);
+    stats->overrunErrors = COMM_Get16(&payload);
+    stats->retries = COMM_Get16(&payload);
+    stats->timeouts = COMM_Get16(&payload);
+    stats->maxRttMs = COMM_Get16(&payload);
+    return true;
+}
+
+void COMM_EncodeProfile(const COMM_Profile *profile, uint8_t *payload)
+{
+    *payload++ = profile->cmd;
+    payload = COMM_Put32(payload, profile->count);
+    payload = COMM_Put32(payload, profile->rejected);
+    payload = COMM_Put32(payload, profile->minCycles);
+    payload = COMM_Put32(payload, profile->avgCycles);
+    (void)COMM_Put32(payload, profile->maxCycles);
+}
+
+bool COMM_DecodeProfile(const uint8_t *payload, uint8_t len, COMM_Profile *profile)
+{
+    if (len != COMM_PROFILE_LEN)
+    {
+        return false;
+    }
+    profile->cmd = *payload++;
+    profile->count = COMM_Get32(&payload);
+    profile->rejected = COMM_Get32(&payload);
+    profile->minCycles = COMM_Get32(&payload);
+    profile->avgCycles = COMM_Get32(&payload);
+    profile->maxCycles = COMM_Get32(&payload);
+    return true;
+}
+
+/*******************************************************************************
+ *                         Baud-rate Negotiation                               *
+ *******************************************************************************/
+
+uint8_t COMM_BaudCapabilities(void)
+{
+    uint8_t caps = 0;
+    for (uint8_t i = 0; i < BAUD_RATE_COUNT; i++)
+    {
+        if (UART_BaudSupported(baudRates[i]))
+        {
+            caps |= (uint8_t)(1U << i);
+        }
+    }
+    return caps;
+}
+
+uint32_t COMM_SelectBaud(uint8_t caps)
+{
+    for (uint8_t i = BAUD_RATE_COUNT; i > 0; i--)
+    {
+        if (caps & (1U << (i - 1)))
+        {
+            return baudRates[i - 1];
+        }
+    }
+    return COMM_BAUD_FALLBACK;
+}
+
+/* CMD_READY payload of this ECU, returns its length */
+static uint8_t COMM_ReadyPayload(uint8_t *payload)
+{
+    payload[0] = COMM_BaudCapabilities();
+    payload[1] = COMM_PROTOCOL_VERSION;
+    payload[2] = COMM_FEATURES;
+    return COMM_READY_LEN;
+}
+
+/* Features of the link with the peer that sent this READY, none for a version 1 peer */
+static uint8_t COMM_ReadyFeatures(const COMM_Frame *ready)
+{
+    return (ready->len >= COMM_READY_LEN) ? (uint8_t)(COMM_FEATURES & ready->payload[2]) : 0;
+}
+
+/* Bytes received around a rate change are noise, start clean */
+static void COMM_DiscardInput(void)
+{
+    uint8_t byte;
+    while (UART_TryReceiveByte(&byte)) { }
+    COMM_ParserReset(&rxParser);
+    /* The ring scan starts over too: a held view's bytes are gone, and a
+       search position or hunt left from a half frame would misread the next */
+    viewHeld = false;
+#if UART_USE_INTERRUPTS
+    scanned = 0;
+    ringHunting = false;
+#endif
+}
+
+static uint32_t COMM_FallBack(void)
+{
+    (void)UART_SetBaudRate(COMM_BAUD_FALLBACK);
+    COMM_DiscardInput();
+    return COMM_BAUD_FALLBACK;
+}
+
+/* 0 if the HMI has not answered READY by deadlineMs */
+static uint32_t COMM_InitiateBaud(uint8_t status, uint32_t deadlineMs)
+{
+    COMM_Frame frame;
+    uint8_t ready[COMM_READY_LEN];
+    uint8_t readyLen = COMM_ReadyPayload(ready);
+
+    /* Repeat READY until the HMI answers, it may boot after us */
+    bool answered = false;
+    while (!answered)
+    {
+        COMM_SendFrame(CMD_READY, ready, readyLen);
+        uint32_t deadline = Tick_Deadline(COMM_HANDSHAKE_RETRY_MS);
+        if ((int32_t)(deadline - deadlineMs) > 0)
+        {
+            deadline = deadlineMs;
+        }
+        while (!answered && COMM_ReceiveFrameUntil(&frame, deadline) == COMM_OK)
+        {
+            answered = (frame.cmd == CMD_READY);
+        }
+        if (!answered)
+        {
+            COMM_CountRetry();      /* the next READY is a repeat */
+            if (Tick_Expired(deadlineMs))
+            {
+                return 0;           /* an answer still on its way waits in the ring */
+            }
+        }
+    }
+
+    /* A peer without a caps byte only speaks the fallback rate */
+    uint8_t peerCaps = (frame.len >= 1) ? frame.payload[0] : 0;
+    uint32_t baud = COMM_SelectBaud(ready[0] & peerCaps);
+    linkFeatures = COMM_ReadyFeatures(&frame);
+
+    uint8_t payload[COMM_BAUD_LEN] = {
+        (uint8_t)(baud >> 24), (uint8_t)(baud >> 16), (uint8_t)(baud >> 8), (uint8_t)baud
+    };
+    COMM_SendFrame(status, payload, sizeof(payload));
+
+    if (baud == COMM_BAUD_FALLBACK)
+    {
+        return baud;
+    }
+
+    /* UART_SetBaudRate lets the status frame finish at the old rate */
+    if (!UART_SetBaudRate(baud))
+    {
+        return COMM_FallBack();
+    }
+    COMM_DiscardInput();
+
+    if (COMM_WaitForCommand(CMD_READY, COMM_BAUD_PROBE_MS * COMM_BAUD_PROBE_TRIES) != COMM_OK)
+    {
+        return COMM_FallBack();
+    }
+    COMM_SendCommand(CMD_ACK);
+    return baud;
+}
+
+/* 0 if Control's READY did not come by deadlineMs or its status never followed */
+static uint32_t COMM_RespondBaud(uint8_t *status, uint32_t deadlineMs)
+{
+    COMM_Frame frame;
+    uint8_t ready[COMM_READY_LEN];
+    uint8_t readyLen = COMM_ReadyPayload(ready);
+
+    do
+    {
+        if (COMM_ReceiveFrameUntil(&frame, deadlineMs) != COMM_OK)
+        {
+            return 0;
+        }
+    } while (frame.cmd != CMD_READY);
+    linkFeatures = COMM_ReadyFeatures(&frame);
+
+    /* Control repeats READY until it hears from us, answer each repeat */
+    do
+    {
+        COMM_SendFrame(CMD_READY, ready, readyLen);
+        if (COMM_ReceiveFrameUntil(&frame, Tick_Deadline(2 * COMM_HANDSHAKE_RETRY_MS)) != COMM_OK)
+        {
+            return 0;
+        }
+    } while (frame.cmd == CMD_READY);
+    *status = frame.cmd;
+
+    uint32_t baud = COMM_BAUD_FALLBACK;
+    if (frame.len == COMM_BAUD_LEN)
+    {
+        baud = ((uint32_t)frame.payload[0] << 24) | ((uint32_t)frame.payload[1] << 16) |
+               ((uint32_t)frame.payload[2] << 8) | frame.payload[3];
+    }
+    if (baud == COMM_BAUD_FALLBACK)
+    {
+        return baud;
+    }
+
+    /* If this side cannot switch, Control's probe wait times out as well */
+    if (!UART_SetBaudRate(baud))
+    {
+        return COMM_FallBack();
+    }
+    COMM_DiscardInput();
+
+    for (uint8_t attempt = 0; attempt < COMM_BAUD_PROBE_TRIES; attempt++)
+    {
+        if (attempt > 0)
+        {
+            COMM_CountRetry();
+        }
+        COMM_SendCommand(CMD_READY);
+        if (COMM_WaitForCommand(CMD_ACK, COMM_BAUD_PROBE_MS) == COMM_OK)
+        {
+            return baud;
+        }
+    }
+    return COMM_FallBack();
+}
+
+/*
+ * A handshake after a lost link: a restarted peer listens at the fallback
+ * rate, and no credit from the old session may hold our frames back.
+ */
+static void COMM_LinkDrop(void)
+{
+    if (!linkUp)
+    {
+        return;
+    }
+    linkUp = false;
+    flowStarted = false;
+    creditActive = false;
+    (void)COMM_FallBack();
+}
+
+/* Both sides start counting for flow control once the link rate is settled */
+static void COMM_LinkStart(bool responder)
+{
+    COMM_ForgetReplies();
+    COMM_FlowReset();
+    linkUp = true;
+    linkResponder = responder;
+    peerRestarted = false;
+    lastFrameTicks = GetTicks();
+}
+
+uint32_t COMM_HandshakeInitiateUntil(uint8_t status, uint32_t deadlineMs)
+{
+    COMM_LinkDrop();
+    uint32_t baud = COMM_InitiateBaud(status, deadlineMs);
+    if (baud != 0)
+    {
+        COMM_LinkStart(false);
+    }
+    return baud;
+}
+
+uint32_t COMM_HandshakeInitiate(uint8_t status)
+{
+    uint32_t baud;
+    do
+    {
+        baud = COMM_HandshakeInitiateUntil(status, Tick_Deadline(COMM_HANDSHAKE_RETRY_MS));
+    } while (baud == 0);
+    return baud;
+}
+
+uint32_t COMM_HandshakeRespondUntil(uint8_t *status, uint32_t deadlineMs)
+{
+    COMM_LinkDrop();
+    uint32_t baud = COMM_RespondBaud(status, deadlineMs);
+    if (baud != 0)
+    {
+        COMM_LinkStart(true);
+    }
+    return baud;
+}
+
+uint32_t COMM_HandshakeRespond(uint8_t *status)
+{
+    uint32_t baud;
+    do
+    {
+        baud = COMM_HandshakeRespondUntil(status, Tick_Deadline(2 * COMM_HANDSHAKE_RETRY_MS));
+    } while (baud == 0);
+    return baud;
+}
+
+/*******************************************************************************
+ *                         Link Supervision                                    *
+ *******************************************************************************/
+
+uint32_t COMM_LinkIdleMs(void)
+{
+    return GetTicks() - lastFrameTicks;
+}
+
+bool COMM_LinkAlive(void)
+{
+    /* Without heartbeats an idle peer is silent, silence says nothing then */
+    bool heard = !(linkFeatures & COMM_FEATURE_HEARTBEAT) || COMM_LinkIdleMs() < COMM_LINK_TIMEOUT_MS;
+    return linkUp && !peerRestarted && heard;
+}
+
+uint8_t COMM_Features(void)
+{
+    return linkFeatures;
+}
+
+/*******************************************************************************
+ *                         Warm Reset                                          *
+ *******************************************************************************/
+
+/* RX ring bytes not processed yet, none with the polled driver */
+static uint16_t COMM_RingPending(void)
+{
+    uint16_t pending = 0;
+#if UART_USE_INTERRUPTS
+    uint8_t *data;
+    uint16_t span;
+    while ((span = UART_RxPeek(pending, &data)) > 0)
+    {
+        pending += span;
+    }
+#endif
+    return pending;
+}
+
+bool COMM_LinkSave(COMM_LinkSnapshot *snapshot)
+{
+    UART_Drain();   /* frames sent so far reach the peer before the reset */
+    if (!linkUp || peerRestarted)
+    {
+        return false;
+    }
+    snapshot->baud = UART_GetBaudRate();
+    snapshot->features = linkFeatures;
+    snapshot->txSeq = txSeq;
+    snapshot->responder = linkResponder;
+    snapshot->creditActive = creditActive;
+    snapshot->creditLimit = creditLimit;
+    snapshot->sentBytes = sentBytes;
+    snapshot->consumedBytes = (uint16_t)(consumedBytes + COMM_RingPending());
+    snapshot->grantedLimit = grantedLimit;
+    snapshot->replyNext = replyNext;
+    snapshot->rxSeqKnown = rxSeqKnown;
+    snapshot->rxNewestSeq = rxNewestSeq;
+    memcpy(snapshot->replies, replyCache, sizeof(replyCache));
+    return true;
 }
 
-void COMM_ReceiveMessage(uint8_t *buffer)
+void COMM_LinkResume(const COMM_LinkSnapshot *snapshot)
 {
-    uint8_t i = 0;
-    buffer[i] = UART_ReceiveByte();
-    while(buffer[i] != COMM_END_MARKER && buffer[i] != '\r')
+    if (snapshot->baud != UART_GetBaudRate() && !UART_SetBaudRate(snapshot->baud))
     {
-        i++;
-        buffer[i] = UART_ReceiveByte();
+        return;     /* link stays down, the caller's link check shakes hands */
     }
-    buffer[i] = '\0';
+    COMM_DiscardInput();
+    linkFeatures = snapshot->features;
+    txSeq = snapshot->txSeq;
+    flowStarted = COMM_FLOW_ENABLED && (linkFeatures & COMM_FEATURE_CREDIT);
+    creditActive = snapshot->creditActive;
+    creditLimit = snapshot->creditLimit;
+    sentBytes = snapshot->sentBytes;
+    consumedBytes = snapshot->consumedBytes;
+    grantedLimit = snapshot->grantedLimit;
+    replyNext = (snapshot->replyNext < COMM_REPLY_CACHE) ? snapshot->replyNext : 0;
+    memcpy(replyCache, snapshot->replies, sizeof(replyCache));
+    rxSeqKnown = snapshot->rxSeqKnown;
+    rxNewestSeq = snapshot->rxNewestSeq;
+    linkUp = true;
+    linkResponder = snapshot->responder;
+    peerRestarted = false;
+    lastFrameTicks = GetTicks();
 }
@@ -1,38 +1,226 @@
 #ifndef COMM_INTERFACE_H_
 #define COMM_INTERFACE_H_
 
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include "../MCAL/uart.h"
+#include "comm_protocol.h"
 
 /*******************************************************************************
  *                         Definitions and Protocol                            *
  *******************************************************************************/
 
 /*
- * Application-defined message protocol:
- * - Each command is 1 byte (e.g. 'O' for open door, 'C' for change pass)
- * - Followed by payload bytes if needed
- * - End of message indicated by '#\n'
+ * Application-defined frame format (all fields 1 byte unless noted):
+ *
+ *   | CMD | SEQ | LEN | PAYLOAD (LEN bytes) | CRC16 hi | CRC16 lo |
+ *
+ * On the wire every frame is COBS-stuffed and followed by a 0x00 delimiter:
+ *
+ *   | code | frame with each 0x00 replaced by a distance | 0x00 |
+ *
+ * - 0x00 never occurs inside a stuffed frame, so after a lost or corrupted
+ *   byte the receiver drops what it has and starts again at the next 0x00;
+ *   garbage can never be taken for a command
+ * - the leading code byte is the distance to the first replaced 0x00 (or to
+ *   the end), each replaced 0x00 holds the distance to the next one; frames
+ *   are shorter than 254 bytes, so stuffing always costs exactly one byte
+ * - SEQ is a per-sender counter, replies may echo the request's SEQ
+ * - LEN is checked against COMM_MAX_PAYLOAD before any payload byte is stored
+ * - CRC16 (CCITT-FALSE) covers CMD, SEQ, LEN and the payload
+ * Payload bytes are raw binary, so any value (including 0x00) is allowed.
  */
-#define COMM_END_MARKER   '\n'
+#define COMM_DELIMITER          0x00
+#define COMM_HEADER_SIZE        3       /* CMD, SEQ, LEN */
+#define COMM_CRC_SIZE           2
+#define COMM_COBS_OVERHEAD      1       /* code byte */
 
+/* Hard limit on payload bytes the receiver will accept */
+#ifndef COMM_MAX_PAYLOAD
+#define COMM_MAX_PAYLOAD        32
+#endif
 
-/* enumaration of command codes */
+#if COMM_MAX_PAYLOAD > 248
+#error "COMM_MAX_PAYLOAD: a frame must stay below 254 bytes for one-byte COBS overhead"
+#endif
+
+/* Unstuffed frame, and the same frame on the wire (code byte and delimiter added) */
+#define COMM_MAX_FRAME_SIZE     (COMM_HEADER_SIZE + COMM_MAX_PAYLOAD + COMM_CRC_SIZE)
+#define COMM_WIRE_SIZE(len)     (COMM_COBS_OVERHEAD + COMM_HEADER_SIZE + (len) + COMM_CRC_SIZE + 1)
+#define COMM_MAX_WIRE_SIZE      COMM_WIRE_SIZE(COMM_MAX_PAYLOAD)
+
+/*
+ * Baud-rate and feature negotiation (inside the CMD_READY / CMD_INIT handshake):
+ *   Control -> HMI : CMD_READY [caps | version | features]
+ *   HMI -> Control : CMD_READY [caps | version | features]
+ *   Control -> HMI : CMD_INIT or CMD_ACK [baud, 4 bytes big-endian]
+ *   both switch, then HMI -> Control : CMD_READY, Control -> HMI : CMD_ACK
+ * If the probe is not answered both sides return to COMM_BAUD_FALLBACK.
+ * Bit n of caps is the n-th entry of the rate table in comm_interface.c
+ * (115200, 230400, 460800, 921600, 1000000). Both sides keep the features
+ * they have in common (COMM_FEATURE_* in comm_protocol.h).
+ */
+#define COMM_BAUD_FALLBACK      UART_BAUD_RATE
+
+/* Control repeats its READY this often (ms) until the HMI answers */
+#ifndef COMM_HANDSHAKE_RETRY_MS
+#define COMM_HANDSHAKE_RETRY_MS 250
+#endif
+
+/* Wait for each probe step (ms), and probe attempts */
+#ifndef COMM_BAUD_PROBE_MS
+#define COMM_BAUD_PROBE_MS      50
+#endif
+#define COMM_BAUD_PROBE_TRIES   4
+
+/*
+ * Link supervision after the handshake. The link is up while valid frames
+ * keep arriving: the HMI sends CMD_HEARTBEAT (no payload) once it has heard
+ * nothing for COMM_HEARTBEAT_MS, Control answers it with CMD_HEARTBEAT and the
+ * same SEQ. A side that hears nothing for COMM_LINK_TIMEOUT_MS takes the peer
+ * as reset or unplugged and goes back to the handshake at COMM_BAUD_FALLBACK,
+ * where a restarted peer is waiting (see comm_link.h for the HMI side).
+ */
+#ifndef COMM_HEARTBEAT_MS
+#define COMM_HEARTBEAT_MS       500
+#endif
+
+/* Longer than Control's slowest blocking action, the 3 s lockout buzzer */
+#ifndef COMM_LINK_TIMEOUT_MS
+#define COMM_LINK_TIMEOUT_MS    4000
+#endif
+
+/*
+ * Credit-based flow control (interrupt-driven UART only). After the handshake
+ * each side grants its peer room in its RX ring:
+ *   CMD_CREDIT [limit, 2 bytes big-endian]
+ * limit is a byte count on the peer's side: everything it has sent since the
+ * handshake, this frame included, may not go past it. The receiver moves the
+ * limit forward as it consumes frames, so a sender can never fill the ring
+ * while the receiver is busy (EEPROM write, motor). A sender out of credit
+ * waits in COMM_SendFrame and friends for the next grant, at most
+ * COMM_FLOW_WAIT_MS, then sends anyway and stops limiting until a new grant.
+ * CMD_CREDIT itself is never held back, COMM_FLOW_RESERVE bytes of the ring
+ * are kept for it. A peer that never grants is never limited.
+ */
+#ifndef COMM_FLOW_CONTROL
+#define COMM_FLOW_CONTROL       1
+#endif
+#define COMM_FLOW_RESERVE       64
+#define COMM_FLOW_WINDOW        (UART_RX_BUFFER_SIZE - COMM_FLOW_RESERVE)
+#define COMM_FLOW_UPDATE        (COMM_FLOW_WINDOW / 4)  /* bytes consumed before a new grant */
+
+/* Replies kept for repeated requests (COMM_ReplayReply), one per request the peer can have in flight */
+#ifndef COMM_REPLY_CACHE
+#define COMM_REPLY_CACHE        4
+#endif
+
+/*
+ * A reply is replayed only while its SEQ is less than this many behind the
+ * newest one received. The peer's SEQ wraps at 8 bits (idle heartbeats alone
+ * take it round in about 2 minutes), so an older reply could otherwise answer
+ * a new request that happens to land on the same SEQ.
+ */
+#define COMM_REPLY_WINDOW       (2 * COMM_REPLY_CACHE)
+
+/* Longest receiver stall a sender waits out (the door motor loop blocks 1-2 s) */
+#ifndef COMM_FLOW_WAIT_MS
+#define COMM_FLOW_WAIT_MS       2000
+#endif
+
+/* Reply to a recent request, sent again when the request is repeated */
+typedef struct {
+    bool used;
+    uint8_t request;            /* command of the request answered */
+    uint8_t seq;
+    uint8_t cmd;
+    uint8_t len;
+    uint8_t payload[COMM_MAX_PAYLOAD];
+} COMM_CachedReply;
+
+/* One decoded frame */
+typedef struct {
+    uint8_t cmd;
+    uint8_t seq;
+    uint8_t len;
+    uint8_t payload[COMM_MAX_PAYLOAD];
+} COMM_Frame;
+
+/*
+ * A received frame left where it arrived, in the UART RX ring (see
+ * COMM_PeekFrame). It is unstuffed in place, which only ever moves bytes
+ * towards the front of its own slots. payload stays valid, and its ring slots
+ * stay taken, until COMM_ReleaseFrame. Only a frame that straddles the end of
+ * the ring is copied once, into a COMM_MAX_PAYLOAD buffer inside the comm layer.
+ */
+typedef struct {
+    uint8_t cmd;
+    uint8_t seq;
+    uint8_t len;
+    const uint8_t *payload;
+    uint8_t size;           /* bytes the whole frame occupies in the ring */
+} COMM_FrameView;
+
+/* Receiver state machine, advanced one byte at a time */
 typedef enum {
-    CMD_READY = 0x10,
-    CMD_SEND_PASSWORD,
-    CMD_PASSWORD_CORRECT,
-    CMD_PASSWORD_WRONG,
-    CMD_CHANGE_PASSWORD,
-    CMD_DOOR_UNLOCK,
-    CMD_DOOR_LOCK,
-    CMD_SET_TIMEOUT,
-    CMD_SUCCESS,
-    CMD_FAIL,
-    CMD_ALARM,
-    CMD_ACK,
-    CMD_UNKNOWN,
-    CMD_INIT
-} COMM_CommandID;
+    COMM_RX_START,          /* next byte is the code byte of a new frame */
+    COMM_RX_DATA,           /* inside a stuffed frame */
+    COMM_RX_HUNT            /* frame rejected, dropping bytes up to the next 0x00 */
+} COMM_RxState;
+
+typedef struct {
+    COMM_RxState state;
+    uint8_t run;            /* stuffed bytes left in the current block, 0 = code byte next */
+    bool zeroPending;       /* the block that just ended stands for a 0x00 */
+    uint8_t index;          /* unstuffed bytes so far */
+    uint16_t crc;           /* running CRC over CMD..PAYLOAD */
+    uint16_t rxCrc;         /* CRC received in the trailer */
+    COMM_Frame frame;
+} COMM_Parser;
+
+typedef enum {
+    COMM_PARSE_BUSY,        /* byte consumed, frame not finished */
+    COMM_PARSE_FRAME,       /* parser->frame holds a valid frame */
+    COMM_PARSE_ERROR        /* bad stuffing, length or CRC, parser resynchronizing */
+} COMM_ParseResult;
+
+/* Result of a bounded receive */
+typedef enum {
+    COMM_OK,
+    COMM_TIMEOUT,
+    COMM_TRUNCATED          /* payload longer than the caller's buffer, tail dropped */
+} COMM_Status;
+
+/* Link counters of this ECU since COMM_Init / COMM_ResetStats */
+typedef struct {
+    uint32_t bytesIn;
+    uint32_t bytesOut;
+    uint32_t framesIn;          /* valid frames received */
+    uint32_t framesOut;
+    uint32_t crcErrors;         /* frames dropped for a CRC mismatch or oversized LEN */
+    uint32_t framingErrors;     /* UART framing, parity or break errors */
+    uint32_t overrunErrors;     /* UART FIFO overruns and bytes lost on a full RX ring */
+    uint32_t retries;           /* frames sent again because no answer came */
+    uint32_t timeouts;          /* requests whose deadline passed without a reply */
+    uint32_t maxRttMs;          /* slowest answered request */
+} COMM_Stats;
+
+/* How the dispatcher of the replying ECU handled one command, see comm_dispatch.h */
+typedef struct {
+    uint8_t cmd;
+    uint32_t count;             /* handler runs */
+    uint32_t rejected;          /* frames refused before a handler ran */
+    uint32_t minCycles;         /* core cycles of one handler run, reply included */
+    uint32_t avgCycles;
+    uint32_t maxCycles;
+} COMM_Profile;
+
+/* Called from interrupt context once an async payload buffer may be reused */
+typedef void (*COMM_TxCallback)(void);
+
+/* Called from interrupt context when bytes were received */
+typedef void (*COMM_RxCallback)(void);
 
 /*******************************************************************************
  *                         Function Prototypes                                 *
@@ -42,16 +230,216 @@ typedef enum {
 /* Initializes UART communication channel */
 void COMM_Init(void);
 
-/* Send a command (1 byte) */
+/* Send a frame with no payload */
 void COMM_SendCommand(uint8_t cmd);
 
-/* Send a string message terminated by COMM_END_MARKER */
-void COMM_SendMessage(const uint8_t *msg);
+/*
+ * Stuffed wire bytes of a frame, delimiter included, into wire (at least
+ * COMM_MAX_WIRE_SIZE bytes). Returns COMM_WIRE_SIZE(len).
+ */
+uint8_t COMM_EncodeFrame(uint8_t *wire, uint8_t cmd, uint8_t seq,
+                         const uint8_t *payload, uint8_t len);
+
+/* Send a frame carrying len payload bytes (len <= COMM_MAX_PAYLOAD), returns its SEQ */
+uint8_t COMM_SendFrame(uint8_t cmd, const uint8_t *payload, uint8_t len);
+
+/*
+ * Send a frame that echoes the SEQ of the request it answers (see comm_request.h).
+ * A reply to the last received frame is kept for COMM_ReplayReply.
+ */
+void COMM_SendReply(uint8_t seq, uint8_t cmd, const uint8_t *payload, uint8_t len);
+
+/* Send a request again under its original SEQ (retransmission) */
+void COMM_ResendFrame(uint8_t seq, uint8_t cmd, const uint8_t *payload, uint8_t len);
+
+/*
+ * Duplicate suppression on the answering side: if the request cmd with this
+ * SEQ was one of the last COMM_REPLY_CACHE answered, and the SEQ is within
+ * COMM_REPLY_WINDOW behind the newest received, its reply is sent again and
+ * true is returned, the caller drops the frame without acting on it. Replies
+ * fall out as newer SEQs arrive, and the handshake empties the cache when the
+ * peer's SEQ restarts.
+ */
+bool COMM_ReplayReply(uint8_t cmd, uint8_t seq);
+
+/*
+ * Zero-copy variant: header and CRC go through the TX ring, the payload is
+ * handed to the uDMA and the call returns at once. payload must not be
+ * modified until done runs (interrupt context) or COMM_TxBusy() is false.
+ * A payload containing 0x00 has to be stuffed, it is copied through the TX
+ * ring like COMM_SendFrame and done runs before the call returns.
+ */
+uint8_t COMM_SendFrameAsync(uint8_t cmd, const uint8_t *payload, uint8_t len,
+                            COMM_TxCallback done);
+
+/* True while an async payload is still being read from the caller's buffer */
+bool COMM_TxBusy(void);
+
+/*
+ * Run received (interrupt context) whenever bytes come in, for an event
+ * loop that peeks for frames only then. NULL stops it.
+ */
+void COMM_SetRxCallback(COMM_RxCallback received);
+
+/* Block until a valid frame arrives (corrupt frames are dropped) */
+void COMM_ReceiveFrame(COMM_Frame *frame);
 
-/* Receive a command (1 byte) */
+/* Non-blocking: consume whatever bytes are waiting, true once a frame is complete */
+bool COMM_PollFrame(COMM_Frame *frame);
+
+/* Receive the next frame and return its command (payload is discarded) */
 uint8_t COMM_ReceiveCommand(void);
 
-/* Receive a string message until COMM_END_MARKER */
-void COMM_ReceiveMessage(uint8_t *buffer);
+/* Non-blocking: true and *cmd set if a complete frame was waiting */
+bool COMM_TryReceiveCommand(uint8_t *cmd);
+
+/*
+ * Bounded receive: wait for the next valid frame until GetTicks() reaches
+ * deadlineMs (see Tick_Deadline in tick.h). COMM_TIMEOUT leaves *frame untouched.
+ */
+COMM_Status COMM_ReceiveFrameUntil(COMM_Frame *frame, uint32_t deadlineMs);
+
+/* Same as COMM_ReceiveFrameUntil, only the command is returned */
+COMM_Status COMM_ReceiveCommandUntil(uint8_t *cmd, uint32_t deadlineMs);
+
+/* Wait up to timeoutMs for a frame carrying cmd, other frames are dropped */
+COMM_Status COMM_WaitForCommand(uint8_t cmd, uint32_t timeoutMs);
+
+/*
+ * Bounded receive into a caller-sized buffer: wait until deadlineMs for the
+ * next frame, store its command and at most capacity payload bytes, and set
+ * *len to the number stored. The payload is copied once, straight from the
+ * RX ring. COMM_TRUNCATED if it did not fit, COMM_TIMEOUT leaves all untouched.
+ */
+COMM_Status COMM_ReceiveMessage(uint8_t *cmd, uint8_t *buffer, uint8_t capacity,
+                                uint8_t *len, uint32_t deadlineMs);
+
+/*
+ * Zero-copy receive. Non-blocking: true once a complete, CRC-checked frame is
+ * at the front of the RX ring; *view describes it in place. Until it is
+ * released every call returns the same frame. Use either views or the
+ * COMM_Frame receives above, a frame half read by one is lost to the other.
+ * With the polled UART driver the frame is parsed into a buffer in the comm
+ * layer instead and the view points there.
+ */
+bool COMM_PeekFrame(COMM_FrameView *view);
+
+/* COMM_PeekFrame, waiting until deadlineMs */
+COMM_Status COMM_PeekFrameUntil(COMM_FrameView *view, uint32_t deadlineMs);
+
+/* Done with the frame: its ring slots go back to the receiver */
+void COMM_ReleaseFrame(const COMM_FrameView *view);
+
+/* Bitmask of handshake rates this ECU's clock can generate */
+uint8_t COMM_BaudCapabilities(void);
+
+/* Highest rate present in caps, COMM_BAUD_FALLBACK if none */
+uint32_t COMM_SelectBaud(uint8_t caps);
+
+/*
+ * Control side of the startup handshake: announce readiness, wait for the
+ * HMI, send status (CMD_INIT or CMD_ACK) with the chosen rate and switch to it.
+ * Returns the rate in use afterwards.
+ */
+uint32_t COMM_HandshakeInitiate(uint8_t status);
+
+/*
+ * COMM_HandshakeInitiate that gives up if the HMI has not answered READY by
+ * deadlineMs. Returns 0 then; the next call goes on with one more READY, and
+ * an answer that came late is still waiting in the ring for it. For a main
+ * loop that must keep its timers running while the HMI is away.
+ */
+uint32_t COMM_HandshakeInitiateUntil(uint8_t status, uint32_t deadlineMs);
+
+/* HMI side: answer CMD_READY, store the status Control sent, follow its rate */
+uint32_t COMM_HandshakeRespond(uint8_t *status);
+
+/*
+ * COMM_HandshakeRespond that gives up if Control's READY has not come by
+ * deadlineMs, or a later step of the handshake goes unanswered. Returns 0
+ * then, and the call can simply be repeated.
+ */
+uint32_t COMM_HandshakeRespondUntil(uint8_t *status, uint32_t deadlineMs);
+
+/*
+ * True from a completed handshake for as long as valid frames keep arriving,
+ * none more than COMM_LINK_TIMEOUT_MS apart (only with COMM_FEATURE_HEARTBEAT,
+ * an idle peer is silent otherwise). On the HMI a READY with caps from Control
+ * (it restarted its handshake) ends it at once. Both handshakes start by
+ * moving the UART back to COMM_BAUD_FALLBACK if the link was up.
+ */
+bool COMM_LinkAlive(void);
+
+/* Milliseconds since the last valid frame was received */
+uint32_t COMM_LinkIdleMs(void);
+
+/*
+ * What a link needs to carry on across a warm reset of this ECU
+ * (Control_ECU/Helpers/software_reset.h) without a new handshake: the rate
+ * and features agreed, the flow control counts, the next seq and the reply
+ * cache, so a request repeated after the reset is still answered from it.
+ */
+typedef struct {
+    uint32_t baud;
+    uint8_t features;
+    uint8_t txSeq;
+    bool responder;
+    bool creditActive;
+    uint16_t creditLimit;
+    uint16_t sentBytes;
+    uint16_t consumedBytes;
+    uint16_t grantedLimit;
+    uint8_t replyNext;
+    bool rxSeqKnown;
+    uint8_t rxNewestSeq;
+    COMM_CachedReply replies[COMM_REPLY_CACHE];
+} COMM_LinkSnapshot;
+
+/*
+ * Snapshot of the link for a warm reset, false while it is down (a reset
+ * then needs the handshake anyway). Bytes still waiting in the RX ring are
+ * lost with the reset, they count as consumed so the peer keeps its window.
+ * Returns once every frame sent so far has left the UART.
+ */
+bool COMM_LinkSave(COMM_LinkSnapshot *snapshot);
+
+/*
+ * After COMM_Init on a warm boot, instead of the handshake: back to the
+ * saved rate and counts, link up as if no frame had been missed.
+ */
+void COMM_LinkResume(const COMM_LinkSnapshot *snapshot);
+
+/*
+ * Restart flow control with both byte counts at zero and grant the peer its
+ * first window. Called at the end of both handshake functions.
+ */
+void COMM_FlowReset(void);
+
+/* Bytes this side may still send, 0xFFFF while the peer does not limit it */
+uint16_t COMM_FlowCredit(void);
+
+/* Snapshot of the counters (UART byte and error counts included) */
+void COMM_GetStats(COMM_Stats *stats);
+
+void COMM_ResetStats(void);
+
+/* Counter updates from the layers above the framing (request layer, handshake) */
+void COMM_CountRetry(void);
+void COMM_CountTimeout(void);
+void COMM_CountRtt(uint32_t rttMs);
+
+/* CMD_STATS payload <-> COMM_Stats, decoding fails unless len is COMM_STATS_LEN */
+void COMM_EncodeStats(const COMM_Stats *stats, uint8_t *payload);
+bool COMM_DecodeStats(const uint8_t *payload, uint8_t len, COMM_Stats *stats);
+
+/* CMD_PROFILE reply payload <-> COMM_Profile, decoding fails unless len is COMM_PROFILE_LEN */
+void COMM_EncodeProfile(const COMM_Profile *profile, uint8_t *payload);
+bool COMM_DecodeProfile(const uint8_t *payload, uint8_t len, COMM_Profile *profile);
+
+/* Reset a parser to start on the next byte, as after a delimiter */
+void COMM_ParserReset(COMM_Parser *parser);
+
+/* Feed one received wire byte to the parser, O(1) */
+COMM_ParseResult COMM_ParseByte(COMM_Parser *parser, uint8_t byte);
 
 #endif /* COMM_INTERFACE_H_ */
@@ -0,0 +1,101 @@
+#include "comm_link.h"
+#include "comm_request.h"
+#include "../MCAL/tick.h"
+#include "../Utils/swtimer.h"
+
+/*******************************************************************************
+ *                         Private Variables                                   *
+ *******************************************************************************/
+
+static COMM_RequestHandle heartbeat = COMM_REQUEST_NONE;
+
+/*******************************************************************************
+ *                         Private Functions                                   *
+ *******************************************************************************/
+
+/* One heartbeat in flight at a time, it only has to draw some frame from Control */
+static void COMM_LinkHeartbeat(void)
+{
+    if (!COMM_PeerSupports(CMD_HEARTBEAT))
+    {
+        return;
+    }
+    if (heartbeat != COMM_REQUEST_NONE)
+    {
+        if (COMM_RequestGetState(heartbeat) == COMM_REQ_PENDING)
+        {
+            return;
+        }
+        COMM_RequestRelease(heartbeat);
+        heartbeat = COMM_REQUEST_NONE;
+    }
+    if (COMM_LinkIdleMs() >= COMM_HEARTBEAT_MS)
+    {
+        heartbeat = COMM_RequestSend(CMD_HEARTBEAT, NULL, 0, COMM_HEARTBEAT_MS);
+    }
+}
+
+/* Earliest of wake and the tick sinceIdle ms after the last frame */
+static uint32_t COMM_LinkEarliest(uint32_t wake, uint32_t now, uint32_t idle, uint32_t sinceIdle)
+{
+    uint32_t at = now + ((idle < sinceIdle) ? sinceIdle - idle : 0);
+    return ((int32_t)(at - wake) < 0) ? at : wake;
+}
+
+/*******************************************************************************
+ *                         Functions Definitions                               *
+ *******************************************************************************/
+
+void COMM_LinkInit(void)
+{
+    heartbeat = COMM_REQUEST_NONE;
+}
+
+COMM_LinkState COMM_LinkService(uint8_t *status)
+{
+    COMM_RequestPoll();
+    if (COMM_LinkAlive())
+    {
+        COMM_LinkHeartbeat();
+        return COMM_LINK_UP;
+    }
+
+    if (COMM_HandshakeRespondUntil(status, Tick_Deadline(COMM_RECONNECT_SLICE_MS)) == 0)
+    {
+        return COMM_LINK_DOWN;
+    }
+    COMM_RequestReset();
+    if (heartbeat != COMM_REQUEST_NONE)
+    {
+        COMM_RequestRelease(heartbeat);
+        heartbeat = COMM_REQUEST_NONE;
+    }
+    return COMM_LINK_RECONNECTED;
+}
+
+uint32_t COMM_LinkWakeTick(void)
+{
+    uint32_t now = GetTicks();
+    if (!COMM_LinkAlive())
+    {
+        return now;
+    }
+
+    uint32_t idle = COMM_LinkIdleMs();
+    uint32_t wake;
+    if (!SWTIMER_NextDue(&wake))
+    {
+        wake = now + COMM_LINK_TIMEOUT_MS;      /* nothing sooner, look again then */
+    }
+    if (COMM_Features() & COMM_FEATURE_HEARTBEAT)
+    {
+        wake = COMM_LinkEarliest(wake, now, idle, COMM_LINK_TIMEOUT_MS);
+    }
+    /* A heartbeat in flight is covered by its request timer */
+    if (COMM_PeerSupports(CMD_HEARTBEAT) &&
+        (heartbeat == COMM_REQUEST_NONE || COMM_RequestGetState(heartbeat) != COMM_REQ_PENDING))
+    {
+        wake = COMM_LinkEarliest(wake, now, idle, COMM_HEARTBEAT_MS);
+    }
+    return wake;
+}
@@ -0,0 +1,55 @@
+#ifndef COMM_LINK_H_
+#define COMM_LINK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "comm_interface.h"
+
+/*******************************************************************************
+ *                         Link Supervision (HMI side)                         *
+ *******************************************************************************/
+
+/*
+ * Keeps the link to Control alive and brings it back after either ECU reset,
+ * on top of comm_request.h. COMM_LinkService is called from every wait loop of
+ * the application, it never blocks for long:
+ * - it runs COMM_RequestPoll, so frames are taken in while the UI waits
+ * - after COMM_HEARTBEAT_MS without a frame from Control it sends CMD_HEARTBEAT
+ * - after COMM_LINK_TIMEOUT_MS without one the link is down: the UART goes
+ *   back to COMM_BAUD_FALLBACK and each call listens up to
+ *   COMM_RECONNECT_SLICE_MS for the READY a restarted Control repeats
+ * Control needs none of this: it answers CMD_HEARTBEAT and runs
+ * COMM_HandshakeInitiateUntil again once COMM_LinkAlive() turns false, which also
+ * covers a reset HMI waiting in its own handshake. Without
+ * COMM_FEATURE_HEARTBEAT on both sides only a restarted Control is noticed
+ * (its READY), silence is not.
+ */
+
+/* Two of Control's READY repeats, one of them is heard whole */
+#define COMM_RECONNECT_SLICE_MS (2 * COMM_HANDSHAKE_RETRY_MS)
+
+typedef enum {
+    COMM_LINK_UP,
+    COMM_LINK_DOWN,             /* Control silent, listening for its handshake */
+    COMM_LINK_RECONNECTED       /* handshake done again, once; *status is CMD_INIT or CMD_ACK */
+} COMM_LinkState;
+
+/* Start supervising, after the first handshake and COMM_RequestInit */
+void COMM_LinkInit(void);
+
+/*
+ * Heartbeat and reconnect step, see above. After COMM_LINK_RECONNECTED the
+ * requests still pending have timed out (COMM_RequestReset) and the caller
+ * has to restore its session from *status, e.g. set a password up again.
+ */
+COMM_LinkState COMM_LinkService(uint8_t *status);
+
+/*
+ * Tick by which COMM_LinkService has timed work: a heartbeat to send, the
+ * link timeout, a request's deadline or retransmission. GetTicks() while the
+ * link is down (it listens then). A caller that sleeps between services wakes
+ * by then at the latest (POWER_SleepUntil); frames wake it anyway.
+ */
+uint32_t COMM_LinkWakeTick(void);
+
+#endif /* COMM_LINK_H_ */
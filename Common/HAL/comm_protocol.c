@@ -0,0 +1,71 @@
+#include "comm_protocol.h"
+#include "comm_interface.h"
+
+/*******************************************************************************
+ *                         Generated Tables                                    *
+ *******************************************************************************/
+
+/* Every row must fit a frame, and its ID the table below */
+#define COMM_COMMAND_CHECK(name, id, sender, feature, minLen, maxLen, digits) \
+    typedef char name##_row_check[((maxLen) <= COMM_MAX_PAYLOAD && (minLen) <= (maxLen) && \
+                                   (digits) <= (minLen) && (id) >= COMM_COMMAND_FIRST) ? 1 : -1];
+COMM_COMMAND_TABLE(COMM_COMMAND_CHECK)
+
+/* Indexed by ID, gaps (no such command) have no name */
+#define COMM_COMMAND_ROW(name, id, sender, feature, minLen, maxLen, digits) \
+    [COMM_COMMAND_INDEX(id)] = { #name, (sender), (feature), (minLen), (maxLen), (digits) },
+static const COMM_CommandInfo commandTable[COMM_COMMAND_SLOTS] = {
+    COMM_COMMAND_TABLE(COMM_COMMAND_ROW)
+};
+
+/*******************************************************************************
+ *                         Functions Definitions                               *
+ *******************************************************************************/
+
+const COMM_CommandInfo *COMM_GetCommandInfo(uint8_t cmd)
+{
+    if (cmd < COMM_COMMAND_FIRST || cmd >= COMM_COMMAND_LIMIT)
+    {
+        return NULL;
+    }
+    const COMM_CommandInfo *info = &commandTable[COMM_COMMAND_INDEX(cmd)];
+    return (info->name != NULL) ? info : NULL;
+}
+
+const char *COMM_CommandName(uint8_t cmd)
+{
+    const COMM_CommandInfo *info = COMM_GetCommandInfo(cmd);
+    return (info != NULL) ? info->name : "?";
+}
+
+COMM_CheckResult COMM_CheckPayload(uint8_t cmd, const uint8_t *payload, uint8_t len,
+                                   COMM_Sender from)
+{
+    const COMM_CommandInfo *info = COMM_GetCommandInfo(cmd);
+    if (info == NULL || !(info->sender & from))
+    {
+        return COMM_CHECK_UNKNOWN;
+    }
+    if (!COMM_PeerSupports(cmd))
+    {
+        return COMM_CHECK_UNSUPPORTED;
+    }
+    if (len < info->minLen || len > info->maxLen)
+    {
+        return COMM_CHECK_MALFORMED;
+    }
+    for (uint8_t i = 0; i < info->digits; i++)
+    {
+        if (payload[i] < '0' || payload[i] > '9')
+        {
+            return COMM_CHECK_MALFORMED;
+        }
+    }
+    return COMM_CHECK_OK;
+}
+
+bool COMM_PeerSupports(uint8_t cmd)
+{
+    const COMM_CommandInfo *info = COMM_GetCommandInfo(cmd);
+    return info != NULL && (info->feature & COMM_Features()) == info->feature;
+}
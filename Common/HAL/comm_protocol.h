@@ -0,0 +1,210 @@
+#ifndef COMM_PROTOCOL_H_
+#define COMM_PROTOCOL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ *                         Payload Layouts                                     *
+ *******************************************************************************/
+
+#define COMM_PASSWORD_LENGTH    5       /* ASCII digits, not terminated */
+
+/*
+ * Handshake, see comm_interface.h:
+ *   CMD_READY [baud caps | protocol version | features]
+ *   CMD_INIT / CMD_ACK [baud, 4 bytes big-endian]
+ * A READY with only the caps byte (or none) is a version 1 peer, it has no
+ * optional features.
+ */
+#define COMM_READY_LEN          3
+#define COMM_BAUD_LEN           4
+
+/*
+ * Compound commands: the credential travels with the action, Control checks
+ * it and acts in the same request and sends one reply.
+ *   CMD_VERIFY_AND_UNLOCK      [password]            -> CMD_SUCCESS [auto-lock s]
+ *   CMD_VERIFY_AND_SET_TIMEOUT [password | seconds]  -> CMD_SUCCESS / CMD_FAIL
+ *   CMD_VERIFY_AND_CHANGE      [old | new password]  -> CMD_ACK / CMD_FAIL
+ * A wrong password is answered with CMD_PASSWORD_WRONG and nothing is done.
+ * Without COMM_FEATURE_COMPOUND the HMI sends CMD_SEND_PASSWORD and then
+ * CMD_DOOR_UNLOCK, CMD_SET_TIMEOUT [seconds] or CMD_CHANGE_PASSWORD [new],
+ * which Control accepts only right after the password was found correct.
+ */
+#define COMM_VERIFY_AND_UNLOCK_LEN      COMM_PASSWORD_LENGTH
+#define COMM_VERIFY_AND_SET_TIMEOUT_LEN (COMM_PASSWORD_LENGTH + 1)
+#define COMM_VERIFY_AND_CHANGE_LEN      (2 * COMM_PASSWORD_LENGTH)
+
+/*
+ * CMD_STATS (no payload) is answered with CMD_STATS carrying the link counters
+ * of the ECU that replies (see COMM_Stats), big-endian:
+ *   bytesIn, bytesOut, framesIn, framesOut     4 bytes each
+ *   crcErrors, framingErrors, overrunErrors,
+ *   retries, timeouts, maxRttMs                2 bytes each, saturated
+ */
+#define COMM_STATS_LEN                  28
+
+/* CMD_CREDIT [limit, 2 bytes big-endian], see the flow control notes in comm_interface.h */
+#define COMM_CREDIT_LEN                 2
+
+/*
+ * CMD_PROFILE [cmd] is answered with CMD_PROFILE carrying how the replying
+ * ECU's dispatcher handled cmd (see COMM_Profile and comm_dispatch.h):
+ *   cmd                                        1 byte
+ *   count, rejected,
+ *   minCycles, avgCycles, maxCycles            4 bytes each, big-endian
+ */
+#define COMM_PROFILE_QUERY_LEN          1
+#define COMM_PROFILE_LEN                21
+
+/*
+ * Lockout: after too many wrong passwords Control sounds the alarm and, for
+ * a while, answers every password with CMD_ALARM [seconds left] at once.
+ * The HMI may send CMD_ALARM (no payload) to raise the alarm itself.
+ * Without COMM_FEATURE_LOCKOUT the answer is CMD_PASSWORD_WRONG.
+ */
+#define COMM_ALARM_LEN                  1
+
+/*
+ * CMD_BOOT [marks] is answered with CMD_BOOT [marks]: the boot-phase
+ * timestamps of the sender, then of the replier (boot_profile.h). Per mark:
+ *   step                                       1 byte (BOOT_Step)
+ *   time since boot                            2 bytes big-endian, 0.1 ms, saturated
+ */
+#define COMM_BOOT_MARK_LEN              3
+#define COMM_BOOT_MAX_MARKS             10
+#define COMM_BOOT_LEN                   (COMM_BOOT_MARK_LEN * COMM_BOOT_MAX_MARKS)
+
+/*******************************************************************************
+ *                         Protocol Version and Features                       *
+ *******************************************************************************/
+
+#define COMM_PROTOCOL_VERSION   2
+
+/*
+ * Optional parts of the protocol. Each side announces its set in CMD_READY,
+ * the link uses the ones both have (COMM_Features()) and a command that
+ * needs a missing feature is never sent and answered with CMD_UNKNOWN.
+ */
+#define COMM_FEATURE_COMPOUND   0x01    /* CMD_VERIFY_AND_* in one round trip */
+#define COMM_FEATURE_STATS      0x02    /* CMD_STATS */
+#define COMM_FEATURE_CREDIT     0x04    /* CMD_CREDIT flow control */
+#define COMM_FEATURE_HEARTBEAT  0x08    /* CMD_HEARTBEAT and the link timeout */
+#define COMM_FEATURE_PROFILE    0x10    /* CMD_PROFILE */
+#define COMM_FEATURE_LOCKOUT    0x20    /* CMD_ALARM [seconds left] answers a password */
+#define COMM_FEATURE_BOOT       0x40    /* CMD_BOOT */
+
+/* Features this build announces, e.g. -DCOMM_FEATURES=0 for a base-protocol ECU */
+#ifndef COMM_FEATURES
+#define COMM_FEATURES           (COMM_FEATURE_COMPOUND | COMM_FEATURE_STATS | \
+                                 COMM_FEATURE_CREDIT | COMM_FEATURE_HEARTBEAT | \
+                                 COMM_FEATURE_PROFILE | COMM_FEATURE_LOCKOUT | \
+                                 COMM_FEATURE_BOOT)
+#endif
+
+/*******************************************************************************
+ *                         Command Table                                       *
+ *******************************************************************************/
+
+/* Who may send a command */
+typedef enum {
+    COMM_FROM_HMI       = 0x01,
+    COMM_FROM_CONTROL   = 0x02,
+    COMM_FROM_BOTH      = 0x03
+} COMM_Sender;
+
+/*
+ * Every command of the protocol, in one place:
+ *   X(name, id, sender, feature, minLen, maxLen, digits)
+ * - feature: COMM_FEATURE_* bit both ends must have, 0 for the base protocol
+ * - minLen..maxLen: payload sizes accepted
+ * - digits: leading payload bytes that must be ASCII '0'..'9' (passwords)
+ * COMM_CommandID, the descriptor table behind COMM_GetCommandInfo and the
+ * checks in COMM_CheckPayload are generated from it, and comm_protocol.c
+ * fails to compile if a maxLen does not fit COMM_MAX_PAYLOAD. IDs are fixed
+ * on the wire: new commands get new IDs, old ones are never renumbered.
+ */
+#define COMM_COMMAND_TABLE(X) \
+    X(CMD_READY,                  0x10, COMM_FROM_BOTH,    0,                      0, COMM_READY_LEN, 0) \
+    X(CMD_SEND_PASSWORD,          0x11, COMM_FROM_HMI,     0,                      COMM_PASSWORD_LENGTH, COMM_PASSWORD_LENGTH, COMM_PASSWORD_LENGTH) \
+    X(CMD_PASSWORD_CORRECT,       0x12, COMM_FROM_CONTROL, 0,                      0, 0, 0) \
+    X(CMD_PASSWORD_WRONG,         0x13, COMM_FROM_CONTROL, 0,                      0, 0, 0) \
+    X(CMD_CHANGE_PASSWORD,        0x14, COMM_FROM_HMI,     0,                      COMM_PASSWORD_LENGTH, COMM_PASSWORD_LENGTH, COMM_PASSWORD_LENGTH) \
+    X(CMD_DOOR_UNLOCK,            0x15, COMM_FROM_HMI,     0,                      0, 0, 0) \
+    X(CMD_DOOR_LOCK,              0x16, COMM_FROM_HMI,     0,                      0, 0, 0) \
+    X(CMD_SET_TIMEOUT,            0x17, COMM_FROM_HMI,     0,                      1, 1, 0) \
+    X(CMD_SUCCESS,                0x18, COMM_FROM_CONTROL, 0,                      0, 1, 0) \
+    X(CMD_FAIL,                   0x19, COMM_FROM_CONTROL, 0,                      0, 0, 0) \
+    X(CMD_ALARM,                  0x1A, COMM_FROM_BOTH,    0,                      0, COMM_ALARM_LEN, 0) \
+    X(CMD_ACK,                    0x1B, COMM_FROM_BOTH,    0,                      0, COMM_BAUD_LEN, 0) \
+    X(CMD_UNKNOWN,                0x1C, COMM_FROM_CONTROL, 0,                      0, 0, 0) \
+    X(CMD_INIT,                   0x1D, COMM_FROM_CONTROL, 0,                      0, COMM_BAUD_LEN, 0) \
+    X(CMD_VERIFY_AND_UNLOCK,      0x1E, COMM_FROM_HMI,     COMM_FEATURE_COMPOUND,  COMM_VERIFY_AND_UNLOCK_LEN, COMM_VERIFY_AND_UNLOCK_LEN, COMM_PASSWORD_LENGTH) \
+    X(CMD_VERIFY_AND_SET_TIMEOUT, 0x1F, COMM_FROM_HMI,     COMM_FEATURE_COMPOUND,  COMM_VERIFY_AND_SET_TIMEOUT_LEN, COMM_VERIFY_AND_SET_TIMEOUT_LEN, COMM_PASSWORD_LENGTH) \
+    X(CMD_VERIFY_AND_CHANGE,      0x20, COMM_FROM_HMI,     COMM_FEATURE_COMPOUND,  COMM_VERIFY_AND_CHANGE_LEN, COMM_VERIFY_AND_CHANGE_LEN, COMM_VERIFY_AND_CHANGE_LEN) \
+    X(CMD_STATS,                  0x21, COMM_FROM_BOTH,    COMM_FEATURE_STATS,     0, COMM_STATS_LEN, 0) \
+    X(CMD_CREDIT,                 0x22, COMM_FROM_BOTH,    COMM_FEATURE_CREDIT,    COMM_CREDIT_LEN, COMM_CREDIT_LEN, 0) \
+    X(CMD_HEARTBEAT,              0x23, COMM_FROM_BOTH,    COMM_FEATURE_HEARTBEAT, 0, 0, 0) \
+    X(CMD_PROFILE,                0x24, COMM_FROM_BOTH,    COMM_FEATURE_PROFILE,   COMM_PROFILE_QUERY_LEN, COMM_PROFILE_LEN, 0) \
+    X(CMD_BOOT,                   0x25, COMM_FROM_BOTH,    COMM_FEATURE_BOOT,      0, COMM_BOOT_LEN, 0)
+
+/* enumaration of command codes */
+#define COMM_COMMAND_ENUM(name, id, sender, feature, minLen, maxLen, digits) name = id,
+typedef enum {
+    COMM_COMMAND_TABLE(COMM_COMMAND_ENUM)
+} COMM_CommandID;
+#undef COMM_COMMAND_ENUM
+
+/* Lowest ID, and the number of IDs from it to the highest, gaps included */
+#define COMM_COMMAND_FIRST      CMD_READY
+#define COMM_COMMAND_SLOTS      (COMM_COMMAND_LIMIT - COMM_COMMAND_FIRST)
+
+/* Slot of cmd in an ID-indexed table, cmd must be a COMM_CommandID */
+#define COMM_COMMAND_INDEX(cmd) ((cmd) - COMM_COMMAND_FIRST)
+
+/* One past the highest ID: a union with an (id + 1)-byte member per command */
+#define COMM_COMMAND_SPAN(name, id, sender, feature, minLen, maxLen, digits) uint8_t name[(id) + 1];
+typedef union {
+    COMM_COMMAND_TABLE(COMM_COMMAND_SPAN)
+} COMM_CommandSpan;
+#undef COMM_COMMAND_SPAN
+#define COMM_COMMAND_LIMIT      sizeof(COMM_CommandSpan)
+
+/* One row of COMM_COMMAND_TABLE */
+typedef struct {
+    const char *name;
+    uint8_t sender;         /* COMM_Sender bits */
+    uint8_t feature;
+    uint8_t minLen;
+    uint8_t maxLen;
+    uint8_t digits;
+} COMM_CommandInfo;
+
+typedef enum {
+    COMM_CHECK_OK,
+    COMM_CHECK_UNKNOWN,     /* no such command, or not one this sender may send */
+    COMM_CHECK_UNSUPPORTED, /* needs a feature the link did not negotiate */
+    COMM_CHECK_MALFORMED    /* payload length or digits wrong */
+} COMM_CheckResult;
+
+/*******************************************************************************
+ *                         Function Prototypes                                 *
+ *******************************************************************************/
+
+/* Descriptor of cmd, NULL if the protocol has no such command. O(1) */
+const COMM_CommandInfo *COMM_GetCommandInfo(uint8_t cmd);
+
+/* "CMD_..." for logs and benchmarks, "?" for an unknown code */
+const char *COMM_CommandName(uint8_t cmd);
+
+/* Check a received frame against the table and the negotiated features */
+COMM_CheckResult COMM_CheckPayload(uint8_t cmd, const uint8_t *payload, uint8_t len,
+                                   COMM_Sender from);
+
+/* True if both ends announced what cmd needs (base commands always) */
+bool COMM_PeerSupports(uint8_t cmd);
+
+/* Features of the current link: ours and the peer's, COMM_FEATURES before a handshake */
+uint8_t COMM_Features(void);
+
+#endif /* COMM_PROTOCOL_H_ */
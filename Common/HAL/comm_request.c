@@ -0,0 +1,348 @@
+#include "comm_request.h"
+#include "../MCAL/cpu.h"
+#include "../MCAL/tick.h"
+#include "../MCAL/power.h"
+#include "../Utils/swtimer.h"
+#include <string.h>
+
+/*******************************************************************************
+ *                         Private Types and Variables                         *
+ *******************************************************************************/
+
+typedef struct {
+    COMM_RequestState state;
+    uint8_t seq;
+    uint32_t sentAt;            /* GetTicks() when sent, for the RTT counter */
+    SWTIMER_Timer deadline;
+    COMM_Frame reply;
+    /* Reliable requests keep a copy for retransmission */
+    bool reliable;
+    uint8_t retries;            /* sent again so far, no RTT sample once > 0 */
+    bool answered;              /* reply stored, kept after release for duplicates */
+    uint32_t rto;               /* current timeout of this request, doubles per retry */
+    SWTIMER_Timer retransmit;
+    bool retransmitDue;         /* retransmit timer went off, sent from COMM_RequestPoll */
+    uint8_t cmd;
+    uint8_t len;
+    uint8_t payload[COMM_MAX_PAYLOAD];
+} COMM_PendingRequest;
+
+static COMM_PendingRequest pending[COMM_MAX_PENDING];
+static COMM_FrameHandler unsolicitedHandler;
+
+/* Round trip estimate, srtt scaled by 8 and rttvar by 4 as in Jacobson's code */
+static bool rttValid;
+static uint32_t srtt8;
+static uint32_t rttvar4;
+static uint32_t rto;
+
+/*******************************************************************************
+ *                         Private Functions                                   *
+ *******************************************************************************/
+
+static uint32_t COMM_RtoClamp(uint32_t value)
+{
+    if (value < COMM_RTO_MIN_MS)
+    {
+        return COMM_RTO_MIN_MS;
+    }
+    return (value > COMM_RTO_MAX_MS) ? COMM_RTO_MAX_MS : value;
+}
+
+/* One round trip of a request answered on its first transmission */
+static void COMM_RttSample(uint32_t rttMs)
+{
+    if (!rttValid)
+    {
+        /* RFC 6298: SRTT = R, RTTVAR = R / 2 */
+        srtt8 = rttMs << 3;
+        rttvar4 = rttMs << 1;
+        rttValid = true;
+    }
+    else
+    {
+        int32_t delta = (int32_t)rttMs - (int32_t)(srtt8 >> 3);
+        srtt8 = (uint32_t)((int32_t)srtt8 + delta);
+        if (delta < 0)
+        {
+            delta = -delta;
+        }
+        rttvar4 = (uint32_t)((int32_t)rttvar4 + delta - (int32_t)(rttvar4 >> 2));
+    }
+    /* RTO = SRTT + 4 * RTTVAR, with at least one tick of variance */
+    rto = COMM_RtoClamp((srtt8 >> 3) + ((rttvar4 > 0) ? rttvar4 : 1));
+}
+
+/* Timers of one request, run from SWTIMER_Service in COMM_RequestPoll */
+static void COMM_DeadlinePassed(void *arg)
+{
+    COMM_PendingRequest *request = arg;
+    if (request->state == COMM_REQ_PENDING)
+    {
+        request->state = COMM_REQ_TIMEOUT;
+        SWTIMER_Stop(&request->retransmit);
+        COMM_CountTimeout();
+    }
+}
+
+static void COMM_RetransmitDue(void *arg)
+{
+    COMM_PendingRequest *request = arg;
+    request->retransmitDue = true;
+}
+
+/* No timer of a request that is no longer pending may go off */
+static void COMM_RequestStopTimers(COMM_PendingRequest *request)
+{
+    SWTIMER_Stop(&request->deadline);
+    SWTIMER_Stop(&request->retransmit);
+    request->retransmitDue = false;
+}
+
+static bool COMM_RequestValid(COMM_RequestHandle handle)
+{
+    return handle >= 0 && handle < COMM_MAX_PENDING && pending[handle].state != COMM_REQ_FREE;
+}
+
+static COMM_RequestHandle COMM_RequestStart(uint8_t cmd, const uint8_t *payload, uint8_t len,
+                                            uint32_t timeoutMs, bool reliable)
+{
+    for (COMM_RequestHandle i = 0; i < COMM_MAX_PENDING; i++)
+    {
+        COMM_PendingRequest *request = &pending[i];
+        if (request->state == COMM_REQ_FREE)
+        {
+            request->state = COMM_REQ_PENDING;
+            request->reliable = reliable;
+            request->retries = 0;
+            request->answered = false;
+            request->sentAt = GetTicks();
+            request->retransmitDue = false;
+            SWTIMER_Setup(&request->deadline, COMM_DeadlinePassed, request);
+            SWTIMER_Setup(&request->retransmit, COMM_RetransmitDue, request);
+            SWTIMER_Start(&request->deadline, timeoutMs, 0);
+            if (reliable)
+            {
+                request->cmd = cmd;
+                request->len = (len > COMM_MAX_PAYLOAD) ? COMM_MAX_PAYLOAD : len;
+                if (request->len > 0)
+                {
+                    memcpy(request->payload, payload, request->len);
+                }
+                request->rto = rto;
+                SWTIMER_Start(&request->retransmit, rto, 0);
+            }
+            request->seq = COMM_SendFrame(cmd, payload, len);
+            return i;
+        }
+    }
+    return COMM_REQUEST_NONE;
+}
+
+/* Send a reliable request again once its timeout passed without a reply */
+static void COMM_RequestRetransmit(COMM_PendingRequest *request)
+{
+    if (request->retries >= COMM_MAX_RETRIES)
+    {
+        request->retransmitDue = false;     /* only the deadline is left */
+        return;
+    }
+    /* Out of credit: the peer has not even read the first copy, it is not lost; try again next poll */
+    if (COMM_FlowCredit() < COMM_WIRE_SIZE(request->len))
+    {
+        return;
+    }
+
+    /*
+     * Back the estimate off until a clean sample comes in (RFC 6298 5.5), once
+     * per request rather than per retransmission: on a lossy link the next
+     * request then does not start from this one's longest timeout, while a
+     * peer that really got slower still pushes the RTO up until it is sampled.
+     */
+    if (request->retries == 0)
+    {
+        rto = COMM_RtoClamp(rto * 2);
+    }
+
+    COMM_ResendFrame(request->seq, request->cmd, request->payload, request->len);
+    COMM_CountRetry();
+    request->retries++;
+    request->rto = COMM_RtoClamp(request->rto * 2);
+    request->retransmitDue = false;
+    SWTIMER_Start(&request->retransmit, request->rto, 0);
+}
+
+/* Hand one received frame to the request it answers */
+static void COMM_RequestDispatch(const COMM_Frame *frame)
+{
+    for (uint8_t i = 0; i < COMM_MAX_PENDING; i++)
+    {
+        if (pending[i].state == COMM_REQ_PENDING && pending[i].seq == frame->seq)
+        {
+            uint32_t rtt = GetTicks() - pending[i].sentAt;
+            pending[i].reply = *frame;
+            pending[i].state = COMM_REQ_DONE;
+            pending[i].answered = true;
+            COMM_RequestStopTimers(&pending[i]);
+            COMM_CountRtt(rtt);
+            /* Karn: a retransmitted request's reply may answer either copy */
+            if (pending[i].retries == 0)
+            {
+                COMM_RttSample(rtt);
+            }
+            return;
+        }
+    }
+    for (uint8_t i = 0; i < COMM_MAX_PENDING; i++)
+    {
+        /* Both copies of a retransmitted request got answered, drop the second */
+        if (pending[i].answered && pending[i].retries > 0 &&
+            pending[i].seq == frame->seq && pending[i].reply.cmd == frame->cmd)
+        {
+            return;
+        }
+    }
+    if (unsolicitedHandler)
+    {
+        unsolicitedHandler(frame);
+    }
+}
+
+/*******************************************************************************
+ *                         Functions Definitions                               *
+ *******************************************************************************/
+
+void COMM_RequestInit(void)
+{
+    for (uint8_t i = 0; i < COMM_MAX_PENDING; i++)
+    {
+        COMM_RequestStopTimers(&pending[i]);
+        pending[i].state = COMM_REQ_FREE;
+    }
+    unsolicitedHandler = NULL;
+    COMM_RequestReset();
+}
+
+void COMM_RequestReset(void)
+{
+    for (uint8_t i = 0; i < COMM_MAX_PENDING; i++)
+    {
+        if (pending[i].state == COMM_REQ_PENDING)
+        {
+            pending[i].state = COMM_REQ_TIMEOUT;
+        }
+        COMM_RequestStopTimers(&pending[i]);
+        pending[i].answered = false;
+    }
+    rttValid = false;
+    rto = COMM_RTO_INITIAL_MS;
+}
+
+void COMM_RequestSetUnsolicitedHandler(COMM_FrameHandler handler)
+{
+    unsolicitedHandler = handler;
+}
+
+COMM_RequestHandle COMM_RequestSend(uint8_t cmd, const uint8_t *payload, uint8_t len,
+                                    uint32_t timeoutMs)
+{
+    return COMM_RequestStart(cmd, payload, len, timeoutMs, false);
+}
+
+COMM_RequestHandle COMM_RequestSendReliable(uint8_t cmd, const uint8_t *payload, uint8_t len,
+                                            uint32_t timeoutMs)
+{
+    return COMM_RequestStart(cmd, payload, len, timeoutMs, true);
+}
+
+void COMM_RequestPoll(void)
+{
+    COMM_Frame frame;
+    while (COMM_PollFrame(&frame))
+    {
+        COMM_RequestDispatch(&frame);
+    }
+
+    /* Deadlines and retransmit timeouts: replies matched above win over them */
+    SWTIMER_Service();
+    for (uint8_t i = 0; i < COMM_MAX_PENDING; i++)
+    {
+        if (pending[i].state == COMM_REQ_PENDING && pending[i].retransmitDue)
+        {
+            COMM_RequestRetransmit(&pending[i]);
+        }
+    }
+}
+
+COMM_RequestState COMM_RequestGetState(COMM_RequestHandle handle)
+{
+    return COMM_RequestValid(handle) ? pending[handle].state : COMM_REQ_FREE;
+}
+
+COMM_RequestState COMM_RequestWait(COMM_RequestHandle handle, COMM_Frame *reply)
+{
+    if (!COMM_RequestValid(handle))
+    {
+        return COMM_REQ_FREE;
+    }
+
+    for (;;)
+    {
+        COMM_RequestPoll();
+        if (pending[handle].state != COMM_REQ_PENDING)
+        {
+            break;
+        }
+#if UART_USE_INTERRUPTS
+        /* Asleep until UART2 RX or the next deadline or retransmit (its
+         * timers always run while the request is pending) */
+        uint32_t wake;
+        CPU_DisableInterrupts();
+        if (SWTIMER_NextDue(&wake))
+        {
+            POWER_SleepUntil(wake);
+        }
+        else
+        {
+            POWER_Sleep();
+        }
+#else
+        CPU_Idle();             /* the polled driver loses bytes while asleep */
+#endif
+    }
+
+    if (pending[handle].state == COMM_REQ_DONE && reply)
+    {
+        *reply = pending[handle].reply;
+    }
+    return pending[handle].state;
+}
+
+void COMM_RequestRelease(COMM_RequestHandle handle)
+{
+    if (COMM_RequestValid(handle))
+    {
+        COMM_RequestStopTimers(&pending[handle]);
+        pending[handle].state = COMM_REQ_FREE;
+    }
+}
+
+uint8_t COMM_RequestInUse(void)
+{
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < COMM_MAX_PENDING; i++)
+    {
+        count += (pending[i].state != COMM_REQ_FREE);
+    }
+    return count;
+}
+
+uint32_t COMM_RequestRto(void)
+{
+    return rto;
+}
+
+uint32_t COMM_RequestSrtt(void)
+{
+    return rttValid ? (srtt8 >> 3) : 0;
+}
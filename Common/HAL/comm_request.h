@@ -0,0 +1,114 @@
+#ifndef COMM_REQUEST_H_
+#define COMM_REQUEST_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "comm_interface.h"
+
+/*******************************************************************************
+ *                         Request / Response Layer                            *
+ *******************************************************************************/
+
+/*
+ * Pipelined requests on top of the framed link. Each request is sent with the
+ * next SEQ and parked in a small pending table with its own deadline (a
+ * software timer, swtimer.h, turned by COMM_RequestPoll); the
+ * peer answers with COMM_SendReply(request SEQ, ...), so replies are matched by
+ * SEQ and may arrive in any order. Several requests can be in flight at once
+ * instead of the old send / wait / ACK / delay / send sequence.
+ *
+ * Frames whose SEQ matches no pending request are handed to the unsolicited
+ * handler (if one is set) and dropped otherwise.
+ *
+ * Reliable requests (COMM_RequestSendReliable) are sent again with the same
+ * SEQ whenever the retransmission timeout passes without a reply, until their
+ * own deadline. The timeout follows the measured round trip (Jacobson/Karels:
+ * RTO = SRTT + 4 * RTTVAR, only from requests answered on the first try) and
+ * doubles with every retransmission until the next clean sample. The peer
+ * answers a repeated SEQ from its reply cache (COMM_ReplayReply) instead of
+ * running the request twice, and a second reply to a retransmitted request is
+ * dropped here.
+ */
+
+/* Requests in flight at the same time */
+#ifndef COMM_MAX_PENDING
+#define COMM_MAX_PENDING        4
+#endif
+
+/* Retransmission timeout: before the first sample, and its bounds */
+#ifndef COMM_RTO_INITIAL_MS
+#define COMM_RTO_INITIAL_MS     250
+#endif
+#define COMM_RTO_MIN_MS         20
+#define COMM_RTO_MAX_MS         1000
+
+/* Retransmissions of one reliable request, at most */
+#define COMM_MAX_RETRIES        4
+
+/* Returned by COMM_RequestSend when the pending table is full */
+#define COMM_REQUEST_NONE       (-1)
+
+typedef int8_t COMM_RequestHandle;
+
+typedef enum {
+    COMM_REQ_FREE,
+    COMM_REQ_PENDING,       /* sent, no reply yet */
+    COMM_REQ_DONE,          /* reply stored, read it with COMM_RequestWait */
+    COMM_REQ_TIMEOUT        /* deadline passed without a reply */
+} COMM_RequestState;
+
+typedef void (*COMM_FrameHandler)(const COMM_Frame *frame);
+
+/* Empty the pending table (call after COMM_Init) */
+void COMM_RequestInit(void);
+
+/*
+ * After a new handshake: requests still pending went to the old session and
+ * time out at once (their slots stay taken until released), and the round
+ * trip estimate starts over, the link rate may have changed.
+ */
+void COMM_RequestReset(void);
+
+/* Frames that answer no pending request go here */
+void COMM_RequestSetUnsolicitedHandler(COMM_FrameHandler handler);
+
+/*
+ * Send cmd with its payload and register it as pending for timeoutMs.
+ * Returns a handle, or COMM_REQUEST_NONE if COMM_MAX_PENDING are in flight.
+ */
+COMM_RequestHandle COMM_RequestSend(uint8_t cmd, const uint8_t *payload, uint8_t len,
+                                    uint32_t timeoutMs);
+
+/*
+ * COMM_RequestSend that retransmits until answered or timeoutMs has passed
+ * (see above). The peer must answer repeated requests with COMM_ReplayReply.
+ */
+COMM_RequestHandle COMM_RequestSendReliable(uint8_t cmd, const uint8_t *payload, uint8_t len,
+                                            uint32_t timeoutMs);
+
+/* Non-blocking: match received replies, retransmit and expire deadlines */
+void COMM_RequestPoll(void);
+
+COMM_RequestState COMM_RequestGetState(COMM_RequestHandle handle);
+
+/*
+ * Block until the request is answered or its deadline passes. On COMM_REQ_DONE
+ * the reply is copied to *reply (may be NULL). Other requests keep progressing
+ * while waiting; with the interrupt-driven UART driver the core sleeps in
+ * between (POWER_SleepUntil on the next timer), woken by UART2 RX.
+ */
+COMM_RequestState COMM_RequestWait(COMM_RequestHandle handle, COMM_Frame *reply);
+
+/* Give the slot back; a late reply for it is then treated as unsolicited */
+void COMM_RequestRelease(COMM_RequestHandle handle);
+
+/* Requests currently in the table (pending, answered or timed out) */
+uint8_t COMM_RequestInUse(void);
+
+/* Retransmission timeout the next reliable request starts with */
+uint32_t COMM_RequestRto(void);
+
+/* Smoothed round trip, 0 before the first sample */
+uint32_t COMM_RequestSrtt(void);
+
+#endif /* COMM_REQUEST_H_ */
@@ -0,0 +1,41 @@
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+ *                         Monotonic Clock                                     *
+ *******************************************************************************/
+
+/*
+ * Microseconds since CLOCK_Init, 64 bits wide, so they never wrap. On the board
+ * WTIMER0 runs as one 64-bit timer counting system clock cycles upward
+ * (clock_tm4c.c). Nothing has to interrupt to keep it counting, so no sleep is
+ * broken just to count time. The host simulation reads the host clock
+ * (Sim/MCAL/clock_sim.c).
+ *
+ * Reads are a few register accesses with no lock, safe from ISRs.
+ * GetTicks() (tick.h) is the low 32 bits of CLOCK_NowMs() on the board.
+ *
+ * The same timer's match interrupt is the wake-up alarm for tickless sleep
+ * (POWER_SleepUntil).
+ */
+
+/* The 16 MHz PIOSC both ECUs run from, in deep-sleep too (power.h) */
+#define CLOCK_HZ                16000000u
+
+/* Start the counter and enable the alarm interrupt. First thing after reset */
+void CLOCK_Init(void);
+
+uint64_t CLOCK_NowUs(void);
+uint64_t CLOCK_NowMs(void);
+
+/*
+ * Raise the alarm interrupt once CLOCK_NowUs() reaches atUs (at once if it
+ * already has), replacing the previous alarm. It only ends a WFI, the ISR
+ * does nothing else.
+ */
+void CLOCK_SetAlarm(uint64_t atUs);
+void CLOCK_CancelAlarm(void);
+
+#endif /* CLOCK_H_ */
@@ -0,0 +1,81 @@
+#include "clock.h"
+#include "tick.h"
+#include "tm4c123gh6pm.h"
+
+#define WTIMER0A_NVIC_BIT       (1U << (94 - 64))   /* WTIMER0A is interrupt 94 */
+#define CLOCK_CYCLES_PER_US     (CLOCK_HZ / 1000000u)
+
+/* Cycles since CLOCK_Init; the high half is read again in case the low half wrapped */
+static uint64_t CLOCK_Cycles(void)
+{
+    uint32_t high;
+    uint32_t low;
+    do
+    {
+        high = WTIMER0_TBV_R;
+        low = WTIMER0_TAV_R;
+    } while (high != WTIMER0_TBV_R);
+    return ((uint64_t)high << 32) | low;
+}
+
+void CLOCK_Init(void)
+{
+    SYSCTL_RCGCWTIMER_R |= SYSCTL_RCGCWTIMER_R0;
+    while ((SYSCTL_PRWTIMER_R & SYSCTL_PRWTIMER_R0) == 0) {}
+
+    WTIMER0_CTL_R = 0;
+    WTIMER0_CFG_R = 0;                      /* 64-bit: TAV low half, TBV high half */
+    WTIMER0_TAMR_R = TIMER_TAMR_TAMR_PERIOD | TIMER_TAMR_TACDIR | TIMER_TAMR_TAMIE;
+    WTIMER0_TAILR_R = 0xFFFFFFFF;           /* count the full 64 bits */
+    WTIMER0_TBILR_R = 0xFFFFFFFF;
+    WTIMER0_IMR_R = 0;                      /* no alarm yet */
+    WTIMER0_ICR_R = TIMER_ICR_TAMCINT;
+    NVIC_EN2_R = WTIMER0A_NVIC_BIT;
+    WTIMER0_CTL_R = TIMER_CTL_TAEN | TIMER_CTL_TASTALL;     /* stops with the debugger */
+}
+
+uint64_t CLOCK_NowUs(void)
+{
+    return CLOCK_Cycles() / CLOCK_CYCLES_PER_US;    /* a shift at 16 MHz */
+}
+
+uint64_t CLOCK_NowMs(void)
+{
+    return CLOCK_NowUs() / 1000u;
+}
+
+void CLOCK_SetAlarm(uint64_t atUs)
+{
+    uint64_t at = atUs * CLOCK_CYCLES_PER_US;
+
+    WTIMER0_IMR_R &= ~TIMER_IMR_TAMIM;
+    WTIMER0_TAMATCHR_R = (uint32_t)at;
+    WTIMER0_TBMATCHR_R = (uint32_t)(at >> 32);
+    WTIMER0_ICR_R = TIMER_ICR_TAMCINT;
+    WTIMER0_IMR_R |= TIMER_IMR_TAMIM;
+
+    /* The match only fires on equality: a time already passed is pended by hand */
+    if (CLOCK_Cycles() >= at)
+    {
+        NVIC_PEND2_R = WTIMER0A_NVIC_BIT;
+    }
+}
+
+void CLOCK_CancelAlarm(void)
+{
+    WTIMER0_IMR_R &= ~TIMER_IMR_TAMIM;
+    WTIMER0_ICR_R = TIMER_ICR_TAMCINT;
+}
+
+/* The alarm has woken the core, that was all */
+void WTIMER0A_Handler(void)
+{
+    WTIMER0_IMR_R &= ~TIMER_IMR_TAMIM;
+    WTIMER0_ICR_R = TIMER_ICR_TAMCINT;
+}
+
+/* tick.h on the board: milliseconds of the same clock, no SysTick */
+uint32_t GetTicks(void)
+{
+    return (uint32_t)CLOCK_NowMs();
+}
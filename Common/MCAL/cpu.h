@@ -0,0 +1,61 @@
+#ifndef CPU_H_
+#define CPU_H_
+
+/*******************************************************************************
+ *                         Core Intrinsics                                     *
+ *******************************************************************************/
+
+/*
+ * Thin wrappers around the Cortex-M4 instructions the drivers need, so the
+ * same driver code builds for the board (IAR) and for the Linux host
+ * simulation (HOST_SIM), where "interrupts" are delivered by the simulated
+ * peripherals whenever the CPU idles.
+ */
+#include <stdint.h>
+
+/*
+ * CPU_Cycles() counts core clock cycles, wrapping at 32 bits (268 s at
+ * 16 MHz), so the difference of two readings is an exact duration. On the
+ * board it is the DWT cycle counter, started by CPU_CycleCounterInit(); on
+ * the host it is simulated time at 16 MHz.
+ *
+ * CPU_CompilerBarrier() stops the compiler from moving memory accesses across
+ * it, e.g. a plain store past the volatile index that hands it to an ISR.
+ */
+#ifdef HOST_SIM
+
+void SIM_Idle(void);
+void SIM_SetInterruptsEnabled(int enabled);
+uint32_t SIM_Cycles(void);
+
+#define CPU_EnableInterrupts()      SIM_SetInterruptsEnabled(1)
+#define CPU_DisableInterrupts()     SIM_SetInterruptsEnabled(0)
+#define CPU_Idle()                  SIM_Idle()
+#define CPU_CycleCounterInit()      do { } while (0)
+#define CPU_Cycles()                SIM_Cycles()
+#define CPU_CompilerBarrier()       __asm__ volatile ("" ::: "memory")
+
+#else
+
+#define CPU_EnableInterrupts()      __asm("CPSIE I")
+#define CPU_DisableInterrupts()     __asm("CPSID I")
+/* Called from every busy-wait; a plain spin until an ISR makes progress */
+#define CPU_Idle()                  do { } while (0)
+/* Single in-order core: keeping the compiler from reordering is enough */
+#define CPU_CompilerBarrier()       __asm volatile ("" ::: "memory")
+
+/* Debug trace enable (DEMCR.TRCENA) and the DWT cycle counter */
+#define CPU_DEMCR_R                 (*((volatile uint32_t *)0xE000EDFC))
+#define CPU_DWT_CTRL_R              (*((volatile uint32_t *)0xE0001000))
+#define CPU_DWT_CYCCNT_R            (*((volatile uint32_t *)0xE0001004))
+#define CPU_DEMCR_TRCENA            0x01000000
+#define CPU_DWT_CTRL_CYCCNTENA      0x00000001
+
+#define CPU_CycleCounterInit()      do { CPU_DEMCR_R |= CPU_DEMCR_TRCENA; \
+                                         CPU_DWT_CYCCNT_R = 0;            \
+                                         CPU_DWT_CTRL_R |= CPU_DWT_CTRL_CYCCNTENA; } while (0)
+#define CPU_Cycles()                (CPU_DWT_CYCCNT_R)
+
+#endif /* HOST_SIM */
+
+#endif /* CPU_H_ */
@@ -0,0 +1,63 @@
+#include "power.h"
+#include "power_hw.h"
+#include "clock.h"
+#include "tick.h"
+#include "cpu.h"
+
+/*******************************************************************************
+ *                         Private Variables                                   *
+ *******************************************************************************/
+
+static uint32_t sleeps;
+static uint64_t asleepUs;
+static uint64_t awakeUs;
+static uint64_t wokeAtUs;       /* end of the last sleep, or POWER_Init */
+
+/*******************************************************************************
+ *                         Functions Definitions                               *
+ *******************************************************************************/
+
+void POWER_Init(void)
+{
+    POWER_HW_Init(POWER_DEEP_SLEEP != 0);
+    sleeps = 0;
+    asleepUs = 0;
+    awakeUs = 0;
+    wokeAtUs = CLOCK_NowUs();
+}
+
+void POWER_Sleep(void)
+{
+    uint64_t start = CLOCK_NowUs();
+    awakeUs += start - wokeAtUs;
+
+    POWER_HW_WaitForInterrupt();
+
+    // The waking ISR has run by now, its time counts as asleep
+    wokeAtUs = CLOCK_NowUs();
+    asleepUs += wokeAtUs - start;
+    sleeps++;
+}
+
+void POWER_SleepUntil(uint32_t wakeTick)
+{
+    uint64_t nowUs = CLOCK_NowUs();
+    int32_t leftMs = (int32_t)(wakeTick - GetTicks());
+    if (leftMs <= 0)
+    {
+        CPU_EnableInterrupts();
+        return;
+    }
+
+    /* At the start of tick wakeTick, the first moment GetTicks() returns it */
+    CLOCK_SetAlarm(nowUs - nowUs % 1000u + (uint64_t)leftMs * 1000u);
+    POWER_Sleep();
+    CLOCK_CancelAlarm();
+}
+
+void POWER_GetStats(POWER_Stats *stats)
+{
+    stats->sleeps = sleeps;
+    stats->asleepMs = (uint32_t)(asleepUs / 1000);
+    stats->awakeMs = (uint32_t)((awakeUs + (CLOCK_NowUs() - wokeAtUs)) / 1000);
+}
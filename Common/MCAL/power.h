@@ -0,0 +1,52 @@
+#ifndef POWER_H_
+#define POWER_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+ *                         Idle Sleep                                          *
+ *******************************************************************************/
+
+/*
+ * Stops the core while an ECU has nothing to do (WFI). Any enabled interrupt
+ * wakes it: UART2 RX, a keypad row edge, or the clock's alarm (clock.h) when
+ * the sleeper has a deadline. There is no periodic tick, an ECU with nothing
+ * timed sleeps until the next event.
+ *
+ * POWER_DEEP_SLEEP 1 uses deep-sleep instead (SLEEPDEEP). The deep-sleep
+ * clock is the 16 MHz PIOSC both ECUs already run from, and every peripheral
+ * clocked in run mode stays clocked, so baud rates and timer periods do not
+ * change; flash and SRAM go to their low-power modes and take longer to wake.
+ *
+ * Time asleep and awake is accounted from POWER_Init on, see POWER_GetStats.
+ */
+#ifndef POWER_DEEP_SLEEP
+#define POWER_DEEP_SLEEP        0
+#endif
+
+typedef struct {
+    uint32_t sleeps;        /* POWER_Sleep calls, each ended by an interrupt */
+    uint32_t asleepMs;
+    uint32_t awakeMs;
+} POWER_Stats;
+
+/* Select the sleep mode and start the accounting. After CLOCK_Init */
+void POWER_Init(void);
+
+/*
+ * Sleep until the next interrupt. Call it with interrupts disabled, right
+ * after finding nothing to do: an interrupt that comes in between still ends
+ * the sleep at once. Returns with interrupts enabled, after the ISR that woke
+ * the core has run.
+ */
+void POWER_Sleep(void);
+
+/*
+ * POWER_Sleep that also wakes once GetTicks() reaches wakeTick (the clock's
+ * alarm). Returns at once, interrupts enabled, if it already has.
+ */
+void POWER_SleepUntil(uint32_t wakeTick);
+
+void POWER_GetStats(POWER_Stats *stats);
+
+#endif /* POWER_H_ */
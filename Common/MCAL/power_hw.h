@@ -0,0 +1,18 @@
+#ifndef POWER_HW_H_
+#define POWER_HW_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Register-level part of power.c: power_hw_tm4c.c on the board,
+ * Sim/MCAL/power_hw_sim.c on the host.
+ */
+
+/* Sleep (false) or deep-sleep (true) on the next WFI */
+void POWER_HW_Init(bool deepSleep);
+
+/* WFI with interrupts disabled, then enable them so the waking ISR runs */
+void POWER_HW_WaitForInterrupt(void);
+
+#endif /* POWER_HW_H_ */
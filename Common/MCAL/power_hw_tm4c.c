@@ -0,0 +1,44 @@
+#include "power_hw.h"
+#include "cpu.h"
+#include "tm4c123gh6pm.h"
+
+static bool deepSleep;
+
+/* Deep-sleep clock gating follows run mode, peripherals enabled later too */
+static void POWER_HW_KeepClocks(void)
+{
+    SYSCTL_DCGCGPIO_R = SYSCTL_RCGCGPIO_R;
+    SYSCTL_DCGCUART_R = SYSCTL_RCGCUART_R;
+    SYSCTL_DCGCTIMER_R = SYSCTL_RCGCTIMER_R;
+    SYSCTL_DCGCWTIMER_R = SYSCTL_RCGCWTIMER_R;
+    SYSCTL_DCGCDMA_R = SYSCTL_RCGCDMA_R;
+    SYSCTL_DCGCI2C_R = SYSCTL_RCGCI2C_R;
+    SYSCTL_DCGCADC_R = SYSCTL_RCGCADC_R;
+    SYSCTL_DCGCEEPROM_R = SYSCTL_RCGCEEPROM_R;
+}
+
+void POWER_HW_Init(bool deep)
+{
+    deepSleep = deep;
+    if (deep)
+    {
+        SYSCTL_DSLPCLKCFG_R = SYSCTL_DSLPCLKCFG_O_IO;      /* PIOSC, not divided */
+        SYSCTL_DSLPPWRCFG_R = SYSCTL_DSLPPWRCFG_FLASHPM_SLP | SYSCTL_DSLPPWRCFG_SRAMPM_SBY;
+        NVIC_SYS_CTRL_R |= NVIC_SYS_CTRL_SLEEPDEEP;
+    }
+    else
+    {
+        NVIC_SYS_CTRL_R &= ~NVIC_SYS_CTRL_SLEEPDEEP;
+    }
+}
+
+void POWER_HW_WaitForInterrupt(void)
+{
+    if (deepSleep)
+    {
+        POWER_HW_KeepClocks();
+    }
+    /* A pending interrupt ends WFI even while PRIMASK holds it off */
+    __asm("WFI");
+    CPU_EnableInterrupts();
+}
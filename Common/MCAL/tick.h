@@ -0,0 +1,31 @@
+#ifndef TICK_H_
+#define TICK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ *                         Millisecond Tick                                    *
+ *******************************************************************************/
+
+/*
+ * Milliseconds since CLOCK_Init: the low 32 bits of the 64-bit clock on the
+ * board (clock.h, clock_tm4c.c), the host clock in the simulation
+ * (Sim/MCAL/tick_sim.c). No interrupt counts them.
+ * The counter wraps after ~49 days; compare through the helpers below.
+ */
+uint32_t GetTicks(void);
+
+/* Absolute deadline timeoutMs from now */
+static inline uint32_t Tick_Deadline(uint32_t timeoutMs)
+{
+    return GetTicks() + timeoutMs;
+}
+
+/* True once deadline has been reached, correct across wrap-around */
+static inline bool Tick_Expired(uint32_t deadline)
+{
+    return (int32_t)(GetTicks() - deadline) >= 0;
+}
+
+#endif /* TICK_H_ */
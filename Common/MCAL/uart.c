@@ -1,56 +1,436 @@
 #include "uart.h"
+#include "uart_hw.h"
+#include "udma_hw.h"
+#include "cpu.h"
 #include "tm4c123gh6pm.h"
+#include "../Utils/ring_buffer.h"
+
+/* 16 MHz PIOSC, 9600 baud: used if the clock cannot be decoded */
+#define UART_IBRD_9600   104
+#define UART_FBRD_9600   11
+
+#define UART_RX_INTERRUPTS   (UART_IM_RXIM | UART_IM_RTIM)
+#define UART_DR_LINE_ERRORS  (UART_DR_FE | UART_DR_PE | UART_DR_BE)
+
+static uint8_t rxStorage[UART_RX_BUFFER_SIZE];
+static uint8_t txStorage[UART_TX_BUFFER_SIZE];
+static RingBuffer rxRing;
+static RingBuffer txRing;
+static uint32_t currentBaud;
+static UART_Stats stats;
+static UART_RxCallback rxCallback;
+
+/* Error bits the hardware attached to a received byte (UART_DR_R bits 8-11) */
+static void UART_CountRxErrors(uint32_t data)
+{
+    if (data & UART_DR_LINE_ERRORS)
+    {
+        stats.framingErrors++;
+    }
+    if (data & UART_DR_OE)
+    {
+        stats.overrunErrors++;
+    }
+}
+
+void UART_SetRxCallback(UART_RxCallback received)
+{
+    rxCallback = received;
+}
+
+bool UART_ComputeDivisors(uint32_t clockHz, uint32_t baud, uint32_t *ibrd, uint32_t *fbrd)
+{
+    if (baud == 0 || baud > UART_MAX_BAUD_RATE)
+    {
+        return false;
+    }
+
+    /* BRD = clock / (16 * baud), kept in 1/64 units and rounded */
+    uint32_t div64 = (uint32_t)(((uint64_t)clockHz * 4 + baud / 2) / baud);
+    uint32_t integer = div64 >> 6;
+    if (integer == 0 || integer > 0xFFFF)
+    {
+        return false;
+    }
+
+    uint32_t actual = (uint32_t)((uint64_t)clockHz * 4 / div64);
+    uint32_t error = (actual > baud) ? actual - baud : baud - actual;
+    if ((uint64_t)error * 1000 > (uint64_t)baud * UART_BAUD_TOLERANCE)
+    {
+        return false;
+    }
+
+    *ibrd = integer;
+    *fbrd = div64 & 0x3F;
+    return true;
+}
+
+bool UART_BaudSupported(uint32_t baud)
+{
+    uint32_t ibrd, fbrd;
+    return UART_ComputeDivisors(UART_HW_GetClockHz(), baud, &ibrd, &fbrd);
+}
+
+uint32_t UART_GetBaudRate(void)
+{
+    return currentBaud;
+}
+
+void UART_GetStats(UART_Stats *out)
+{
+    *out = stats;
+}
+
+void UART_ResetStats(void)
+{
+    stats = (UART_Stats){0};
+}
 
 void UART_Init()
 {
-    /* 1. Enable clocks for UART2 and GPIOD */
-    SYSCTL_RCGCUART_R |= SYSCTL_RCGCUART_R2;    // Enable clock to UART2
-    SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R3;    // Enable clock to PORTD (Bit 3)
+    uint32_t ibrd, fbrd;
+
+    RingBuffer_Init(&rxRing, rxStorage, UART_RX_BUFFER_SIZE);
+    RingBuffer_Init(&txRing, txStorage, UART_TX_BUFFER_SIZE);
+
+    if (!UART_ComputeDivisors(UART_HW_GetClockHz(), UART_BAUD_RATE, &ibrd, &fbrd))
+    {
+        ibrd = UART_IBRD_9600;
+        fbrd = UART_FBRD_9600;
+    }
+    UART_HW_Init(ibrd, fbrd);
+    currentBaud = UART_BAUD_RATE;
+    UART_ResetStats();
+
+#if UART_USE_INTERRUPTS
+    UART_HW_EnableInterrupts(UART_RX_INTERRUPTS);
+#if UART_USE_DMA
+    UDMA_HW_Init();
+#endif
+#endif
+}
+
+#if UART_USE_INTERRUPTS
+
+/* Async (zero copy) transfer in progress */
+static const uint8_t *volatile asyncData;
+static volatile uint16_t asyncRemaining;
+static volatile bool asyncBusy;
+static UART_TxCompleteCallback asyncDone;
+
+/*
+ * Move bytes from the TX ring into the hardware FIFO until one of them is
+ * full/empty. Only called with the TX interrupt masked (from the main loop)
+ * or from the ISR itself, so the TX ring always has a single consumer.
+ */
+static void UART_FillTxFifo(void)
+{
+    uint8_t data;
+    while (!UART_HW_TxFull() && RingBuffer_Get(&txRing, &data))
+    {
+        UART_HW_WriteData(data);
+        stats.bytesOut++;
+    }
+}
+
+/*
+ * Prime the FIFO and let the TX interrupt take over the rest of the ring.
+ * While a DMA transfer owns the FIFO the ring just accumulates; the DMA
+ * completion interrupt starts it again so ordering is preserved.
+ */
+static void UART_StartTx(void)
+{
+    if (asyncBusy)
+    {
+        return;
+    }
+    UART_HW_DisableInterrupts(UART_IM_TXIM);
+    UART_FillTxFifo();
+    if (!RingBuffer_IsEmpty(&txRing))
+    {
+        UART_HW_EnableInterrupts(UART_IM_TXIM);
+    }
+}
+
+void UART_SendByte(uint8_t data)
+{
+    while (!RingBuffer_Put(&txRing, data))
+    {
+        UART_StartTx();
+        CPU_Idle();
+    }
+    UART_StartTx();
+}
+
+void UART_SendBuffer(const uint8_t *data, uint16_t len)
+{
+    for (uint16_t i = 0; i < len; i++)
+    {
+        while (!RingBuffer_Put(&txRing, data[i]))
+        {
+            UART_StartTx();
+            CPU_Idle();
+        }
+    }
+    UART_StartTx();
+}
 
-    while((SYSCTL_PRGPIO_R & SYSCTL_PRGPIO_R3) == 0){} // Wait until GPIOD is ready
+#if UART_USE_DMA
 
-    /* --- UNLOCK PD7 --- */
-    GPIO_PORTD_LOCK_R = 0x4C4F434B;   // Unlock Port D
-    GPIO_PORTD_CR_R |= 0x80;          // Allow changes to PD7
-    /* ------------------ */
+static void UART_StartDmaChunk(void)
+{
+    uint16_t chunk = asyncRemaining;
+    if (chunk > UDMA_MAX_TRANSFER)
+    {
+        chunk = UDMA_MAX_TRANSFER;
+    }
+    const uint8_t *src = asyncData;
+    asyncData = src + chunk;
+    asyncRemaining -= chunk;
+    stats.bytesOut += chunk;
+    UDMA_HW_StartUartTx(src, chunk);
+}
 
-    /* 2. Disable UART2 before configuration */
-    UART2_CTL_R &= ~UART_CTL_UARTEN; 
+void UART_SendBufferAsync(const uint8_t *data, uint16_t len, UART_TxCompleteCallback done)
+{
+    /* Earlier transfers (DMA or ring) must reach the FIFO first */
+    while (asyncBusy || !RingBuffer_IsEmpty(&txRing))
+    {
+        UART_StartTx();
+        CPU_Idle();
+    }
 
-    /* 3. Set baud rate (16 MHz clock, 9600 baud) */
-    UART2_IBRD_R = 104; 
-    UART2_FBRD_R = 11;
+    if (len == 0)
+    {
+        if (done) { done(); }
+        return;
+    }
 
-    /* 4. Configure line control (8-bit, FIFO enabled) */
-    UART2_LCRH_R = UART_LCRH_WLEN_8 | UART_LCRH_FEN;
+    UART_HW_DisableInterrupts(UART_IM_TXIM);
+    asyncDone = done;
+    asyncData = data;
+    asyncRemaining = len;
+    asyncBusy = true;
+    UART_StartDmaChunk();
+}
 
-    /* 5. Select system clock as UART clock source */
-    UART2_CC_R = UART_CC_CS_SYSCLK; 
+/* DMA completion: next 1024-byte chunk, or hand the FIFO back to the ring */
+static void UART_DmaComplete(void)
+{
+    if (asyncRemaining > 0)
+    {
+        UART_StartDmaChunk();
+        return;
+    }
 
-    /* 6. Enable UART2, TXE, and RXE */
-    UART2_CTL_R |= (UART_CTL_UARTEN | UART_CTL_TXE | UART_CTL_RXE);
+    asyncBusy = false;
+    if (asyncDone)
+    {
+        asyncDone();
+    }
+    UART_StartTx();
+}
 
-    /* 7. Configure PD6 (U2RX) and PD7 (U2TX) */
-    GPIO_PORTD_DEN_R   |= 0xC0;       // Enable digital function on PD6, PD7 (0xC0 = 1100 0000)
-    GPIO_PORTD_AFSEL_R |= 0xC0;       // Enable alternate function on PD6, PD7
-    GPIO_PORTD_AMSEL_R &= ~0xC0;      // Disable analog function
+#else
 
-    // Configure PCTL: PD6=U2RX (val 1), PD7=U2TX (val 1)
-    // Note: Use register bit-shifting if the specific macros aren't in your header
-    GPIO_PORTD_PCTL_R  &= ~0xFF000000; // Clear bits for PD6 and PD7
-    GPIO_PORTD_PCTL_R  |=  0x11000000; // Set PMCx to 1 for both (UART function)
+void UART_SendBufferAsync(const uint8_t *data, uint16_t len, UART_TxCompleteCallback done)
+{
+    UART_SendBuffer(data, len);   /* copied into the ring, buffer free at once */
+    if (done) { done(); }
+}
+
+#endif /* UART_USE_DMA */
+
+bool UART_TxAsyncBusy(void)
+{
+    return asyncBusy;
+}
+
+uint8_t UART_ReceiveByte()
+{
+    uint8_t data;
+    while (!RingBuffer_Get(&rxRing, &data))
+    {
+        CPU_Idle();
+    }
+    return data;
+}
+
+bool UART_TryReceiveByte(uint8_t *data)
+{
+    return RingBuffer_Get(&rxRing, data);
+}
+
+uint16_t UART_RxAvailable(void)
+{
+    return RingBuffer_Count(&rxRing);
+}
+
+uint16_t UART_RxPeek(uint16_t offset, uint8_t **data)
+{
+    return RingBuffer_Peek(&rxRing, offset, data);
+}
+
+void UART_RxRelease(uint16_t count)
+{
+    RingBuffer_Skip(&rxRing, count);
+}
+
+void UART_Flush(void)
+{
+    while (asyncBusy || !RingBuffer_IsEmpty(&txRing))
+    {
+        UART_StartTx();
+        CPU_Idle();
+    }
+}
+
+/*
+ * RX: fires when the FIFO reaches the IFLS level (8 bytes) or when a partial
+ * burst has sat idle for 32 bit-times (receive timeout), and drains the whole
+ * FIFO either way. TX: fires when the FIFO drops to 2 bytes and refills it.
+ * uDMA completion of the TX channel is also signalled on this vector.
+ */
+void UART2_Handler(void)
+{
+    uint32_t status = UART_HW_GetInterruptStatus();
+    UART_HW_ClearInterrupts(status);
+
+#if UART_USE_DMA
+    if (asyncBusy && UDMA_HW_UartTxDone())
+    {
+        UART_DmaComplete();
+    }
+#endif
+
+    if (status & (UART_MIS_RXMIS | UART_MIS_RTMIS))
+    {
+        while (!UART_HW_RxEmpty())
+        {
+            uint32_t data = UART_HW_ReadData();
+            stats.bytesIn++;
+            UART_CountRxErrors(data);
+            /* On a full ring the newest byte is dropped */
+            if (!RingBuffer_Put(&rxRing, (uint8_t)(data & UART_DR_DATA_M)))
+            {
+                stats.overrunErrors++;
+            }
+        }
+        if (rxCallback)
+        {
+            rxCallback();
+        }
+    }
+
+    if (status & UART_MIS_TXMIS)
+    {
+        UART_FillTxFifo();
+        if (RingBuffer_IsEmpty(&txRing))
+        {
+            UART_HW_DisableInterrupts(UART_IM_TXIM);
+        }
+    }
+}
+
+#else /* polled driver */
+
+void UART_Flush(void)
+{
 }
 
 void UART_SendByte(uint8_t data)
 {
     /* Wait until transmit FIFO is not full */
-    while ((UART2_FR_R & UART_FR_TXFF) != 0);
-    UART2_DR_R = data;
+    while (UART_HW_TxFull()) { CPU_Idle(); }
+    UART_HW_WriteData(data);
+    stats.bytesOut++;
+}
+
+void UART_SendBuffer(const uint8_t *data, uint16_t len)
+{
+    for (uint16_t i = 0; i < len; i++)
+    {
+        UART_SendByte(data[i]);
+    }
 }
 
 uint8_t UART_ReceiveByte()
 {
-    /* Wait until receive FIFO is not empty (RXFE is bit 4) */
-    while(UART2_FR_R & UART_FR_RXFE); 
-    return (uint8_t)(UART2_DR_R & 0xFF);
-}
\ No newline at end of file
+    /* Wait until receive FIFO is not empty */
+    while (UART_HW_RxEmpty()) { CPU_Idle(); }
+    uint32_t data = UART_HW_ReadData();
+    stats.bytesIn++;
+    UART_CountRxErrors(data);
+    return (uint8_t)(data & UART_DR_DATA_M);
+}
+
+bool UART_TryReceiveByte(uint8_t *data)
+{
+    if (UART_HW_RxEmpty())
+    {
+        return false;
+    }
+    uint32_t raw = UART_HW_ReadData();
+    stats.bytesIn++;
+    UART_CountRxErrors(raw);
+    *data = (uint8_t)(raw & UART_DR_DATA_M);
+    return true;
+}
+
+uint16_t UART_RxAvailable(void)
+{
+    return UART_HW_RxEmpty() ? 0 : 1;
+}
+
+uint16_t UART_RxPeek(uint16_t offset, uint8_t **data)
+{
+    (void)offset;
+    (void)data;
+    return 0;
+}
+
+void UART_RxRelease(uint16_t count)
+{
+    (void)count;
+}
+
+void UART_SendBufferAsync(const uint8_t *data, uint16_t len, UART_TxCompleteCallback done)
+{
+    UART_SendBuffer(data, len);
+    if (done) { done(); }
+}
+
+bool UART_TxAsyncBusy(void)
+{
+    return false;
+}
+
+void UART2_Handler(void)
+{
+}
+
+#endif /* UART_USE_INTERRUPTS */
+
+void UART_Drain(void)
+{
+    UART_Flush();
+    while (UART_HW_TxBusy())
+    {
+        CPU_Idle();
+    }
+}
+
+bool UART_SetBaudRate(uint32_t baud)
+{
+    uint32_t ibrd, fbrd;
+    if (!UART_ComputeDivisors(UART_HW_GetClockHz(), baud, &ibrd, &fbrd))
+    {
+        return false;
+    }
+
+    /* Bytes already queued go out at the old rate */
+    UART_Drain();
+    UART_HW_SetDivisors(ibrd, fbrd);
+    currentBaud = baud;
+    return true;
+}
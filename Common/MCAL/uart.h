@@ -2,11 +2,143 @@
 #define UART_H_
 
 #include <stdint.h>
+#include <stdbool.h>
+
+/* ------------- Configuration -------------- */
+
+/* Rate used after UART_Init and whenever negotiation fails */
+#ifndef UART_BAUD_RATE
+#define UART_BAUD_RATE          9600
+#endif
+
+/* Highest rate UART_SetBaudRate accepts (clock/16 is the hardware limit) */
+#ifndef UART_MAX_BAUD_RATE
+#define UART_MAX_BAUD_RATE      1000000
+#endif
+
+/* Largest divisor rounding error accepted for a rate, in 1/1000 */
+#ifndef UART_BAUD_TOLERANCE
+#define UART_BAUD_TOLERANCE     20
+#endif
+
+/*
+ * 1 = interrupt-driven UART2: the ISR moves bytes between the hardware FIFOs
+ *     and the RX/TX rings below, callers only touch the rings
+ * 0 = original polled driver spinning on UART2_FR_R
+ */
+#ifndef UART_USE_INTERRUPTS
+#define UART_USE_INTERRUPTS     1
+#endif
+
+/* Ring sizes, must be powers of two */
+#ifndef UART_RX_BUFFER_SIZE
+#define UART_RX_BUFFER_SIZE     256
+#endif
+
+#ifndef UART_TX_BUFFER_SIZE
+#define UART_TX_BUFFER_SIZE     256
+#endif
+
+/*
+ * 1 = UART_SendBufferAsync hands the caller's buffer to the uDMA UART2 TX
+ *     channel (zero copy), 0 = it is copied through the TX ring instead.
+ *     Only used with UART_USE_INTERRUPTS.
+ */
+#ifndef UART_USE_DMA
+#define UART_USE_DMA            1
+#endif
+
+/* Called from interrupt context once an async buffer may be reused */
+typedef void (*UART_TxCompleteCallback)(void);
+
+/* Called from interrupt context after received bytes were put in the RX ring */
+typedef void (*UART_RxCallback)(void);
+
+/*
+ * Link counters. Each one has a single writer (the ISR, or the caller with the
+ * polled driver), so updating them is a plain increment; a snapshot taken while
+ * traffic flows may be a byte behind.
+ */
+typedef struct {
+    uint32_t bytesIn;
+    uint32_t bytesOut;
+    uint32_t framingErrors;     /* UART_DR_FE, UART_DR_PE or UART_DR_BE on a received byte */
+    uint32_t overrunErrors;     /* UART_DR_OE (FIFO overrun) or byte dropped on a full RX ring */
+} UART_Stats;
 
 /* ------------- Functions Protoypes -------------- */
 void UART_Init();
 void UART_SendByte(uint8_t data);
 uint8_t UART_ReceiveByte();
 
+/* Queue len bytes for transmission (blocks only while the TX ring is full) */
+void UART_SendBuffer(const uint8_t *data, uint16_t len);
+
+/*
+ * Zero-copy transmit: returns as soon as the transfer is started. data must
+ * stay valid until done runs (or UART_TxAsyncBusy() returns false). Bytes
+ * sent with UART_SendByte/UART_SendBuffer afterwards go out after it.
+ * Only one async transfer is in flight; a second call waits for the first.
+ */
+void UART_SendBufferAsync(const uint8_t *data, uint16_t len, UART_TxCompleteCallback done);
+
+/* True while an async transfer still reads from the caller's buffer */
+bool UART_TxAsyncBusy(void);
+
+/* Non-blocking receive: returns false when no byte is waiting */
+bool UART_TryReceiveByte(uint8_t *data);
+
+/* Number of received bytes waiting to be read */
+uint16_t UART_RxAvailable(void);
+
+/*
+ * Zero-copy receive (interrupt driver only, the polled driver has no ring):
+ * *data points into the RX ring at offset bytes past the oldest unread byte,
+ * the return value is how many bytes follow contiguously (0 = not received).
+ * Peeked bytes keep their slots until UART_RxRelease drops them, the caller
+ * may rewrite them in place meanwhile (the ISR only writes past the newest byte).
+ */
+uint16_t UART_RxPeek(uint16_t offset, uint8_t **data);
+
+/* Drop count bytes from the front of the RX ring */
+void UART_RxRelease(uint16_t count);
+
+/*
+ * Have the ISR call received (NULL: nothing) whenever it took bytes in, so a
+ * main loop can sleep until data is there. The polled driver never calls it.
+ */
+void UART_SetRxCallback(UART_RxCallback received);
+
+/* Wait until every queued byte has been handed to the hardware FIFO */
+void UART_Flush(void);
+
+/* UART_Flush, then wait until the last byte has left the shift register */
+void UART_Drain(void);
+
+/*
+ * IBRD/FBRD for baud at clockHz (16x oversampling). Returns false when the
+ * rate is out of range or the rounding error exceeds UART_BAUD_TOLERANCE.
+ */
+bool UART_ComputeDivisors(uint32_t clockHz, uint32_t baud, uint32_t *ibrd, uint32_t *fbrd);
+
+/* True if the current clock can generate baud within tolerance */
+bool UART_BaudSupported(uint32_t baud);
+
+/*
+ * Drain everything queued for transmission, then switch to baud. Returns
+ * false (rate unchanged) if the rate cannot be generated.
+ */
+bool UART_SetBaudRate(uint32_t baud);
+
+uint32_t UART_GetBaudRate(void);
+
+/* Copy of the counters since UART_Init / UART_ResetStats */
+void UART_GetStats(UART_Stats *stats);
+
+void UART_ResetStats(void);
+
+/* UART2 interrupt service routine (vector table entry) */
+void UART2_Handler(void);
+
 
-#endif
\ No newline at end of file
+#endif
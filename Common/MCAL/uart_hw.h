@@ -0,0 +1,42 @@
+#ifndef UART_HW_H
+#define UART_HW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Register-level access to UART2, kept behind functions the same way
+ * eeprom_hw.h does for the EEPROM so uart.c can run against the TM4C
+ * (uart_hw_tm4c.c) or the host simulation (Sim/MCAL/uart_hw_sim.c).
+ * Interrupt masks use the UART_IM_* / UART_MIS_* bits of tm4c123gh6pm.h.
+ */
+
+void UART_HW_Init(uint32_t ibrd, uint32_t fbrd);
+
+bool UART_HW_TxFull(void);
+
+bool UART_HW_RxEmpty(void);
+
+void UART_HW_WriteData(uint8_t data);
+
+/* Returns the full data register: byte in bits 0-7, UART_DR_* errors above */
+uint32_t UART_HW_ReadData(void);
+
+void UART_HW_EnableInterrupts(uint32_t mask);
+
+void UART_HW_DisableInterrupts(uint32_t mask);
+
+uint32_t UART_HW_GetInterruptStatus(void);
+
+void UART_HW_ClearInterrupts(uint32_t mask);
+
+/* True until the TX FIFO is empty and the last stop bit has been sent */
+bool UART_HW_TxBusy(void);
+
+/* Reprogram IBRD/FBRD on the running UART (FIFO contents are kept) */
+void UART_HW_SetDivisors(uint32_t ibrd, uint32_t fbrd);
+
+/* Clock feeding the baud-rate generator, in Hz */
+uint32_t UART_HW_GetClockHz(void);
+
+#endif
@@ -0,0 +1,168 @@
+#include "uart_hw.h"
+#include "tm4c123gh6pm.h"
+
+#define UART2_NVIC_BIT   (1U << (33 - 32))   /* UART2 is interrupt 33 */
+
+#define PIOSC_HZ         16000000UL
+#define LFIOSC_HZ        30000UL
+#define HIB_OSC_HZ       32768UL
+#define PLL_HZ           400000000UL
+
+/* Crystal frequency for each RCC XTAL code, starting at 0x06 (4 MHz) */
+static const uint32_t xtalHz[] = {
+    4000000, 4096000, 4915200, 5000000, 5120000, 6000000, 6144000,
+    7372800, 8000000, 8192000, 10000000, 12000000, 12288000, 13560000,
+    14318180, 16000000, 16384000, 18000000, 20000000, 24000000, 25000000
+};
+
+void UART_HW_Init(uint32_t ibrd, uint32_t fbrd)
+{
+    /* 1. Enable clocks for UART2 and GPIOD */
+    SYSCTL_RCGCUART_R |= SYSCTL_RCGCUART_R2;    // Enable clock to UART2
+    SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R3;    // Enable clock to PORTD (Bit 3)
+
+    while((SYSCTL_PRGPIO_R & SYSCTL_PRGPIO_R3) == 0){} // Wait until GPIOD is ready
+
+    /* --- UNLOCK PD7 --- */
+    GPIO_PORTD_LOCK_R = 0x4C4F434B;   // Unlock Port D
+    GPIO_PORTD_CR_R |= 0x80;          // Allow changes to PD7
+    /* ------------------ */
+
+    /* 2. Disable UART2 before configuration */
+    UART2_CTL_R &= ~UART_CTL_UARTEN;
+
+    /* 3. Set baud rate divisors */
+    UART2_IBRD_R = ibrd;
+    UART2_FBRD_R = fbrd;
+
+    /* 4. Configure line control (8-bit, FIFO enabled) */
+    UART2_LCRH_R = UART_LCRH_WLEN_8 | UART_LCRH_FEN;
+
+    /* 5. Select system clock as UART clock source */
+    UART2_CC_R = UART_CC_CS_SYSCLK;
+
+    /* 6. Interrupt when RX FIFO is half full / TX FIFO is down to 2 bytes,
+          so each interrupt moves a burst instead of a single byte */
+    UART2_IFLS_R = UART_IFLS_RX4_8 | UART_IFLS_TX1_8;
+    UART2_IM_R = 0;
+    UART2_ICR_R = 0x7F2;              // Clear anything left pending
+
+    /* 7. Enable UART2, TXE, and RXE */
+    UART2_CTL_R |= (UART_CTL_UARTEN | UART_CTL_TXE | UART_CTL_RXE);
+
+    /* 8. Configure PD6 (U2RX) and PD7 (U2TX) */
+    GPIO_PORTD_DEN_R   |= 0xC0;       // Enable digital function on PD6, PD7 (0xC0 = 1100 0000)
+    GPIO_PORTD_AFSEL_R |= 0xC0;       // Enable alternate function on PD6, PD7
+    GPIO_PORTD_AMSEL_R &= ~0xC0;      // Disable analog function
+
+    // Configure PCTL: PD6=U2RX (val 1), PD7=U2TX (val 1)
+    GPIO_PORTD_PCTL_R  &= ~0xFF000000; // Clear bits for PD6 and PD7
+    GPIO_PORTD_PCTL_R  |=  0x11000000; // Set PMCx to 1 for both (UART function)
+
+    /* 9. Route UART2 interrupt through the NVIC */
+    NVIC_EN1_R |= UART2_NVIC_BIT;
+}
+
+bool UART_HW_TxFull(void)
+{
+    return (UART2_FR_R & UART_FR_TXFF) != 0;
+}
+
+bool UART_HW_RxEmpty(void)
+{
+    return (UART2_FR_R & UART_FR_RXFE) != 0;
+}
+
+void UART_HW_WriteData(uint8_t data)
+{
+    UART2_DR_R = data;
+}
+
+uint32_t UART_HW_ReadData(void)
+{
+    return UART2_DR_R;
+}
+
+void UART_HW_EnableInterrupts(uint32_t mask)
+{
+    UART2_IM_R |= mask;
+}
+
+void UART_HW_DisableInterrupts(uint32_t mask)
+{
+    UART2_IM_R &= ~mask;
+}
+
+uint32_t UART_HW_GetInterruptStatus(void)
+{
+    return UART2_MIS_R;
+}
+
+void UART_HW_ClearInterrupts(uint32_t mask)
+{
+    UART2_ICR_R = mask;
+}
+
+bool UART_HW_TxBusy(void)
+{
+    /* BUSY stays set until the stop bit of the last FIFO byte has left */
+    return (UART2_FR_R & UART_FR_BUSY) != 0;
+}
+
+void UART_HW_SetDivisors(uint32_t ibrd, uint32_t fbrd)
+{
+    UART2_CTL_R &= ~UART_CTL_UARTEN;
+    UART2_IBRD_R = ibrd;
+    UART2_FBRD_R = fbrd;
+    /* Divisor registers only latch on a write to LCRH */
+    UART2_LCRH_R = UART_LCRH_WLEN_8 | UART_LCRH_FEN;
+    UART2_CTL_R |= (UART_CTL_UARTEN | UART_CTL_TXE | UART_CTL_RXE);
+}
+
+/*
+ * UART2 runs from the system clock (UART_CC_CS_SYSCLK), so decode it from
+ * RCC/RCC2 instead of assuming the 16 MHz PIOSC the boards boot from.
+ */
+uint32_t UART_HW_GetClockHz(void)
+{
+    uint32_t rcc = SYSCTL_RCC_R;
+    uint32_t rcc2 = SYSCTL_RCC2_R;
+    bool useRcc2 = (rcc2 & SYSCTL_RCC2_USERCC2) != 0;
+    uint32_t oscSrc = useRcc2 ? (rcc2 & SYSCTL_RCC2_OSCSRC2_M) : (rcc & SYSCTL_RCC_OSCSRC_M);
+    bool bypass = useRcc2 ? (rcc2 & SYSCTL_RCC2_BYPASS2) != 0 : (rcc & SYSCTL_RCC_BYPASS) != 0;
+    uint32_t clk;
+
+    switch (oscSrc)
+    {
+        case SYSCTL_RCC2_OSCSRC2_IO:  clk = PIOSC_HZ;     break;
+        case SYSCTL_RCC2_OSCSRC2_IO4: clk = PIOSC_HZ / 4; break;
+        case SYSCTL_RCC2_OSCSRC2_30:  clk = LFIOSC_HZ;    break;
+        case SYSCTL_RCC2_OSCSRC2_32:  clk = HIB_OSC_HZ;   break;
+        default:
+        {
+            uint32_t xtal = (rcc & SYSCTL_RCC_XTAL_M) >> 6;
+            clk = (xtal >= 0x06 && xtal - 0x06 < sizeof(xtalHz) / sizeof(xtalHz[0]))
+                  ? xtalHz[xtal - 0x06] : PIOSC_HZ;
+            break;
+        }
+    }
+
+    if (!bypass)
+    {
+        /* PLL is 400 MHz, divided by two unless DIV400 selects the 7-bit divisor */
+        if (useRcc2 && (rcc2 & SYSCTL_RCC2_DIV400))
+        {
+            uint32_t div = ((rcc2 & (SYSCTL_RCC2_SYSDIV2_M | SYSCTL_RCC2_SYSDIV2LSB)) >> 22) + 1;
+            return PLL_HZ / div;
+        }
+        clk = PLL_HZ / 2;
+    }
+
+    if (rcc & SYSCTL_RCC_USESYSDIV)
+    {
+        uint32_t div = useRcc2 ? ((rcc2 & SYSCTL_RCC2_SYSDIV2_M) >> SYSCTL_RCC2_SYSDIV2_S)
+                               : ((rcc & SYSCTL_RCC_SYSDIV_M) >> SYSCTL_RCC_SYSDIV_S);
+        clk /= div + 1;
+    }
+    return clk;
+}
@@ -0,0 +1,24 @@
+#ifndef UDMA_HW_H
+#define UDMA_HW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * uDMA channel 1 (encoding 1) feeding the UART2 TX FIFO. Like uart_hw.h this
+ * is implemented for the TM4C (udma_hw_tm4c.c) and for the host simulation
+ * (Sim/MCAL/udma_hw_sim.c), where the engine can be stepped from a test.
+ */
+
+/* Largest transfer the uDMA can do in one basic-mode request */
+#define UDMA_MAX_TRANSFER   1024
+
+void UDMA_HW_Init(void);
+
+/* Start copying count bytes (1..UDMA_MAX_TRANSFER) from src to UART2_DR */
+void UDMA_HW_StartUartTx(const uint8_t *src, uint16_t count);
+
+/* Called from UART2_Handler: true (and acknowledged) once the transfer completed */
+bool UDMA_HW_UartTxDone(void);
+
+#endif
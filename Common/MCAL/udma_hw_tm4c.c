@@ -0,0 +1,63 @@
+#include "udma_hw.h"
+#include "tm4c123gh6pm.h"
+
+#define UDMA_UART2_TX_CH     1
+#define UDMA_UART2_TX_BIT    (1U << UDMA_UART2_TX_CH)
+#define UDMA_UART2_TX_ENC    1
+
+/* Channel control structure: source end, destination end, control word, unused */
+#define UDMA_CH_SRC_END      0
+#define UDMA_CH_DST_END      1
+#define UDMA_CH_CONTROL      2
+
+/*
+ * Primary control table: 32 channels x 4 words. The controller needs the base
+ * 1024-byte aligned. Only the UART2 TX entry is ever written.
+ */
+#pragma data_alignment = 1024
+static volatile uint32_t udmaControlTable[32 * 4];
+
+void UDMA_HW_Init(void)
+{
+    SYSCTL_RCGCDMA_R |= 0x01;                      // Enable clock to uDMA
+    while ((SYSCTL_PRDMA_R & SYSCTL_PRDMA_R0) == 0) {}
+
+    UDMA_CFG_R = UDMA_CFG_MASTEN;
+    UDMA_CTLBASE_R = (uint32_t)udmaControlTable;
+
+    /* Channel 1 -> UART2 TX, primary structure, default priority, single+burst */
+    UDMA_CHMAP0_R = (UDMA_CHMAP0_R & ~UDMA_CHMAP0_CH1SEL_M) |
+                    (UDMA_UART2_TX_ENC << UDMA_CHMAP0_CH1SEL_S);
+    UDMA_ALTCLR_R      = UDMA_UART2_TX_BIT;
+    UDMA_PRIOCLR_R     = UDMA_UART2_TX_BIT;
+    UDMA_USEBURSTCLR_R = UDMA_UART2_TX_BIT;
+    UDMA_REQMASKCLR_R  = UDMA_UART2_TX_BIT;
+
+    UART2_DMACTL_R |= UART_DMACTL_TXDMAE;
+}
+
+void UDMA_HW_StartUartTx(const uint8_t *src, uint16_t count)
+{
+    volatile uint32_t *entry = &udmaControlTable[UDMA_UART2_TX_CH * 4];
+
+    entry[UDMA_CH_SRC_END] = (uint32_t)(src + count - 1);
+    entry[UDMA_CH_DST_END] = (uint32_t)&UART2_DR_R;
+    entry[UDMA_CH_CONTROL] = UDMA_CHCTL_DSTINC_NONE | UDMA_CHCTL_DSTSIZE_8 |
+                             UDMA_CHCTL_SRCINC_8 | UDMA_CHCTL_SRCSIZE_8 |
+                             UDMA_CHCTL_ARBSIZE_4 |
+                             ((uint32_t)(count - 1) << UDMA_CHCTL_XFERSIZE_S) |
+                             UDMA_CHCTL_XFERMODE_BASIC;
+
+    UDMA_ENASET_R = UDMA_UART2_TX_BIT;
+}
+
+bool UDMA_HW_UartTxDone(void)
+{
+    /* Completion of a peripheral channel is signalled on the UART2 vector */
+    if (UDMA_CHIS_R & UDMA_UART2_TX_BIT)
+    {
+        UDMA_CHIS_R = UDMA_UART2_TX_BIT;           // Write 1 to clear
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,1245 @@
+#include <string.h>
+#include "../../../External/unity.h"
+#include "../../HAL/comm_interface.h"
+#include "../../HAL/comm_request.h"
+#include "../../HAL/comm_link.h"
+#include "../../HAL/comm_dispatch.h"
+#include "../../Utils/crc16.h"
+#include "../../Utils/boot_profile.h"
+#include "../../MCAL/tick.h"
+#include "../../MCAL/cpu.h"
+#include "../../MCAL/clock.h"
+#include "../../../Sim/MCAL/uart_sim.h"
+#include "comm_unit_test.h"
+
+void setUp(void) {
+    UART_SIM_Reset();
+    UART_SIM_SetLoopback(true);
+    COMM_Init();
+    COMM_RequestInit();
+}
+
+void tearDown(void) {}
+
+/* Textbook COBS encoder plus delimiter, independent of the one in comm_interface.c */
+static uint8_t cobs_encode(const uint8_t *in, uint8_t len, uint8_t *out) {
+    uint8_t codeAt = 0;
+    uint8_t o = 1;
+    uint8_t code = 1;
+    for (uint8_t i = 0; i < len; i++) {
+        if (in[i] == 0) {
+            out[codeAt] = code;
+            codeAt = o++;
+            code = 1;
+        } else {
+            out[o++] = in[i];
+            code++;
+        }
+    }
+    out[codeAt] = code;
+    out[o++] = 0x00;
+    return o;
+}
+
+/* Build a wire frame by hand, independent of COMM_SendFrame */
+static uint8_t build_frame(uint8_t *out, uint8_t cmd, uint8_t seq,
+                           const uint8_t *payload, uint8_t len) {
+    uint8_t frame[COMM_MAX_FRAME_SIZE];
+    frame[0] = cmd;
+    frame[1] = seq;
+    frame[2] = len;
+    if (len > 0) {
+        memcpy(&frame[3], payload, len);
+    }
+    uint16_t crc = CRC16_Compute(CRC16_INIT, frame, (uint16_t)(3 + len));
+    frame[3 + len] = (uint8_t)(crc >> 8);
+    frame[4 + len] = (uint8_t)(crc & 0xFF);
+    return cobs_encode(frame, (uint8_t)(5 + len), out);
+}
+
+/* Feed bytes to a parser, return the result of the last byte */
+static COMM_ParseResult feed(COMM_Parser *parser, const uint8_t *data, uint8_t len) {
+    COMM_ParseResult result = COMM_PARSE_BUSY;
+    for (uint8_t i = 0; i < len; i++) {
+        result = COMM_ParseByte(parser, data[i]);
+    }
+    return result;
+}
+
+/* ---------- CRC TESTS ---------- */
+
+void test_crc16_check_value(void) {
+    /* CRC-16/CCITT-FALSE check value */
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, CRC16_Compute(CRC16_INIT, (const uint8_t*)"123456789", 9));
+}
+
+/* ---------- PARSER TESTS ---------- */
+
+void test_parser_accepts_valid_frame(void) {
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+    COMM_Parser parser;
+    COMM_ParserReset(&parser);
+
+    uint8_t n = build_frame(wire, CMD_SEND_PASSWORD, 7, (const uint8_t*)"12345", 5);
+    TEST_ASSERT_EQUAL(COMM_PARSE_FRAME, feed(&parser, wire, n));
+    TEST_ASSERT_EQUAL_HEX8(CMD_SEND_PASSWORD, parser.frame.cmd);
+    TEST_ASSERT_EQUAL_UINT8(7, parser.frame.seq);
+    TEST_ASSERT_EQUAL_UINT8(5, parser.frame.len);
+    TEST_ASSERT_EQUAL_MEMORY("12345", parser.frame.payload, 5);
+}
+
+void test_parser_accepts_newline_in_payload(void) {
+    /* The old '\n'-terminated format could not carry these bytes, 0x00 is stuffed */
+    const uint8_t payload[] = { '\n', 0x00, 0x7E, 0x00 };
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+    COMM_Parser parser;
+    COMM_ParserReset(&parser);
+
+    uint8_t n = build_frame(wire, CMD_CHANGE_PASSWORD, 0, payload, sizeof(payload));
+    TEST_ASSERT_NULL(memchr(wire, COMM_DELIMITER, n - 1));
+    TEST_ASSERT_EQUAL(COMM_PARSE_FRAME, feed(&parser, wire, n));
+    TEST_ASSERT_EQUAL_UINT8(sizeof(payload), parser.frame.len);
+    TEST_ASSERT_EQUAL_MEMORY(payload, parser.frame.payload, sizeof(payload));
+}
+
+void test_encode_frame_matches_reference_cobs(void) {
+    const uint8_t payload[] = { 0x00, 0x11, 0x00, 0x00 };
+    uint8_t expected[COMM_MAX_WIRE_SIZE];
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+
+    uint8_t n = build_frame(expected, CMD_SET_TIMEOUT, 0, payload, sizeof(payload));
+    TEST_ASSERT_EQUAL_UINT8(n, COMM_EncodeFrame(wire, CMD_SET_TIMEOUT, 0, payload, sizeof(payload)));
+    TEST_ASSERT_EQUAL_UINT8(COMM_WIRE_SIZE(sizeof(payload)), n);
+    TEST_ASSERT_EQUAL_MEMORY(expected, wire, n);
+}
+
+void test_parser_rejects_bad_crc(void) {
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+    COMM_Parser parser;
+    COMM_ParserReset(&parser);
+
+    uint8_t n = build_frame(wire, CMD_SEND_PASSWORD, 1, (const uint8_t*)"12345", 5);
+    wire[6] ^= 0x01;    /* flip one payload bit */
+    TEST_ASSERT_EQUAL(COMM_PARSE_ERROR, feed(&parser, wire, n));
+    TEST_ASSERT_EQUAL(COMM_RX_START, parser.state);
+}
+
+void test_parser_rejects_oversized_length(void) {
+    /* code byte, CMD, SEQ, LEN */
+    const uint8_t header[] = { 0x04, CMD_SEND_PASSWORD, 1, COMM_MAX_PAYLOAD + 1 };
+    const uint8_t delimiter = COMM_DELIMITER;
+    COMM_Parser parser;
+    COMM_ParserReset(&parser);
+
+    /* Error on the LEN byte itself, the rest up to the delimiter is ignored */
+    TEST_ASSERT_EQUAL(COMM_PARSE_ERROR, feed(&parser, header, sizeof(header)));
+    TEST_ASSERT_EQUAL(COMM_RX_HUNT, parser.state);
+    TEST_ASSERT_EQUAL(COMM_PARSE_BUSY, feed(&parser, header, sizeof(header)));
+    TEST_ASSERT_EQUAL(COMM_PARSE_BUSY, feed(&parser, &delimiter, 1));
+    TEST_ASSERT_EQUAL(COMM_RX_START, parser.state);
+}
+
+void test_parser_resyncs_after_garbage(void) {
+    /* A frame cut short by a lost byte: only its own delimiter is needed to recover */
+    const uint8_t garbage[] = { 0x55, 0xFF, 0x7E, CMD_ACK, 0x03, COMM_DELIMITER };
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+    COMM_Parser parser;
+    COMM_ParserReset(&parser);
+
+    TEST_ASSERT_EQUAL(COMM_PARSE_ERROR, feed(&parser, garbage, sizeof(garbage)));
+    uint8_t n = build_frame(wire, CMD_DOOR_UNLOCK, 9, NULL, 0);
+    TEST_ASSERT_EQUAL(COMM_PARSE_FRAME, feed(&parser, wire, n));
+    TEST_ASSERT_EQUAL_HEX8(CMD_DOOR_UNLOCK, parser.frame.cmd);
+}
+
+void test_parser_never_reads_payload_as_command(void) {
+    /* Garbage without a delimiter swallows the next frame, never more */
+    const uint8_t garbage[] = { 0x03, CMD_DOOR_UNLOCK, 0x11 };
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+    COMM_Parser parser;
+    COMM_ParserReset(&parser);
+
+    (void)feed(&parser, garbage, sizeof(garbage));
+    uint8_t n = build_frame(wire, CMD_SEND_PASSWORD, 2, (const uint8_t*)"12345", 5);
+    TEST_ASSERT_NOT_EQUAL(COMM_PARSE_FRAME, feed(&parser, wire, n));
+    TEST_ASSERT_EQUAL(COMM_RX_START, parser.state);
+    TEST_ASSERT_EQUAL(COMM_PARSE_FRAME, feed(&parser, wire, n));
+    TEST_ASSERT_EQUAL_HEX8(CMD_SEND_PASSWORD, parser.frame.cmd);
+}
+
+/* ---------- FRAME TRANSPORT TESTS ---------- */
+
+void test_comm_frame_round_trip(void) {
+    uint8_t payload[COMM_MAX_PAYLOAD];
+    COMM_Frame frame;
+    for (uint8_t i = 0; i < COMM_MAX_PAYLOAD; i++) {
+        payload[i] = (uint8_t)(0xFF - i);
+    }
+
+    uint8_t seq = COMM_SendFrame(CMD_CHANGE_PASSWORD, payload, COMM_MAX_PAYLOAD);
+    COMM_ReceiveFrame(&frame);
+
+    TEST_ASSERT_EQUAL_HEX8(CMD_CHANGE_PASSWORD, frame.cmd);
+    TEST_ASSERT_EQUAL_UINT8(seq, frame.seq);
+    TEST_ASSERT_EQUAL_UINT8(COMM_MAX_PAYLOAD, frame.len);
+    TEST_ASSERT_EQUAL_MEMORY(payload, frame.payload, COMM_MAX_PAYLOAD);
+}
+
+void test_comm_command_round_trip(void) {
+    COMM_SendCommand(CMD_READY);
+    COMM_SendCommand(CMD_INIT);
+    TEST_ASSERT_EQUAL_HEX8(CMD_READY, COMM_ReceiveCommand());
+    TEST_ASSERT_EQUAL_HEX8(CMD_INIT, COMM_ReceiveCommand());
+}
+
+void test_comm_poll_frame_partial(void) {
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+    COMM_Frame frame;
+    UART_SIM_SetLoopback(false);
+
+    uint8_t n = build_frame(wire, CMD_SET_TIMEOUT, 2, (const uint8_t*)"\x0F", 1);
+    UART_SIM_Inject(wire, 3);
+    UART_SIM_Service();
+    TEST_ASSERT_FALSE(COMM_PollFrame(&frame));
+
+    UART_SIM_Inject(&wire[3], (uint16_t)(n - 3));
+    UART_SIM_Service();
+    TEST_ASSERT_TRUE(COMM_PollFrame(&frame));
+    TEST_ASSERT_EQUAL_HEX8(CMD_SET_TIMEOUT, frame.cmd);
+    TEST_ASSERT_EQUAL_UINT8(0x0F, frame.payload[0]);
+}
+
+void test_comm_async_frame_round_trip(void) {
+    static const uint8_t payload[] = "async payload";
+    COMM_Frame frame;
+
+    (void)COMM_SendFrameAsync(CMD_SEND_PASSWORD, payload, sizeof(payload), NULL);
+    COMM_ReceiveFrame(&frame);
+
+    TEST_ASSERT_FALSE(COMM_TxBusy());
+    TEST_ASSERT_EQUAL_UINT8(sizeof(payload), frame.len);
+    TEST_ASSERT_EQUAL_MEMORY(payload, frame.payload, sizeof(payload));
+}
+
+static bool asyncDone;
+static void async_done(void) { asyncDone = true; }
+
+void test_comm_async_frame_with_zero_in_payload(void) {
+    /* 0x00 must be stuffed, so this payload goes through the TX ring instead */
+    static const uint8_t payload[] = { 0x12, 0x00, 0x34 };
+    COMM_Frame frame;
+    asyncDone = false;
+
+    (void)COMM_SendFrameAsync(CMD_SET_TIMEOUT, payload, sizeof(payload), async_done);
+    TEST_ASSERT_TRUE(asyncDone);
+    COMM_ReceiveFrame(&frame);
+
+    TEST_ASSERT_EQUAL_UINT8(sizeof(payload), frame.len);
+    TEST_ASSERT_EQUAL_MEMORY(payload, frame.payload, sizeof(payload));
+}
+
+/* ---------- BOUNDED RECEIVE TESTS ---------- */
+
+void test_tick_expired_across_wrap(void) {
+    uint32_t now = GetTicks();
+    TEST_ASSERT_TRUE(Tick_Expired(now));
+    TEST_ASSERT_FALSE(Tick_Expired(now + 1000));
+    /* a deadline "behind" by more than half the range counts as future */
+    TEST_ASSERT_TRUE(Tick_Expired(now - 0x7FFFFFFFUL));
+}
+
+void test_comm_try_receive_empty(void) {
+    uint8_t cmd = 0xAA;
+    TEST_ASSERT_FALSE(COMM_TryReceiveCommand(&cmd));
+    TEST_ASSERT_EQUAL_HEX8(0xAA, cmd);
+
+    COMM_SendCommand(CMD_ACK);
+    UART_SIM_Service();
+    TEST_ASSERT_TRUE(COMM_TryReceiveCommand(&cmd));
+    TEST_ASSERT_EQUAL_HEX8(CMD_ACK, cmd);
+}
+
+void test_comm_receive_until_times_out(void) {
+    COMM_Frame frame;
+    uint32_t start = GetTicks();
+
+    TEST_ASSERT_EQUAL(COMM_TIMEOUT, COMM_ReceiveFrameUntil(&frame, Tick_Deadline(20)));
+    uint32_t waited = GetTicks() - start;
+    TEST_ASSERT_TRUE(waited >= 20);
+    TEST_ASSERT_TRUE(waited < 200);
+}
+
+void test_comm_receive_until_returns_frame(void) {
+    uint8_t cmd = 0;
+    COMM_SendCommand(CMD_PASSWORD_CORRECT);
+    TEST_ASSERT_EQUAL(COMM_OK, COMM_ReceiveCommandUntil(&cmd, Tick_Deadline(1000)));
+    TEST_ASSERT_EQUAL_HEX8(CMD_PASSWORD_CORRECT, cmd);
+}
+
+void test_comm_wait_for_command_skips_others(void) {
+    COMM_SendCommand(CMD_UNKNOWN);
+    COMM_SendCommand(CMD_ACK);
+    TEST_ASSERT_EQUAL(COMM_OK, COMM_WaitForCommand(CMD_ACK, 1000));
+    TEST_ASSERT_EQUAL(COMM_TIMEOUT, COMM_WaitForCommand(CMD_ACK, 10));
+}
+
+/* ---------- CALLER-SIZED AND ZERO-COPY RECEIVE TESTS ---------- */
+
+void test_comm_receive_message_respects_capacity(void) {
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+    uint8_t buffer[6] = {0};
+    uint8_t cmd, len;
+    UART_SIM_SetLoopback(false);
+
+    uint8_t n = build_frame(wire, CMD_VERIFY_AND_CHANGE, 3, (const uint8_t*)"1234554321", 10);
+    UART_SIM_Inject(wire, n);
+    n = build_frame(wire, CMD_SEND_PASSWORD, 4, (const uint8_t*)"12345", 5);
+    UART_SIM_Inject(wire, n);
+    UART_SIM_Service();
+
+    /* the last byte of buffer is a guard, capacity is one less */
+    TEST_ASSERT_EQUAL(COMM_TRUNCATED, COMM_ReceiveMessage(&cmd, buffer, 5, &len, Tick_Deadline(10)));
+    TEST_ASSERT_EQUAL_HEX8(CMD_VERIFY_AND_CHANGE, cmd);
+    TEST_ASSERT_EQUAL_UINT8(5, len);
+    TEST_ASSERT_EQUAL_UINT8(0, buffer[5]);
+
+    TEST_ASSERT_EQUAL(COMM_OK, COMM_ReceiveMessage(&cmd, buffer, 5, &len, Tick_Deadline(10)));
+    TEST_ASSERT_EQUAL_HEX8(CMD_SEND_PASSWORD, cmd);
+    TEST_ASSERT_EQUAL_MEMORY("12345", buffer, 5);
+    TEST_ASSERT_EQUAL(COMM_TIMEOUT, COMM_ReceiveMessage(&cmd, buffer, 5, &len, Tick_Deadline(10)));
+}
+
+void test_comm_peek_frame_is_zero_copy(void) {
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+    COMM_FrameView view, again;
+    uint8_t *ring;
+    UART_SIM_SetLoopback(false);
+
+    uint8_t n = build_frame(wire, CMD_SEND_PASSWORD, 5, (const uint8_t*)"12345", 5);
+    UART_SIM_Inject(wire, n);
+    UART_SIM_Service();
+
+    TEST_ASSERT_TRUE(COMM_PeekFrame(&view));
+    TEST_ASSERT_EQUAL_UINT8(n, view.size);
+    TEST_ASSERT_EQUAL_UINT16(n, UART_RxAvailable());     /* still in the ring */
+    TEST_ASSERT_TRUE(UART_RxPeek(COMM_HEADER_SIZE, &ring) >= 5);
+    TEST_ASSERT_EQUAL_PTR(ring, view.payload);
+    TEST_ASSERT_EQUAL_MEMORY("12345", view.payload, 5);
+
+    /* same frame until released, and a second release drops nothing */
+    TEST_ASSERT_TRUE(COMM_PeekFrame(&again));
+    TEST_ASSERT_EQUAL_PTR(view.payload, again.payload);
+    COMM_ReleaseFrame(&view);
+    TEST_ASSERT_EQUAL_UINT16(0, UART_RxAvailable());
+    TEST_ASSERT_FALSE(COMM_PeekFrame(&view));
+}
+
+void test_comm_peek_frame_across_ring_wrap(void) {
+    uint8_t filler[UART_RX_BUFFER_SIZE - 8] = {0};
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+    COMM_FrameView view;
+    UART_SIM_SetLoopback(false);
+
+    /* move the ring indices so the payload straddles the end of the storage */
+    UART_SIM_Inject(filler, sizeof(filler));
+    UART_SIM_Service();
+    TEST_ASSERT_FALSE(COMM_PeekFrame(&view));
+    TEST_ASSERT_EQUAL_UINT16(0, UART_RxAvailable());
+
+    uint8_t n = build_frame(wire, CMD_VERIFY_AND_CHANGE, 6, (const uint8_t*)"1234554321", 10);
+    UART_SIM_Inject(wire, n);
+    UART_SIM_Service();
+
+    TEST_ASSERT_TRUE(COMM_PeekFrame(&view));
+    TEST_ASSERT_EQUAL_HEX8(CMD_VERIFY_AND_CHANGE, view.cmd);
+    TEST_ASSERT_EQUAL_UINT8(10, view.len);
+    TEST_ASSERT_EQUAL_MEMORY("1234554321", view.payload, 10);
+    COMM_ReleaseFrame(&view);
+    TEST_ASSERT_EQUAL_UINT16(0, UART_RxAvailable());
+}
+
+void test_comm_peek_frame_skips_corrupt_frame(void) {
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+    COMM_FrameView view;
+    COMM_Stats stats;
+    UART_SIM_SetLoopback(false);
+
+    uint8_t n = build_frame(wire, CMD_SEND_PASSWORD, 1, (const uint8_t*)"12345", 5);
+    wire[6] ^= 0x01;
+    UART_SIM_Inject(wire, n);
+    n = build_frame(wire, CMD_DOOR_UNLOCK, 2, NULL, 0);
+    UART_SIM_Inject(wire, n);
+    UART_SIM_Service();
+
+    TEST_ASSERT_TRUE(COMM_PeekFrame(&view));
+    TEST_ASSERT_EQUAL_HEX8(CMD_DOOR_UNLOCK, view.cmd);
+    TEST_ASSERT_EQUAL_UINT8(0, view.len);
+    COMM_ReleaseFrame(&view);
+
+    COMM_GetStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.crcErrors);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.framesIn);
+}
+
+/* ---------- BAUD NEGOTIATION TESTS ---------- */
+
+void test_comm_caps_follow_clock(void) {
+    /* 16 MHz reaches every rate up to 1 Mbaud */
+    TEST_ASSERT_EQUAL_HEX8(0x1F, COMM_BaudCapabilities());
+
+    /* 8 MHz tops out at clock / 16 = 500 kbaud */
+    UART_SIM_SetClockHz(8000000);
+    TEST_ASSERT_EQUAL_HEX8(0x07, COMM_BaudCapabilities());
+
+    /* 1 MHz cannot reach any of them, the handshake stays at 9600 */
+    UART_SIM_SetClockHz(1000000);
+    TEST_ASSERT_EQUAL_HEX8(0x00, COMM_BaudCapabilities());
+}
+
+void test_comm_select_highest_common_rate(void) {
+    TEST_ASSERT_EQUAL_UINT32(1000000, COMM_SelectBaud(0x1F));
+    TEST_ASSERT_EQUAL_UINT32(921600, COMM_SelectBaud(0x0B));
+    TEST_ASSERT_EQUAL_UINT32(115200, COMM_SelectBaud(0x01));
+    TEST_ASSERT_EQUAL_UINT32(COMM_BAUD_FALLBACK, COMM_SelectBaud(0x00));
+}
+
+void test_comm_initiate_falls_back_without_probe(void) {
+    /* Loopback: our own READY comes back as the peer's, nobody probes */
+    uint32_t baud = COMM_HandshakeInitiate(CMD_ACK);
+    TEST_ASSERT_EQUAL_UINT32(COMM_BAUD_FALLBACK, baud);
+    TEST_ASSERT_EQUAL_UINT32(COMM_BAUD_FALLBACK, UART_GetBaudRate());
+}
+
+void test_comm_initiate_until_gives_up(void) {
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+    const uint8_t caps = 0x00;      /* no common rate: no probe step */
+    UART_SIM_SetLoopback(false);
+
+    /* Nobody answers: back at the deadline, not after a full retry */
+    uint32_t start = GetTicks();
+    TEST_ASSERT_EQUAL_UINT32(0, COMM_HandshakeInitiateUntil(CMD_ACK, Tick_Deadline(30)));
+    uint32_t elapsed = GetTicks() - start;
+    TEST_ASSERT_TRUE(elapsed >= 30 && elapsed < COMM_HANDSHAKE_RETRY_MS);
+    TEST_ASSERT_FALSE(COMM_LinkAlive());
+
+    /* The HMI's answer came late: the next call finds it and carries on */
+    uint8_t n = build_frame(wire, CMD_READY, 0, &caps, 1);
+    UART_SIM_Inject(wire, n);
+    TEST_ASSERT_EQUAL_UINT32(COMM_BAUD_FALLBACK, COMM_HandshakeInitiateUntil(CMD_ACK, Tick_Deadline(30)));
+    TEST_ASSERT_TRUE(COMM_LinkAlive());
+}
+
+void test_comm_respond_falls_back_without_ack(void) {
+    uint8_t wire[2 * COMM_MAX_WIRE_SIZE];
+    const uint8_t caps = 0x1F;
+    const uint8_t baud[4] = { 0x00, 0x01, 0xC2, 0x00 };    /* 115200 */
+    uint8_t status = 0;
+    UART_SIM_SetLoopback(false);
+
+    uint8_t n = build_frame(wire, CMD_READY, 0, &caps, 1);
+    n += build_frame(&wire[n], CMD_INIT, 1, baud, sizeof(baud));
+    UART_SIM_Inject(wire, n);
+
+    TEST_ASSERT_EQUAL_UINT32(COMM_BAUD_FALLBACK, COMM_HandshakeRespond(&status));
+    TEST_ASSERT_EQUAL_HEX8(CMD_INIT, status);
+    TEST_ASSERT_EQUAL_UINT32(COMM_BAUD_FALLBACK, UART_GetBaudRate());
+}
+
+void test_comm_respond_keeps_fallback_for_old_peer(void) {
+    uint8_t wire[2 * COMM_MAX_WIRE_SIZE];
+    uint8_t status = 0;
+    UART_SIM_SetLoopback(false);
+
+    /* Bare READY / ACK without caps or rate */
+    uint8_t n = build_frame(wire, CMD_READY, 0, NULL, 0);
+    n += build_frame(&wire[n], CMD_ACK, 1, NULL, 0);
+    UART_SIM_Inject(wire, n);
+
+    TEST_ASSERT_EQUAL_UINT32(COMM_BAUD_FALLBACK, COMM_HandshakeRespond(&status));
+    TEST_ASSERT_EQUAL_HEX8(CMD_ACK, status);
+}
+
+/* ---------- REQUEST LAYER TESTS ---------- */
+
+/* The other ECU: frames taken off the TX pin, replies injected on RX */
+static COMM_Frame peerInbox[COMM_MAX_PENDING + 1];
+static uint8_t peerCount;
+
+static void peer_collect(void) {
+    static COMM_Parser parser;
+    uint8_t wire[256];
+    UART_Flush();
+    UART_SIM_Service();
+    uint16_t n = UART_SIM_Drain(wire, sizeof(wire));
+    for (uint16_t i = 0; i < n; i++) {
+        if (COMM_ParseByte(&parser, wire[i]) == COMM_PARSE_FRAME && peerCount < COMM_MAX_PENDING + 1) {
+            peerInbox[peerCount++] = parser.frame;
+        }
+    }
+}
+
+static void peer_reply(uint8_t seq, uint8_t cmd) {
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+    uint8_t n = build_frame(wire, cmd, seq, NULL, 0);
+    UART_SIM_Inject(wire, n);
+}
+
+static uint8_t unsolicitedCount;
+static uint8_t unsolicitedCmd;
+
+static void count_unsolicited(const COMM_Frame *frame) {
+    unsolicitedCount++;
+    unsolicitedCmd = frame->cmd;
+}
+
+void test_request_replies_matched_out_of_order(void) {
+    const uint8_t timeout = 10;
+    COMM_Frame reply;
+    UART_SIM_SetLoopback(false);
+    peerCount = 0;
+
+    COMM_RequestHandle password = COMM_RequestSend(CMD_SEND_PASSWORD, (const uint8_t*)"12345", 5, 1000);
+    COMM_RequestHandle setTimeout = COMM_RequestSend(CMD_SET_TIMEOUT, &timeout, 1, 1000);
+    TEST_ASSERT_NOT_EQUAL(COMM_REQUEST_NONE, password);
+    TEST_ASSERT_NOT_EQUAL(COMM_REQUEST_NONE, setTimeout);
+
+    /* both requests are on the wire before any reply */
+    peer_collect();
+    TEST_ASSERT_EQUAL_UINT8(2, peerCount);
+    TEST_ASSERT_EQUAL_UINT8(2, COMM_RequestInUse());
+
+    /* answer the second one first */
+    peer_reply(peerInbox[1].seq, CMD_SUCCESS);
+    peer_reply(peerInbox[0].seq, CMD_PASSWORD_CORRECT);
+
+    TEST_ASSERT_EQUAL(COMM_REQ_DONE, COMM_RequestWait(password, &reply));
+    TEST_ASSERT_EQUAL_HEX8(CMD_PASSWORD_CORRECT, reply.cmd);
+    TEST_ASSERT_EQUAL(COMM_REQ_DONE, COMM_RequestWait(setTimeout, &reply));
+    TEST_ASSERT_EQUAL_HEX8(CMD_SUCCESS, reply.cmd);
+
+    COMM_RequestRelease(password);
+    COMM_RequestRelease(setTimeout);
+    TEST_ASSERT_EQUAL_UINT8(0, COMM_RequestInUse());
+}
+
+void test_request_timeouts_are_per_request(void) {
+    COMM_Frame reply;
+    UART_SIM_SetLoopback(false);
+    peerCount = 0;
+
+    COMM_RequestHandle shortWait = COMM_RequestSend(CMD_SEND_PASSWORD, (const uint8_t*)"12345", 5, 10);
+    COMM_RequestHandle longWait = COMM_RequestSend(CMD_DOOR_UNLOCK, NULL, 0, 1000);
+    peer_collect();
+
+    TEST_ASSERT_EQUAL(COMM_REQ_TIMEOUT, COMM_RequestWait(shortWait, &reply));
+    TEST_ASSERT_EQUAL(COMM_REQ_PENDING, COMM_RequestGetState(longWait));
+
+    peer_reply(peerInbox[1].seq, CMD_ACK);
+    TEST_ASSERT_EQUAL(COMM_REQ_DONE, COMM_RequestWait(longWait, &reply));
+    TEST_ASSERT_EQUAL_HEX8(CMD_ACK, reply.cmd);
+}
+
+void test_request_table_full(void) {
+    COMM_RequestHandle handles[COMM_MAX_PENDING];
+    UART_SIM_SetLoopback(false);
+
+    for (uint8_t i = 0; i < COMM_MAX_PENDING; i++) {
+        handles[i] = COMM_RequestSend(CMD_DOOR_UNLOCK, NULL, 0, 1000);
+        TEST_ASSERT_NOT_EQUAL(COMM_REQUEST_NONE, handles[i]);
+    }
+    TEST_ASSERT_EQUAL(COMM_REQUEST_NONE, COMM_RequestSend(CMD_DOOR_UNLOCK, NULL, 0, 1000));
+
+    COMM_RequestRelease(handles[1]);
+    TEST_ASSERT_EQUAL(handles[1], COMM_RequestSend(CMD_DOOR_UNLOCK, NULL, 0, 1000));
+}
+
+void test_request_unmatched_goes_to_handler(void) {
+    UART_SIM_SetLoopback(false);
+    peerCount = 0;
+    unsolicitedCount = 0;
+    COMM_RequestSetUnsolicitedHandler(count_unsolicited);
+
+    COMM_RequestHandle request = COMM_RequestSend(CMD_DOOR_UNLOCK, NULL, 0, 1000);
+    peer_collect();
+    COMM_RequestRelease(request);
+
+    /* a reply for a released request and a frame nobody asked for */
+    peer_reply(peerInbox[0].seq, CMD_FAIL);
+    peer_reply((uint8_t)(peerInbox[0].seq + 100), CMD_ALARM);
+    UART_SIM_Service();
+    COMM_RequestPoll();
+
+    TEST_ASSERT_EQUAL_UINT8(2, unsolicitedCount);
+    TEST_ASSERT_EQUAL_HEX8(CMD_ALARM, unsolicitedCmd);
+}
+
+/* ---------- RETRANSMISSION TESTS ---------- */
+
+/* Run the request layer until the peer has seen count frames or ms have passed */
+static void peer_collect_until(uint8_t count, uint32_t ms) {
+    uint32_t deadline = Tick_Deadline(ms);
+    while (peerCount < count && !Tick_Expired(deadline)) {
+        COMM_RequestPoll();
+        CPU_Idle();
+        peer_collect();
+    }
+}
+
+void test_request_reliable_retransmits_same_seq(void) {
+    COMM_Frame reply;
+    COMM_Stats stats;
+    UART_SIM_SetLoopback(false);
+    peerCount = 0;
+
+    COMM_RequestHandle request = COMM_RequestSendReliable(CMD_VERIFY_AND_UNLOCK,
+                                                          (const uint8_t*)"12345", 5, 1000);
+    peer_collect_until(2, COMM_RTO_INITIAL_MS * 2);
+    TEST_ASSERT_EQUAL_UINT8(2, peerCount);
+    TEST_ASSERT_EQUAL_UINT8(peerInbox[0].seq, peerInbox[1].seq);
+    TEST_ASSERT_EQUAL_MEMORY(peerInbox[0].payload, peerInbox[1].payload, 5);
+
+    peer_reply(peerInbox[1].seq, CMD_SUCCESS);
+    TEST_ASSERT_EQUAL(COMM_REQ_DONE, COMM_RequestWait(request, &reply));
+    COMM_GetStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.retries);
+    /* Karn: the reply may answer either copy, no sample taken */
+    TEST_ASSERT_EQUAL_UINT32(0, COMM_RequestSrtt());
+    TEST_ASSERT_EQUAL_UINT32(COMM_RTO_INITIAL_MS * 2, COMM_RequestRto());
+}
+
+void test_request_rto_follows_rtt(void) {
+    COMM_Frame reply;
+    UART_SIM_SetLoopback(false);
+
+    for (uint8_t i = 0; i < 8; i++) {
+        peerCount = 0;
+        COMM_RequestHandle request = COMM_RequestSendReliable(CMD_READY, NULL, 0, 1000);
+        peer_collect();
+        peer_reply(peerInbox[0].seq, CMD_ACK);
+        TEST_ASSERT_EQUAL(COMM_REQ_DONE, COMM_RequestWait(request, &reply));
+        COMM_RequestRelease(request);
+    }
+    /* Answered at once: the timeout shrinks to its floor, nothing was sent twice */
+    TEST_ASSERT_EQUAL_UINT32(COMM_RTO_MIN_MS, COMM_RequestRto());
+    TEST_ASSERT_EQUAL_UINT8(1, peerCount);
+}
+
+void test_request_duplicate_reply_dropped(void) {
+    COMM_Frame reply;
+    UART_SIM_SetLoopback(false);
+    peerCount = 0;
+    unsolicitedCount = 0;
+    COMM_RequestSetUnsolicitedHandler(count_unsolicited);
+
+    COMM_RequestHandle request = COMM_RequestSendReliable(CMD_DOOR_UNLOCK, NULL, 0, 1000);
+    peer_collect_until(2, COMM_RTO_INITIAL_MS * 2);
+
+    /* Both copies arrived, the peer answers the second from its cache */
+    peer_reply(peerInbox[0].seq, CMD_FAIL);
+    peer_reply(peerInbox[1].seq, CMD_FAIL);
+    TEST_ASSERT_EQUAL(COMM_REQ_DONE, COMM_RequestWait(request, &reply));
+    COMM_RequestRelease(request);
+    UART_SIM_Service();
+    COMM_RequestPoll();
+    TEST_ASSERT_EQUAL_UINT8(0, unsolicitedCount);
+}
+
+void test_reply_replayed_for_repeated_request(void) {
+    const uint8_t seconds = 15;
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+    uint8_t first[COMM_MAX_WIRE_SIZE];
+    uint8_t again[COMM_MAX_WIRE_SIZE];
+    COMM_Frame frame;
+    UART_SIM_SetLoopback(false);
+
+    uint8_t n = build_frame(wire, CMD_VERIFY_AND_UNLOCK, 7, (const uint8_t*)"12345", 5);
+    UART_SIM_Inject(wire, n);
+    UART_SIM_Service();
+    TEST_ASSERT_TRUE(COMM_PollFrame(&frame));
+    TEST_ASSERT_FALSE(COMM_ReplayReply(frame.cmd, frame.seq));
+    COMM_SendReply(frame.seq, CMD_SUCCESS, &seconds, 1);
+    UART_Flush();
+    UART_SIM_Service();
+    uint16_t size = UART_SIM_Drain(first, sizeof(first));
+
+    /* The same request again: answered from the cache, byte for byte */
+    UART_SIM_Inject(wire, n);
+    UART_SIM_Service();
+    TEST_ASSERT_TRUE(COMM_PollFrame(&frame));
+    TEST_ASSERT_TRUE(COMM_ReplayReply(frame.cmd, frame.seq));
+    UART_Flush();
+    UART_SIM_Service();
+    TEST_ASSERT_EQUAL_UINT16(size, UART_SIM_Drain(again, sizeof(again)));
+    TEST_ASSERT_EQUAL_MEMORY(first, again, size);
+
+    /* Another command or SEQ is a new request */
+    TEST_ASSERT_FALSE(COMM_ReplayReply(CMD_VERIFY_AND_CHANGE, 7));
+    TEST_ASSERT_FALSE(COMM_ReplayReply(CMD_VERIFY_AND_UNLOCK, 8));
+}
+
+/* Hand the frame to the link as the peer would send it, and take it off again */
+static void receive_frame(uint8_t cmd, uint8_t seq, const uint8_t *payload, uint8_t len,
+                          COMM_Frame *frame) {
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+    uint8_t n = build_frame(wire, cmd, seq, payload, len);
+    UART_SIM_Inject(wire, n);
+    UART_SIM_Service();
+    TEST_ASSERT_TRUE(COMM_PollFrame(frame));
+}
+
+void test_reply_not_replayed_after_seq_wraps(void) {
+    const uint8_t seconds = 15;
+    COMM_Frame frame;
+    UART_SIM_SetLoopback(false);
+
+    receive_frame(CMD_VERIFY_AND_UNLOCK, 7, (const uint8_t*)"12345", 5, &frame);
+    TEST_ASSERT_FALSE(COMM_ReplayReply(frame.cmd, frame.seq));
+    COMM_SendReply(frame.seq, CMD_SUCCESS, &seconds, 1);
+
+    /* A retransmission a few SEQs later is still answered from the cache */
+    receive_frame(CMD_HEARTBEAT, 8, NULL, 0, &frame);
+    receive_frame(CMD_HEARTBEAT, 9, NULL, 0, &frame);
+    receive_frame(CMD_VERIFY_AND_UNLOCK, 7, (const uint8_t*)"12345", 5, &frame);
+    TEST_ASSERT_TRUE(COMM_ReplayReply(frame.cmd, frame.seq));
+
+    /* Idle heartbeats take the SEQ all the way round */
+    for (uint8_t seq = 10; seq != 7; seq++) {
+        receive_frame(CMD_HEARTBEAT, seq, NULL, 0, &frame);
+    }
+
+    /* A new request on SEQ 7, with another password: it must be checked again */
+    receive_frame(CMD_VERIFY_AND_UNLOCK, 7, (const uint8_t*)"99999", 5, &frame);
+    TEST_ASSERT_FALSE(COMM_ReplayReply(frame.cmd, frame.seq));
+}
+
+/* ---------- FLOW CONTROL TESTS ---------- */
+
+/* Inject the grant a peer would send */
+static void inject_credit(uint16_t limit) {
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+    const uint8_t payload[COMM_CREDIT_LEN] = { (uint8_t)(limit >> 8), (uint8_t)limit };
+    uint8_t n = build_frame(wire, CMD_CREDIT, 0, payload, sizeof(payload));
+    UART_SIM_Inject(wire, n);
+    UART_SIM_Service();
+}
+
+/* Last CMD_CREDIT limit this side put on the wire, -1 if none */
+static int32_t drain_last_grant(void) {
+    uint8_t wire[256];
+    int32_t limit = -1;
+    COMM_Parser parser;
+    COMM_ParserReset(&parser);
+
+    UART_SIM_Service();
+    uint16_t n = UART_SIM_Drain(wire, sizeof(wire));
+    for (uint16_t i = 0; i < n; i++) {
+        if (COMM_ParseByte(&parser, wire[i]) == COMM_PARSE_FRAME && parser.frame.cmd == CMD_CREDIT) {
+            limit = (parser.frame.payload[0] << 8) | parser.frame.payload[1];
+        }
+    }
+    return limit;
+}
+
+void test_flow_reset_grants_window(void) {
+    UART_SIM_SetLoopback(false);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, COMM_FlowCredit());
+
+    COMM_FlowReset();
+    TEST_ASSERT_EQUAL_INT32(COMM_FLOW_WINDOW, drain_last_grant());
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, COMM_FlowCredit());   /* peer has not granted yet */
+}
+
+void test_flow_sender_waits_for_credit(void) {
+    const uint8_t frameSize = COMM_WIRE_SIZE(0);
+    COMM_FrameView view;
+    UART_SIM_SetLoopback(false);
+    COMM_FlowReset();
+    (void)drain_last_grant();
+
+    /* the grant is consumed by the comm layer, never handed out as a frame */
+    inject_credit(2 * frameSize);
+    TEST_ASSERT_FALSE(COMM_PeekFrame(&view));
+    TEST_ASSERT_EQUAL_UINT16(2 * frameSize, COMM_FlowCredit());
+
+    COMM_SendCommand(CMD_DOOR_UNLOCK);
+    COMM_SendCommand(CMD_DOOR_UNLOCK);
+    TEST_ASSERT_EQUAL_UINT16(0, COMM_FlowCredit());
+
+    /* a grant still waiting in the RX ring releases the sender at once */
+    inject_credit(3 * frameSize);
+    uint32_t start = GetTicks();
+    COMM_SendCommand(CMD_DOOR_UNLOCK);
+    TEST_ASSERT_TRUE(GetTicks() - start < COMM_FLOW_WAIT_MS);
+    TEST_ASSERT_EQUAL_UINT16(0, COMM_FlowCredit());
+
+    /* no grant at all: wait it out, then stop limiting */
+    start = GetTicks();
+    COMM_SendCommand(CMD_DOOR_UNLOCK);
+    TEST_ASSERT_TRUE(GetTicks() - start >= COMM_FLOW_WAIT_MS);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, COMM_FlowCredit());
+}
+
+void test_flow_receiver_grants_as_it_consumes(void) {
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+    COMM_Frame frame;
+    uint16_t consumed = 0;
+    UART_SIM_SetLoopback(false);
+    COMM_FlowReset();
+    TEST_ASSERT_EQUAL_INT32(COMM_FLOW_WINDOW, drain_last_grant());
+
+    /* frames still in the ring earn no credit back */
+    while (consumed < COMM_FLOW_UPDATE) {
+        uint8_t n = build_frame(wire, CMD_SEND_PASSWORD, 1, (const uint8_t*)"12345", 5);
+        UART_SIM_Inject(wire, n);
+        consumed += n;
+    }
+    UART_SIM_Service();
+    TEST_ASSERT_EQUAL_INT32(-1, drain_last_grant());
+
+    while (COMM_PollFrame(&frame)) { }
+    TEST_ASSERT_EQUAL_INT32(COMM_FLOW_UPDATE + COMM_FLOW_WINDOW, drain_last_grant());
+}
+
+/* ---------- LINK STATISTICS TESTS ---------- */
+
+void test_comm_stats_count_frames_and_crc_errors(void) {
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+    COMM_Frame frame;
+    COMM_Stats stats;
+    UART_SIM_SetLoopback(false);
+
+    uint8_t n = build_frame(wire, CMD_SEND_PASSWORD, 1, (const uint8_t*)"12345", 5);
+    wire[6] ^= 0x01;
+    UART_SIM_Inject(wire, n);
+    n = build_frame(wire, CMD_DOOR_UNLOCK, 2, NULL, 0);
+    UART_SIM_Inject(wire, n);
+    UART_SIM_Service();
+    TEST_ASSERT_TRUE(COMM_PollFrame(&frame));
+    COMM_SendReply(frame.seq, CMD_ACK, NULL, 0);
+
+    COMM_GetStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.framesIn);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.framesOut);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.crcErrors);
+    TEST_ASSERT_EQUAL_UINT32(COMM_WIRE_SIZE(5) + COMM_WIRE_SIZE(0), stats.bytesIn);
+}
+
+void test_comm_stats_encode_decode_round_trip(void) {
+    COMM_Stats in = {
+        .bytesIn = 0x01020304, .bytesOut = 5, .framesIn = 6, .framesOut = 7,
+        .crcErrors = 8, .framingErrors = 9, .overrunErrors = 10,
+        .retries = 11, .timeouts = 0x12345, .maxRttMs = 250
+    };
+    COMM_Stats out;
+    uint8_t payload[COMM_STATS_LEN];
+
+    COMM_EncodeStats(&in, payload);
+    TEST_ASSERT_EQUAL_HEX8(0x01, payload[0]);
+    TEST_ASSERT_TRUE(COMM_DecodeStats(payload, COMM_STATS_LEN, &out));
+    TEST_ASSERT_EQUAL_UINT32(in.bytesIn, out.bytesIn);
+    TEST_ASSERT_EQUAL_UINT32(in.framesOut, out.framesOut);
+    TEST_ASSERT_EQUAL_UINT32(in.retries, out.retries);
+    TEST_ASSERT_EQUAL_UINT32(in.maxRttMs, out.maxRttMs);
+    /* 16-bit fields saturate instead of wrapping */
+    TEST_ASSERT_EQUAL_UINT32(0xFFFF, out.timeouts);
+    TEST_ASSERT_FALSE(COMM_DecodeStats(payload, COMM_STATS_LEN - 1, &out));
+}
+
+void test_request_stats_count_timeouts_and_rtt(void) {
+    COMM_Frame reply;
+    COMM_Stats stats;
+    UART_SIM_SetLoopback(false);
+    peerCount = 0;
+
+    COMM_RequestHandle lost = COMM_RequestSend(CMD_SEND_PASSWORD, (const uint8_t*)"12345", 5, 10);
+    COMM_RequestHandle answered = COMM_RequestSend(CMD_DOOR_UNLOCK, NULL, 0, 1000);
+    peer_collect();
+
+    TEST_ASSERT_EQUAL(COMM_REQ_TIMEOUT, COMM_RequestWait(lost, &reply));
+    peer_reply(peerInbox[1].seq, CMD_ACK);
+    TEST_ASSERT_EQUAL(COMM_REQ_DONE, COMM_RequestWait(answered, &reply));
+
+    COMM_GetStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.timeouts);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.framesOut);
+    TEST_ASSERT_TRUE(stats.maxRttMs >= 10);
+}
+
+/* ---------- LINK SUPERVISION TESTS ---------- */
+/* Built with short COMM_HEARTBEAT_MS / COMM_LINK_TIMEOUT_MS, see CMakeLists.txt */
+
+/* Handshake as the HMI with a peer that has every feature, then run at a negotiated rate */
+static void link_up(void) {
+    uint8_t wire[2 * COMM_MAX_WIRE_SIZE];
+    const uint8_t ready[COMM_READY_LEN] = { 0x1F, COMM_PROTOCOL_VERSION, COMM_FEATURES };
+    uint8_t status = 0;
+    UART_SIM_SetLoopback(false);
+
+    uint8_t n = build_frame(wire, CMD_READY, 0, ready, sizeof(ready));
+    n += build_frame(&wire[n], CMD_ACK, 1, NULL, 0);
+    UART_SIM_Inject(wire, n);
+    COMM_HandshakeRespond(&status);
+    COMM_LinkInit();
+    UART_SetBaudRate(115200);
+    peerCount = 0;
+}
+
+void test_link_alive_until_silence(void) {
+    link_up();
+    TEST_ASSERT_TRUE(COMM_LinkAlive());
+
+    uint32_t deadline = Tick_Deadline(COMM_LINK_TIMEOUT_MS + 20);
+    while (!Tick_Expired(deadline)) {
+        CPU_Idle();
+    }
+    TEST_ASSERT_FALSE(COMM_LinkAlive());
+}
+
+void test_link_heartbeat_when_idle(void) {
+    uint8_t status;
+    link_up();
+
+    /* Credit grants may go out first, the heartbeat is the last frame */
+    uint32_t deadline = Tick_Deadline(COMM_HEARTBEAT_MS * 2);
+    while ((peerCount == 0 || peerInbox[peerCount - 1].cmd != CMD_HEARTBEAT) &&
+           !Tick_Expired(deadline)) {
+        TEST_ASSERT_EQUAL(COMM_LINK_UP, COMM_LinkService(&status));
+        CPU_Idle();
+        peer_collect();
+    }
+    TEST_ASSERT_TRUE(peerCount > 0);
+    TEST_ASSERT_EQUAL_HEX8(CMD_HEARTBEAT, peerInbox[peerCount - 1].cmd);
+    TEST_ASSERT_TRUE(COMM_LinkIdleMs() >= COMM_HEARTBEAT_MS);
+
+    /* The answer counts as traffic, silence starts over */
+    peer_reply(peerInbox[peerCount - 1].seq, CMD_HEARTBEAT);
+    deadline = Tick_Deadline(20);
+    while (COMM_LinkIdleMs() >= COMM_HEARTBEAT_MS && !Tick_Expired(deadline)) {
+        COMM_LinkService(&status);
+        CPU_Idle();
+    }
+    TEST_ASSERT_TRUE(COMM_LinkIdleMs() < COMM_HEARTBEAT_MS);
+}
+
+void test_link_peer_ready_ends_session(void) {
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+    const uint8_t caps = 0x1F;
+    link_up();
+
+    /* A restarted Control opens with READY and its caps, valid as any frame */
+    uint8_t n = build_frame(wire, CMD_READY, 0, &caps, 1);
+    UART_SIM_Inject(wire, n);
+    uint32_t deadline = Tick_Deadline(20);
+    while (COMM_LinkAlive() && !Tick_Expired(deadline)) {
+        COMM_RequestPoll();
+        CPU_Idle();
+    }
+    TEST_ASSERT_FALSE(COMM_LinkAlive());
+}
+
+void test_link_reconnects_after_peer_reset(void) {
+    uint8_t wire[2 * COMM_MAX_WIRE_SIZE];
+    uint8_t status = 0;
+    COMM_LinkState state = COMM_LINK_UP;
+    link_up();
+    COMM_RequestHandle request = COMM_RequestSend(CMD_DOOR_UNLOCK, NULL, 0, 10000);
+
+    /* Silence: the link drops back to the handshake rate */
+    uint32_t deadline = Tick_Deadline(COMM_LINK_TIMEOUT_MS * 2);
+    while (state != COMM_LINK_DOWN && !Tick_Expired(deadline)) {
+        state = COMM_LinkService(&status);
+        CPU_Idle();
+        peer_collect();
+    }
+    TEST_ASSERT_EQUAL(COMM_LINK_DOWN, state);
+    TEST_ASSERT_EQUAL_UINT32(COMM_BAUD_FALLBACK, UART_GetBaudRate());
+
+    /* Control back with a blank EEPROM */
+    uint8_t n = build_frame(wire, CMD_READY, 0, NULL, 0);
+    n += build_frame(&wire[n], CMD_INIT, 1, NULL, 0);
+    UART_SIM_Inject(wire, n);
+    TEST_ASSERT_EQUAL(COMM_LINK_RECONNECTED, COMM_LinkService(&status));
+    TEST_ASSERT_EQUAL_HEX8(CMD_INIT, status);
+    TEST_ASSERT_TRUE(COMM_LinkAlive());
+    /* The old session's request will not be answered any more */
+    TEST_ASSERT_EQUAL(COMM_REQ_TIMEOUT, COMM_RequestGetState(request));
+}
+
+void test_link_reconnect_drops_half_frame(void) {
+    uint8_t wire[2 * COMM_MAX_WIRE_SIZE];
+    uint8_t payload[COMM_MAX_PAYLOAD];
+    uint8_t status = 0;
+    COMM_LinkState state = COMM_LINK_UP;
+    COMM_FrameView view;
+    COMM_Stats stats;
+    link_up();
+
+    /* Control resets partway through a long frame: no delimiter after it */
+    memset(payload, 0x55, sizeof(payload));
+    uint8_t n = build_frame(wire, CMD_STATS, 9, payload, sizeof(payload));
+    UART_SIM_Inject(wire, (uint8_t)(n - 1));
+    UART_SIM_Service();
+    TEST_ASSERT_FALSE(COMM_PeekFrame(&view));
+
+    uint32_t deadline = Tick_Deadline(COMM_LINK_TIMEOUT_MS * 2);
+    while (state != COMM_LINK_DOWN && !Tick_Expired(deadline)) {
+        state = COMM_LinkService(&status);
+        CPU_Idle();
+    }
+    TEST_ASSERT_EQUAL(COMM_LINK_DOWN, state);
+
+    n = build_frame(wire, CMD_READY, 0, NULL, 0);
+    n += build_frame(&wire[n], CMD_ACK, 1, NULL, 0);
+    UART_SIM_Inject(wire, n);
+    TEST_ASSERT_EQUAL(COMM_LINK_RECONNECTED, COMM_LinkService(&status));
+    COMM_ResetStats();
+
+    /* Two short frames of the new session: each found at its own delimiter */
+    n = build_frame(wire, CMD_ALARM, 2, NULL, 0);
+    n += build_frame(&wire[n], CMD_HEARTBEAT, 3, NULL, 0);
+    UART_SIM_Inject(wire, n);
+    UART_SIM_Service();
+    TEST_ASSERT_TRUE(COMM_PeekFrame(&view));
+    TEST_ASSERT_EQUAL_HEX8(CMD_ALARM, view.cmd);
+    COMM_ReleaseFrame(&view);
+    TEST_ASSERT_TRUE(COMM_PeekFrame(&view));
+    TEST_ASSERT_EQUAL_HEX8(CMD_HEARTBEAT, view.cmd);
+    COMM_ReleaseFrame(&view);
+    COMM_GetStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.crcErrors);
+}
+
+/* ---------- PROTOCOL TABLE TESTS ---------- */
+
+void test_protocol_table_describes_commands(void) {
+    const COMM_CommandInfo *info = COMM_GetCommandInfo(CMD_VERIFY_AND_SET_TIMEOUT);
+    TEST_ASSERT_NOT_NULL(info);
+    TEST_ASSERT_EQUAL_STRING("CMD_VERIFY_AND_SET_TIMEOUT", info->name);
+    TEST_ASSERT_EQUAL_UINT8(COMM_VERIFY_AND_SET_TIMEOUT_LEN, info->minLen);
+    TEST_ASSERT_EQUAL_UINT8(COMM_VERIFY_AND_SET_TIMEOUT_LEN, info->maxLen);
+    TEST_ASSERT_EQUAL_UINT8(COMM_PASSWORD_LENGTH, info->digits);
+    TEST_ASSERT_EQUAL_HEX8(COMM_FEATURE_COMPOUND, info->feature);
+
+    TEST_ASSERT_NULL(COMM_GetCommandInfo(0x00));
+    TEST_ASSERT_NULL(COMM_GetCommandInfo(CMD_BOOT + 1));
+    TEST_ASSERT_EQUAL_STRING("CMD_HEARTBEAT", COMM_CommandName(CMD_HEARTBEAT));
+    TEST_ASSERT_EQUAL_STRING("?", COMM_CommandName(0xFF));
+}
+
+void test_protocol_check_payload(void) {
+    const uint8_t setTimeout[COMM_VERIFY_AND_SET_TIMEOUT_LEN] = { '1', '2', '3', '4', '5', 0x00 };
+
+    TEST_ASSERT_EQUAL(COMM_CHECK_OK, COMM_CheckPayload(CMD_SEND_PASSWORD,
+                      (const uint8_t*)"12345", 5, COMM_FROM_HMI));
+    TEST_ASSERT_EQUAL(COMM_CHECK_MALFORMED, COMM_CheckPayload(CMD_SEND_PASSWORD,
+                      (const uint8_t*)"1234", 4, COMM_FROM_HMI));
+    TEST_ASSERT_EQUAL(COMM_CHECK_MALFORMED, COMM_CheckPayload(CMD_SEND_PASSWORD,
+                      (const uint8_t*)"12#45", 5, COMM_FROM_HMI));
+    /* The seconds byte after the password is raw */
+    TEST_ASSERT_EQUAL(COMM_CHECK_OK, COMM_CheckPayload(CMD_VERIFY_AND_SET_TIMEOUT,
+                      setTimeout, sizeof(setTimeout), COMM_FROM_HMI));
+
+    /* Replies are not requests, and gaps in the ID range are no commands */
+    TEST_ASSERT_EQUAL(COMM_CHECK_UNKNOWN, COMM_CheckPayload(CMD_SUCCESS, NULL, 0, COMM_FROM_HMI));
+    TEST_ASSERT_EQUAL(COMM_CHECK_OK, COMM_CheckPayload(CMD_SUCCESS, NULL, 0, COMM_FROM_CONTROL));
+    TEST_ASSERT_EQUAL(COMM_CHECK_UNKNOWN, COMM_CheckPayload(0x05, NULL, 0, COMM_FROM_HMI));
+}
+
+void test_protocol_features_negotiated_in_handshake(void) {
+    uint8_t wire[2 * COMM_MAX_WIRE_SIZE];
+    /* Bit 7 is no feature this build knows, it is dropped */
+    const uint8_t ready[COMM_READY_LEN] = { 0x1F, COMM_PROTOCOL_VERSION, COMM_FEATURE_COMPOUND | 0x80 };
+    uint8_t status = 0;
+    UART_SIM_SetLoopback(false);
+    peerCount = 0;
+
+    uint8_t n = build_frame(wire, CMD_READY, 0, ready, sizeof(ready));
+    n += build_frame(&wire[n], CMD_ACK, 1, NULL, 0);
+    UART_SIM_Inject(wire, n);
+    COMM_HandshakeRespond(&status);
+
+    TEST_ASSERT_EQUAL_HEX8(COMM_FEATURE_COMPOUND, COMM_Features());
+    TEST_ASSERT_TRUE(COMM_PeerSupports(CMD_VERIFY_AND_UNLOCK));
+    TEST_ASSERT_TRUE(COMM_PeerSupports(CMD_SEND_PASSWORD));
+    TEST_ASSERT_FALSE(COMM_PeerSupports(CMD_HEARTBEAT));
+    TEST_ASSERT_EQUAL(COMM_CHECK_UNSUPPORTED, COMM_CheckPayload(CMD_STATS, NULL, 0, COMM_FROM_HMI));
+
+    /* Our READY announced this build, and the peer got no credit it cannot read */
+    peer_collect();
+    TEST_ASSERT_EQUAL_UINT8(1, peerCount);
+    TEST_ASSERT_EQUAL_HEX8(CMD_READY, peerInbox[0].cmd);
+    TEST_ASSERT_EQUAL_UINT8(COMM_READY_LEN, peerInbox[0].len);
+    TEST_ASSERT_EQUAL_UINT8(COMM_PROTOCOL_VERSION, peerInbox[0].payload[1]);
+    TEST_ASSERT_EQUAL_HEX8(COMM_FEATURES, peerInbox[0].payload[2]);
+}
+
+void test_protocol_version1_peer_has_no_features(void) {
+    uint8_t wire[2 * COMM_MAX_WIRE_SIZE];
+    const uint8_t caps = 0x1F;
+    uint8_t status = 0;
+    UART_SIM_SetLoopback(false);
+
+    uint8_t n = build_frame(wire, CMD_READY, 0, &caps, 1);
+    n += build_frame(&wire[n], CMD_ACK, 1, NULL, 0);
+    UART_SIM_Inject(wire, n);
+    COMM_HandshakeRespond(&status);
+
+    TEST_ASSERT_EQUAL_HEX8(0, COMM_Features());
+    TEST_ASSERT_FALSE(COMM_PeerSupports(CMD_VERIFY_AND_CHANGE));
+    TEST_ASSERT_TRUE(COMM_PeerSupports(CMD_CHANGE_PASSWORD));
+    /* Without heartbeats silence does not end the link */
+    TEST_ASSERT_TRUE(COMM_LinkAlive());
+}
+
+/* ---------- DISPATCH TESTS ---------- */
+
+static uint8_t handledCount;
+static void handle_password(const COMM_FrameView *frame) {
+    handledCount++;
+    COMM_SendReply(frame->seq, CMD_PASSWORD_CORRECT, NULL, 0);
+}
+
+static const COMM_CommandHandler testHandlers[COMM_COMMAND_SLOTS] = {
+    [COMM_COMMAND_INDEX(CMD_SEND_PASSWORD)] = handle_password,
+    [COMM_COMMAND_INDEX(CMD_PROFILE)]       = COMM_DispatchProfileHandler,
+};
+
+static COMM_CheckResult dispatch(uint8_t cmd, uint8_t seq, const void *payload, uint8_t len) {
+    COMM_FrameView frame = { .cmd = cmd, .seq = seq, .len = len, .payload = payload };
+    return COMM_Dispatch(&frame);
+}
+
+static void dispatch_setup(void) {
+    UART_SIM_SetLoopback(false);
+    COMM_DispatchInit(testHandlers, COMM_FROM_HMI);
+    handledCount = 0;
+    peerCount = 0;
+}
+
+void test_dispatch_runs_handler_and_accounts(void) {
+    COMM_Profile profile;
+    dispatch_setup();
+
+    TEST_ASSERT_EQUAL(COMM_CHECK_OK, dispatch(CMD_SEND_PASSWORD, 3, "12345", 5));
+    TEST_ASSERT_EQUAL(COMM_CHECK_OK, dispatch(CMD_SEND_PASSWORD, 4, "54321", 5));
+    TEST_ASSERT_EQUAL_UINT8(2, handledCount);
+    peer_collect();
+    TEST_ASSERT_EQUAL_UINT8(2, peerCount);
+    TEST_ASSERT_EQUAL_HEX8(CMD_PASSWORD_CORRECT, peerInbox[1].cmd);
+    TEST_ASSERT_EQUAL_UINT8(4, peerInbox[1].seq);
+
+    COMM_DispatchGetProfile(CMD_SEND_PASSWORD, &profile);
+    TEST_ASSERT_EQUAL_UINT32(2, profile.count);
+    TEST_ASSERT_EQUAL_UINT32(0, profile.rejected);
+    TEST_ASSERT_TRUE(profile.minCycles <= profile.avgCycles);
+    TEST_ASSERT_TRUE(profile.avgCycles <= profile.maxCycles);
+
+    COMM_DispatchResetProfile();
+    COMM_DispatchGetProfile(CMD_SEND_PASSWORD, &profile);
+    TEST_ASSERT_EQUAL_UINT32(0, profile.count);
+    TEST_ASSERT_EQUAL_UINT32(0, profile.maxCycles);
+}
+
+void test_dispatch_refuses_without_running_handler(void) {
+    COMM_Profile profile;
+    dispatch_setup();
+
+    /* Malformed payload, no handler for the command, no such command */
+    TEST_ASSERT_EQUAL(COMM_CHECK_MALFORMED, dispatch(CMD_SEND_PASSWORD, 1, "12#45", 5));
+    TEST_ASSERT_EQUAL(COMM_CHECK_UNKNOWN, dispatch(CMD_DOOR_LOCK, 2, NULL, 0));
+    TEST_ASSERT_EQUAL(COMM_CHECK_UNKNOWN, dispatch(0x05, 3, NULL, 0));
+    TEST_ASSERT_EQUAL_UINT8(0, handledCount);
+
+    peer_collect();
+    TEST_ASSERT_EQUAL_UINT8(3, peerCount);
+    TEST_ASSERT_EQUAL_HEX8(CMD_FAIL, peerInbox[0].cmd);
+    TEST_ASSERT_EQUAL_HEX8(CMD_UNKNOWN, peerInbox[1].cmd);
+    TEST_ASSERT_EQUAL_HEX8(CMD_UNKNOWN, peerInbox[2].cmd);
+    TEST_ASSERT_EQUAL_UINT8(3, peerInbox[2].seq);
+
+    COMM_DispatchGetProfile(CMD_SEND_PASSWORD, &profile);
+    TEST_ASSERT_EQUAL_UINT32(0, profile.count);
+    TEST_ASSERT_EQUAL_UINT32(1, profile.rejected);
+    COMM_DispatchGetProfile(CMD_DOOR_LOCK, &profile);
+    TEST_ASSERT_EQUAL_UINT32(1, profile.rejected);
+    COMM_DispatchGetProfile(0x05, &profile);
+    TEST_ASSERT_EQUAL_UINT32(1, profile.rejected);
+}
+
+void test_dispatch_profile_read_over_link(void) {
+    const uint8_t query = CMD_SEND_PASSWORD;
+    COMM_Profile profile;
+    dispatch_setup();
+
+    (void)dispatch(CMD_SEND_PASSWORD, 1, "12345", 5);
+    (void)dispatch(CMD_SEND_PASSWORD, 2, "1", 1);
+    TEST_ASSERT_EQUAL(COMM_CHECK_OK, dispatch(CMD_PROFILE, 3, &query, sizeof(query)));
+
+    peer_collect();
+    TEST_ASSERT_EQUAL_UINT8(3, peerCount);
+    TEST_ASSERT_EQUAL_HEX8(CMD_PROFILE, peerInbox[2].cmd);
+    TEST_ASSERT_TRUE(COMM_DecodeProfile(peerInbox[2].payload, peerInbox[2].len, &profile));
+    TEST_ASSERT_EQUAL_HEX8(CMD_SEND_PASSWORD, profile.cmd);
+    TEST_ASSERT_EQUAL_UINT32(1, profile.count);
+    TEST_ASSERT_EQUAL_UINT32(1, profile.rejected);
+
+    /* A profile sent back is no query */
+    TEST_ASSERT_EQUAL(COMM_CHECK_OK, dispatch(CMD_PROFILE, 4, peerInbox[2].payload, peerInbox[2].len));
+    peer_collect();
+    TEST_ASSERT_EQUAL_HEX8(CMD_FAIL, peerInbox[3].cmd);
+}
+
+/* ---------- BOOT PROFILE TESTS ---------- */
+
+void test_boot_profile_encode_decode_round_trip(void) {
+    BOOT_Profile in = { .marked = (1u << BOOT_COMM) | (1u << BOOT_LINK) | (1u << BOOT_SPLASH) };
+    in.us[BOOT_COMM] = 180;             /* 0.1 ms resolution on the wire */
+    in.us[BOOT_LINK] = 41250;
+    in.us[BOOT_SPLASH] = 9000000;       /* past 6.5535 s */
+    BOOT_Profile out;
+    uint8_t payload[COMM_BOOT_LEN + 1];
+
+    uint8_t len = BOOT_Encode(&in, payload);
+    TEST_ASSERT_EQUAL_UINT8(3 * COMM_BOOT_MARK_LEN, len);
+    TEST_ASSERT_EQUAL(COMM_CHECK_OK, COMM_CheckPayload(CMD_BOOT, payload, len, COMM_FROM_HMI));
+    TEST_ASSERT_TRUE(BOOT_Decode(payload, len, &out));
+    TEST_ASSERT_EQUAL_HEX16(in.marked, out.marked);
+    TEST_ASSERT_EQUAL_UINT32(100, out.us[BOOT_COMM]);
+    TEST_ASSERT_EQUAL_UINT32(41200, out.us[BOOT_LINK]);
+    /* Saturates instead of wrapping */
+    TEST_ASSERT_EQUAL_UINT32(0xFFFFu * 100u, out.us[BOOT_SPLASH]);
+
+    char text[64];
+    BOOT_Format(&out, text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("comm 0.1 link 41.2 splash 6553.5", text);
+
+    /* Part of a mark, or a step this build does not know */
+    TEST_ASSERT_FALSE(BOOT_Decode(payload, len - 1, &out));
+    payload[0] = BOOT_STEP_COUNT;
+    TEST_ASSERT_FALSE(BOOT_Decode(payload, len, &out));
+    TEST_ASSERT_EQUAL(COMM_CHECK_MALFORMED,
+                      COMM_CheckPayload(CMD_BOOT, payload, COMM_BOOT_LEN + 1, COMM_FROM_HMI));
+}
+
+void test_boot_profile_keeps_first_mark(void) {
+    BOOT_Profile profile;
+    BOOT_Start();
+    BOOT_Mark(BOOT_COMM);
+    BOOT_Get(&profile);
+    uint32_t first = profile.us[BOOT_COMM];
+    TEST_ASSERT_EQUAL_HEX16(1u << BOOT_COMM, profile.marked);
+
+    uint64_t later = CLOCK_NowUs() + 2000;
+    while (CLOCK_NowUs() < later) {
+    }
+    BOOT_Mark(BOOT_COMM);
+    BOOT_Mark(BOOT_READY);
+    BOOT_Get(&profile);
+    TEST_ASSERT_EQUAL_UINT32(first, profile.us[BOOT_COMM]);
+    TEST_ASSERT_TRUE(profile.us[BOOT_READY] >= first + 2000);
+
+    /* A new boot forgets the old marks */
+    BOOT_Start();
+    BOOT_Get(&profile);
+    TEST_ASSERT_EQUAL_HEX16(0, profile.marked);
+}
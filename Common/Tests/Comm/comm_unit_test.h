@@ -0,0 +1,93 @@
+#ifndef COMM_UNIT_TEST_H
+#define COMM_UNIT_TEST_H
+
+/* Unity test setup/teardown */
+void setUp(void);
+void tearDown(void);
+
+/* ---------- CRC TESTS ---------- */
+void test_crc16_check_value(void);
+
+/* ---------- PARSER TESTS ---------- */
+void test_parser_accepts_valid_frame(void);
+void test_parser_accepts_newline_in_payload(void);
+void test_encode_frame_matches_reference_cobs(void);
+void test_parser_rejects_bad_crc(void);
+void test_parser_rejects_oversized_length(void);
+void test_parser_resyncs_after_garbage(void);
+void test_parser_never_reads_payload_as_command(void);
+
+/* ---------- FRAME TRANSPORT TESTS ---------- */
+void test_comm_frame_round_trip(void);
+void test_comm_command_round_trip(void);
+void test_comm_poll_frame_partial(void);
+void test_comm_async_frame_round_trip(void);
+void test_comm_async_frame_with_zero_in_payload(void);
+
+/* ---------- BOUNDED RECEIVE TESTS ---------- */
+void test_tick_expired_across_wrap(void);
+void test_comm_try_receive_empty(void);
+void test_comm_receive_until_times_out(void);
+void test_comm_receive_until_returns_frame(void);
+void test_comm_wait_for_command_skips_others(void);
+
+/* ---------- CALLER-SIZED AND ZERO-COPY RECEIVE TESTS ---------- */
+void test_comm_receive_message_respects_capacity(void);
+void test_comm_peek_frame_is_zero_copy(void);
+void test_comm_peek_frame_across_ring_wrap(void);
+void test_comm_peek_frame_skips_corrupt_frame(void);
+
+/* ---------- BAUD NEGOTIATION TESTS ---------- */
+void test_comm_caps_follow_clock(void);
+void test_comm_select_highest_common_rate(void);
+void test_comm_initiate_falls_back_without_probe(void);
+void test_comm_initiate_until_gives_up(void);
+void test_comm_respond_falls_back_without_ack(void);
+void test_comm_respond_keeps_fallback_for_old_peer(void);
+
+/* ---------- REQUEST LAYER TESTS ---------- */
+void test_request_replies_matched_out_of_order(void);
+void test_request_timeouts_are_per_request(void);
+void test_request_table_full(void);
+void test_request_unmatched_goes_to_handler(void);
+
+/* ---------- RETRANSMISSION TESTS ---------- */
+void test_request_reliable_retransmits_same_seq(void);
+void test_request_rto_follows_rtt(void);
+void test_request_duplicate_reply_dropped(void);
+void test_reply_replayed_for_repeated_request(void);
+void test_reply_not_replayed_after_seq_wraps(void);
+
+/* ---------- FLOW CONTROL TESTS ---------- */
+void test_flow_reset_grants_window(void);
+void test_flow_sender_waits_for_credit(void);
+void test_flow_receiver_grants_as_it_consumes(void);
+
+/* ---------- LINK STATISTICS TESTS ---------- */
+void test_comm_stats_count_frames_and_crc_errors(void);
+void test_comm_stats_encode_decode_round_trip(void);
+void test_request_stats_count_timeouts_and_rtt(void);
+
+/* ---------- LINK SUPERVISION TESTS ---------- */
+void test_link_alive_until_silence(void);
+void test_link_heartbeat_when_idle(void);
+void test_link_peer_ready_ends_session(void);
+void test_link_reconnects_after_peer_reset(void);
+void test_link_reconnect_drops_half_frame(void);
+
+/* ---------- PROTOCOL TABLE TESTS ---------- */
+void test_protocol_table_describes_commands(void);
+void test_protocol_check_payload(void);
+void test_protocol_features_negotiated_in_handshake(void);
+void test_protocol_version1_peer_has_no_features(void);
+
+/* ---------- DISPATCH TESTS ---------- */
+void test_dispatch_runs_handler_and_accounts(void);
+void test_dispatch_refuses_without_running_handler(void);
+void test_dispatch_profile_read_over_link(void);
+
+/* ---------- BOOT PROFILE TESTS ---------- */
+void test_boot_profile_encode_decode_round_trip(void);
+void test_boot_profile_keeps_first_mark(void);
+
+#endif // COMM_UNIT_TEST_H
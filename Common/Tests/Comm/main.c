@@ -0,0 +1,93 @@
+#include "../../../External/unity.h"
+#include "comm_unit_test.h"
+
+int main(void) {
+    UNITY_BEGIN();  // Initialize Unity
+
+    /* ---------- CRC TESTS ---------- */
+    RUN_TEST(test_crc16_check_value);
+
+    /* ---------- PARSER TESTS ---------- */
+    RUN_TEST(test_parser_accepts_valid_frame);
+    RUN_TEST(test_parser_accepts_newline_in_payload);
+    RUN_TEST(test_encode_frame_matches_reference_cobs);
+    RUN_TEST(test_parser_rejects_bad_crc);
+    RUN_TEST(test_parser_rejects_oversized_length);
+    RUN_TEST(test_parser_resyncs_after_garbage);
+    RUN_TEST(test_parser_never_reads_payload_as_command);
+
+    /* ---------- FRAME TRANSPORT TESTS ---------- */
+    RUN_TEST(test_comm_frame_round_trip);
+    RUN_TEST(test_comm_command_round_trip);
+    RUN_TEST(test_comm_poll_frame_partial);
+    RUN_TEST(test_comm_async_frame_round_trip);
+    RUN_TEST(test_comm_async_frame_with_zero_in_payload);
+
+    /* ---------- BOUNDED RECEIVE TESTS ---------- */
+    RUN_TEST(test_tick_expired_across_wrap);
+    RUN_TEST(test_comm_try_receive_empty);
+    RUN_TEST(test_comm_receive_until_times_out);
+    RUN_TEST(test_comm_receive_until_returns_frame);
+    RUN_TEST(test_comm_wait_for_command_skips_others);
+
+    /* ---------- CALLER-SIZED AND ZERO-COPY RECEIVE TESTS ---------- */
+    RUN_TEST(test_comm_receive_message_respects_capacity);
+    RUN_TEST(test_comm_peek_frame_is_zero_copy);
+    RUN_TEST(test_comm_peek_frame_across_ring_wrap);
+    RUN_TEST(test_comm_peek_frame_skips_corrupt_frame);
+
+    /* ---------- BAUD NEGOTIATION TESTS ---------- */
+    RUN_TEST(test_comm_caps_follow_clock);
+    RUN_TEST(test_comm_select_highest_common_rate);
+    RUN_TEST(test_comm_initiate_falls_back_without_probe);
+    RUN_TEST(test_comm_initiate_until_gives_up);
+    RUN_TEST(test_comm_respond_falls_back_without_ack);
+    RUN_TEST(test_comm_respond_keeps_fallback_for_old_peer);
+
+    /* ---------- REQUEST LAYER TESTS ---------- */
+    RUN_TEST(test_request_replies_matched_out_of_order);
+    RUN_TEST(test_request_timeouts_are_per_request);
+    RUN_TEST(test_request_table_full);
+    RUN_TEST(test_request_unmatched_goes_to_handler);
+
+    /* ---------- RETRANSMISSION TESTS ---------- */
+    RUN_TEST(test_request_reliable_retransmits_same_seq);
+    RUN_TEST(test_request_rto_follows_rtt);
+    RUN_TEST(test_request_duplicate_reply_dropped);
+    RUN_TEST(test_reply_replayed_for_repeated_request);
+    RUN_TEST(test_reply_not_replayed_after_seq_wraps);
+
+    /* ---------- FLOW CONTROL TESTS ---------- */
+    RUN_TEST(test_flow_reset_grants_window);
+    RUN_TEST(test_flow_sender_waits_for_credit);
+    RUN_TEST(test_flow_receiver_grants_as_it_consumes);
+
+    /* ---------- LINK STATISTICS TESTS ---------- */
+    RUN_TEST(test_comm_stats_count_frames_and_crc_errors);
+    RUN_TEST(test_comm_stats_encode_decode_round_trip);
+    RUN_TEST(test_request_stats_count_timeouts_and_rtt);
+
+    /* ---------- LINK SUPERVISION TESTS ---------- */
+    RUN_TEST(test_link_alive_until_silence);
+    RUN_TEST(test_link_heartbeat_when_idle);
+    RUN_TEST(test_link_peer_ready_ends_session);
+    RUN_TEST(test_link_reconnects_after_peer_reset);
+    RUN_TEST(test_link_reconnect_drops_half_frame);
+
+    /* ---------- PROTOCOL TABLE TESTS ---------- */
+    RUN_TEST(test_protocol_table_describes_commands);
+    RUN_TEST(test_protocol_check_payload);
+    RUN_TEST(test_protocol_features_negotiated_in_handshake);
+    RUN_TEST(test_protocol_version1_peer_has_no_features);
+
+    /* ---------- DISPATCH TESTS ---------- */
+    RUN_TEST(test_dispatch_runs_handler_and_accounts);
+    RUN_TEST(test_dispatch_refuses_without_running_handler);
+    RUN_TEST(test_dispatch_profile_read_over_link);
+
+    /* ---------- BOOT PROFILE TESTS ---------- */
+    RUN_TEST(test_boot_profile_encode_decode_round_trip);
+    RUN_TEST(test_boot_profile_keeps_first_mark);
+
+    return UNITY_END();  // Print summary
+}
@@ -0,0 +1,29 @@
+#include "../../../External/unity.h"
+#include "swtimer_unit_test.h"
+
+int main(void) {
+    UNITY_BEGIN();  // Initialize Unity
+
+    /* ---------- ONE-SHOT TESTS ---------- */
+    RUN_TEST(test_swtimer_one_shot_fires_once_on_time);
+    RUN_TEST(test_swtimer_zero_delay_fires_next_tick);
+    RUN_TEST(test_swtimer_stop_cancels);
+    RUN_TEST(test_swtimer_restart_moves_deadline);
+    RUN_TEST(test_swtimer_long_delay_waits_whole_turns);
+
+    /* ---------- PERIODIC TESTS ---------- */
+    RUN_TEST(test_swtimer_periodic_does_not_drift);
+    RUN_TEST(test_swtimer_late_service_catches_up);
+
+    /* ---------- CALLBACK TESTS ---------- */
+    RUN_TEST(test_swtimer_callback_stops_other_timer);
+    RUN_TEST(test_swtimer_callback_restarts_itself);
+    RUN_TEST(test_swtimer_slow_callback_on_empty_wheel);
+    RUN_TEST(test_swtimer_due_only_with_timers_running);
+
+    /* ---------- TICKLESS WAKE TESTS ---------- */
+    RUN_TEST(test_swtimer_next_due_is_nearest_timer);
+    RUN_TEST(test_swtimer_next_due_bounded_by_one_turn);
+
+    return UNITY_END();  // Print summary
+}
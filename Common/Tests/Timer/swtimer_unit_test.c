@@ -0,0 +1,264 @@
+#include "../../../External/unity.h"
+#include "../../MCAL/tick.h"
+#include "../../Utils/swtimer.h"
+#include "swtimer_unit_test.h"
+
+/* The wheel reads this instead of the clock, the tests move it by hand */
+static uint32_t fakeTicks = 1000;
+
+uint32_t GetTicks(void)
+{
+    return fakeTicks;
+}
+
+/* Every callback run, in order, with the tick it ran at */
+#define MAX_FIRED 32
+static void *fired[MAX_FIRED];
+static uint32_t firedAt[MAX_FIRED];
+static uint8_t firedCount;
+
+static void Record(void *arg)
+{
+    if (firedCount < MAX_FIRED)
+    {
+        fired[firedCount] = arg;
+        firedAt[firedCount] = fakeTicks;
+        firedCount++;
+    }
+}
+
+/* Advance the clock one ms at a time, servicing after every tick */
+static void RunFor(uint32_t ms)
+{
+    while (ms--)
+    {
+        fakeTicks++;
+        SWTIMER_Service();
+    }
+}
+
+static SWTIMER_Timer a = SWTIMER_TIMER(Record, &a);
+static SWTIMER_Timer b = SWTIMER_TIMER(Record, &b);
+
+void setUp(void) {
+    firedCount = 0;
+    SWTIMER_Service();
+}
+
+void tearDown(void) {
+    SWTIMER_Stop(&a);
+    SWTIMER_Stop(&b);
+}
+
+/* ---------- ONE-SHOT TESTS ---------- */
+
+void test_swtimer_one_shot_fires_once_on_time(void) {
+    uint32_t start = fakeTicks;
+    SWTIMER_Start(&a, 10, 0);
+    TEST_ASSERT_TRUE(SWTIMER_IsRunning(&a));
+
+    RunFor(9);
+    TEST_ASSERT_EQUAL_UINT8(0, firedCount);
+    RunFor(1);
+    TEST_ASSERT_EQUAL_UINT8(1, firedCount);
+    TEST_ASSERT_EQUAL_PTR(&a, fired[0]);
+    TEST_ASSERT_EQUAL_UINT32(start + 10, firedAt[0]);
+    TEST_ASSERT_FALSE(SWTIMER_IsRunning(&a));
+
+    RunFor(200);
+    TEST_ASSERT_EQUAL_UINT8(1, firedCount);
+}
+
+void test_swtimer_zero_delay_fires_next_tick(void) {
+    SWTIMER_Start(&a, 0, 0);
+    SWTIMER_Service();
+    TEST_ASSERT_EQUAL_UINT8(0, firedCount);
+    RunFor(1);
+    TEST_ASSERT_EQUAL_UINT8(1, firedCount);
+}
+
+void test_swtimer_stop_cancels(void) {
+    SWTIMER_Start(&a, 5, 0);
+    SWTIMER_Start(&b, 5, 0);
+    SWTIMER_Stop(&a);
+    SWTIMER_Stop(&a);   /* stopping twice is harmless */
+    TEST_ASSERT_FALSE(SWTIMER_IsRunning(&a));
+
+    RunFor(10);
+    TEST_ASSERT_EQUAL_UINT8(1, firedCount);
+    TEST_ASSERT_EQUAL_PTR(&b, fired[0]);
+}
+
+void test_swtimer_restart_moves_deadline(void) {
+    uint32_t start = fakeTicks;
+    SWTIMER_Start(&a, 5, 0);
+    RunFor(3);
+    SWTIMER_Start(&a, 5, 0);
+
+    RunFor(10);
+    TEST_ASSERT_EQUAL_UINT8(1, firedCount);
+    TEST_ASSERT_EQUAL_UINT32(start + 8, firedAt[0]);
+}
+
+/* Same slot as a short timer, but several turns of the wheel later */
+void test_swtimer_long_delay_waits_whole_turns(void) {
+    uint32_t start = fakeTicks;
+    SWTIMER_Start(&a, 3 * SWTIMER_SLOTS + 7, 0);
+    SWTIMER_Start(&b, 7, 0);
+
+    RunFor(3 * SWTIMER_SLOTS + 7);
+    TEST_ASSERT_EQUAL_UINT8(2, firedCount);
+    TEST_ASSERT_EQUAL_PTR(&b, fired[0]);
+    TEST_ASSERT_EQUAL_UINT32(start + 7, firedAt[0]);
+    TEST_ASSERT_EQUAL_PTR(&a, fired[1]);
+    TEST_ASSERT_EQUAL_UINT32(start + 3 * SWTIMER_SLOTS + 7, firedAt[1]);
+}
+
+/* ---------- PERIODIC TESTS ---------- */
+
+void test_swtimer_periodic_does_not_drift(void) {
+    uint32_t start = fakeTicks;
+    SWTIMER_Start(&a, 10, 25);
+
+    RunFor(10 + 4 * 25);
+    TEST_ASSERT_EQUAL_UINT8(5, firedCount);
+    for (uint8_t i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL_UINT32(start + 10 + i * 25, firedAt[i]);
+    }
+    TEST_ASSERT_TRUE(SWTIMER_IsRunning(&a));
+}
+
+/* The main loop was busy: every period that passed still runs, none is lost */
+void test_swtimer_late_service_catches_up(void) {
+    SWTIMER_Start(&a, 10, 10);
+    fakeTicks += 45;
+    TEST_ASSERT_TRUE(SWTIMER_Due());
+    SWTIMER_Service();
+    TEST_ASSERT_EQUAL_UINT8(4, firedCount);
+    TEST_ASSERT_FALSE(SWTIMER_Due());
+
+    RunFor(5);
+    TEST_ASSERT_EQUAL_UINT8(5, firedCount);
+}
+
+/* ---------- CALLBACK TESTS ---------- */
+
+static void StopB(void *arg)
+{
+    Record(arg);
+    SWTIMER_Stop(&b);
+}
+
+void test_swtimer_callback_stops_other_timer(void) {
+    SWTIMER_Timer stopper = SWTIMER_TIMER(StopB, 0);
+    SWTIMER_Setup(&stopper, StopB, &stopper);
+    SWTIMER_Start(&stopper, 4, 0);
+    SWTIMER_Start(&b, 4, 0);     /* due the same tick, after the stopper */
+
+    RunFor(10);
+    TEST_ASSERT_EQUAL_UINT8(1, firedCount);
+    TEST_ASSERT_EQUAL_PTR(&stopper, fired[0]);
+    TEST_ASSERT_FALSE(SWTIMER_IsRunning(&b));
+}
+
+static SWTIMER_Timer again;
+static uint8_t againLeft;
+
+static void Again(void *arg)
+{
+    Record(arg);
+    if (--againLeft)
+    {
+        SWTIMER_Start(&again, 3, 0);
+    }
+}
+
+void test_swtimer_callback_restarts_itself(void) {
+    uint32_t start = fakeTicks;
+    SWTIMER_Setup(&again, Again, &again);
+    againLeft = 3;
+    SWTIMER_Start(&again, 3, 0);
+
+    RunFor(20);
+    TEST_ASSERT_EQUAL_UINT8(3, firedCount);
+    TEST_ASSERT_EQUAL_UINT32(start + 9, firedAt[2]);
+    TEST_ASSERT_FALSE(SWTIMER_IsRunning(&again));
+}
+
+/* The clock moves on while the only timer's callback runs and restarts it */
+static void Slow(void *arg)
+{
+    Record(arg);
+    fakeTicks += 5;
+    if (firedCount < 2)
+    {
+        SWTIMER_Start(&again, 3, 0);
+    }
+}
+
+void test_swtimer_slow_callback_on_empty_wheel(void) {
+    uint32_t start = fakeTicks;
+    SWTIMER_Setup(&again, Slow, &again);
+    SWTIMER_Start(&again, 1, 0);
+
+    RunFor(1);      /* must return, not spin on a cursor past its target */
+    TEST_ASSERT_EQUAL_UINT8(1, firedCount);
+    TEST_ASSERT_TRUE(SWTIMER_Due());
+    SWTIMER_Service();
+    TEST_ASSERT_EQUAL_UINT8(1, firedCount);
+    RunFor(3);
+    TEST_ASSERT_EQUAL_UINT8(2, firedCount);
+    TEST_ASSERT_EQUAL_UINT32(start + 1 + 5 + 3, firedAt[1]);
+    TEST_ASSERT_FALSE(SWTIMER_IsRunning(&again));
+}
+
+void test_swtimer_due_only_with_timers_running(void) {
+    fakeTicks += 100;
+    TEST_ASSERT_FALSE(SWTIMER_Due());
+    SWTIMER_Start(&a, 1, 0);
+    TEST_ASSERT_FALSE(SWTIMER_Due());
+    fakeTicks++;
+    TEST_ASSERT_TRUE(SWTIMER_Due());
+    SWTIMER_Service();
+    TEST_ASSERT_FALSE(SWTIMER_Due());
+    TEST_ASSERT_EQUAL_UINT8(1, firedCount);
+}
+
+/* ---------- TICKLESS WAKE TESTS ---------- */
+
+void test_swtimer_next_due_is_nearest_timer(void) {
+    uint32_t wake;
+    TEST_ASSERT_FALSE(SWTIMER_NextDue(&wake));
+
+    SWTIMER_Start(&a, 30, 0);
+    SWTIMER_Start(&b, 12, 0);
+    TEST_ASSERT_TRUE(SWTIMER_NextDue(&wake));
+    TEST_ASSERT_EQUAL_UINT32(fakeTicks + 12, wake);
+
+    fakeTicks = wake;   /* slept until then */
+    SWTIMER_Service();
+    TEST_ASSERT_EQUAL_UINT8(1, firedCount);
+    TEST_ASSERT_TRUE(SWTIMER_NextDue(&wake));
+    TEST_ASSERT_EQUAL_UINT32(fakeTicks + 18, wake);
+
+    SWTIMER_Stop(&a);
+    TEST_ASSERT_FALSE(SWTIMER_NextDue(&wake));
+}
+
+/* A timer several turns out wakes the sleeper once per turn, and fires on time */
+void test_swtimer_next_due_bounded_by_one_turn(void) {
+    uint32_t start = fakeTicks;
+    uint32_t wake;
+    uint8_t wakes = 0;
+    SWTIMER_Start(&a, 3 * SWTIMER_SLOTS + 5, 0);
+
+    while (SWTIMER_NextDue(&wake)) {
+        TEST_ASSERT_TRUE(wake - fakeTicks <= SWTIMER_SLOTS);
+        fakeTicks = wake;
+        SWTIMER_Service();
+        wakes++;
+    }
+    TEST_ASSERT_EQUAL_UINT8(1, firedCount);
+    TEST_ASSERT_EQUAL_UINT32(start + 3 * SWTIMER_SLOTS + 5, firedAt[0]);
+    TEST_ASSERT_EQUAL_UINT8(4, wakes);
+}
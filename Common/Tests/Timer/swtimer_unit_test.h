@@ -0,0 +1,29 @@
+#ifndef SWTIMER_UNIT_TEST_H
+#define SWTIMER_UNIT_TEST_H
+
+/* Unity test setup/teardown */
+void setUp(void);
+void tearDown(void);
+
+/* ---------- ONE-SHOT TESTS ---------- */
+void test_swtimer_one_shot_fires_once_on_time(void);
+void test_swtimer_zero_delay_fires_next_tick(void);
+void test_swtimer_stop_cancels(void);
+void test_swtimer_restart_moves_deadline(void);
+void test_swtimer_long_delay_waits_whole_turns(void);
+
+/* ---------- PERIODIC TESTS ---------- */
+void test_swtimer_periodic_does_not_drift(void);
+void test_swtimer_late_service_catches_up(void);
+
+/* ---------- CALLBACK TESTS ---------- */
+void test_swtimer_callback_stops_other_timer(void);
+void test_swtimer_callback_restarts_itself(void);
+void test_swtimer_slow_callback_on_empty_wheel(void);
+void test_swtimer_due_only_with_timers_running(void);
+
+/* ---------- TICKLESS WAKE TESTS ---------- */
+void test_swtimer_next_due_is_nearest_timer(void);
+void test_swtimer_next_due_bounded_by_one_turn(void);
+
+#endif // SWTIMER_UNIT_TEST_H
@@ -0,0 +1,39 @@
+#include "../../../External/unity.h"
+#include "uart_unit_test.h"
+
+int main(void) {
+    UNITY_BEGIN();  // Initialize Unity
+
+    /* ---------- RING BUFFER TESTS ---------- */
+    RUN_TEST(test_ring_put_get_in_order);
+    RUN_TEST(test_ring_full_rejects_put);
+    RUN_TEST(test_ring_wraps_indices);
+
+    /* ---------- UART DRIVER TESTS ---------- */
+    RUN_TEST(test_uart_loopback_round_trip);
+    RUN_TEST(test_uart_rx_burst_single_interrupt);
+    RUN_TEST(test_uart_rx_partial_burst_uses_timeout);
+    RUN_TEST(test_uart_tx_refills_in_bursts);
+    RUN_TEST(test_uart_try_receive_empty);
+    RUN_TEST(test_uart_rx_ring_full_drops_newest);
+    RUN_TEST(test_uart_rx_peek_leaves_bytes_in_ring);
+
+    /* ---------- LINK STATISTICS TESTS ---------- */
+    RUN_TEST(test_uart_stats_count_bytes);
+    RUN_TEST(test_uart_stats_count_line_errors);
+    RUN_TEST(test_uart_stats_count_ring_drops);
+
+    /* ---------- ASYNC (uDMA) TX TESTS ---------- */
+    RUN_TEST(test_uart_async_returns_before_completion);
+    RUN_TEST(test_uart_async_chunks_large_transfer);
+    RUN_TEST(test_uart_bytes_after_async_keep_order);
+
+    /* ---------- BAUD RATE TESTS ---------- */
+    RUN_TEST(test_uart_divisors_match_datasheet_9600);
+    RUN_TEST(test_uart_divisors_follow_clock);
+    RUN_TEST(test_uart_divisors_reject_unreachable_rate);
+    RUN_TEST(test_uart_set_baud_rate_reprograms_divisors);
+    RUN_TEST(test_uart_set_baud_rate_drains_tx_first);
+
+    return UNITY_END();  // Print summary
+}
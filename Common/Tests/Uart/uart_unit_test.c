@@ -0,0 +1,348 @@
+#include "../../../External/unity.h"
+#include "../../MCAL/uart.h"
+#include "../../MCAL/tm4c123gh6pm.h"
+#include "../../Utils/ring_buffer.h"
+#include "../../../Sim/MCAL/uart_sim.h"
+#include "uart_unit_test.h"
+
+void setUp(void) {
+    UART_SIM_Reset();
+    UART_Init();
+}
+
+void tearDown(void) {}
+
+/* ---------- RING BUFFER TESTS ---------- */
+
+void test_ring_put_get_in_order(void) {
+    uint8_t storage[8];
+    RingBuffer rb;
+    RingBuffer_Init(&rb, storage, sizeof(storage));
+
+    for (uint8_t i = 0; i < 5; i++) {
+        TEST_ASSERT_TRUE(RingBuffer_Put(&rb, i));
+    }
+    TEST_ASSERT_EQUAL_UINT16(5, RingBuffer_Count(&rb));
+    TEST_ASSERT_EQUAL_UINT16(3, RingBuffer_Free(&rb));
+
+    for (uint8_t i = 0; i < 5; i++) {
+        uint8_t data;
+        TEST_ASSERT_TRUE(RingBuffer_Get(&rb, &data));
+        TEST_ASSERT_EQUAL_UINT8(i, data);
+    }
+    TEST_ASSERT_TRUE(RingBuffer_IsEmpty(&rb));
+}
+
+void test_ring_full_rejects_put(void) {
+    uint8_t storage[4];
+    RingBuffer rb;
+    RingBuffer_Init(&rb, storage, sizeof(storage));
+
+    for (uint8_t i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(RingBuffer_Put(&rb, i));
+    }
+    TEST_ASSERT_FALSE(RingBuffer_Put(&rb, 0xAA));
+    TEST_ASSERT_EQUAL_UINT16(0, RingBuffer_Free(&rb));
+}
+
+void test_ring_wraps_indices(void) {
+    uint8_t storage[4];
+    uint8_t data;
+    RingBuffer rb;
+    RingBuffer_Init(&rb, storage, sizeof(storage));
+
+    /* push the free-running indices across the 16-bit boundary */
+    rb.head = rb.tail = 0xFFFE;
+    for (uint8_t i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(RingBuffer_Put(&rb, (uint8_t)(0x10 + i)));
+    }
+    TEST_ASSERT_EQUAL_UINT16(4, RingBuffer_Count(&rb));
+    for (uint8_t i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(RingBuffer_Get(&rb, &data));
+        TEST_ASSERT_EQUAL_UINT8(0x10 + i, data);
+    }
+    TEST_ASSERT_FALSE(RingBuffer_Get(&rb, &data));
+}
+
+/* ---------- UART DRIVER TESTS ---------- */
+
+void test_uart_loopback_round_trip(void) {
+    uint8_t msg[100];
+    for (uint8_t i = 0; i < sizeof(msg); i++) {
+        msg[i] = (uint8_t)(i * 7);
+    }
+
+    UART_SIM_SetLoopback(true);
+    UART_SendBuffer(msg, sizeof(msg));
+
+    for (uint8_t i = 0; i < sizeof(msg); i++) {
+        TEST_ASSERT_EQUAL_UINT8(msg[i], UART_ReceiveByte());
+    }
+}
+
+void test_uart_rx_burst_single_interrupt(void) {
+    const uint8_t burst[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    UART_SIM_Stats stats;
+
+    UART_SIM_Inject(burst, sizeof(burst));
+    UART_SIM_Service();
+
+    UART_SIM_GetStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.isrCalls);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.rxInterrupts);
+    TEST_ASSERT_EQUAL_UINT16(8, UART_RxAvailable());
+}
+
+void test_uart_rx_partial_burst_uses_timeout(void) {
+    const uint8_t burst[3] = {'a', 'b', 'c'};
+    UART_SIM_Stats stats;
+
+    UART_SIM_Inject(burst, sizeof(burst));
+    UART_SIM_Service();
+
+    UART_SIM_GetStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.rxInterrupts);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.rtInterrupts);
+    TEST_ASSERT_EQUAL_UINT8('a', UART_ReceiveByte());
+    TEST_ASSERT_EQUAL_UINT8('b', UART_ReceiveByte());
+    TEST_ASSERT_EQUAL_UINT8('c', UART_ReceiveByte());
+}
+
+void test_uart_tx_refills_in_bursts(void) {
+    uint8_t msg[128];
+    uint8_t out[128];
+    UART_SIM_Stats stats;
+    for (uint8_t i = 0; i < sizeof(msg); i++) {
+        msg[i] = i;
+    }
+
+    UART_SendBuffer(msg, sizeof(msg));
+    UART_Flush();
+    UART_SIM_Service();
+
+    TEST_ASSERT_EQUAL_UINT16(sizeof(msg), UART_SIM_Drain(out, sizeof(out)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg, out, sizeof(msg));
+
+    /* 16 bytes primed, then one interrupt per 14 bytes refilled */
+    UART_SIM_GetStats(&stats);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(9, stats.txInterrupts);
+}
+
+void test_uart_try_receive_empty(void) {
+    uint8_t data = 0x55;
+    TEST_ASSERT_FALSE(UART_TryReceiveByte(&data));
+    TEST_ASSERT_EQUAL_UINT8(0x55, data);
+    TEST_ASSERT_EQUAL_UINT16(0, UART_RxAvailable());
+}
+
+void test_uart_rx_ring_full_drops_newest(void) {
+    uint8_t chunk[64];
+    uint8_t data;
+    for (uint8_t i = 0; i < sizeof(chunk); i++) {
+        chunk[i] = i;
+    }
+
+    for (int i = 0; i < (UART_RX_BUFFER_SIZE / 64) + 1; i++) {
+        UART_SIM_Inject(chunk, sizeof(chunk));
+        UART_SIM_Service();
+    }
+
+    TEST_ASSERT_EQUAL_UINT16(UART_RX_BUFFER_SIZE, UART_RxAvailable());
+    TEST_ASSERT_TRUE(UART_TryReceiveByte(&data));
+    TEST_ASSERT_EQUAL_UINT8(0, data);
+}
+
+void test_uart_rx_peek_leaves_bytes_in_ring(void) {
+    uint8_t filler[UART_RX_BUFFER_SIZE - 2] = {0};
+    const uint8_t msg[4] = {0xA1, 0xA2, 0xA3, 0xA4};
+    uint8_t *data;
+
+    /* park the ring indices two bytes before the end of the storage */
+    UART_SIM_Inject(filler, sizeof(filler));
+    UART_SIM_Service();
+    UART_RxRelease(sizeof(filler));
+
+    UART_SIM_Inject(msg, sizeof(msg));
+    UART_SIM_Service();
+    TEST_ASSERT_EQUAL_UINT16(2, UART_RxPeek(0, &data));
+    TEST_ASSERT_EQUAL_UINT8(0xA1, data[0]);
+    TEST_ASSERT_EQUAL_UINT16(2, UART_RxPeek(2, &data));
+    TEST_ASSERT_EQUAL_UINT8(0xA3, data[0]);
+    TEST_ASSERT_EQUAL_UINT16(0, UART_RxPeek(4, &data));
+    TEST_ASSERT_EQUAL_UINT16(4, UART_RxAvailable());
+
+    UART_RxRelease(3);
+    TEST_ASSERT_EQUAL_UINT16(1, UART_RxAvailable());
+    TEST_ASSERT_EQUAL_UINT8(0xA4, UART_ReceiveByte());
+}
+
+/* ---------- LINK STATISTICS TESTS ---------- */
+
+void test_uart_stats_count_bytes(void) {
+    const uint8_t msg[10] = {0};
+    UART_Stats stats;
+
+    UART_SIM_SetLoopback(true);
+    UART_SendBuffer(msg, sizeof(msg));
+    for (uint8_t i = 0; i < sizeof(msg); i++) {
+        (void)UART_ReceiveByte();
+    }
+
+    UART_GetStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(10, stats.bytesOut);
+    TEST_ASSERT_EQUAL_UINT32(10, stats.bytesIn);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.framingErrors);
+
+    UART_ResetStats();
+    UART_GetStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.bytesIn);
+}
+
+void test_uart_stats_count_line_errors(void) {
+    const uint8_t byte = 0x55;
+    UART_Stats stats;
+
+    UART_SIM_InjectErrors(UART_DR_FE);
+    UART_SIM_Inject(&byte, 1);
+    UART_SIM_Service();
+    UART_SIM_InjectErrors(UART_DR_OE);
+    UART_SIM_Inject(&byte, 1);
+    UART_SIM_Service();
+    UART_SIM_Inject(&byte, 1);
+    UART_SIM_Service();
+
+    UART_GetStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.bytesIn);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.framingErrors);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.overrunErrors);
+}
+
+void test_uart_stats_count_ring_drops(void) {
+    uint8_t chunk[64] = {0};
+    UART_Stats stats;
+
+    for (int i = 0; i < (UART_RX_BUFFER_SIZE / 64) + 1; i++) {
+        UART_SIM_Inject(chunk, sizeof(chunk));
+        UART_SIM_Service();
+    }
+
+    UART_GetStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(64, stats.overrunErrors);
+}
+
+/* ---------- ASYNC (uDMA) TX TESTS ---------- */
+
+static uint8_t asyncDoneCount;
+
+static void count_async_done(void) {
+    asyncDoneCount++;
+}
+
+void test_uart_async_returns_before_completion(void) {
+    static uint8_t msg[300];
+    static uint8_t out[300];
+    for (uint16_t i = 0; i < sizeof(msg); i++) {
+        msg[i] = (uint8_t)(i ^ 0x5A);
+    }
+    asyncDoneCount = 0;
+
+    UART_SendBufferAsync(msg, sizeof(msg), count_async_done);
+
+    /* nothing has moved yet: the caller got control back immediately */
+    TEST_ASSERT_TRUE(UART_TxAsyncBusy());
+    TEST_ASSERT_EQUAL_UINT8(0, asyncDoneCount);
+
+    UART_Flush();
+    UART_SIM_Service();
+
+    TEST_ASSERT_FALSE(UART_TxAsyncBusy());
+    TEST_ASSERT_EQUAL_UINT8(1, asyncDoneCount);
+    TEST_ASSERT_EQUAL_UINT16(sizeof(msg), UART_SIM_Drain(out, sizeof(out)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg, out, sizeof(msg));
+}
+
+void test_uart_async_chunks_large_transfer(void) {
+    static uint8_t msg[2500];
+    static uint8_t out[2500];
+    UART_SIM_Stats stats;
+    for (uint16_t i = 0; i < sizeof(msg); i++) {
+        msg[i] = (uint8_t)i;
+    }
+    asyncDoneCount = 0;
+
+    UART_SendBufferAsync(msg, sizeof(msg), count_async_done);
+    UART_Flush();
+    UART_SIM_Service();
+
+    UART_SIM_GetStats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.dmaInterrupts);   /* 1024 + 1024 + 452 */
+    TEST_ASSERT_EQUAL_UINT32(0, stats.txInterrupts);    /* no per-byte CPU work */
+    TEST_ASSERT_EQUAL_UINT8(1, asyncDoneCount);
+    TEST_ASSERT_EQUAL_UINT16(sizeof(msg), UART_SIM_Drain(out, sizeof(out)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg, out, sizeof(msg));
+}
+
+void test_uart_bytes_after_async_keep_order(void) {
+    static const uint8_t msg[40] = "0123456789abcdefghijklmnopqrstuvwxyzABCD";
+    uint8_t out[42];
+
+    UART_SendByte('<');
+    UART_SendBufferAsync(msg, sizeof(msg), NULL);
+    UART_SendByte('>');
+    UART_Flush();
+    UART_SIM_Service();
+
+    TEST_ASSERT_EQUAL_UINT16(42, UART_SIM_Drain(out, sizeof(out)));
+    TEST_ASSERT_EQUAL_UINT8('<', out[0]);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg, &out[1], sizeof(msg));
+    TEST_ASSERT_EQUAL_UINT8('>', out[41]);
+}
+
+/* ---------- BAUD RATE TESTS ---------- */
+
+void test_uart_divisors_match_datasheet_9600(void) {
+    uint32_t ibrd, fbrd;
+    /* the values UART_Init used to hardcode */
+    TEST_ASSERT_TRUE(UART_ComputeDivisors(16000000, 9600, &ibrd, &fbrd));
+    TEST_ASSERT_EQUAL_UINT32(104, ibrd);
+    TEST_ASSERT_EQUAL_UINT32(11, fbrd);
+}
+
+void test_uart_divisors_follow_clock(void) {
+    uint32_t ibrd, fbrd;
+    TEST_ASSERT_TRUE(UART_ComputeDivisors(16000000, 1000000, &ibrd, &fbrd));
+    TEST_ASSERT_EQUAL_UINT32(1, ibrd);
+    TEST_ASSERT_EQUAL_UINT32(0, fbrd);
+
+    /* 80 MHz PLL: 115200 -> 43 + 26/64 */
+    TEST_ASSERT_TRUE(UART_ComputeDivisors(80000000, 115200, &ibrd, &fbrd));
+    TEST_ASSERT_EQUAL_UINT32(43, ibrd);
+    TEST_ASSERT_EQUAL_UINT32(26, fbrd);
+}
+
+void test_uart_divisors_reject_unreachable_rate(void) {
+    uint32_t ibrd, fbrd;
+    /* above clock / 16 */
+    TEST_ASSERT_FALSE(UART_ComputeDivisors(8000000, 1000000, &ibrd, &fbrd));
+    /* above UART_MAX_BAUD_RATE */
+    TEST_ASSERT_FALSE(UART_ComputeDivisors(80000000, 2000000, &ibrd, &fbrd));
+    TEST_ASSERT_FALSE(UART_ComputeDivisors(16000000, 0, &ibrd, &fbrd));
+}
+
+void test_uart_set_baud_rate_reprograms_divisors(void) {
+    TEST_ASSERT_EQUAL_UINT32(UART_BAUD_RATE, UART_GetBaudRate());
+    TEST_ASSERT_TRUE(UART_SetBaudRate(115200));
+    TEST_ASSERT_EQUAL_UINT32(115200, UART_GetBaudRate());
+    /* 16 MHz / (16 * (8 + 44/64)) */
+    TEST_ASSERT_UINT32_WITHIN(1200, 115200, UART_SIM_GetBaudRate());
+
+    TEST_ASSERT_FALSE(UART_SetBaudRate(3000000));
+    TEST_ASSERT_EQUAL_UINT32(115200, UART_GetBaudRate());
+}
+
+void test_uart_set_baud_rate_drains_tx_first(void) {
+    uint8_t out[4];
+    UART_SendBuffer((const uint8_t*)"ab", 2);
+    TEST_ASSERT_TRUE(UART_SetBaudRate(230400));
+    TEST_ASSERT_EQUAL_UINT16(2, UART_SIM_Drain(out, sizeof(out)));
+}
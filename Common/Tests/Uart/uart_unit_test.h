@@ -0,0 +1,39 @@
+#ifndef UART_UNIT_TEST_H
+#define UART_UNIT_TEST_H
+
+/* Unity test setup/teardown */
+void setUp(void);
+void tearDown(void);
+
+/* ---------- RING BUFFER TESTS ---------- */
+void test_ring_put_get_in_order(void);
+void test_ring_full_rejects_put(void);
+void test_ring_wraps_indices(void);
+
+/* ---------- UART DRIVER TESTS ---------- */
+void test_uart_loopback_round_trip(void);
+void test_uart_rx_burst_single_interrupt(void);
+void test_uart_rx_partial_burst_uses_timeout(void);
+void test_uart_tx_refills_in_bursts(void);
+void test_uart_try_receive_empty(void);
+void test_uart_rx_ring_full_drops_newest(void);
+void test_uart_rx_peek_leaves_bytes_in_ring(void);
+
+/* ---------- LINK STATISTICS TESTS ---------- */
+void test_uart_stats_count_bytes(void);
+void test_uart_stats_count_line_errors(void);
+void test_uart_stats_count_ring_drops(void);
+
+/* ---------- ASYNC (uDMA) TX TESTS ---------- */
+void test_uart_async_returns_before_completion(void);
+void test_uart_async_chunks_large_transfer(void);
+void test_uart_bytes_after_async_keep_order(void);
+
+/* ---------- BAUD RATE TESTS ---------- */
+void test_uart_divisors_match_datasheet_9600(void);
+void test_uart_divisors_follow_clock(void);
+void test_uart_divisors_reject_unreachable_rate(void);
+void test_uart_set_baud_rate_reprograms_divisors(void);
+void test_uart_set_baud_rate_drains_tx_first(void);
+
+#endif // UART_UNIT_TEST_H
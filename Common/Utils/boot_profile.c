@@ -0,0 +1,135 @@
+#include "boot_profile.h"
+#include "../HAL/comm_protocol.h"
+#include "../MCAL/clock.h"
+#include <stdio.h>
+
+#define BOOT_UNIT_US        100u        /* wire resolution, 0.1 ms */
+
+/* CMD_BOOT carries every step */
+typedef char BootStepsFit[(BOOT_STEP_COUNT <= COMM_BOOT_MAX_MARKS) ? 1 : -1];
+
+static const char *const stepNames[BOOT_STEP_COUNT] = {
+    [BOOT_COMM]    = "comm",
+    [BOOT_DRIVERS] = "drivers",
+    [BOOT_POWER]   = "power",
+    [BOOT_LCD]     = "lcd",
+    [BOOT_SCHED]   = "sched",
+    [BOOT_EEPROM]  = "eeprom",
+    [BOOT_LINK]    = "link",
+    [BOOT_READY]   = "ready",
+    [BOOT_SPLASH]  = "splash",
+};
+
+static uint64_t startUs;
+static BOOT_Profile own;
+static BOOT_Profile peer;
+static bool peerKnown;
+
+/*******************************************************************************
+ *                         Functions Definitions                               *
+ *******************************************************************************/
+
+void BOOT_Start(void)
+{
+    startUs = CLOCK_NowUs();
+    own.marked = 0;
+}
+
+void BOOT_Mark(BOOT_Step step)
+{
+    if (step >= BOOT_STEP_COUNT || (own.marked & (1u << step)))
+    {
+        return;
+    }
+    uint64_t us = CLOCK_NowUs() - startUs;
+    own.us[step] = (us > UINT32_MAX) ? UINT32_MAX : (uint32_t)us;
+    own.marked |= (uint16_t)(1u << step);
+}
+
+void BOOT_Get(BOOT_Profile *profile)
+{
+    *profile = own;
+}
+
+uint8_t BOOT_Encode(const BOOT_Profile *profile, uint8_t *payload)
+{
+    uint8_t len = 0;
+    for (uint8_t step = 0; step < BOOT_STEP_COUNT; step++)
+    {
+        if (!(profile->marked & (1u << step)))
+        {
+            continue;
+        }
+        uint32_t units = profile->us[step] / BOOT_UNIT_US;
+        if (units > UINT16_MAX)
+        {
+            units = UINT16_MAX;
+        }
+        payload[len++] = step;
+        payload[len++] = (uint8_t)(units >> 8);
+        payload[len++] = (uint8_t)units;
+    }
+    return len;
+}
+
+bool BOOT_Decode(const uint8_t *payload, uint8_t len, BOOT_Profile *profile)
+{
+    if (len % COMM_BOOT_MARK_LEN != 0)
+    {
+        return false;
+    }
+    profile->marked = 0;
+    for (uint8_t i = 0; i < len; i += COMM_BOOT_MARK_LEN)
+    {
+        uint8_t step = payload[i];
+        if (step >= BOOT_STEP_COUNT)
+        {
+            return false;
+        }
+        profile->us[step] = (((uint32_t)payload[i + 1] << 8) | payload[i + 2]) * BOOT_UNIT_US;
+        profile->marked |= (uint16_t)(1u << step);
+    }
+    return true;
+}
+
+void BOOT_SetPeer(const BOOT_Profile *profile)
+{
+    peer = *profile;
+    peerKnown = true;
+}
+
+bool BOOT_GetPeer(BOOT_Profile *profile)
+{
+    if (peerKnown)
+    {
+        *profile = peer;
+    }
+    return peerKnown;
+}
+
+const char *BOOT_StepName(uint8_t step)
+{
+    return (step < BOOT_STEP_COUNT) ? stepNames[step] : "?";
+}
+
+int BOOT_Format(const BOOT_Profile *profile, char *text, uint32_t size)
+{
+    int len = 0;
+    text[0] = '\0';
+    for (uint8_t step = 0; step < BOOT_STEP_COUNT; step++)
+    {
+        if (!(profile->marked & (1u << step)) || (uint32_t)len >= size)
+        {
+            continue;
+        }
+        int n = snprintf(&text[len], size - (uint32_t)len, "%s%s %lu.%lu", len ? " " : "",
+                         stepNames[step], (unsigned long)(profile->us[step] / 1000u),
+                         (unsigned long)(profile->us[step] / BOOT_UNIT_US % 10u));
+        if (n < 0)
+        {
+            break;
+        }
+        len += n;
+    }
+    return len;
+}
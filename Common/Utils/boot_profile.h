@@ -0,0 +1,59 @@
+#ifndef BOOT_PROFILE_H_
+#define BOOT_PROFILE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Boot-phase timestamps. BOOT_Start right after CLOCK_Init sets time zero (on
+ * the board that is a few µs after reset), then each ECU marks the end of its
+ * init steps with BOOT_Mark. The HMI sends its marks to Control in CMD_BOOT
+ * once the link is up, Control answers with its own, and each side keeps the
+ * peer's (BOOT_GetPeer). See COMM_BOOT_LEN for the wire layout.
+ *
+ * Not every ECU has every step; a step marked twice keeps the first time.
+ */
+
+typedef enum {
+    BOOT_COMM,          /* UART and framing up (COMM_Init) */
+    BOOT_DRIVERS,       /* keypad, LEDs, potentiometer / LEDs, dispatcher */
+    BOOT_POWER,         /* POWER_Init */
+    BOOT_LCD,           /* LCD initialized, splash on screen */
+    BOOT_SCHED,         /* SCHED_Init */
+    BOOT_EEPROM,        /* EEPROM settings copied to RAM (init_Eeprom) */
+    BOOT_LINK,          /* handshake done, or the link resumed after a warm reset */
+    BOOT_READY,         /* commands are handled from here on */
+    BOOT_SPLASH,        /* splash and "Connected!" over, menu on screen */
+    BOOT_STEP_COUNT
+} BOOT_Step;
+
+typedef struct {
+    uint16_t marked;                    /* bit n: step n was marked */
+    uint32_t us[BOOT_STEP_COUNT];       /* since BOOT_Start */
+} BOOT_Profile;
+
+/* Time zero of the marks, right after CLOCK_Init */
+void BOOT_Start(void);
+
+void BOOT_Mark(BOOT_Step step);
+
+/* Marks of this ECU so far */
+void BOOT_Get(BOOT_Profile *profile);
+
+/* Payload of CMD_BOOT, at most COMM_BOOT_LEN bytes; returns its length */
+uint8_t BOOT_Encode(const BOOT_Profile *profile, uint8_t *payload);
+
+/* False if len is not whole marks or a step is unknown; times in 0.1 ms steps */
+bool BOOT_Decode(const uint8_t *payload, uint8_t len, BOOT_Profile *profile);
+
+/* The other ECU's marks, from CMD_BOOT. BOOT_GetPeer is false before any */
+void BOOT_SetPeer(const BOOT_Profile *profile);
+bool BOOT_GetPeer(BOOT_Profile *profile);
+
+/* "comm", "link", ... for reports, "?" for an unknown step */
+const char *BOOT_StepName(uint8_t step);
+
+/* "comm 0.0 drivers 0.1 ..." in ms, the marked steps only; returns the length */
+int BOOT_Format(const BOOT_Profile *profile, char *text, uint32_t size);
+
+#endif /* BOOT_PROFILE_H_ */
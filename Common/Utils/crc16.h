@@ -0,0 +1,22 @@
+#ifndef CRC16_H_
+#define CRC16_H_
+
+#include <stdint.h>
+
+/*
+ * CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, no reflection, no xorout).
+ * Table driven so the frame receiver can update it in O(1) per byte.
+ */
+#define CRC16_INIT      0xFFFF
+
+extern const uint16_t crc16Table[256];
+
+static inline uint16_t CRC16_Update(uint16_t crc, uint8_t data)
+{
+    return (uint16_t)((crc << 8) ^ crc16Table[((crc >> 8) ^ data) & 0xFF]);
+}
+
+/* CRC of a whole buffer, starting from crc (CRC16_INIT for a fresh one) */
+uint16_t CRC16_Compute(uint16_t crc, const uint8_t *data, uint16_t len);
+
+#endif /* CRC16_H_ */
@@ -0,0 +1,113 @@
+#ifndef RING_BUFFER_H_
+#define RING_BUFFER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../MCAL/cpu.h"
+
+/*******************************************************************************
+ *                         Definitions                                         *
+ *******************************************************************************/
+
+/*
+ * Lock-free single-producer / single-consumer byte ring.
+ * - size must be a power of two (indices are masked, never divided)
+ * - head is only written by the producer, tail only by the consumer, so an
+ *   ISR on one side and the main loop on the other need no critical section
+ * - buffer is plain memory, a CPU_CompilerBarrier keeps its accesses before
+ *   the head/tail store that hands the slot to the other side
+ * - head/tail run freely and wrap at 16 bits, count = head - tail
+ */
+typedef struct {
+    uint8_t *buffer;
+    uint16_t mask;
+    volatile uint16_t head;   /* next write position (producer) */
+    volatile uint16_t tail;   /* next read position (consumer) */
+} RingBuffer;
+
+/*******************************************************************************
+ *                         Functions Definitions                               *
+ *******************************************************************************/
+
+/* storage must hold size bytes, size a power of two <= 32768 */
+static inline void RingBuffer_Init(RingBuffer *rb, uint8_t *storage, uint16_t size)
+{
+    rb->buffer = storage;
+    rb->mask = (uint16_t)(size - 1);
+    rb->head = 0;
+    rb->tail = 0;
+}
+
+static inline uint16_t RingBuffer_Count(const RingBuffer *rb)
+{
+    return (uint16_t)(rb->head - rb->tail);
+}
+
+static inline uint16_t RingBuffer_Free(const RingBuffer *rb)
+{
+    return (uint16_t)(rb->mask + 1 - RingBuffer_Count(rb));
+}
+
+static inline bool RingBuffer_IsEmpty(const RingBuffer *rb)
+{
+    return rb->head == rb->tail;
+}
+
+/* Producer side: returns false (and drops the byte) when the ring is full */
+static inline bool RingBuffer_Put(RingBuffer *rb, uint8_t data)
+{
+    uint16_t head = rb->head;
+    if ((uint16_t)(head - rb->tail) > rb->mask)
+    {
+        return false;
+    }
+    rb->buffer[head & rb->mask] = data;
+    CPU_CompilerBarrier();
+    rb->head = (uint16_t)(head + 1);   /* publish only after the byte is stored */
+    return true;
+}
+
+/* Consumer side: returns false when the ring is empty */
+static inline bool RingBuffer_Get(RingBuffer *rb, uint8_t *data)
+{
+    uint16_t tail = rb->tail;
+    if (tail == rb->head)
+    {
+        return false;
+    }
+    *data = rb->buffer[tail & rb->mask];
+    CPU_CompilerBarrier();
+    rb->tail = (uint16_t)(tail + 1);   /* release the slot after the byte is read */
+    return true;
+}
+
+/*
+ * Consumer side, zero copy: *data points at the byte offset places past the
+ * oldest unread one. Returns how many bytes can be read from there before the
+ * storage wraps (0 if that byte has not arrived). The bytes stay in the ring,
+ * and the producer cannot overwrite them, until RingBuffer_Skip; the consumer
+ * may rewrite them in place.
+ */
+static inline uint16_t RingBuffer_Peek(const RingBuffer *rb, uint16_t offset, uint8_t **data)
+{
+    uint16_t count = RingBuffer_Count(rb);
+    if (offset >= count)
+    {
+        return 0;
+    }
+    uint16_t index = (uint16_t)(rb->tail + offset) & rb->mask;
+    uint16_t toEnd = (uint16_t)(rb->mask + 1 - index);
+    *data = &rb->buffer[index];
+    count = (uint16_t)(count - offset);
+    return (count < toEnd) ? count : toEnd;
+}
+
+/* Consumer side: drop up to count bytes */
+static inline void RingBuffer_Skip(RingBuffer *rb, uint16_t count)
+{
+    uint16_t available = RingBuffer_Count(rb);
+    CPU_CompilerBarrier();              /* reads and in-place rewrites done */
+    rb->tail = (uint16_t)(rb->tail + ((count < available) ? count : available));
+}
+
+#endif /* RING_BUFFER_H_ */
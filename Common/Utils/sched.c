@@ -0,0 +1,96 @@
+#include "sched.h"
+#include "../MCAL/cpu.h"
+#include "../MCAL/power.h"
+
+static SCHED_Task *const *taskList;
+static uint8_t taskCount;
+
+/* Timer callback of a deferred post */
+static void SCHED_Expired(void *task)
+{
+    SCHED_Post((SCHED_Task *)task);
+}
+
+void SCHED_Init(SCHED_Task *const *tasks, uint8_t count)
+{
+    taskList = tasks;
+    taskCount = count;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        tasks[i]->pending = 0;
+        SWTIMER_Stop(&tasks[i]->timer);
+        SWTIMER_Setup(&tasks[i]->timer, SCHED_Expired, tasks[i]);
+    }
+}
+
+void SCHED_PostAfter(SCHED_Task *task, uint32_t ms)
+{
+    SWTIMER_Start(&task->timer, ms, 0);
+}
+
+void SCHED_Cancel(SCHED_Task *task)
+{
+    SWTIMER_Stop(&task->timer);
+    task->pending = 0;
+}
+
+bool SCHED_IsArmed(const SCHED_Task *task)
+{
+    return SWTIMER_IsRunning(&task->timer);
+}
+
+/* A task is pending or a timer is due */
+static bool SCHED_Ready(void)
+{
+    for (uint8_t i = 0; i < taskCount; i++)
+    {
+        if (taskList[i]->pending)
+        {
+            return true;
+        }
+    }
+    return SWTIMER_Due();
+}
+
+bool SCHED_RunOnce(void)
+{
+    SWTIMER_Service();
+    for (uint8_t i = 0; i < taskCount; i++)
+    {
+        SCHED_Task *task = taskList[i];
+        if (task->pending)
+        {
+            // Cleared first: a post while it runs makes it run again
+            task->pending = 0;
+            task->run();
+            return true;
+        }
+    }
+    return false;
+}
+
+void SCHED_Run(void)
+{
+    for (;;)
+    {
+        if (SCHED_RunOnce())
+        {
+            continue;
+        }
+        // Checked again with interrupts off: a post from here on wakes the sleep
+        CPU_DisableInterrupts();
+        uint32_t wake;
+        if (SCHED_Ready())
+        {
+            CPU_EnableInterrupts();
+        }
+        else if (SWTIMER_NextDue(&wake))
+        {
+            POWER_SleepUntil(wake);
+        }
+        else
+        {
+            POWER_Sleep();      // no timer running: until the next interrupt
+        }
+    }
+}
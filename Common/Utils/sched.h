@@ -0,0 +1,57 @@
+#ifndef SCHED_H_
+#define SCHED_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "swtimer.h"
+
+/*
+ * Run-to-completion scheduler for a main loop that must never block.
+ * Work is split into tasks, each a function that does one step and returns.
+ * A task runs when its event has been posted:
+ * - SCHED_Post from an ISR (UART RX), a task or a timer callback
+ * - SCHED_PostAfter: deferred, posted by the task's timer (swtimer.h) once
+ *   the time is up
+ * An event posted again before its task ran is not queued twice, so a
+ * task handles everything that is waiting (or posts itself to continue).
+ * Pending tasks run in the order given to SCHED_Init, the first one first,
+ * so the worst wait for a task is the longest single step of the others.
+ */
+
+typedef struct {
+    void (*run)(void);
+    volatile uint8_t pending;   /* set by SCHED_Post, cleared just before run */
+    SWTIMER_Timer timer;        /* deferred post, set up by SCHED_Init */
+} SCHED_Task;
+
+#define SCHED_TASK(run)     { (run), 0, SWTIMER_TIMER(0, 0) }
+
+/* Schedule tasks[0..count-1], highest priority first. The array is not copied */
+void SCHED_Init(SCHED_Task *const *tasks, uint8_t count);
+
+/* Run task soon. Safe from interrupt context, a single byte store */
+static inline void SCHED_Post(SCHED_Task *task)
+{
+    task->pending = 1;
+}
+
+/* Post task in ms (0: at the next pass), replacing an earlier deferred post. Main loop only */
+void SCHED_PostAfter(SCHED_Task *task, uint32_t ms);
+
+/* Drop a deferred post that is not due yet, and the pending event. Main loop only */
+void SCHED_Cancel(SCHED_Task *task);
+
+/* True while a deferred post of task waits for its time */
+bool SCHED_IsArmed(const SCHED_Task *task);
+
+/* Run expired timers (deferred posts among them), then the first pending task. False if none ran */
+bool SCHED_RunOnce(void);
+
+/*
+ * SCHED_RunOnce forever, sleeping while nothing is pending. An ISR that
+ * posts wakes it, and so does the clock's alarm once the next software timer
+ * is due (POWER_SleepUntil, SWTIMER_NextDue)
+ */
+void SCHED_Run(void);
+
+#endif /* SCHED_H_ */
@@ -0,0 +1,181 @@
+#include "swtimer.h"
+#include "../MCAL/tick.h"
+
+#define SWTIMER_SLOT_MASK   (SWTIMER_SLOTS - 1u)
+
+/* Circular lists, each headed by a sentinel that is never a timer */
+static SWTIMER_Timer slots[SWTIMER_SLOTS];
+static SWTIMER_Timer expired;       /* timers of the current tick, not run yet */
+static uint32_t cursor;             /* last tick the wheel has turned to */
+static uint32_t running;            /* timers in the wheel or on the expired list */
+static bool started;
+static bool servicing;
+
+/*******************************************************************************
+ *                         Private Functions                                   *
+ *******************************************************************************/
+
+static void SWTIMER_Begin(void)
+{
+    if (started)
+    {
+        return;
+    }
+    for (uint32_t i = 0; i < SWTIMER_SLOTS; i++)
+    {
+        slots[i].next = &slots[i];
+        slots[i].prev = &slots[i];
+    }
+    expired.next = &expired;
+    expired.prev = &expired;
+    cursor = GetTicks();
+    started = true;
+}
+
+static void SWTIMER_Link(SWTIMER_Timer *head, SWTIMER_Timer *timer)
+{
+    timer->prev = head->prev;
+    timer->next = head;
+    head->prev->next = timer;
+    head->prev = timer;
+}
+
+static void SWTIMER_Unlink(SWTIMER_Timer *timer)
+{
+    timer->prev->next = timer->next;
+    timer->next->prev = timer->prev;
+    timer->next = 0;
+    timer->prev = 0;
+}
+
+/* Into the slot of tick dueTick, at the earliest the next tick after the cursor */
+static void SWTIMER_Insert(SWTIMER_Timer *timer, uint32_t dueTick)
+{
+    uint32_t delta = dueTick - cursor;
+    if ((int32_t)delta < 1)
+    {
+        delta = 1;
+    }
+    timer->rounds = (delta - 1u) >> SWTIMER_SLOT_BITS;
+    SWTIMER_Link(&slots[(cursor + delta) & SWTIMER_SLOT_MASK], timer);
+}
+
+/*******************************************************************************
+ *                         Functions Definitions                               *
+ *******************************************************************************/
+
+void SWTIMER_Setup(SWTIMER_Timer *timer, SWTIMER_Callback callback, void *arg)
+{
+    timer->next = 0;
+    timer->prev = 0;
+    timer->callback = callback;
+    timer->arg = arg;
+}
+
+void SWTIMER_Start(SWTIMER_Timer *timer, uint32_t ms, uint32_t periodMs)
+{
+    SWTIMER_Begin();
+    SWTIMER_Stop(timer);
+    if (running == 0 && !servicing)
+    {
+        cursor = GetTicks();    /* empty wheel, no need to catch up first */
+    }
+    timer->periodMs = periodMs;
+    SWTIMER_Insert(timer, GetTicks() + ms);
+    running++;
+}
+
+void SWTIMER_Stop(SWTIMER_Timer *timer)
+{
+    if (timer->next)
+    {
+        SWTIMER_Unlink(timer);
+        running--;
+    }
+}
+
+bool SWTIMER_IsRunning(const SWTIMER_Timer *timer)
+{
+    return timer->next != 0;
+}
+
+void SWTIMER_Service(void)
+{
+    // A callback that polls (COMM_RequestPoll) must not turn the wheel under us
+    if (servicing)
+    {
+        return;
+    }
+    SWTIMER_Begin();
+    servicing = true;
+
+    uint32_t now = GetTicks();
+    while ((int32_t)(now - cursor) > 0)
+    {
+        if (running == 0)
+        {
+            cursor = now;   /* nothing to expire on the way */
+            break;
+        }
+        cursor++;
+
+        /* Sort out the slot first, the callbacks may change any list */
+        SWTIMER_Timer *head = &slots[cursor & SWTIMER_SLOT_MASK];
+        SWTIMER_Timer *next;
+        for (SWTIMER_Timer *timer = head->next; timer != head; timer = next)
+        {
+            next = timer->next;
+            if (timer->rounds == 0)
+            {
+                SWTIMER_Unlink(timer);
+                SWTIMER_Link(&expired, timer);
+            }
+            else
+            {
+                timer->rounds--;
+            }
+        }
+
+        /* A callback may stop a timer still on the list, it then does not run */
+        while (expired.next != &expired)
+        {
+            SWTIMER_Timer *timer = expired.next;
+            SWTIMER_Unlink(timer);
+            if (timer->periodMs)
+            {
+                SWTIMER_Insert(timer, cursor + timer->periodMs);    /* no drift */
+            }
+            else
+            {
+                running--;
+            }
+            timer->callback(timer->arg);
+        }
+    }
+
+    servicing = false;
+}
+
+bool SWTIMER_Due(void)
+{
+    return started && running != 0 && cursor != GetTicks();
+}
+
+bool SWTIMER_NextDue(uint32_t *tick)
+{
+    if (!started || running == 0)
+    {
+        return false;
+    }
+    for (uint32_t i = 1; i <= SWTIMER_SLOTS; i++)
+    {
+        const SWTIMER_Timer *head = &slots[(cursor + i) & SWTIMER_SLOT_MASK];
+        if (head->next != head)
+        {
+            *tick = cursor + i;
+            return true;
+        }
+    }
+    *tick = cursor;     /* only the expired list, inside SWTIMER_Service */
+    return true;
+}
@@ -0,0 +1,67 @@
+#ifndef SWTIMER_H_
+#define SWTIMER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Software timers on the 1 ms GetTicks() (tick.h), any number of them, one-shot or
+ * periodic. They are kept in a hashed timing wheel: SWTIMER_SLOTS lists, a
+ * timer due in d ms sits in slot (now + d) % SWTIMER_SLOTS with d / SWTIMER_SLOTS
+ * turns of the wheel still to wait. Start and stop are O(1) (a doubly linked
+ * list insert / unlink), and each tick visits one slot.
+ *
+ * The wheel turns in SWTIMER_Service, not in an interrupt: it catches up to
+ * GetTicks() and runs the callbacks of the expired timers in the caller's
+ * context (the scheduler, COMM_RequestPoll). Callbacks may start and stop any
+ * timer, themselves included. Everything here is main loop only.
+ *
+ * Nothing ticks while the core sleeps: a sleeper asks SWTIMER_NextDue when to
+ * wake (POWER_SleepUntil). That is the next slot holding a timer, so a long
+ * timer costs one wake per turn of the wheel (SWTIMER_SLOTS ms), no more.
+ */
+
+#define SWTIMER_SLOT_BITS   6
+#define SWTIMER_SLOTS       (1u << SWTIMER_SLOT_BITS)
+
+typedef void (*SWTIMER_Callback)(void *arg);
+
+typedef struct SWTIMER_Timer {
+    struct SWTIMER_Timer *next;     /* slot list, NULL while stopped */
+    struct SWTIMER_Timer *prev;
+    SWTIMER_Callback callback;
+    void *arg;
+    uint32_t periodMs;              /* 0: one-shot */
+    uint32_t rounds;                /* full turns of the wheel left */
+} SWTIMER_Timer;
+
+/* Static initializer for a stopped timer */
+#define SWTIMER_TIMER(callback, arg)    { 0, 0, (callback), (arg), 0, 0 }
+
+/* Set the callback of a stopped timer (the run-time SWTIMER_TIMER) */
+void SWTIMER_Setup(SWTIMER_Timer *timer, SWTIMER_Callback callback, void *arg);
+
+/*
+ * Run callback in ms (0: at the next tick), then every periodMs unless that
+ * is 0. Restarts a running timer.
+ */
+void SWTIMER_Start(SWTIMER_Timer *timer, uint32_t ms, uint32_t periodMs);
+
+/* Stop a timer; stopping a stopped one does nothing */
+void SWTIMER_Stop(SWTIMER_Timer *timer);
+
+bool SWTIMER_IsRunning(const SWTIMER_Timer *timer);
+
+/* Turn the wheel up to now and run the expired callbacks */
+void SWTIMER_Service(void);
+
+/* True while SWTIMER_Service has ticks to catch up on with timers running */
+bool SWTIMER_Due(void);
+
+/*
+ * Tick at which SWTIMER_Service has work next, at most SWTIMER_SLOTS ms
+ * ahead (it may have passed already). False while no timer runs.
+ */
+bool SWTIMER_NextDue(uint32_t *tick);
+
+#endif /* SWTIMER_H_ */
@@ -1,9 +1,9 @@
 #include "buzzer.h"
 #include "../../../Common/MCAL/tm4c123gh6pm.h"
+#include "../../../Common/Utils/swtimer.h"
 
 
 #define TOTAL_BEEPS 3
-#define CYCLES_PER_MS 16000  // 16 MHz / 1000 = 16000 cycles per ms
 
 // Duration arrays (milliseconds)
 uint32_t on_durations[TOTAL_BEEPS]  = {600, 700, 850};  // buzzer ON
@@ -14,6 +14,9 @@ volatile uint8_t buzzer_state = 0; // 0 = off, 1 = on
 volatile uint8_t beep_index = 0;
 volatile uint8_t buzzer_is_working = 0; // 0 ->buzzer isnt workin, 1 -> buzzer is working
 
+static void step_Buzzer(void *arg);
+static SWTIMER_Timer stepTimer = SWTIMER_TIMER(step_Buzzer, 0); //end of the current beep or pause
+
 
 uint8_t buzzer_State(void){
   return buzzer_is_working; //return buzzer working or not state for app logic
@@ -38,17 +41,6 @@ When a pin is in alternate function mode, PCTL selects which alternate function
   Bits 11:8   -> PB2
   .... so on !!
 */
-  
-  //**********************************************TIMER0 init****************************************************//
-  SYSCTL_RCGCTIMER_R |=(1<<0); //enable clock to timer 0
-   while ((SYSCTL_PRTIMER_R & (1 << 0)) == 0); //wait till its set up
-   TIMER0_CTL_R &= ~(1 << 0);//disable timer before configuration
-   
-   TIMER0_CFG_R = 0x00000000; //configure it to be 32-bit timer
-   TIMER0_TAMR_R = 0x1; // 0x1 = One-Shot Timer modee counts once only
-   //interupt settings
-   TIMER0_IMR_R |= 0x01; // enable timeout interrupt
-   NVIC_EN0_R |= (1 << 19); // enable TIMER0A's only interrupt in NVIC
 }
 
 
@@ -60,9 +52,8 @@ void toggle_Buzzer(void) {
         GPIO_PORTB_DATA_R &= ~(1 << 0); 
         buzzer_state = 0;
 
-        //load OFF duration
-        TIMER0_TAILR_R = (off_durations[beep_index] * CYCLES_PER_MS) - 1;
-        TIMER0_CTL_R |= 0x01; //restart timer
+        //OFF duration
+        SWTIMER_Start(&stepTimer, off_durations[beep_index], 0);
     } else {
         //buzzer was off check next beep
         beep_index++; 
@@ -72,12 +63,10 @@ void toggle_Buzzer(void) {
             GPIO_PORTB_DATA_R |= (1 << 0); 
             buzzer_state = 1;
 
-            // Load ON duration
-            TIMER0_TAILR_R = (on_durations[beep_index] * CYCLES_PER_MS) - 1;
-            TIMER0_CTL_R |= 0x01; // Restart Timer
+            // ON duration
+            SWTIMER_Start(&stepTimer, on_durations[beep_index], 0);
         } else {
             //stop buzzer from working
-            TIMER0_CTL_R &= ~(1 << 0);      //stop timer
             GPIO_PORTB_DATA_R &= ~(1 << 0); //ensure Pin LOW
             buzzer_is_working = 0; //marker to indicate buzzer not working!!
         }
@@ -85,26 +74,22 @@ void toggle_Buzzer(void) {
 }
 
 
-void Timer0A_Handler(void) {
-    TIMER0_ICR_R = 0x01; // Clear interrupt flag
-    toggle_Buzzer();     //handle interrupt in a separated func!!
+//timer callback, run from SWTIMER_Service in the main loop
+static void step_Buzzer(void *arg) {
+    (void)arg;
+    toggle_Buzzer();
 }
 
 void Buzzer_Start(void) {
     buzzer_is_working  = 1; //marker to indicate buzzer started !!
     init_Buzzer();
-    TIMER0_CTL_R &= ~(1 << 0); //Stop timer if running
-    TIMER0_ICR_R = 0x01;       //Clear pending interrupts 
     
     beep_index = 0;
     buzzer_state = 1; 
 
-    // Load first ON duration
-    TIMER0_TAILR_R = (on_durations[beep_index] * CYCLES_PER_MS) - 1;
-    
     GPIO_PORTB_DATA_R |= (1 << 0);
     
-    //start timer
-    TIMER0_CTL_R |= 0x01; //the timers interrupt handler will get invoked when the first time from the array period have elapsed
+    //restarts the pattern if it was running, step_Buzzer runs once the first ON time has elapsed
+    SWTIMER_Start(&stepTimer, on_durations[beep_index], 0);
 }
 
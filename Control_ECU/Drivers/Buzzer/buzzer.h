@@ -3,7 +3,7 @@
 #include <stdint.h>
 
 //functions declarations
-void Buzzer_Start(void);
+void Buzzer_Start(void); //returns at once, buzzer_State() tells when the alarm is over
 
 uint8_t buzzer_State(void); //returns buzzer state!!
 
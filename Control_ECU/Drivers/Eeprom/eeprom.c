@@ -2,50 +2,111 @@
 #include "eeprom_hw.h"
 
 #define USED_BLOCK 1 //used block 1 to store passwords
-#define PASSWORD_OFFSET 0 //used byte offset 0 to store password inside 
+#define PASSWORD_OFFSET 0 //used byte offset 0 to store password inside
 #define LAST_CHAR_OFFSET 3 //used byte offset 3 to store last char of the password
 #define AUTOLOCKOUT_OFFSET 1 //used byte offset 1 to store auto lock value
+#define INIT_FLAG_OFFSET 2 //used byte offset 2 to store the password-set flag (bit 0)
+#define USED_WORDS EEPROM_IMAGE_WORDS //words 0..3 of block 1, all of the above
+#define PASSWORD_LENGTH 5
+
+//RAM copy of the used words, loaded by init_Eeprom (or load_EepromImage after a warm
+//reset) and written through by every setter: the password check and the getters never touch the peripheral !!
+static uint32_t mirror[USED_WORDS];
+static bool hw_ready = false;
+static bool loaded = false;
+
+//EEPROM_HW_Init software-resets the peripheral, once per boot is enough !!
+static void hw_Once(void){
+    if (!hw_ready){
+        EEPROM_HW_Init();
+        hw_ready = true;
+    }
+}
+
+//the 5 password bytes as stored: 4 in word 0, the last one in word 3
+static void stored_Password(uint8_t *bytes){
+    bytes[0] = (mirror[PASSWORD_OFFSET] >> 0)  & 0xFF;
+    bytes[1] = (mirror[PASSWORD_OFFSET] >> 8)  & 0xFF;
+    bytes[2] = (mirror[PASSWORD_OFFSET] >> 16) & 0xFF;
+    bytes[3] = (mirror[PASSWORD_OFFSET] >> 24) & 0xFF;
+    bytes[4] = (mirror[LAST_CHAR_OFFSET] >> 0) & 0xFF;
+}
 
-//read the password from the eeprom/block 1 and compare it with the passed password
+//the HMI only ever sends ASCII digits, anything else is a blank or corrupt block
+static bool password_Valid(void){
+    uint8_t bytes[PASSWORD_LENGTH];
+    stored_Password(bytes);
+    for (int i = 0; i < PASSWORD_LENGTH; i++){
+        if (bytes[i] < '0' || bytes[i] > '9'){
+            return false;
+        }
+    }
+    return true;
+}
+
+static void load_Once(void){
+    if (!loaded){
+        init_Eeprom();
+    }
+}
+
+//write one word through to the eeprom, the mirror then holds what the eeprom holds
+static bool write_Word(uint32_t offset, uint32_t value){
+    load_Once();
+    hw_Once(); //a warm boot brings the peripheral up at its first write only
+    if (!EEPROM_HW_WriteWord(USED_BLOCK, offset, value)){
+        mirror[offset] = EEPROM_HW_ReadWord(USED_BLOCK, offset); //a failed write may have changed it or not
+        return false;
+    }
+    mirror[offset] = value;
+    return true;
+}
+
+
+void init_Eeprom(void){
+    hw_Once();
+    for (uint32_t i = 0; i < USED_WORDS; i++){
+        mirror[i] = EEPROM_HW_ReadWord(USED_BLOCK, i);
+    }
+    //a flag with no 5-digit password behind it counts as no password, the HMI sets one up again
+    if ((mirror[INIT_FLAG_OFFSET] & 1) && !password_Valid()){
+        mirror[INIT_FLAG_OFFSET] &= ~1u;
+    }
+    loaded = true;
+}
+
+
+//compare the passed password with the stored one (RAM copy)
 bool compare_Passwords(const uint8_t *entered_password){
-  
-  EEPROM_HW_Init(); //initialize eeprom block!!
-
-   uint32_t stored_password = EEPROM_HW_ReadWord(USED_BLOCK, PASSWORD_OFFSET); //read full password word without incrementing to the next word address!!
-   uint32_t stored_last_char = EEPROM_HW_ReadWord(USED_BLOCK, LAST_CHAR_OFFSET); //read last char of the password
-    // Convert stored_password (1 word) into 4 bytes
-    uint8_t stored_bytes[5];
-    stored_bytes[0] = (stored_password >> 0)  & 0xFF;
-    stored_bytes[1] = (stored_password >> 8)  & 0xFF;
-    stored_bytes[2] = (stored_password >> 16) & 0xFF;
-    stored_bytes[3] = (stored_password >> 24) & 0xFF;
-    stored_bytes[4] = (stored_last_char >> 0) & 0xFF;
-
-   for (int i = 0; i < 5; i++){
+
+    load_Once();
+
+    uint8_t stored_bytes[PASSWORD_LENGTH];
+    stored_Password(stored_bytes);
+
+   for (int i = 0; i < PASSWORD_LENGTH; i++){
         if (stored_bytes[i] != entered_password[i]){
             return false;
         }
     }
    return true;
- 
+
 }
 
 
-//replace the old password with the new passed one by writing to the old password location 
-bool change_Password(const uint8_t *new_password){ 
-  
+//replace the old password with the new passed one by writing to the old password location
+bool change_Password(const uint8_t *new_password){
+
   if (!new_password) return false; //pointer is null!!
-  
-  EEPROM_HW_Init(); //initialize eeprom block !!
 
-  uint32_t full_password = ( new_password[0] | ((new_password[1])<<8) | ((new_password[2])<<16) | ((new_password[3])<<24));
+  uint32_t full_password = ( new_password[0] | ((new_password[1])<<8) | ((new_password[2])<<16) | ((uint32_t)(new_password[3])<<24));
 
-   if (!EEPROM_HW_WriteWord(USED_BLOCK, PASSWORD_OFFSET, full_password)) {
+   if (!write_Word(PASSWORD_OFFSET, full_password)) {
        return false;
    }
 
    uint32_t last_char = new_password[4];
-   if (!EEPROM_HW_WriteWord(USED_BLOCK, LAST_CHAR_OFFSET, last_char)) {
+   if (!write_Word(LAST_CHAR_OFFSET, last_char)) {
        return false;
    }
 
@@ -54,32 +115,60 @@ bool change_Password(const uint8_t *new_password){
 
 
 int get_AutoLockTimeout(){
-  
-  EEPROM_HW_Init(); //initialize eeprom block !!
-  
-  uint32_t full_word = EEPROM_HW_ReadWord(USED_BLOCK, AUTOLOCKOUT_OFFSET);
-  uint8_t timeout =  (full_word & 0xFF); //this should only have byte 0 !!
-  
-  return timeout; //compiler inertprets it as an integer 
+
+  load_Once();
+
+  uint8_t timeout =  (mirror[AUTOLOCKOUT_OFFSET] & 0xFF); //this should only have byte 0 !!
+
+  return timeout; //compiler inertprets it as an integer
 }
 
 
 
 bool set_AutoLockTimeout(const uint8_t lockout_time ){
-  
+
   if((lockout_time < 5) ||(lockout_time > 30)) { return false;}
-  
-  EEPROM_HW_Init(); //initialize eeprom block !!
+
+  load_Once();
 
   //the stored first byte of the word is the one that has got the value of the timeout !!
-  
-  uint32_t oldValue = EEPROM_HW_ReadWord(USED_BLOCK, AUTOLOCKOUT_OFFSET);;
-  uint32_t valueToStore = ( oldValue & 0xffffff00 ) | (lockout_time); //we can only write a whole word 
+  uint32_t valueToStore = ( mirror[AUTOLOCKOUT_OFFSET] & 0xffffff00 ) | (lockout_time); //we can only write a whole word
 
-  if (!EEPROM_HW_WriteWord(USED_BLOCK, AUTOLOCKOUT_OFFSET, valueToStore)) {
-      return false;
+  return write_Word(AUTOLOCKOUT_OFFSET, valueToStore);
+}
+
+
+void save_EepromImage(uint32_t *words){
+
+  load_Once();
+
+  for (uint32_t i = 0; i < USED_WORDS; i++){
+      words[i] = mirror[i];
   }
+}
+
 
+void load_EepromImage(const uint32_t *words){
 
-  return true; // write succeeded
-}
\ No newline at end of file
+  //checked by init_Eeprom on the boot that read it, the warm state has its own CRC
+  for (uint32_t i = 0; i < USED_WORDS; i++){
+      mirror[i] = words[i];
+  }
+  loaded = true;
+}
+
+
+bool get_InitFlag(void){
+
+  load_Once();
+
+  return (mirror[INIT_FLAG_OFFSET] & 1) == 1;
+}
+
+
+bool set_InitFlag(void){
+
+  load_Once();
+
+  return write_Word(INIT_FLAG_OFFSET, mirror[INIT_FLAG_OFFSET] | 1);
+}
@@ -3,13 +3,26 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#define EEPROM_IMAGE_WORDS 4 //size of the RAM copy, see save_EepromImage
+
 //function declarations
 
-//used block no.1 & offsets 0&1
+//EEPROM_HW_Init once, then loads the stored settings into RAM; call it again to reload.
+//Every other function works on that RAM copy, the setters write through to the eeprom
+void init_Eeprom(void);
+
+//the RAM copy as it is, and back: a warm reset carries it across (software_reset.h)
+//so that boot reads nothing from the eeprom. words holds EEPROM_IMAGE_WORDS
+void save_EepromImage(uint32_t *words);
+void load_EepromImage(const uint32_t *words);
+
+//used block no.1 & offsets 0..3
 bool compare_Passwords(const uint8_t *entered_password); //compares sent password with the stored one!!
 bool change_Password(const uint8_t *new_password); //changes stored password with the passed new one 
 int get_AutoLockTimeout(); //returns the value of timeout !!
 bool set_AutoLockTimeout(const uint8_t lockout_time ); //sets a new auto lockout time 
+bool get_InitFlag(void); //true once a password was set up (and a 5-digit one is stored)
+bool set_InitFlag(void); //marks the password as set up
 
 
 #endif
@@ -1,10 +1,9 @@
 #include "motor.h"
 #include "../../../Common/MCAL/tm4c123gh6pm.h"
 #include "../../../Common/HAL/comm_interface.h"
+#include "../../../Common/Utils/swtimer.h"
 
 
-#define CLK_FREQUENCY 16000000
-
 volatile uint8_t Door_State = 0; // 0 = closing and is kept in closed state, 1 = opening
 
 /* 
@@ -44,62 +43,88 @@ void init_Motor(void){
   GPIO_PORTB_DEN_R |= ((1<<2) | (1<<3));
   GPIO_PORTB_DIR_R |= ((1<<2) | (1<<3));
   
-  
-  //***********************init timer 1*********************************//
-  SYSCTL_RCGCTIMER_R |= (1<<1); //enable clk to timer 1
-  while ((SYSCTL_PRTIMER_R & (1 << 1)) == 0); //wait till its set up
-  
-  TIMER1_CTL_R &= ~(1 << 0); //disable timer before configuration
-  TIMER1_CFG_R = 0x0; //enable it as a 32-bit timer 
-  TIMER1_TAMR_R = 0x1; //enable one shot mode!!
-  
-  TIMER1_ICR_R = 0x01; //disable interrupts
-  TIMER1_IMR_R |= 0x01; //enable interrupts 
-  NVIC_EN0_R |= (1 << 21); // enable TIMER1A's only interrupt in NVIC!!!
   //***********************init leds************************************//
   init_LEDs();
 }
 
+//door cycle driven by a software timer (swtimer.h), one one-shot per phase, nothing waits in a loop
+typedef enum {
+  MOTOR_IDLE,    //closed, motor stopped
+  MOTOR_OPENING, //IN1 = 1 for MOTOR_MOVE_MS
+  MOTOR_OPEN,    //stopped for the auto-lock time
+  MOTOR_CLOSING  //IN2 = 1 for MOTOR_MOVE_MS
+} MotorPhase;
+
+static void phase_End(void *arg);
+
+static volatile MotorPhase phase = MOTOR_IDLE;
+static uint32_t openMs; //auto-lock time
+static SWTIMER_Timer phaseTimer = SWTIMER_TIMER(phase_End, 0);
+
+static void run_Timer(uint32_t ms){
+  SWTIMER_Start(&phaseTimer, ms, 0); //restarts it if the door was still moving
+}
+
 //NOTE: IN1 ->PB2 & IN2 ->PB3 !!
 void open_door(void){
   Door_State = 1; //change mmotor state to opening 
+  phase = MOTOR_OPENING;
+  GPIO_PORTB_DATA_R &= ~(1<<3); //IN2 = 0, in case the door was closing
   GPIO_PORTB_DATA_R |=  (1<<2); //IN1 = 1
-  GPIO_PORTB_DATA_R &= ~(1<<3); //IN2 = 0
-  for(int i = 0; i<9000000;i++){} //delay to keep the motor mocing for a while 
-  TIMER1_CTL_R = 0x1; //start timer 
-  GPIO_PORTB_DATA_R &= ~(1<<2);  //IN1 = 0 (the input to the h bridge is [0 & 0] to stop the movemnt)
+  run_Timer(MOTOR_MOVE_MS); //keep the motor moving for a while
 }
 
 void close_door(void){
-  
+  phase = MOTOR_CLOSING;
   //change motor movemnt direction
   GPIO_PORTB_DATA_R &= ~(1<<2); //IN1 = 0
   GPIO_PORTB_DATA_R |=  (1<<3); //IN2 = 1
   
   toggle_LED(1 << 3); 
-  for(int i = 0; i<9000000;i++){} //delay to keep the motor moving for a while
-  GPIO_PORTB_DATA_R &= ~(1<<3); //IN2 = 0 (the input to the h bridge is [0 & 0] to stop the movemnt)
-  COMM_SendCommand(CMD_ACK);
+  run_Timer(MOTOR_MOVE_MS); //keep the motor moving for a while
 }
 
-void Timer1A_Handler(void){
-  TIMER1_ICR_R = 0x1; // clear interrupt flag
-  close_door();
-  Door_State = 0; //change state to closed
+//end of a phase, run from SWTIMER_Service in the main loop
+static void phase_End(void *arg){
+  (void)arg;
+  switch (phase) {
+  case MOTOR_OPENING:
+    GPIO_PORTB_DATA_R &= ~(1<<2);  //IN1 = 0 (the input to the h bridge is [0 & 0] to stop the movemnt)
+    phase = MOTOR_OPEN;
+    run_Timer(openMs); //door stays open for the auto-lock time
+    break;
+  case MOTOR_OPEN:
+    close_door();
+    break;
+  case MOTOR_CLOSING:
+    GPIO_PORTB_DATA_R &= ~(1<<3); //IN2 = 0 (the input to the h bridge is [0 & 0] to stop the movemnt)
+    phase = MOTOR_IDLE;
+    Door_State = 0; //change state to closed
+    break;
+  default:
+    break;
+  }
 }
 
 
 
 //Note: auto_lockoutSeconds is an integer number representing the number of seconds the door should be opened for !!
+//returns at once, the door opens, waits and closes from its software timer
 void start_Motor(int auto_lockoutSeconds){
   
   init_Motor();
   
-  TIMER1_CTL_R &= ~(1 << 0); //disable timer before configuration
-  TIMER1_ICR_R = 0x01; //clear interrupt flag
-  
-  TIMER1_TAILR_R = (auto_lockoutSeconds * CLK_FREQUENCY) -1;
+  openMs = (uint32_t)auto_lockoutSeconds * 1000u;
   
   open_door();
   toggle_LED(1 << 2);
 }
+
+//after a warm reset the pins are low again with the door open or half way, run it closed
+void lock_Motor(void){
+  
+  init_Motor();
+  
+  Door_State = 1; //counts as open until the closing phase ends
+  close_door();
+}
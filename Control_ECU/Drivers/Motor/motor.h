@@ -3,11 +3,21 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+//how long the motor runs to open or to close the door (ms)
+#define MOTOR_MOVE_MS 2000
+
 //function declarations
 
+void init_LEDs(void); //PF1-PF3 as outputs, used as status LEDs
+void toggle_LED(uint8_t led_pin); //turns all status LEDs off, then the given pin on
+
 //pass the seconds needed for the door to stay open!!
+//returns at once: the door opens (MOTOR_MOVE_MS), stays open, then closes (MOTOR_MOVE_MS)
 void start_Motor(int auto_lockoutSeconds);
 
+//closes the door from wherever a reset stopped it (MOTOR_MOVE_MS), returns at once
+void lock_Motor(void);
+
 uint8_t motor_state(void); //returns door state (-1 is for closinga and maintaing closed state | 1 for openeed and maintain state ) 
 
 #endif 
\ No newline at end of file
@@ -1,17 +1,94 @@
+ #include <string.h>
  #include "../Common/HAL/comm_interface.h"
+ #include "../Common/HAL/comm_dispatch.h"
+ #include "../Common/Utils/sched.h"
+ #include "../Common/Utils/boot_profile.h"
  #include "Drivers/Eeprom/eeprom.h"
  #include "Drivers/Motor/motor.h"
  #include "Drivers/Buzzer/buzzer.h"
  #include "Helpers/timer.h"
-//#include "Helpers/software_reset.h"
+ #include "Helpers/password_init.h"
+ #include "../Common/MCAL/cpu.h"
+ #include "../Common/MCAL/tick.h"
+ #include "../Common/MCAL/power.h"
+ #include "Helpers/software_reset.h"
  #include "../Common/MCAL/tm4c123gh6pm.h"
 
 #define MAX_ATTEMPTS 2
-#define TIMEOUT_MS 100
+#define LINK_CHECK_MS 100 // how often a silent HMI is looked for
+#define LINK_HANDSHAKE_MS 50 // longest a LinkTask run listens for the HMI's answer to its READY
+#define LOCKOUT_MS 60000  // no password is checked for this long after the alarm
+#define RESET_QUIET_MS 50 // longest a warm reset waits for received bytes to be handled
 
-void static inline WaitForAck(void);
-void static inline IncrementAttempts(uint8_t *attempts);
+bool static inline IncrementAttempts(uint8_t *attempts);
 void static inline ResetAttempts(uint8_t *attempts);
+bool static VerifyCredential(const COMM_FrameView *frame, uint8_t *attempts);
+static void StartLockout(void);
+static void ReplyLockout(uint8_t seq);
+
+static void HandleSendPassword(const COMM_FrameView *frame);
+static void HandleVerifyAndUnlock(const COMM_FrameView *frame);
+static void HandleVerifyAndSetTimeout(const COMM_FrameView *frame);
+static void HandleVerifyAndChange(const COMM_FrameView *frame);
+static void HandleChangePassword(const COMM_FrameView *frame);
+static void HandleDoorUnlock(const COMM_FrameView *frame);
+static void HandleSetTimeout(const COMM_FrameView *frame);
+static void HandleReady(const COMM_FrameView *frame);
+static void HandleAck(const COMM_FrameView *frame);
+static void HandleHeartbeat(const COMM_FrameView *frame);
+static void HandleStats(const COMM_FrameView *frame);
+static void HandleAlarm(const COMM_FrameView *frame);
+static void HandleBoot(const COMM_FrameView *frame);
+
+static void RxTask(void);
+static void LinkTask(void);
+static void LockoutTask(void);
+static void ResetTask(void);
+static void OnBytesReceived(void);
+static void WarmBoot(const RESET_WarmState *warm);
+void RequestWarmReset(void); // for the sim's "reset" device command, nothing on the board calls it yet
+
+// Handler of every command the HMI may send, by ID. Payload sizes, password
+// digits and negotiated features come from the protocol table
+// (comm_protocol.h), COMM_Dispatch checks them before a handler runs
+static const COMM_CommandHandler handlers[COMM_COMMAND_SLOTS] = {
+    [COMM_COMMAND_INDEX(CMD_READY)]                  = HandleReady,
+    [COMM_COMMAND_INDEX(CMD_SEND_PASSWORD)]          = HandleSendPassword,
+    [COMM_COMMAND_INDEX(CMD_CHANGE_PASSWORD)]        = HandleChangePassword,
+    [COMM_COMMAND_INDEX(CMD_DOOR_UNLOCK)]            = HandleDoorUnlock,
+    [COMM_COMMAND_INDEX(CMD_SET_TIMEOUT)]            = HandleSetTimeout,
+    [COMM_COMMAND_INDEX(CMD_ALARM)]                  = HandleAlarm,
+    [COMM_COMMAND_INDEX(CMD_ACK)]                    = HandleAck,
+    [COMM_COMMAND_INDEX(CMD_VERIFY_AND_UNLOCK)]      = HandleVerifyAndUnlock,
+    [COMM_COMMAND_INDEX(CMD_VERIFY_AND_SET_TIMEOUT)] = HandleVerifyAndSetTimeout,
+    [COMM_COMMAND_INDEX(CMD_VERIFY_AND_CHANGE)]      = HandleVerifyAndChange,
+    [COMM_COMMAND_INDEX(CMD_STATS)]                  = HandleStats,
+    [COMM_COMMAND_INDEX(CMD_HEARTBEAT)]              = HandleHeartbeat,
+    [COMM_COMMAND_INDEX(CMD_PROFILE)]                = COMM_DispatchProfileHandler,
+    [COMM_COMMAND_INDEX(CMD_BOOT)]                   = HandleBoot,
+};
+
+// Main loop work, run to completion by the scheduler in this order. The
+// drivers do their timing on software timers (motor.c, buzzer.c), so a
+// command is never stuck behind the door moving or the alarm sounding
+static SCHED_Task rxTask = SCHED_TASK(RxTask);
+static SCHED_Task linkTask = SCHED_TASK(LinkTask);
+static SCHED_Task lockoutTask = SCHED_TASK(LockoutTask);
+static SCHED_Task resetTask = SCHED_TASK(ResetTask);
+static SCHED_Task *const tasks[] = { &rxTask, &linkTask, &lockoutTask, &resetTask };
+
+static uint8_t incorrectAttempts = 0;
+// Lockout: armed lockoutTask, ends at lockoutEndMs (Tick_Deadline)
+static uint32_t lockoutEndMs;
+// Warm reset requested, it happens once the RX ring is empty or by then
+static uint32_t resetDeadlineMs;
+// LinkTask's handshake is under way: the HMI's answer to a READY stays in
+// the RX ring for its next run, rxTask would take it for a stray repeat
+static bool linkHandshaking = false;
+// Base-protocol HMI (no CMD_VERIFY_AND_*): a correct CMD_SEND_PASSWORD
+// allows the one frame right after it to unlock or change settings
+static bool passwordChecked = false;
+static bool authorized = false;
 
 //void init_LEDs(void) {
   //  SYSCTL_RCGCGPIO_R |= (1 << 5);        //enable clock for Port F
@@ -30,106 +107,318 @@ void static inline ResetAttempts(uint8_t *attempts);
 
 int main(void) {
 
-     __asm("CPSIE I");  // set the I-bit in PRIMASK ? enables global interrupts
+    CPU_EnableInterrupts();  // clear PRIMASK (CPSIE I), enables global interrupts
+    // Start the 64-bit clock behind GetTicks() before anything reads the time
+    CLOCK_Init();
+    // Every init step is timed from here, the HMI asks for the marks (CMD_BOOT)
+    BOOT_Start();
     // Initialize the communication path
     COMM_Init();
+    BOOT_Mark(BOOT_COMM);
+    COMM_DispatchInit(handlers, COMM_FROM_HMI);
     init_LEDs();  //init leds debugging purposes
-    // Initialize the timer
-    SysTick_Init(16000, SYSTICK_INT);
+    BOOT_Mark(BOOT_DRIVERS);
+    // Sleep (WFI) whenever the scheduler has nothing to run
+    POWER_Init();
+    BOOT_Mark(BOOT_POWER);
+    SCHED_Init(tasks, sizeof(tasks) / sizeof(tasks[0]));
+    BOOT_Mark(BOOT_SCHED);
+
+    RESET_WarmState warm;
+    if (RESET_WarmStart(&warm)) {
+        // Back from our own ResetTiva: carry on where we stopped
+        WarmBoot(&warm);
+    } else {
+        // Password, auto-lock time and init flag into RAM: from here on no
+        // command reads the EEPROM, the setters write through
+        init_Eeprom();
+        BOOT_Mark(BOOT_EEPROM);
+        // Handshake with the HMI_ECU: tell it whether a password must be set up
+        // (CMD_INIT) or not (CMD_ACK) and agree on the fastest common baud rate
+        COMM_HandshakeInitiate(is_password_init() ? CMD_ACK : CMD_INIT);
+    }
+    BOOT_Mark(BOOT_LINK);
+
+    // UARTprintf("DEBUG: Received Password via UART: %s\n", input);
+    COMM_SetRxCallback(OnBytesReceived);
+    SCHED_Post(&rxTask);        // frames that came in with the handshake
+    SCHED_PostAfter(&linkTask, LINK_CHECK_MS);
+    BOOT_Mark(BOOT_READY);
+    SCHED_Run();
+    return 0;
+}
 
-    // Send a command to the Control_ECU that the HMI_ECU is reading for communication
-    COMM_SendCommand(CMD_READY);
-    while (COMM_ReceiveCommand() != CMD_READY) { }
+// UART RX interrupt: frames may be waiting
+static void OnBytesReceived(void) {
+    SCHED_Post(&rxTask);
+}
 
-    // Check if password is already initialized
-    if (!is_password_init()) {
-        COMM_SendCommand(CMD_INIT);
+// One frame per run, it posts itself again while frames are waiting
+static void RxTask(void) {
+    COMM_FrameView frame;
+    // The frame is read where it sits in the UART RX ring and released
+    // once it has been answered, nothing is copied onto the stack
+    if (linkHandshaking || !COMM_PeekFrame(&frame)) {
+        return;
     }
-    else
-    {
-        COMM_SendCommand(CMD_ACK);
+    // The HMI sends a request again when our reply got lost. Answer it
+    // from the reply cache, it must not unlock or count an attempt twice
+    if (COMM_ReplayReply(frame.cmd, frame.seq)) {
+        COMM_ReleaseFrame(&frame);
+        SCHED_Post(&rxTask);
+        return;
     }
+    // Every reply echoes frame.seq so the HMI can match it to its request
+    authorized = passwordChecked && !COMM_PeerSupports(CMD_VERIFY_AND_UNLOCK);
+    passwordChecked = false;
+    COMM_Dispatch(&frame);
+    COMM_ReleaseFrame(&frame);
+    SCHED_Post(&rxTask);
+}
 
-    // UARTprintf("DEBUG: Received Password via UART: %s\n", input);
-    uint8_t incorrectAttempts = 0;
-    uint8_t input[10];
-
-    for (;;) {
-        const uint8_t command = COMM_ReceiveCommand();
-        // Already executed command
-
-        switch (command) {
-        case CMD_SEND_PASSWORD:{
-                COMM_ReceiveMessage(input);
-                bool volatile isCorrect = compare_Passwords(input);
-
-                if (isCorrect == true) {
-                    COMM_SendCommand(CMD_PASSWORD_CORRECT);
-                    toggle_LED(1 << 3);
-                } else {
-                    COMM_SendCommand(CMD_PASSWORD_WRONG);
-                    IncrementAttempts(&incorrectAttempts);
-                    COMM_SendCommand(CMD_PASSWORD_WRONG);
-                    toggle_LED(1 << 1);
-                }
-                WaitForAck();
-                break;
+// No frame, not even a heartbeat, for COMM_LINK_TIMEOUT_MS: the HMI
+// was reset and waits in its handshake at the fallback rate. One READY
+// per run, so the motor, the lockout and a warm reset go on meanwhile
+static void LinkTask(void) {
+    if (!COMM_LinkAlive()) {
+        linkHandshaking = COMM_HandshakeInitiateUntil(is_password_init() ? CMD_ACK : CMD_INIT,
+                                                      Tick_Deadline(LINK_HANDSHAKE_MS)) == 0;
+        if (!linkHandshaking) {
+            SCHED_Post(&rxTask);
         }
-            case CMD_DOOR_UNLOCK: 
-              volatile int seconds = get_AutoLockTimeout();
-            // get_AutoLockTimeout() ######ADD THIS IN ATART MOTOR() 
-                start_Motor(seconds);
-                break;
-        case CMD_CHANGE_PASSWORD:{
-                COMM_ReceiveMessage(input);
-                bool flag = change_Password(input);
-                if(flag){
-                     COMM_SendCommand(CMD_ACK); //return ack
-                     set_init_flag();
-                     toggle_LED(1 << 2);
-                }
-                break;
-        }
-            case CMD_SET_TIMEOUT:
-                COMM_ReceiveMessage(input);
-                if (set_AutoLockTimeout(input[0])) {
-                    COMM_SendCommand(CMD_SUCCESS);
-                } else {
-                    // Must be >= 5 && <= 30
-                    COMM_SendCommand(CMD_FAIL);
-                }
-                break;
-            default:
-                COMM_SendCommand(CMD_UNKNOWN);
-                break;
+    }
+    SCHED_PostAfter(&linkTask, LINK_CHECK_MS);
+}
+
+// LOCKOUT_MS after the alarm: passwords are checked again, from a fresh count
+static void LockoutTask(void) {
+    ResetAttempts(&incorrectAttempts);
+}
+
+// Warm reset at the next pass of the main loop, no command is half handled then.
+// The board has no trigger yet: no recovery path or command asks for one
+void RequestWarmReset(void) {
+    resetDeadlineMs = Tick_Deadline(RESET_QUIET_MS);
+    SCHED_Post(&resetTask);
+}
+
+// Everything the next boot needs to skip the handshake and the EEPROM reads. The
+// clock restarts at 0, so the lockout goes across as the time it has left
+static void ResetTask(void) {
+    // A request still in the RX ring would be lost and cost the HMI a
+    // retransmission: answer it first (rxTask runs before us)
+    if (UART_RxAvailable() > 0 && !Tick_Expired(resetDeadlineMs)) {
+        SCHED_PostAfter(&resetTask, 1);
+        return;
+    }
+    RESET_WarmState warm;
+    memset(&warm, 0, sizeof(warm));
+    warm.attempts = incorrectAttempts;
+    warm.doorOpen = motor_state() != 0;
+    if (SCHED_IsArmed(&lockoutTask)) {
+        // 1 ms at least, an expired lockout still ends through LockoutTask
+        warm.lockoutLeftMs = Tick_Expired(lockoutEndMs) ? 1 : lockoutEndMs - GetTicks();
+    }
+    // Waits for the last reply to leave, the UART is reset with the rest
+    warm.linkSaved = COMM_LinkSave(&warm.link);
+    save_EepromImage(warm.eeprom);
+    ResetTiva(&warm);
+}
+
+// The state ResetTask left. The buzzer stays quiet, the alarm was heard
+static void WarmBoot(const RESET_WarmState *warm) {
+    // The settings as they were, the EEPROM is not even brought up until a setter writes
+    load_EepromImage(warm->eeprom);
+    BOOT_Mark(BOOT_EEPROM);
+    incorrectAttempts = warm->attempts;
+    if (warm->lockoutLeftMs) {
+        lockoutEndMs = Tick_Deadline(warm->lockoutLeftMs);
+        SCHED_PostAfter(&lockoutTask, warm->lockoutLeftMs);
+    }
+    if (warm->doorOpen) {
+        lock_Motor();
+    }
+    // Without a saved link, or when the resume fails, the link stays down
+    // and LinkTask shakes hands without holding up the restored timers
+    if (warm->linkSaved) {
+        COMM_LinkResume(&warm->link);
+    }
+}
+
+static void HandleSendPassword(const COMM_FrameView *frame) {
+    if (VerifyCredential(frame, &incorrectAttempts)) {
+        COMM_SendReply(frame->seq, CMD_PASSWORD_CORRECT, NULL, 0);
+        passwordChecked = true;
+        toggle_LED(1 << 3);
+    }
+}
+
+static void HandleVerifyAndUnlock(const COMM_FrameView *frame) {
+    if (VerifyCredential(frame, &incorrectAttempts)) {
+        uint8_t seconds = get_AutoLockTimeout();
+        // reply first, the HMI counts the door cycle down on its own
+        COMM_SendReply(frame->seq, CMD_SUCCESS, &seconds, 1);
+        toggle_LED(1 << 3);
+        start_Motor(seconds);
+    }
+}
+
+static void HandleVerifyAndSetTimeout(const COMM_FrameView *frame) {
+    if (VerifyCredential(frame, &incorrectAttempts)) {
+        // Must be >= 5 && <= 30
+        bool saved = set_AutoLockTimeout(frame->payload[COMM_PASSWORD_LENGTH]);
+        COMM_SendReply(frame->seq, saved ? CMD_SUCCESS : CMD_FAIL, NULL, 0);
+    }
+}
+
+static void HandleVerifyAndChange(const COMM_FrameView *frame) {
+    if (VerifyCredential(frame, &incorrectAttempts)) {
+        bool changed = change_Password(&frame->payload[COMM_PASSWORD_LENGTH]);
+        COMM_SendReply(frame->seq, changed ? CMD_ACK : CMD_FAIL, NULL, 0);
+        if (changed) {
+            toggle_LED(1 << 2);
         }
     }
-    return 0;
 }
 
-// Loop indefinitely until a response is made
-void inline WaitForAck(void) {
-    // record start time
-    uint32_t start = GetTicks();
+static void HandleChangePassword(const COMM_FrameView *frame) {
+    // Only for the first-time setup, later changes go through
+    // CMD_VERIFY_AND_CHANGE (or follow CMD_SEND_PASSWORD on the
+    // base protocol) so the old password is always checked. The flag is
+    // written before the reply: an ACK means the next boot skips the setup
+    bool flag = (!is_password_init() || authorized) &&
+                change_Password(frame->payload) &&
+                set_init_flag();
+    if(flag){
+         COMM_SendReply(frame->seq, CMD_ACK, NULL, 0); //return ack
+         toggle_LED(1 << 2);
+    } else {
+         COMM_SendReply(frame->seq, CMD_FAIL, NULL, 0); //already set or eeprom write failed
+    }
+}
+
+static void HandleDoorUnlock(const COMM_FrameView *frame) {
+    // No credential in this frame: only right after CMD_SEND_PASSWORD
+    // from an HMI without CMD_VERIFY_AND_UNLOCK
+    if (authorized) {
+        uint8_t seconds = get_AutoLockTimeout();
+        COMM_SendReply(frame->seq, CMD_SUCCESS, &seconds, 1);
+        start_Motor(seconds);
+    } else {
+        COMM_SendReply(frame->seq, CMD_FAIL, NULL, 0);
+    }
+}
+
+static void HandleSetTimeout(const COMM_FrameView *frame) {
+    if (authorized && set_AutoLockTimeout(frame->payload[0])) {
+        COMM_SendReply(frame->seq, CMD_SUCCESS, NULL, 0);
+    } else {
+        COMM_SendReply(frame->seq, CMD_FAIL, NULL, 0);
+    }
+}
+
+static void HandleReady(const COMM_FrameView *frame) {
+    // Late baud probe from the handshake (our ACK got lost), answer again.
+    // A READY with caps is only a repeated handshake reply, ignore it.
+    // Echo the seq so a READY sent as a request (link check) is matched too
+    if (frame->len == 0) {
+        COMM_SendReply(frame->seq, CMD_ACK, NULL, 0);
+    }
+}
 
-    while (COMM_ReceiveCommand() != CMD_ACK);
+static void HandleAck(const COMM_FrameView *frame) {
+    // Replies are matched by seq now, nothing waits for an ACK here
+    (void)frame;
 }
 
-void inline IncrementAttempts(uint8_t *attempts) {
+static void HandleHeartbeat(const COMM_FrameView *frame) {
+    // The HMI checks the link while idle, any answer will do
+    COMM_SendReply(frame->seq, CMD_HEARTBEAT, NULL, 0);
+}
+
+static void HandleStats(const COMM_FrameView *frame) {
+    // Link counters of this ECU, see COMM_STATS_LEN for the layout
+    COMM_Stats stats;
+    uint8_t snapshot[COMM_STATS_LEN];
+    COMM_GetStats(&stats);
+    COMM_EncodeStats(&stats, snapshot);
+    COMM_SendReply(frame->seq, CMD_STATS, snapshot, sizeof(snapshot));
+}
+
+static void HandleBoot(const COMM_FrameView *frame) {
+    // The HMI's boot marks in, ours back, see COMM_BOOT_LEN for the layout
+    BOOT_Profile profile;
+    uint8_t marks[COMM_BOOT_LEN];
+    if (BOOT_Decode(frame->payload, frame->len, &profile)) {
+        BOOT_SetPeer(&profile);
+    }
+    BOOT_Get(&profile);
+    COMM_SendReply(frame->seq, CMD_BOOT, marks, BOOT_Encode(&profile, marks));
+}
+
+static void HandleAlarm(const COMM_FrameView *frame) {
+    // The HMI raises the alarm itself: lock out as after too many attempts
+    if (!SCHED_IsArmed(&lockoutTask)) {
+        StartLockout();
+    }
+    ReplyLockout(frame->seq);
+}
+
+// True once the attempt is one too many and the lockout has started
+bool inline IncrementAttempts(uint8_t *attempts) {
     if (*attempts < MAX_ATTEMPTS) {
         ++(*attempts);
-    } else {
-        Buzzer_Start();
-        while (buzzer_State() == 1 ) {
-          // Freeze until the buzzer finishes beeping
-        }
+        return false;
     }
+    StartLockout();
+    return true;
 }
 
 void inline ResetAttempts(uint8_t *attempts) {
     *attempts = 0;
 }
 
+// Password check at the start of a CMD_SEND_PASSWORD or CMD_VERIFY_AND_*
+// frame, its length was checked against the protocol table. A wrong one, or
+// any during the lockout, is answered here
+bool static VerifyCredential(const COMM_FrameView *frame, uint8_t *attempts) {
+    if (SCHED_IsArmed(&lockoutTask)) {
+        ReplyLockout(frame->seq);
+        return false;
+    }
+    if (!compare_Passwords(frame->payload)) {
+        if (IncrementAttempts(attempts)) {
+            ReplyLockout(frame->seq);
+        } else {
+            COMM_SendReply(frame->seq, CMD_PASSWORD_WRONG, NULL, 0);
+        }
+        toggle_LED(1 << 1);
+        return false;
+    }
+    ResetAttempts(attempts);
+    return true;
+}
+
+// Sound the alarm and refuse passwords for LOCKOUT_MS. Nothing waits for
+// the buzzer, the link is served all along
+static void StartLockout(void) {
+    Buzzer_Start();
+    lockoutEndMs = Tick_Deadline(LOCKOUT_MS);
+    SCHED_PostAfter(&lockoutTask, LOCKOUT_MS);
+}
+
+// CMD_ALARM [seconds left, rounded up] to an HMI with COMM_FEATURE_LOCKOUT,
+// an older one only learns that the password was not accepted
+static void ReplyLockout(uint8_t seq) {
+    if (!(COMM_Features() & COMM_FEATURE_LOCKOUT)) {
+        COMM_SendReply(seq, CMD_PASSWORD_WRONG, NULL, 0);
+        return;
+    }
+    uint32_t leftMs = Tick_Expired(lockoutEndMs) ? 0 : lockoutEndMs - GetTicks();
+    uint8_t seconds = (uint8_t)((leftMs + 999) / 1000);
+    COMM_SendReply(seq, CMD_ALARM, &seconds, COMM_ALARM_LEN);
+}
+
 // #define USED_BLOCK 1 //used block 1 to store passwords
 // #define PASSWORD_OFFSET 0 //used byte offset 0 to store password inside 
 
@@ -1,13 +1,13 @@
 #include "password_init.h"
+#include "../Drivers/Eeprom/eeprom.h"
 
+// The flag lives in the EEPROM driver's RAM copy, see init_Eeprom
 bool is_password_init(void)
 {
-    EEPROM_HW_Init();
-    return ((EEPROM_HW_ReadWord(1, 2) & 1) == 1);
+    return get_InitFlag();
 }
 
-void set_init_flag(void)
+bool set_init_flag(void)
 {
-    EEPROM_HW_Init();
-    EEPROM_HW_WriteWord(1, 2, 1);
-}
\ No newline at end of file
+    return set_InitFlag();
+}
@@ -5,4 +5,5 @@
 // checks eeprom (is initialized) flag and returns the password state
 bool is_password_init(void);
 
-void set_init_flag(void);
\ No newline at end of file
+// marks the password as set up, false if the eeprom write failed
+bool set_init_flag(void);
\ No newline at end of file
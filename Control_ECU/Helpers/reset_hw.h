@@ -0,0 +1,23 @@
+#ifndef RESET_HW_H
+#define RESET_HW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+  Register-level part of software_reset.c: reset_hw_tm4c.c on the board,
+  Sim/Control/reset_hw_sim.c on the host.
+*/
+
+#define RESET_HW_REGION_SIZE 256 //bytes of RAM the startup code leaves alone
+
+//the no-init region, word aligned, its contents survive a software reset
+uint8_t *RESET_HW_Region(void);
+
+//the last reset was a software reset (SYSRESETREQ), not power-on, pin or watchdog
+bool RESET_HW_WasSoftware(void);
+
+//system reset request, does not return
+void RESET_HW_Reset(void);
+
+#endif
@@ -0,0 +1,28 @@
+#include "reset_hw.h"
+#include "../../Common/MCAL/cpu.h"
+#include "../../Common/MCAL/tm4c123gh6pm.h"
+
+//IAR's startup neither zeroes nor initializes __no_init data
+__no_init static uint32_t region[RESET_HW_REGION_SIZE / sizeof(uint32_t)];
+
+uint8_t *RESET_HW_Region(void) {
+    return (uint8_t *)region;
+}
+
+bool RESET_HW_WasSoftware(void) {
+    //RESC collects the causes since power-on, clear it for the next boot
+    uint32_t cause = SYSCTL_RESC_R;
+    SYSCTL_RESC_R = 0;
+    return (cause & SYSCTL_RESC_SW) &&
+           !(cause & (SYSCTL_RESC_POR | SYSCTL_RESC_BOR | SYSCTL_RESC_EXT |
+                      SYSCTL_RESC_WDT0 | SYSCTL_RESC_WDT1 | SYSCTL_RESC_MOSCFAIL));
+}
+
+void RESET_HW_Reset(void) {
+    CPU_DisableInterrupts();
+    __asm("DSB"); //the region writes land before the reset
+    NVIC_APINT_R = NVIC_APINT_VECTKEY | NVIC_APINT_SYSRESETREQ;
+    __asm("DSB");
+    for (;;) {
+    } //the reset takes a few cycles
+}
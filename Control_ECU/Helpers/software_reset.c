@@ -1,6 +1,48 @@
+#include <string.h>
 #include "software_reset.h"
+#include "reset_hw.h"
+#include "../../Common/Utils/crc16.h"
 
-// Function to reset the
-void ResetTiva(void) {
+#define WARM_MAGIC 0x5741524Du //"WARM"
+
+//layout of the no-init region, the CRC covers state
+typedef struct {
+    uint32_t magic;
+    uint16_t size; //sizeof(RESET_WarmState) of the image that wrote it
+    uint16_t crc;
+    RESET_WarmState state;
+} WarmRecord;
+
+typedef char WarmRecordFits[(sizeof(WarmRecord) <= RESET_HW_REGION_SIZE) ? 1 : -1];
+
+static uint16_t WarmCrc(const RESET_WarmState *state) {
+    return CRC16_Compute(CRC16_INIT, (const uint8_t *)state, (uint16_t)sizeof(*state));
+}
+
+void ResetTiva(const RESET_WarmState *state) {
+    WarmRecord *record = (WarmRecord *)RESET_HW_Region();
+    if (state) {
+        memcpy(&record->state, state, sizeof(*state));
+        record->size = (uint16_t)sizeof(*state);
+        record->crc = WarmCrc(&record->state);
+        record->magic = WARM_MAGIC;
+    } else {
+        record->magic = 0;
+    }
     // Hard resets the tiva
-}
\ No newline at end of file
+    RESET_HW_Reset();
+}
+
+bool RESET_WarmStart(RESET_WarmState *state) {
+    WarmRecord *record = (WarmRecord *)RESET_HW_Region();
+    //RAM keeps garbage over power-on, only a software reset left a record on purpose
+    bool warm = RESET_HW_WasSoftware() &&
+                record->magic == WARM_MAGIC &&
+                record->size == sizeof(*state) &&
+                record->crc == WarmCrc(&record->state);
+    if (warm) {
+        memcpy(state, &record->state, sizeof(*state));
+    }
+    record->magic = 0;
+    return warm;
+}
@@ -1,3 +1,33 @@
-//#include "tm4c123gh6pm.h"
+#ifndef SOFTWARE_RESET_H
+#define SOFTWARE_RESET_H
 
-void ResetTiva(void);
\ No newline at end of file
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../Common/HAL/comm_interface.h"
+#include "../Drivers/Eeprom/eeprom.h"
+
+/*
+  Warm reset: the core restarts through SYSRESETREQ but a small no-init RAM
+  region (reset_hw.h) survives it. ResetTiva leaves the state below there with a
+  CRC, the next boot takes it back with RESET_WarmStart and carries on: no EEPROM
+  read (the settings come back from their RAM copy), no handshake, attempts and
+  lockout kept.
+  Any other reset (power-on, reset pin, watchdog) or a bad CRC is a cold boot.
+*/
+
+typedef struct {
+    uint8_t attempts;       //wrong passwords since the last correct one
+    bool doorOpen;          //the door was open or moving, the motor stopped with the reset
+    uint32_t lockoutLeftMs; //0: no lockout running (the clock restarts from 0)
+    bool linkSaved;         //link carries on, else the boot shakes hands again
+    COMM_LinkSnapshot link;
+    uint32_t eeprom[EEPROM_IMAGE_WORDS]; //the EEPROM driver's RAM copy (save_EepromImage)
+} RESET_WarmState;
+
+//software reset, does not return. state is kept for the next boot, NULL keeps nothing (cold boot)
+void ResetTiva(const RESET_WarmState *state);
+
+//true once after a warm reset: state is what ResetTiva was given. Clears it, a later reset of any kind is cold
+bool RESET_WarmStart(RESET_WarmState *state);
+
+#endif
@@ -1,28 +1,13 @@
 #include <stdint.h>
-#include "../../Common/MCAL/tm4c123gh6pm.h"
+#include "../../Common/MCAL/cpu.h"
 #include "timer.h"
 
-volatile uint32_t msTicks = 0;
-
-void SysTick_Init(uint32_t reload, uint8_t mode)
-{
-
-}
-
+/* Busy-waits on the 64-bit clock (clock.h), no tick interrupt needed */
 void DelayMs(uint32_t ms)
 {
-
+    uint32_t deadline = Tick_Deadline(ms);
+    while (!Tick_Expired(deadline))
+    {
+        CPU_Idle();
+    }
 }
-
-/*
-    SysTick Interrupt Handler
-    Overflow is automatically handled by C
-*/
-void SystickHandler(void)
-{
-   
-}
-
-uint32_t GetTicks() {
-  return msTicks;
-}
\ No newline at end of file
@@ -6,14 +6,21 @@
 void mock_eeprom_clear(void);
 void mock_eeprom_set(uint32_t block, uint32_t offset, uint32_t value);
 void mock_eeprom_force_fail(bool enable);
+uint32_t mock_eeprom_init_calls(void);
+uint32_t mock_eeprom_accesses(void);
+void mock_eeprom_clear_accesses(void);
 
 #define USED_BLOCK 1
 #define PASSWORD_OFFSET 0
 #define AUTOLOCKOUT_OFFSET 1
+#define INIT_FLAG_OFFSET 2
+#define LAST_CHAR_OFFSET 3
 
+/* A boot: blank EEPROM, settings loaded into the driver's RAM copy */
 void setUp(void) {
     mock_eeprom_clear();
     mock_eeprom_force_fail(false);
+    init_Eeprom();
 }
 
 void tearDown(void) {}
@@ -22,20 +29,26 @@ void tearDown(void) {}
 
 void test_compare_passwords_match(void) {
     mock_eeprom_set(USED_BLOCK, PASSWORD_OFFSET, 0x04030201);
+    mock_eeprom_set(USED_BLOCK, LAST_CHAR_OFFSET, 5);
+    init_Eeprom();
 
-    uint8_t pass[4] = {1, 2, 3, 4};
+    uint8_t pass[5] = {1, 2, 3, 4, 5};
     TEST_ASSERT_TRUE(compare_Passwords(pass));
 }
 
 void test_compare_passwords_mismatch(void) {
     mock_eeprom_set(USED_BLOCK, PASSWORD_OFFSET, 0x04030201);
+    mock_eeprom_set(USED_BLOCK, LAST_CHAR_OFFSET, 5);
+    init_Eeprom();
 
-    uint8_t pass[4] = {9, 9, 9, 9};
+    uint8_t pass[5] = {9, 9, 9, 9, 9};
     TEST_ASSERT_FALSE(compare_Passwords(pass));
+    uint8_t last_differs[5] = {1, 2, 3, 4, 9};
+    TEST_ASSERT_FALSE(compare_Passwords(last_differs));
 }
 
 void test_change_password_success(void) {
-    uint8_t new_pass[4] = {5, 6, 7, 8};
+    uint8_t new_pass[5] = {5, 6, 7, 8, 9};
 
     TEST_ASSERT_TRUE(change_Password(new_pass));
 
@@ -48,7 +61,7 @@ void test_change_password_null_pointer(void) {
 }
 
 void test_change_password_write_fail(void) {
-    uint8_t pass[4] = {1, 2, 3, 4};
+    uint8_t pass[5] = {1, 2, 3, 4, 5};
     mock_eeprom_force_fail(true);
 
     TEST_ASSERT_FALSE(change_Password(pass));
@@ -60,6 +73,7 @@ void test_change_password_write_fail(void) {
 
 void test_get_autolock_timeout(void) {
     mock_eeprom_set(USED_BLOCK, AUTOLOCKOUT_OFFSET, 15);
+    init_Eeprom();
 
     TEST_ASSERT_EQUAL_INT(15, get_AutoLockTimeout());
 }
@@ -80,10 +94,99 @@ void test_set_autolock_above_max(void) {
 void test_set_autolock_preserves_upper_bytes(void) {
     /* preset upper bytes */
     mock_eeprom_set(USED_BLOCK, AUTOLOCKOUT_OFFSET, 0xAABBCC00);
+    init_Eeprom();
 
     TEST_ASSERT_TRUE(set_AutoLockTimeout(20));
 
     uint32_t value = EEPROM_HW_ReadWord(USED_BLOCK, AUTOLOCKOUT_OFFSET);
 
     TEST_ASSERT_EQUAL_HEX32(0xAABBCC14, value);
-}
\ No newline at end of file
+}
+
+/* ---------- RAM COPY TESTS ---------- */
+
+void test_reads_do_not_touch_eeprom(void) {
+    uint8_t pass[5] = {'1', '2', '3', '4', '5'};
+    TEST_ASSERT_TRUE(change_Password(pass));
+    TEST_ASSERT_TRUE(set_AutoLockTimeout(12));
+    TEST_ASSERT_TRUE(set_InitFlag());
+
+    mock_eeprom_clear_accesses();
+    for (int i = 0; i < 100; i++) {
+        TEST_ASSERT_TRUE(compare_Passwords(pass));
+        TEST_ASSERT_EQUAL_INT(12, get_AutoLockTimeout());
+        TEST_ASSERT_TRUE(get_InitFlag());
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, mock_eeprom_accesses());
+
+    /* The peripheral was reset by the first init only, not per call */
+    TEST_ASSERT_EQUAL_UINT32(1, mock_eeprom_init_calls());
+}
+
+void test_setters_write_through(void) {
+    uint8_t pass[5] = {'5', '4', '3', '2', '1'};
+
+    mock_eeprom_clear_accesses();
+    TEST_ASSERT_TRUE(change_Password(pass));
+    TEST_ASSERT_TRUE(set_AutoLockTimeout(25));
+    TEST_ASSERT_TRUE(set_InitFlag());
+    /* one word each, the last password char in a second one */
+    TEST_ASSERT_EQUAL_UINT32(4, mock_eeprom_accesses());
+
+    TEST_ASSERT_EQUAL_HEX32(0x32333435, EEPROM_HW_ReadWord(USED_BLOCK, PASSWORD_OFFSET));
+    TEST_ASSERT_EQUAL_HEX32('1', EEPROM_HW_ReadWord(USED_BLOCK, LAST_CHAR_OFFSET));
+    TEST_ASSERT_EQUAL_HEX32(25, EEPROM_HW_ReadWord(USED_BLOCK, AUTOLOCKOUT_OFFSET));
+    TEST_ASSERT_EQUAL_HEX32(1, EEPROM_HW_ReadWord(USED_BLOCK, INIT_FLAG_OFFSET));
+
+    /* The next boot reads back what was written */
+    init_Eeprom();
+    TEST_ASSERT_TRUE(compare_Passwords(pass));
+    TEST_ASSERT_EQUAL_INT(25, get_AutoLockTimeout());
+    TEST_ASSERT_TRUE(get_InitFlag());
+}
+
+void test_failed_write_keeps_old_settings(void) {
+    uint8_t old_pass[5] = {'1', '1', '1', '1', '1'};
+    uint8_t new_pass[5] = {'2', '2', '2', '2', '2'};
+    TEST_ASSERT_TRUE(change_Password(old_pass));
+    TEST_ASSERT_TRUE(set_AutoLockTimeout(10));
+
+    mock_eeprom_force_fail(true);
+    TEST_ASSERT_FALSE(change_Password(new_pass));
+    TEST_ASSERT_FALSE(set_AutoLockTimeout(20));
+    mock_eeprom_force_fail(false);
+
+    TEST_ASSERT_TRUE(compare_Passwords(old_pass));
+    TEST_ASSERT_FALSE(compare_Passwords(new_pass));
+    TEST_ASSERT_EQUAL_INT(10, get_AutoLockTimeout());
+}
+
+void test_init_flag_needs_stored_password(void) {
+    /* Flag set, but no 5-digit password behind it */
+    mock_eeprom_set(USED_BLOCK, INIT_FLAG_OFFSET, 1);
+    init_Eeprom();
+    TEST_ASSERT_FALSE(get_InitFlag());
+
+    mock_eeprom_set(USED_BLOCK, PASSWORD_OFFSET, 0x34333231);
+    mock_eeprom_set(USED_BLOCK, LAST_CHAR_OFFSET, '5');
+    init_Eeprom();
+    TEST_ASSERT_TRUE(get_InitFlag());
+}
+
+void test_warm_image_reads_nothing(void) {
+    uint8_t pass[5] = {'9', '8', '7', '6', '5'};
+    uint32_t image[EEPROM_IMAGE_WORDS];
+    TEST_ASSERT_TRUE(change_Password(pass));
+    TEST_ASSERT_TRUE(set_AutoLockTimeout(18));
+    TEST_ASSERT_TRUE(set_InitFlag());
+    save_EepromImage(image);
+
+    /* What a warm boot finds: the eeprom says otherwise, the image wins */
+    mock_eeprom_clear();
+    mock_eeprom_clear_accesses();
+    load_EepromImage(image);
+    TEST_ASSERT_TRUE(compare_Passwords(pass));
+    TEST_ASSERT_EQUAL_INT(18, get_AutoLockTimeout());
+    TEST_ASSERT_TRUE(get_InitFlag());
+    TEST_ASSERT_EQUAL_UINT32(0, mock_eeprom_accesses());
+}
@@ -8,6 +8,9 @@
 void mock_eeprom_clear(void);
 void mock_eeprom_set(uint32_t block, uint32_t offset, uint32_t value);
 void mock_eeprom_force_fail(bool enable);
+uint32_t mock_eeprom_init_calls(void);
+uint32_t mock_eeprom_accesses(void);
+void mock_eeprom_clear_accesses(void);
 
 /* Unity test setup/teardown */
 void setUp(void);
@@ -27,4 +30,11 @@ void test_set_autolock_below_min(void);
 void test_set_autolock_above_max(void);
 void test_set_autolock_preserves_upper_bytes(void);
 
+/* ---------- RAM COPY TESTS ---------- */
+void test_reads_do_not_touch_eeprom(void);
+void test_setters_write_through(void);
+void test_failed_write_keeps_old_settings(void);
+void test_init_flag_needs_stored_password(void);
+void test_warm_image_reads_nothing(void);
+
 #endif // EEPROM_UNIT_TEST_H
\ No newline at end of file
@@ -18,5 +18,12 @@ int main(void) {
     RUN_TEST(test_set_autolock_above_max);
     RUN_TEST(test_set_autolock_preserves_upper_bytes);
 
+    /* ---------- RAM COPY TESTS ---------- */
+    RUN_TEST(test_reads_do_not_touch_eeprom);
+    RUN_TEST(test_setters_write_through);
+    RUN_TEST(test_failed_write_keeps_old_settings);
+    RUN_TEST(test_init_flag_needs_stored_password);
+    RUN_TEST(test_warm_image_reads_nothing);
+
     return UNITY_END();  // Print summary
 }
\ No newline at end of file
@@ -2,14 +2,20 @@
 
 static uint32_t fake_eeprom[4][16];
 static bool force_write_fail;
+static uint32_t init_calls;     /* never cleared, the driver inits once per boot */
+static uint32_t hw_accesses;    /* reads and writes since mock_eeprom_clear_accesses */
 
-void EEPROM_HW_Init(void) {}
+void EEPROM_HW_Init(void) {
+    init_calls++;
+}
 
 uint32_t EEPROM_HW_ReadWord(uint32_t block, uint32_t offset) {
+    hw_accesses++;
     return fake_eeprom[block][offset];
 }
 
 bool EEPROM_HW_WriteWord(uint32_t block, uint32_t offset, uint32_t value) {
+    hw_accesses++;
     if (force_write_fail) return false;
     fake_eeprom[block][offset] = value;
     return true;
@@ -32,4 +38,16 @@ void mock_eeprom_set(uint32_t block, uint32_t offset, uint32_t value) {
 
 void mock_eeprom_force_fail(bool enable) {
     force_write_fail = enable;
-}
\ No newline at end of file
+}
+
+uint32_t mock_eeprom_init_calls(void) {
+    return init_calls;
+}
+
+uint32_t mock_eeprom_accesses(void) {
+    return hw_accesses;
+}
+
+void mock_eeprom_clear_accesses(void) {
+    hw_accesses = 0;
+}
@@ -1,4 +1,5 @@
 #include "comm_interface.h"
+#include "tick.h"
 #include "src/door/door_driver.h"
 #include "src/eeprom/eeprom_driver.h"
 
@@ -11,12 +12,15 @@ int main(void) {
     while (COMM_ReceiveCommand() != CMD_ACK) { }
 
     for (;;) {
-        const uint8_t command = COMM_ReceiveCommand();
+        uint8_t command;
+        uint8_t input[10];
+        uint8_t len;
+        // Command and payload come in one frame, at most sizeof(input) bytes are kept
+        while (COMM_ReceiveMessage(&command, input, sizeof(input), &len,
+                                   Tick_Deadline(1000)) == COMM_TIMEOUT) { }
 
         switch (command) {
             case CMD_SEND_PASSWORD:
-                uint8_t input[10];
-                COMM_ReceiveMessage(input);
                 int bool = compare_passwords(input);
 
                 if (bool == 0) {
@@ -36,8 +40,7 @@ int main(void) {
                 unlock_door();
                 break;
             case CMD_CHANGE_PASSWORD:
-                uint8_t new_pass[10];
-                change_password(new_pass);
+                change_password(input);
                 COMM_SendCommand(CMD_ACK);
                 break;
             default:
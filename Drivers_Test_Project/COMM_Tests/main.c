@@ -3,49 +3,88 @@
 
 
 /*
-    Test file for the communication interface. It contains echo tests, command 
-    tests and string message tests.
-    These tests are done using putty (python script) 
+    Test file for the communication interface. It contains echo tests, command
+    tests and password frame tests.
+    The board plays Control: it starts the handshake (password already set up,
+    so CMD_ACK), checks every request against the protocol table and answers
+    it with its SEQ. Sim/Bench/comm_link_bench.c can drive it over a serial
+    port with the default --password 12345 and measure every command (see README).
 */
 
+static const uint8_t password[COMM_PASSWORD_LENGTH] = { '1', '2', '3', '4', '5' };
+
+static bool password_Matches(const uint8_t *payload)
+{
+  return memcmp(payload, password, COMM_PASSWORD_LENGTH) == 0;
+}
+
 int main()
 {
   COMM_Init();
-  COMM_SendMessage((uint8_t*)"Hello, from TM4C!\n");
-  uint8_t puttyMsg[50];
+  COMM_HandshakeInitiate(CMD_ACK);
+  COMM_Frame frame;
+  uint8_t seconds = 10;
   while(1)
   {
-    uint8_t cmd = COMM_ReceiveCommand();
-    switch(cmd)
+    COMM_ReceiveFrame(&frame);
+    if(COMM_ReplayReply(frame.cmd, frame.seq))
+    {
+      continue;   // retransmitted request, answered again from the cache
+    }
+    // sizes and password digits as in comm_protocol.h, like Control's dispatcher
+    COMM_CheckResult check = COMM_CheckPayload(frame.cmd, frame.payload, frame.len, COMM_FROM_HMI);
+    if(check != COMM_CHECK_OK)
+    {
+      COMM_SendReply(frame.seq, (check == COMM_CHECK_MALFORMED) ? CMD_FAIL : CMD_UNKNOWN, NULL, 0);
+      continue;
+    }
+    switch(frame.cmd)
     {
         case CMD_READY:
-            COMM_SendCommand(CMD_ACK);
+            COMM_SendReply(frame.seq, CMD_ACK, NULL, 0);
             break;
         case CMD_SEND_PASSWORD:
-            uint8_t password[20];
-            COMM_ReceiveMessage(password);
-            if(strcmp((char*)password, "1234") == 0)
+            COMM_SendReply(frame.seq, password_Matches(frame.payload) ? CMD_PASSWORD_CORRECT
+                                                                      : CMD_PASSWORD_WRONG, NULL, 0);
+            break;
+        case CMD_DOOR_UNLOCK:
+            COMM_SendReply(frame.seq, CMD_ACK, NULL, 0);
+            break;
+        case CMD_CHANGE_PASSWORD:
+            // the new password; nothing is stored, the board keeps 12345
+            COMM_SendReply(frame.seq, CMD_ACK, NULL, 0);
+            break;
+        case CMD_VERIFY_AND_UNLOCK:
+            if(password_Matches(frame.payload))
             {
-                COMM_SendCommand(CMD_PASSWORD_CORRECT);
+                COMM_SendReply(frame.seq, CMD_SUCCESS, &seconds, 1);
             }
             else
             {
-                COMM_SendCommand(CMD_PASSWORD_WRONG);
+                COMM_SendReply(frame.seq, CMD_PASSWORD_WRONG, NULL, 0);
             }
             break;
-        case CMD_DOOR_UNLOCK:
-            COMM_SendCommand(CMD_ACK);
+        case CMD_VERIFY_AND_SET_TIMEOUT:
+            if(password_Matches(frame.payload))
+            {
+                seconds = frame.payload[COMM_PASSWORD_LENGTH];
+                COMM_SendReply(frame.seq, CMD_SUCCESS, NULL, 0);
+            }
+            else
+            {
+                COMM_SendReply(frame.seq, CMD_PASSWORD_WRONG, NULL, 0);
+            }
             break;
-        case CMD_CHANGE_PASSWORD:
-            uint8_t oldPassword[20];
-            uint8_t newPassword[20];
-            COMM_ReceiveMessage(oldPassword);
-            COMM_ReceiveMessage(newPassword);
-            // Here you would normally store the new password securely
-            COMM_SendCommand(CMD_ACK);
+        case CMD_VERIFY_AND_CHANGE:
+            // old password followed by the new one, the new one is not stored
+            COMM_SendReply(frame.seq, password_Matches(frame.payload) ? CMD_ACK : CMD_PASSWORD_WRONG,
+                           NULL, 0);
+            break;
+        case CMD_HEARTBEAT:
+            COMM_SendReply(frame.seq, CMD_HEARTBEAT, NULL, 0);
             break;
         default:
-            COMM_SendCommand(CMD_UNKNOWN);
+            COMM_SendReply(frame.seq, CMD_UNKNOWN, NULL, 0);
             break;
     }
   }
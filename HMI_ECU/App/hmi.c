@@ -13,16 +13,41 @@
 #include "../HAL/pot/pot.h"
 #include "../MCAL/timers/systick.h"
 #include "../../Common/HAL/comm_interface.h"
+#include "../../Common/HAL/comm_request.h"
+#include "../../Common/HAL/comm_link.h"
+#include "../../Common/MCAL/cpu.h"
+#include "../../Common/MCAL/power.h"
+#include "../../Common/Utils/boot_profile.h"
 #include <string.h>
 #include <stdio.h>
 
+/******************************************************************************
+ *                       Static Variables                                      *
+ ******************************************************************************/
+
+static uint8_t linkStarted = 0;     /* first handshake done, supervise the link */
+static uint8_t linkLost = 0;        /* "Link Lost" is on the LCD */
+static uint8_t setupNeeded = 0;     /* Control has no password (CMD_INIT) */
+static uint32_t splashEnd;          /* Tick_Deadline of the welcome message */
+
 /******************************************************************************
  *                       Static Function Prototypes                            *
  ******************************************************************************/
 
+static void HMI_DelayMs(uint32_t ms);
+static uint32_t HMI_WakeTick(uint32_t deadline);
+static void HMI_LinkService(void);
+static void HMI_SleepForKey(void);
 static void HMI_Delay_Seconds(uint16_t seconds);
 static uint8_t HMI_WaitForKey(void);
 static void HMI_ShowCountdown(const char* message, uint16_t seconds);
+static void HMI_ShowNoResponse(void);
+static uint8_t HMI_Request(uint8_t cmd, const uint8_t* payload, uint8_t len, COMM_Frame* reply);
+static uint8_t HMI_BaseCommand(uint8_t cmd);
+static uint8_t HMI_VerifiedRequest(uint8_t cmd, const uint8_t* payload, uint8_t len,
+                                   COMM_Frame* reply);
+static uint8_t HMI_EnterNewPassword(char* password);
+static void HMI_ExchangeBootProfile(void);
 
 /******************************************************************************
  *                       Function Implementations                              *
@@ -31,29 +56,66 @@ static void HMI_ShowCountdown(const char* message, uint16_t seconds);
 void HMI_Init(void)
 {
     /* Initialize all hardware peripherals */
-    LCD_I2C_Init();
     Keypad_Init();
     LED_init();
     POT_Init();
-    //COMM_Init();
+    BOOT_Mark(BOOT_DRIVERS);
+
+    /* Delays and link timeouts run from the 64-bit clock (CLOCK_Init in main) */
+    POWER_Init();
+    BOOT_Mark(BOOT_POWER);
 
-    /* Initialize SysTick for 1ms delays */
-    SysTick_Init(16000, SYSTICK_NOINT);
+    /* Last: the LCD's power-up wait counts from CLOCK_Init, the inits above fill it */
+    LCD_I2C_Init();
 
-    /* Display welcome message */
+    /* Display welcome message, it stays up while HMI_Connect waits for Control */
     HMI_DisplayMessage("Door Locker", "System v1.0");
     LED_setOn(LED_BLUE);
-    HMI_Delay_Seconds(2);
+    splashEnd = Tick_Deadline(SPLASH_MS);
+    BOOT_Mark(BOOT_LCD);
 }
 
 void DisplayConnection() {
     HMI_DisplayMessage("Connected!", "");
     LED_setOn(LED_GREEN);
-    HMI_Delay_Seconds(1);
+    HMI_DelayMs(CONNECTED_MS);
+}
+
+uint8_t HMI_Connect(void)
+{
+    uint8_t status;
+
+    /* Wait for Control_ECU, switch to the baud rate it picks */
+    COMM_HandshakeRespond(&status);
+    BOOT_Mark(BOOT_LINK);
+    COMM_RequestInit();
+    COMM_LinkInit();
+    linkStarted = 1;
+    setupNeeded = (status == CMD_INIT);
+    BOOT_Mark(BOOT_READY);
+
+    HMI_ExchangeBootProfile();
+
+    /* The rest of the splash, with the link already supervised */
+    if(!Tick_Expired(splashEnd))
+    {
+        HMI_DelayMs(splashEnd - GetTicks());
+    }
+    DisplayConnection();
+    BOOT_Mark(BOOT_SPLASH);
+    return status;
 }
 
 void HMI_Task(void)
 {
+    /* Blank Control: at boot, or it came back without a password after a reset */
+    if(setupNeeded)
+    {
+        LED_setOn(LED_RED);
+        setupNeeded = !HMI_SetupPassword();
+        return;
+    }
+
     LED_setOn(LED_GREEN);
     HMI_ShowMainMenu();
 
@@ -99,12 +161,12 @@ void HMI_GetPasswordInput(char* buffer)
         /* Wait for valid numeric key (0-9) */
         while(1)
         {
+            HMI_SleepForKey();
             key = Keypad_GetKey();
             if(key >= '0' && key <= '9')
             {
                 break;
             }
-            DelayMs(50);
         }
 
         /*
@@ -121,7 +183,7 @@ void HMI_GetPasswordInput(char* buffer)
         idx++;
 
         /* Debounce delay */
-        DelayMs(300);
+        HMI_DelayMs(300);
 
         /* Clear keypad buffer to avoid double-press */
         HMI_ClearKeypadBuffer();
@@ -133,70 +195,39 @@ void HMI_GetPasswordInput(char* buffer)
 
 uint8_t HMI_VerifyPassword(const char* password)
 {
-    /* Send command to verify password */
-    COMM_SendCommand(CMD_SEND_PASSWORD);
+    COMM_Frame reply;
 
-    /* Send password */
-    COMM_SendMessage((const uint8_t*)password);
-
-    for (;;) {
-        /* Wait for response */
-        uint8_t response = COMM_ReceiveCommand();
-
-        if(response == CMD_PASSWORD_CORRECT)
-        {
-            COMM_SendCommand(CMD_ACK);
-            return 1;  /* Password correct */
-        }
-        else if (response == CMD_PASSWORD_WRONG) {
-            COMM_SendCommand(CMD_ACK);
-            return 0;  /* Password incorrect */
-        }
-    }
+    /* Send password in a single frame, the reply is matched by its seq */
+    return HMI_VerifiedRequest(CMD_SEND_PASSWORD, (const uint8_t*)password, PASSWORD_LENGTH, &reply);
 }
 
-void HMI_SavePassword(const char* password)
+uint8_t HMI_SavePassword(const char* password)
 {
-    /* Send command to change/save password */
-    COMM_SendCommand(CMD_CHANGE_PASSWORD);
+    COMM_Frame reply;
 
-    /* Send password string */
-    COMM_SendMessage((const uint8_t*)password);
+    /* Send change/save password command with the new password */
+    COMM_RequestHandle request = COMM_RequestSendReliable(CMD_CHANGE_PASSWORD, (const uint8_t*)password,
+                                                          PASSWORD_LENGTH, REPLY_TIMEOUT_MS);
     
     /* Wait for acknowledgment */
-    uint8_t command = COMM_ReceiveCommand();
+    COMM_RequestState state = COMM_RequestWait(request, &reply);
+    COMM_RequestRelease(request);
+    if (state != COMM_REQ_DONE)
+    {
+        HMI_ShowNoResponse();
+        return 0;
+    }
+    return (reply.cmd == CMD_ACK);
 }
 
 uint8_t HMI_SetupPassword(void)
 {
-    char password1[PASSWORD_LENGTH + 1];
-    char password2[PASSWORD_LENGTH + 1];
-
-    /* Step 1: Enter new password */
-    HMI_DisplayMessage("Enter New", "Password:");
-    HMI_Delay_Seconds(1);
-    HMI_GetPasswordInput(password1);
-    DelayMs(500);
-
-    /* Step 2: Re-enter password for confirmation */
-    HMI_DisplayMessage("Re-enter", "Password:");
-    HMI_Delay_Seconds(1);
-    HMI_GetPasswordInput(password2);
-    DelayMs(500);
+    char password[PASSWORD_LENGTH + 1];
 
-    /* Step 3: Check if passwords match */
-    if(strncmp(password1, password2, PASSWORD_LENGTH) == 0)
+    if(HMI_EnterNewPassword(password))
     {
         /* Passwords match - send to Control ECU for storage */
-        HMI_SavePassword(password1);
-        return 1;
-    }
-    else
-    {
-        /* Passwords don't match */
-        HMI_DisplayMessage("Passwords", "Don't Match!");
-        LED_setOn(LED_RED);
-        HMI_Delay_Seconds(2);
+        return HMI_SavePassword(password);
     }
 
     return 0;  /* Failed */
@@ -216,36 +247,43 @@ void HMI_ShowMainMenu(void)
 uint8_t HMI_HandleOpenDoor(void)
 {
     char password[PASSWORD_LENGTH + 1];
+    COMM_Frame reply;
 
     /* Request password from user */
     HMI_DisplayMessage("Enter Password", "to Open Door:");
     LED_setOn(LED_BLUE);
     HMI_GetPasswordInput(password);
 
-    /* Verify password with Control ECU */
-    if(HMI_VerifyPassword(password))
+    /* Control verifies and starts the motor in one request */
+    uint8_t result = HMI_VerifiedRequest(CMD_VERIFY_AND_UNLOCK, (const uint8_t*)password,
+                                         COMM_VERIFY_AND_UNLOCK_LEN, &reply);
+    if(result == VERIFY_CORRECT && reply.cmd == CMD_SUCCESS)
     {
-        DelayMs(50);
-        /* Password correct - send door unlock command */
-        COMM_SendCommand(CMD_DOOR_UNLOCK);
+        /* Reply carries the auto-lock time, count it down locally */
+        uint16_t seconds = (reply.len >= 1) ? reply.payload[0] : DEFAULT_TIMEOUT_SEC;
 
-        /* Display unlocking status */
         LED_setOn(LED_GREEN);
-        HMI_DisplayMessage("Unlocked Door", "");
-
-        if(COMM_ReceiveCommand() != CMD_ACK)
-        {
-           HMI_DisplayMessage("ERROR", "TRY AGAIN");   
-        }
+        HMI_ShowCountdown("Unlocked Door", seconds);
+        HMI_DisplayMessage("Door Locking", "");
         return 1;  /* Success */
     }
+    else if(result == VERIFY_NO_REPLY || result == VERIFY_LOCKED_OUT)
+    {
+        return 0;
+    }
+    else if(result == VERIFY_CORRECT)
+    {
+        HMI_DisplayMessage("ERROR", "TRY AGAIN");
+        LED_setOn(LED_RED);
+        HMI_Delay_Seconds(2);
+        return 0;
+    }
     else
     {
-        COMM_SendCommand(CMD_ACK);
         LED_setOn(LED_RED);
 
         HMI_DisplayMessage("Incorrect Password!", "");
-        DelayMs(2000);
+        HMI_DelayMs(2000);
 
         return 0;
     }
@@ -254,18 +292,43 @@ uint8_t HMI_HandleOpenDoor(void)
 uint8_t HMI_HandleChangePassword(void)
 {
     char oldPassword[PASSWORD_LENGTH + 1];
+    char newPassword[PASSWORD_LENGTH + 1];
+    uint8_t payload[COMM_VERIFY_AND_CHANGE_LEN];
+    COMM_Frame reply;
 
     /* Request old password */
     HMI_DisplayMessage("Enter Old", "Password:");
     LED_setOn(LED_BLUE);
     HMI_GetPasswordInput(oldPassword);
-    DelayMs(500);
+    HMI_DelayMs(500);
+
+    /* Request new password twice */
+    if(!HMI_EnterNewPassword(newPassword))
+    {
+        return 0;
+    }
 
-    /* Verify old password */
-    if(HMI_VerifyPassword(oldPassword))
+    /* Old and new password go in one request, Control checks the old one first */
+    memcpy(payload, oldPassword, PASSWORD_LENGTH);
+    memcpy(&payload[PASSWORD_LENGTH], newPassword, PASSWORD_LENGTH);
+    uint8_t result = HMI_VerifiedRequest(CMD_VERIFY_AND_CHANGE, payload, sizeof(payload), &reply);
+    if(result == VERIFY_CORRECT && reply.cmd == CMD_ACK)
+    {
+        HMI_DisplayMessage("Password", "Changed!");
+        LED_setOn(LED_GREEN);
+        HMI_Delay_Seconds(2);
+        return 1;
+    }
+    else if(result == VERIFY_NO_REPLY || result == VERIFY_LOCKED_OUT)
     {
-        /* Old password correct - setup new password */
-        return HMI_SetupPassword();
+        return 0;
+    }
+    else if(result == VERIFY_CORRECT)
+    {
+        HMI_DisplayMessage("Error saving", "");
+        LED_setOn(LED_RED);
+        HMI_Delay_Seconds(2);
+        return 0;
     }
     else
     {
@@ -309,26 +372,31 @@ uint8_t HMI_HandleSetTimeout(void)
             HMI_DisplayMessage("Enter Password", "to Confirm:");
             HMI_Delay_Seconds(1);
             HMI_GetPasswordInput(password);
-            DelayMs(500);
+            HMI_DelayMs(500);
+
+            /* Password and new timeout in one request */
+            uint8_t payload[COMM_VERIFY_AND_SET_TIMEOUT_LEN];
+            COMM_Frame reply;
+            memcpy(payload, password, PASSWORD_LENGTH);
+            payload[PASSWORD_LENGTH] = (uint8_t)timeout;
 
-            if(HMI_VerifyPassword(password))
+            uint8_t result = HMI_VerifiedRequest(CMD_VERIFY_AND_SET_TIMEOUT, payload,
+                                                 sizeof(payload), &reply);
+            if(result == VERIFY_CORRECT && reply.cmd == CMD_SUCCESS)
+            {
+                HMI_DisplayMessage("Timeout Saved!", "");
+                LED_setOn(LED_GREEN);
+                return 1;
+            }
+            else if(result == VERIFY_CORRECT)
+            {
+                HMI_DisplayMessage("Error saving", "");
+                LED_setOn(LED_RED);
+                return 0;
+            }
+            else if(result == VERIFY_NO_REPLY || result == VERIFY_LOCKED_OUT)
             {
-                /* Password correct - save timeout */
-                uint8_t newTimeout = timeout;
-                COMM_SendCommand(CMD_SET_TIMEOUT);
-                COMM_SendMessage((const uint8_t*)&newTimeout);
-
-                for(;;) {
-                    if (COMM_ReceiveCommand() == CMD_SUCCESS) {
-                        HMI_DisplayMessage("Timeout Saved!", "");
-                        LED_setOn(LED_GREEN);
-                        return 1;
-                    } else if (COMM_ReceiveCommand() == CMD_FAIL) {
-                        HMI_DisplayMessage("Error saving", "");
-                        LED_setOn(LED_RED);
-                        return 0;
-                    }
-                }
+                return 0;
             }
             else
             {
@@ -346,7 +414,7 @@ uint8_t HMI_HandleSetTimeout(void)
             return 0;
         }
 
-        DelayMs(200);  /* Update rate */
+        HMI_DelayMs(200);  /* Update rate */
     }
 }
 
@@ -366,15 +434,13 @@ void HMI_DisplayDoorStatus(const char* status, uint16_t seconds)
     }
 }
 
-void HMI_HandleLockout(void)
+void HMI_HandleLockout(uint16_t seconds)
 {
-    /* Send alarm command to Control ECU */
-    COMM_SendCommand(CMD_ALARM);
-
+    /* Control ECU already sounds the alarm and refuses passwords until then */
     LED_setOn(LED_RED);
 
     /* Display lockout message with countdown */
-    HMI_ShowCountdown("LOCKED OUT!", LOCKOUT_DURATION_SEC);
+    HMI_ShowCountdown("LOCKED OUT!", seconds);
 
     HMI_DisplayMessage("Lockout Ended", "");
     LED_setOn(LED_GREEN);
@@ -399,7 +465,7 @@ void HMI_ClearKeypadBuffer(void)
     /* Read and discard any pending keypad inputs */
     while(Keypad_GetKey() != 0)
     {
-        DelayMs(10);
+        HMI_DelayMs(10);
     }
 }
 
@@ -407,27 +473,129 @@ void HMI_ClearKeypadBuffer(void)
  *                       Static Helper Functions                               *
  ******************************************************************************/
 
+/* DelayMs that keeps the link to Control supervised while the UI waits */
+static void HMI_DelayMs(uint32_t ms)
+{
+    uint32_t deadline = Tick_Deadline(ms);
+
+    HMI_LinkService();
+    for(;;)
+    {
+        /* Checked with interrupts off, so a frame from here on wakes the sleep */
+        CPU_DisableInterrupts();
+        if(Tick_Expired(deadline))
+        {
+            CPU_EnableInterrupts();
+            break;
+        }
+        POWER_SleepUntil(HMI_WakeTick(deadline));
+        HMI_LinkService();
+    }
+}
+
+/* No later than deadline, sooner if the link has timed work */
+static uint32_t HMI_WakeTick(uint32_t deadline)
+{
+    if(!linkStarted)
+    {
+        return deadline;
+    }
+    uint32_t link = COMM_LinkWakeTick();
+    return ((int32_t)(link - deadline) < 0) ? link : deadline;
+}
+
+/* Sleep until a key goes down or a reconnect finds a blank Control.
+ * Every wake (UART2, the link's next timed work) still services the link */
+static void HMI_SleepForKey(void)
+{
+    uint8_t setupBefore = setupNeeded;
+
+    Keypad_ArmWake();
+    HMI_LinkService();
+    for(;;)
+    {
+        CPU_DisableInterrupts();
+        if(Keypad_WakePending())
+        {
+            CPU_EnableInterrupts();
+            break;
+        }
+        if(linkStarted)
+        {
+            POWER_SleepUntil(COMM_LinkWakeTick());
+        }
+        else
+        {
+            POWER_Sleep();
+        }
+        if(setupNeeded && !setupBefore)
+        {
+            break;
+        }
+        HMI_LinkService();
+    }
+}
+
+/* Heartbeats while idle; after a reset on either side, reconnect and restore the session */
+static void HMI_LinkService(void)
+{
+    uint8_t status;
+
+    if(!linkStarted)
+    {
+        return;
+    }
+
+    switch(COMM_LinkService(&status))
+    {
+        case COMM_LINK_DOWN:
+            if(!linkLost)
+            {
+                linkLost = 1;
+                HMI_DisplayMessage("Link Lost", "Reconnecting...");
+                LED_setOn(LED_RED);
+            }
+            break;
+
+        case COMM_LINK_RECONNECTED:
+            linkLost = 0;
+            setupNeeded = (status == CMD_INIT);
+            HMI_DisplayMessage("Connected!", "");
+            LED_setOn(LED_GREEN);
+            break;
+
+        default:
+            break;
+    }
+}
+
 static void HMI_Delay_Seconds(uint16_t seconds)
 {
     for(uint16_t i = 0; i < seconds; i++)
     {
-        DelayMs(1000);
+        HMI_DelayMs(1000);
     }
 }
 
 static uint8_t HMI_WaitForKey(void)
 {
-    char key = '/';
+    char key = 0;
 
-    /* Wait for valid key press */
-    while(key == '/')
+    /* Wait for valid key press, asleep until a row edge. Keypad_GetKey returns
+     * 0 if the key was gone by then (bounce).
+     * A reconnect to a blank Control returns 0 at once, HMI_Task runs the setup */
+    while(key == 0)
     {
+        if(setupNeeded)
+        {
+            return 0;
+        }
+        HMI_SleepForKey();
         key = Keypad_GetKey();
-        DelayMs(50);
     }
 
     /* Debounce */
-    DelayMs(200);
+    HMI_DelayMs(200);
     HMI_ClearKeypadBuffer();
 
     return key;
@@ -446,6 +614,123 @@ static void HMI_ShowCountdown(const char* message, uint16_t seconds)
         snprintf(buffer, sizeof(buffer), "%u seconds", i);
         LCD_I2C_WriteString(buffer);
 
-        DelayMs(1000);
+        HMI_DelayMs(1000);
     }
-}
\ No newline at end of file
+}
+
+static void HMI_ShowNoResponse(void)
+{
+    HMI_DisplayMessage("No Response", "from Control");
+    LED_setOn(LED_RED);
+    HMI_Delay_Seconds(2);
+}
+
+/* One reliable request and its reply, see HMI_VerifiedRequest for the result */
+static uint8_t HMI_Request(uint8_t cmd, const uint8_t* payload, uint8_t len, COMM_Frame* reply)
+{
+    COMM_RequestHandle request = COMM_RequestSendReliable(cmd, payload, len, REPLY_TIMEOUT_MS);
+    COMM_RequestState state = COMM_RequestWait(request, reply);
+    COMM_RequestRelease(request);
+
+    if(state != COMM_REQ_DONE)
+    {
+        HMI_ShowNoResponse();
+        return VERIFY_NO_REPLY;
+    }
+    if(reply->cmd == CMD_ALARM)
+    {
+        HMI_HandleLockout((reply->len >= 1) ? reply->payload[0] : LOCKOUT_DURATION_SEC);
+        return VERIFY_LOCKED_OUT;
+    }
+    return (reply->cmd == CMD_PASSWORD_WRONG) ? VERIFY_WRONG : VERIFY_CORRECT;
+}
+
+/* Base-protocol form of a CMD_VERIFY_AND_* command, sent after CMD_SEND_PASSWORD */
+static uint8_t HMI_BaseCommand(uint8_t cmd)
+{
+    switch(cmd)
+    {
+        case CMD_VERIFY_AND_UNLOCK:      return CMD_DOOR_UNLOCK;
+        case CMD_VERIFY_AND_SET_TIMEOUT: return CMD_SET_TIMEOUT;
+        default:                         return CMD_CHANGE_PASSWORD;
+    }
+}
+
+/*
+ * Send a request carrying a password and wait for its single reply. It is
+ * retransmitted while no reply comes, Control answers repeats from its cache.
+ * VERIFY_CORRECT means Control accepted the password, *reply holds the result
+ * of the action (check reply->cmd); VERIFY_WRONG is CMD_PASSWORD_WRONG and
+ * VERIFY_LOCKED_OUT a CMD_ALARM, its countdown has been shown already.
+ * A Control without COMM_FEATURE_COMPOUND gets the password on its own first
+ * and the rest of the payload in the base-protocol command.
+ */
+static uint8_t HMI_VerifiedRequest(uint8_t cmd, const uint8_t* payload, uint8_t len,
+                                   COMM_Frame* reply)
+{
+    if(COMM_PeerSupports(cmd))
+    {
+        return HMI_Request(cmd, payload, len, reply);
+    }
+
+    uint8_t result = HMI_Request(CMD_SEND_PASSWORD, payload, PASSWORD_LENGTH, reply);
+    if(result != VERIFY_CORRECT)
+    {
+        return result;
+    }
+    return HMI_Request(HMI_BaseCommand(cmd), &payload[PASSWORD_LENGTH],
+                       (uint8_t)(len - PASSWORD_LENGTH), reply);
+}
+
+/* Ask for a new password twice, 1 if both entries match */
+static uint8_t HMI_EnterNewPassword(char* password)
+{
+    char confirm[PASSWORD_LENGTH + 1];
+
+    /* Step 1: Enter new password */
+    HMI_DisplayMessage("Enter New", "Password:");
+    HMI_Delay_Seconds(1);
+    HMI_GetPasswordInput(password);
+    HMI_DelayMs(500);
+
+    /* Step 2: Re-enter password for confirmation */
+    HMI_DisplayMessage("Re-enter", "Password:");
+    HMI_Delay_Seconds(1);
+    HMI_GetPasswordInput(confirm);
+    HMI_DelayMs(500);
+
+    /* Step 3: Check if passwords match */
+    if(strncmp(password, confirm, PASSWORD_LENGTH) == 0)
+    {
+        return 1;
+    }
+
+    /* Passwords don't match */
+    HMI_DisplayMessage("Passwords", "Don't Match!");
+    LED_setOn(LED_RED);
+    HMI_Delay_Seconds(2);
+    return 0;
+}
+
+/* Our boot marks to Control, its marks back; nothing is shown if it does not answer */
+static void HMI_ExchangeBootProfile(void)
+{
+    BOOT_Profile profile;
+    uint8_t marks[COMM_BOOT_LEN];
+    COMM_Frame reply;
+
+    if(!COMM_PeerSupports(CMD_BOOT))
+    {
+        return;
+    }
+    BOOT_Get(&profile);
+    COMM_RequestHandle request = COMM_RequestSendReliable(CMD_BOOT, marks,
+                                                          BOOT_Encode(&profile, marks),
+                                                          REPLY_TIMEOUT_MS);
+    if(COMM_RequestWait(request, &reply) == COMM_REQ_DONE && reply.cmd == CMD_BOOT &&
+       BOOT_Decode(reply.payload, reply.len, &profile))
+    {
+        BOOT_SetPeer(&profile);
+    }
+    COMM_RequestRelease(request);
+}
@@ -30,6 +30,19 @@
 /* Lockout/Alarm Duration */
 #define LOCKOUT_DURATION_SEC    60    /* 1 minute lockout */
 
+/* Link Timeouts (in milliseconds) */
+#define REPLY_TIMEOUT_MS        1000  /* every request, retransmissions included */
+
+/* Boot Screens (in milliseconds) */
+#define SPLASH_MS               2000  /* welcome message, the handshake runs meanwhile */
+#define CONNECTED_MS            1000  /* "Connected!" after the splash */
+
+/* HMI_VerifyPassword results */
+#define VERIFY_WRONG            0
+#define VERIFY_CORRECT          1
+#define VERIFY_NO_REPLY         2     /* Control ECU did not answer in time */
+#define VERIFY_LOCKED_OUT       3     /* Control ECU refused it, lockout shown */
+
 /* Menu Key Definitions */
 #define KEY_OPEN_DOOR           'A'    // Changed from '+'
 #define KEY_CHANGE_PASSWORD     'B'    // Changed from '-'
@@ -43,17 +56,29 @@
 
 /*
  * Description: Initialize HMI system
- * - Initializes all peripherals (LCD, Keypad, LED, Potentiometer, UART)
- * - Performs initial handshake with Control ECU
- * - Displays welcome message
+ * - Initializes the peripherals (Keypad, LED, Potentiometer, LCD last, its
+ *   power-up wait overlaps the others); COMM_Init comes first in main
+ * - Displays welcome message and returns, HMI_Connect keeps it up for SPLASH_MS
  * Parameters: None
  * Returns: None
  */
 void HMI_Init(void);
 
+/*
+ * Description: Connect to Control ECU
+ * - Waits for its handshake and follows the baud rate it picks
+ * - Starts link supervision: heartbeats while the UI waits, reconnect
+ *   after a reset on either side (see comm_link.h)
+ * - Swaps boot timestamps with Control (CMD_BOOT), then lets the splash run out
+ * Parameters: None
+ * Returns: CMD_INIT if a password still has to be set up, CMD_ACK otherwise
+ */
+uint8_t HMI_Connect(void);
+
 /*
  * Description: Main HMI task - implements state machine
  * - Must be called continuously in main loop
+ * - Runs the password setup while Control has none
  * - Handles all user interactions and state transitions
  * Parameters: None
  * Returns: None
@@ -75,7 +100,8 @@ void HMI_GetPasswordInput(char* buffer);
  * Description: Send password to Control ECU and verify
  * Parameters:
  *   - password: Password string to verify
- * Returns: 1 if password correct, 0 if incorrect
+ * Returns: VERIFY_CORRECT, VERIFY_WRONG, VERIFY_LOCKED_OUT after the lockout
+ *          countdown, or VERIFY_NO_REPLY after REPLY_TIMEOUT_MS
  */
 uint8_t HMI_VerifyPassword(const char* password);
 
@@ -83,9 +109,9 @@ uint8_t HMI_VerifyPassword(const char* password);
  * Description: Send password to Control ECU for storage
  * Parameters:
  *   - password: Password string to save
- * Returns: 1 if successful, 0 if failed
+ * Returns: 1 if successful, 0 if failed or no reply within REPLY_TIMEOUT_MS
  */
-void HMI_SavePassword(const char* password);
+uint8_t HMI_SavePassword(const char* password);
 
 /*
  * Description: Handle first-time password setup
@@ -107,8 +133,8 @@ void HMI_ShowMainMenu(void);
 /*
  * Description: Handle door opening operation
  * - Request password from user
- * - Verify with Control ECU
- * - Display door operation status
+ * - Send CMD_VERIFY_AND_UNLOCK, Control verifies and starts the motor
+ * - Count the auto-lock time down on the LCD
  * - Handle failed attempts and lockout
  * Parameters: None
  * Returns: 1 if successful, 0 if failed/locked out
@@ -118,9 +144,8 @@ uint8_t HMI_HandleOpenDoor(void);
 /*
  * Description: Handle password change operation
  * - Request old password
- * - Verify old password
  * - Request new password twice
- * - Save to Control ECU
+ * - Send both in one CMD_VERIFY_AND_CHANGE to Control ECU
  * Parameters: None
  * Returns: 1 if successful, 0 if failed
  */
@@ -130,7 +155,7 @@ uint8_t HMI_HandleChangePassword(void);
  * Description: Handle timeout setting via potentiometer
  * - Display live potentiometer reading (5-30 seconds)
  * - Wait for user confirmation (#) or cancel (C)
- * - Request password before saving
+ * - Request password, send it with the value in CMD_VERIFY_AND_SET_TIMEOUT
  * Parameters: None
  * Returns: 1 if successful, 0 if cancelled/failed
  */
@@ -149,13 +174,14 @@ void HMI_DisplayDoorStatus(const char* status, uint16_t seconds);
 
 /*
  * Description: Handle lockout state
+ * - Control ECU sounds the alarm and answered a password with CMD_ALARM
  * - Display lockout message with countdown
- * - Trigger alarm on Control ECU
  * - Wait for lockout period to expire
- * Parameters: None
+ * Parameters:
+ *   - seconds: Lockout time left, from the CMD_ALARM reply
  * Returns: None
  */
-void HMI_HandleLockout(void);
+void HMI_HandleLockout(uint16_t seconds);
 
 /*
  * Description: Display message on LCD (1 or 2 lines)
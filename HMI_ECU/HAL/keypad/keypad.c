@@ -30,6 +30,10 @@ const char keypad_codes[4][4] = {
 
 #define KEYPAD_ROW_PORT PORTA_ID
 #define KEYPAD_ROW_PINS {PIN2_ID, PIN3_ID, PIN4_ID, PIN5_ID} // PA2-PA5
+#define KEYPAD_ROW_MASK ((1U << PIN2_ID) | (1U << PIN3_ID) | (1U << PIN4_ID) | (1U << PIN5_ID))
+
+/* Set by GPIOA_Handler once a row edge was seen, cleared by Keypad_GetKey */
+static volatile uint8_t wakePending = 0;
 
 
 /*
@@ -69,6 +73,11 @@ void Keypad_Init(void) {
 char Keypad_GetKey(void) {
     uint8_t row_pins[4] = KEYPAD_ROW_PINS;
     uint8_t col_pins[4] = KEYPAD_COL_PINS;
+    // The scan below makes edges of its own
+    for (uint8_t row = 0; row < 4; row++) {
+        GPIO_DisableInterrupt(KEYPAD_ROW_PORT, row_pins[row]);
+    }
+    wakePending = 0;
     for (uint8_t col = 0; col < 4; col++) {
         // Set all columns HIGH (inactive)
         for (uint8_t c = 0; c < 4; c++) {
@@ -91,4 +100,39 @@ char Keypad_GetKey(void) {
         }
     }
     return 0; // No key pressed
-}
\ No newline at end of file
+}
+
+
+/*
+ * Keypad_ArmWake
+ * With every column LOW, any key pulls its row LOW, so one falling edge
+ * interrupt per row catches a press without scanning.
+ */
+void Keypad_ArmWake(void) {
+    uint8_t row_pins[4] = KEYPAD_ROW_PINS;
+    uint8_t col_pins[4] = KEYPAD_COL_PINS;
+    for (uint8_t c = 0; c < 4; c++) {
+        GPIO_WritePin(KEYPAD_COL_PORT, col_pins[c], LOW);
+    }
+    for (uint8_t row = 0; row < 4; row++) {
+        GPIO_EnableEdgeInterrupt(KEYPAD_ROW_PORT, row_pins[row], GPIO_EDGE_FALLING);
+    }
+    // A key held down already made its edge before the interrupt was on
+    for (uint8_t row = 0; row < 4; row++) {
+        if (GPIO_ReadPin(KEYPAD_ROW_PORT, row_pins[row]) == LOW) {
+            wakePending = 1;
+        }
+    }
+}
+
+uint8_t Keypad_WakePending(void) {
+    return wakePending;
+}
+
+void GPIOA_Handler(void) {
+    uint8_t status = GPIO_GetInterruptStatus(KEYPAD_ROW_PORT) & KEYPAD_ROW_MASK;
+    GPIO_ClearInterrupt(KEYPAD_ROW_PORT, status);
+    if (status) {
+        wakePending = 1;
+    }
+}
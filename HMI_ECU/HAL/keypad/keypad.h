@@ -25,4 +25,16 @@ void Keypad_Init(void);
  */
 char Keypad_GetKey(void);
 
+/*
+ * Arms the wake-up on a key press: all columns are driven LOW and a falling
+ * edge on any row interrupts (GPIOA_Handler), which ends a WFI sleep.
+ * Keypad_WakePending is true from the edge on, or at once if a key is
+ * already down. Keypad_GetKey disarms it again.
+ */
+void Keypad_ArmWake(void);
+uint8_t Keypad_WakePending(void);
+
+/* GPIO Port A interrupt: a row went LOW while the wake-up was armed */
+void GPIOA_Handler(void);
+
 #endif // KEYPAD_H
\ No newline at end of file
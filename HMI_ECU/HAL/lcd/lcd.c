@@ -1,5 +1,6 @@
 #include "tm4c123gh6pm.h"
 #include "lcd.h"
+#include "../../../Common/MCAL/clock.h"
 
 // PCF8574 Address
 #define LCD_I2C_ADDR   0x27
@@ -10,6 +11,13 @@
 #define RW             0x02
 #define RS             0x01
 
+// HD44780 timing. An I2C byte takes ~90 us at 100 kHz, longer than the enable
+// pulse and most commands need, so only these are waited for on the clock
+#define LCD_POWER_UP_US   50000   // after power-on, counted from CLOCK_Init
+#define LCD_CMD_US        40      // most commands
+#define LCD_CLEAR_US      2000    // clear and home
+#define LCD_WAKE_US       5000    // after the first 0x3 of the init sequence
+
 // ---------- I2C LOW LEVEL ----------
 void I2C0_Init(void)
 {
@@ -41,12 +49,21 @@ void I2C0_SendByte(uint8_t data)
 }
 
 // ---------- LCD LOW LEVEL ----------
+static void LCD_WaitUntil(uint64_t us)
+{
+    while (CLOCK_NowUs() < us);
+}
+
+static void LCD_WaitUs(uint32_t us)
+{
+    LCD_WaitUntil(CLOCK_NowUs() + us);
+}
+
 void LCD_PulseEnable(uint8_t data)
 {
     I2C0_SendByte(data | EN | LCD_BACKLIGHT);
-    for (volatile int i = 0; i < 3000; i++);
     I2C0_SendByte((data & ~EN) | LCD_BACKLIGHT);
-    for (volatile int i = 0; i < 3000; i++);
+    LCD_WaitUs(LCD_CMD_US);
 }
 
 void LCD_Write4Bits(uint8_t value)
@@ -73,9 +90,13 @@ void LCD_I2C_Init(void)
 {
     I2C0_Init();
 
-    for (volatile int d=0; d<50000; d++); // Wait LCD boot
+    // The LCD powered up with the MCU: whatever ran since CLOCK_Init counts
+    LCD_WaitUntil(LCD_POWER_UP_US);
 
-    LCD_SendCommand(0x33);  
+    // 0x33 a nibble at a time, the LCD wants 4.1 ms after the first
+    LCD_Write4Bits(0x30);
+    LCD_WaitUs(LCD_WAKE_US);
+    LCD_Write4Bits(0x30);
     LCD_SendCommand(0x32);  
     LCD_SendCommand(0x28);  // 4-bit, 2 line
     LCD_SendCommand(0x0C);  // Display ON
@@ -86,7 +107,7 @@ void LCD_I2C_Init(void)
 void LCD_I2C_Clear(void)
 {
     LCD_SendCommand(0x01);
-    for (volatile int i=0;i<50000;i++);
+    LCD_WaitUs(LCD_CLEAR_US);
 }
 
 void LCD_I2C_SetCursor(uint8_t row, uint8_t col)
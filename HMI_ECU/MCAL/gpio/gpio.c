@@ -15,6 +15,17 @@
 
 #define GPIO_LOCK_KEY           0x4C4F434B
 
+/* Interrupt registers, word offsets from the port base */
+#define GPIO_IS_OFFSET          (0x404 / 4)
+#define GPIO_IBE_OFFSET         (0x408 / 4)
+#define GPIO_IEV_OFFSET         (0x40C / 4)
+#define GPIO_IM_OFFSET          (0x410 / 4)
+#define GPIO_MIS_OFFSET         (0x418 / 4)
+#define GPIO_ICR_OFFSET         (0x41C / 4)
+
+/* NVIC interrupt numbers of ports A-E are 0-4, port F is 30 */
+#define GPIO_PORTF_IRQ          30
+
 /* Helper: Get Base Address of Port */
 static volatile uint32_t* GetPortBase(uint8_t port_num)
 {
@@ -237,3 +248,57 @@ void GPIO_SetPullUp(uint8_t port_num, uint8_t pin_num, uint8_t enable)
     else
         *PUR_Ptr &= ~(1 << pin_num);
 }
+
+void GPIO_EnableEdgeInterrupt(uint8_t port_num, uint8_t pin_num, uint8_t edge)
+{
+    volatile uint32_t *base = GetPortBase(port_num);
+    uint32_t bit = (1U << pin_num);
+
+    if(base == 0)
+    {
+        return;
+    }
+
+    base[GPIO_IM_OFFSET] &= ~bit;       /* no interrupt while it is set up */
+    base[GPIO_IS_OFFSET] &= ~bit;       /* edge, not level */
+    base[GPIO_IBE_OFFSET] &= ~bit;      /* one edge only */
+    if(edge == GPIO_EDGE_RISING)
+    {
+        base[GPIO_IEV_OFFSET] |= bit;
+    }
+    else
+    {
+        base[GPIO_IEV_OFFSET] &= ~bit;
+    }
+    base[GPIO_ICR_OFFSET] = bit;        /* forget edges seen before */
+    base[GPIO_IM_OFFSET] |= bit;
+
+    NVIC_EN0_R = 1U << ((port_num == PORTF_ID) ? GPIO_PORTF_IRQ : port_num);
+}
+
+void GPIO_DisableInterrupt(uint8_t port_num, uint8_t pin_num)
+{
+    volatile uint32_t *base = GetPortBase(port_num);
+
+    if(base != 0)
+    {
+        base[GPIO_IM_OFFSET] &= ~(1U << pin_num);
+    }
+}
+
+uint8_t GPIO_GetInterruptStatus(uint8_t port_num)
+{
+    volatile uint32_t *base = GetPortBase(port_num);
+
+    return (base != 0) ? (uint8_t)base[GPIO_MIS_OFFSET] : 0;
+}
+
+void GPIO_ClearInterrupt(uint8_t port_num, uint8_t mask)
+{
+    volatile uint32_t *base = GetPortBase(port_num);
+
+    if(base != 0)
+    {
+        base[GPIO_ICR_OFFSET] = mask;
+    }
+}
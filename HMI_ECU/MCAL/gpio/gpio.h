@@ -23,6 +23,10 @@
 #define INPUT       0
 #define OUTPUT      1
 
+/* Interrupt Edges */
+#define GPIO_EDGE_FALLING   0
+#define GPIO_EDGE_RISING    1
+
 /* Ports */
 #define PORTA_ID    0
 #define PORTB_ID    1
@@ -90,4 +94,31 @@ void GPIO_TogglePin(uint8_t port_num, uint8_t pin_num);
  */
 void GPIO_SetPullUp(uint8_t port_num, uint8_t pin_num, uint8_t enable);
 
+/*
+ * Description: Interrupt on one edge of a pin and enable the port's
+ *              interrupt in the NVIC. The handler is GPIOx_Handler in the
+ *              startup file and must clear the status (GPIO_ClearInterrupt).
+ * Parameters:
+ *   - port_num: Port ID
+ *   - pin_num: Pin ID
+ *   - edge: GPIO_EDGE_FALLING or GPIO_EDGE_RISING
+ */
+void GPIO_EnableEdgeInterrupt(uint8_t port_num, uint8_t pin_num, uint8_t edge);
+
+/*
+ * Description: Stop a pin from interrupting. The NVIC line stays enabled.
+ */
+void GPIO_DisableInterrupt(uint8_t port_num, uint8_t pin_num);
+
+/*
+ * Description: Pins of a port with an edge seen and their interrupt enabled.
+ * Returns: Bit mask, bit n for pin n
+ */
+uint8_t GPIO_GetInterruptStatus(uint8_t port_num);
+
+/*
+ * Description: Acknowledge the edges of the pins in mask.
+ */
+void GPIO_ClearInterrupt(uint8_t port_num, uint8_t mask);
+
 #endif /* GPIO_H_ */
@@ -2,11 +2,10 @@
 #define SYSTICK_H
 
 #include <stdint.h>
+#include "../../../Common/MCAL/tick.h"
+#include "../../../Common/MCAL/clock.h"
 
-#define SYSTICK_NOINT   0
-#define SYSTICK_INT     1
-
-void SysTick_Init(uint32_t reload, uint8_t mode);
+/* GetTicks() (tick.h) runs from the clock started by CLOCK_Init */
 void DelayMs(uint32_t ms);
 
 #endif
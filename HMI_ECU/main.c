@@ -1,4 +1,7 @@
 #include "../Common/HAL/comm_interface.h"
+#include "../Common/HAL/comm_request.h"
+#include "../Common/MCAL/clock.h"
+#include "../Common/Utils/boot_profile.h"
 #include "./App/hmi.h"
 #include "string.h"
 #include "../Common/MCAL/tm4c123gh6pm.h"
@@ -30,27 +33,20 @@ void Debug_InitAndToggleRed(void)
 
 int main()
 {
+  CLOCK_Init();   // GetTicks() runs from it, first thing
+  BOOT_Start();   // init steps are timed from here, see boot_profile.h
+  // UART before the rest: Control's READY waits in the RX ring while the
+  // other peripherals and the LCD come up
   COMM_Init();
+  BOOT_Mark(BOOT_COMM);
   HMI_Init();
   
-  while (COMM_ReceiveCommand() != CMD_READY) { }
-  COMM_SendCommand(CMD_READY);
+  // Wait for Control_ECU, switch to the baud rate it picks and keep the
+  // link supervised, all behind the splash screen. A blank Control
+  // (CMD_INIT) gets its password set up by HMI_Task, at boot and after
+  // any reconnect
+  HMI_Connect();
 
-  DisplayConnection();
-
-  //uint8_t isInit = COMM_ReceiveCommand();
-  uint8_t volatile isInit;
-  isInit = COMM_ReceiveCommand();
-  if (isInit == CMD_INIT) {
-      LED_init();
-       LED_setOn(LED_RED);
-	uint8_t initializedPassword;
-    do {
-    	initializedPassword = HMI_SetupPassword();
-    } while (!initializedPassword);
-  }
-
-  
   while(1)
   {
     HMI_Task();
@@ -0,0 +1,66 @@
+/*
+    Host benchmark for the baud rates the startup handshake can negotiate.
+    The simulated UART2 is paced at the programmed rate in real time and looped
+    back, so each round trip is a password frame out and back followed by the
+    CMD_PASSWORD_CORRECT reply out and back: the same bytes a real HMI/Control
+    exchange puts on the wire, plus the framing and parsing cost on each side.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../../Common/HAL/comm_interface.h"
+#include "../MCAL/uart_sim.h"
+#include "../MCAL/sim.h"
+
+#define BENCH_DEFAULT_ROUNDS  20
+
+static const uint32_t rates[] = { 9600, 115200, 230400, 460800, 921600, 1000000 };
+
+int main(int argc, char **argv)
+{
+    int rounds = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_ROUNDS;
+    const uint8_t password[COMM_PASSWORD_LENGTH] = { '1', '2', '3', '4', '5' };
+    unsigned long errors = 0;
+
+    printf("%-8s %10s %10s %10s %10s\n", "baud", "min ms", "avg ms", "max ms", "wire ms");
+    for (unsigned i = 0; i < sizeof(rates) / sizeof(rates[0]); i++)
+    {
+        COMM_Frame frame;
+        uint64_t minNs = UINT64_MAX, maxNs = 0, totalNs = 0;
+
+        UART_SIM_Reset();
+        UART_SIM_SetLoopback(true);
+        COMM_Init();
+        if (!UART_SetBaudRate(rates[i]))
+        {
+            printf("%-8lu unsupported at this clock\n", (unsigned long)rates[i]);
+            continue;
+        }
+        UART_SIM_SetPacing(true);
+
+        for (int r = 0; r < rounds; r++)
+        {
+            uint64_t start = SIM_NowNs();
+
+            COMM_SendFrame(CMD_SEND_PASSWORD, password, COMM_PASSWORD_LENGTH);
+            COMM_ReceiveFrame(&frame);
+            errors += (frame.cmd != CMD_SEND_PASSWORD);
+            COMM_SendCommand(CMD_PASSWORD_CORRECT);
+            COMM_ReceiveFrame(&frame);
+            errors += (frame.cmd != CMD_PASSWORD_CORRECT);
+
+            uint64_t rtt = SIM_NowNs() - start;
+            totalNs += rtt;
+            if (rtt < minNs) minNs = rtt;
+            if (rtt > maxNs) maxNs = rtt;
+        }
+
+        /* 10 bits per byte, request + reply frames */
+        uint32_t bytes = COMM_WIRE_SIZE(COMM_PASSWORD_LENGTH) + COMM_WIRE_SIZE(0);
+        double wireMs = bytes * 10.0 * 1000.0 / UART_SIM_GetBaudRate();
+        printf("%-8lu %10.3f %10.3f %10.3f %10.3f\n", (unsigned long)rates[i],
+               minNs / 1e6, (double)totalNs / rounds / 1e6, maxNs / 1e6, wireMs);
+    }
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,504 @@
+/*
+    Protocol benchmark against a real Control ECU (serial port) or the
+    simulated one (pty or --spawn). It plays the HMI: answers the startup
+    handshake, sets the password up on a blank board, then drives every
+    COMM_CommandID through the request layer:
+      - latency: --rounds requests one at a time, round trip per request
+        (p50 / p95 / p99 in microseconds)
+      - load: --load requests back to back with up to --window in flight,
+        sustained replies per second
+    Requests carry a valid payload (the right password), so the wrong-password
+    lockout is never triggered; CMD_ALARM, which starts it, is not sent. A command that is not answered 3 times in a
+    row is reported as unanswered and skipped by the load phase.
+    With --loss both boards corrupt that share of the frames they receive;
+    requests are retransmitted (COMM_RequestSendReliable) unless
+    --retransmit off, so success rate and tail latency can be compared.
+
+    Usage: Comm_Link_Bench (--link fd:N|pty|PATH | --spawn PROGRAM) [options]
+      --rounds N        latency samples per command (default 100)
+      --load N          requests per command in the load phase (default 500)
+      --window N        requests in flight during load (default COMM_MAX_PENDING)
+      --password D      5-digit password of the board (default 12345)
+      --autolock S      seconds sent with CMD_VERIFY_AND_SET_TIMEOUT (default 10)
+      --timeout-ms N    reply deadline per request (default 1000)
+      --retransmit on|off  reliable requests with adaptive RTO (default on)
+      --loss PCT        frames corrupted on arrival, each direction (default 0)
+      --format csv|json output format (default csv)
+      --out FILE        write the results to FILE instead of stdout
+    After the run Control's dispatcher is asked (CMD_PROFILE) how often it
+    ran each handler and how many core cycles a run took, reply included:
+    the handler_* and *_cycles columns, all 0 if Control cannot tell.
+    Replaces the putty/Python PASS/FAIL session of Drivers_Test_Project.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include "../../Common/HAL/comm_interface.h"
+#include "../../Common/HAL/comm_request.h"
+#include "../../Common/MCAL/cpu.h"
+#include "../../Common/MCAL/uart.h"
+#include "../Board/board_sim.h"
+#include "../MCAL/sim.h"
+
+#define BENCH_DEFAULT_ROUNDS        100
+#define BENCH_DEFAULT_LOAD          500
+#define BENCH_DEFAULT_TIMEOUT_MS    1000
+#define BENCH_DEFAULT_AUTOLOCK      10
+#define BENCH_GIVE_UP_TIMEOUTS      3       /* consecutive timeouts: command is not answered */
+#define BENCH_HANDSHAKE_TIMEOUT_S   10
+
+#define BENCH_FIRST_CMD             CMD_READY
+#define BENCH_LAST_CMD              CMD_STATS
+#define BENCH_CMD_COUNT             (BENCH_LAST_CMD - BENCH_FIRST_CMD + 1)
+
+typedef struct {
+    uint8_t cmd;
+    uint8_t reply;          /* command of the last reply, 0 if none */
+    uint32_t samples;       /* answered latency requests */
+    uint32_t timeouts;      /* latency and load requests without a reply */
+    uint32_t sent;          /* latency and load requests */
+    uint32_t retries;       /* retransmissions for this command */
+    uint32_t minUs, p50Us, p95Us, p99Us, maxUs;
+    double msgsPerSec;
+    COMM_Profile profile;   /* Control's dispatch counters after the run */
+} BenchResult;
+
+static int rounds = BENCH_DEFAULT_ROUNDS;
+static int load = BENCH_DEFAULT_LOAD;
+static int window = COMM_MAX_PENDING;
+static uint32_t timeoutMs = BENCH_DEFAULT_TIMEOUT_MS;
+static uint8_t autolock = BENCH_DEFAULT_AUTOLOCK;
+static bool retransmit = true;
+static const char *loss = "0";
+static uint8_t password[COMM_PASSWORD_LENGTH] = { '1', '2', '3', '4', '5' };
+
+static BenchResult results[BENCH_CMD_COUNT];
+static int spawnDevFd = -1;
+
+/* Name from the protocol table, "-" for no reply */
+static const char *bench_name(uint8_t cmd)
+{
+    return (cmd != 0) ? COMM_CommandName(cmd) : "-";
+}
+
+/*******************************************************************************
+ *                         Peer                                                *
+ *******************************************************************************/
+
+/* Control on the other end of a socketpair, its device events are discarded */
+static int bench_spawn(const char *program)
+{
+    int link[2], dev[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, link) != 0 ||
+        socketpair(AF_UNIX, SOCK_STREAM, 0, dev) != 0)
+    {
+        perror("socketpair");
+        exit(2);
+    }
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        perror("fork");
+        exit(2);
+    }
+    if (pid == 0)
+    {
+        (void)prctl(PR_SET_PDEATHSIG, SIGKILL);
+        dup2(link[1], 3);
+        dup2(dev[1], 4);
+        for (int fd = 5; fd < 64; fd++)
+        {
+            close(fd);
+        }
+        execl(program, program, "--link", "fd:3", "--dev", "fd:4", "--loss", loss, (char *)NULL);
+        perror(program);
+        _exit(127);
+    }
+
+    close(link[1]);
+    close(dev[1]);
+    spawnDevFd = dev[0];
+    return link[0];
+}
+
+static void bench_drain_peer_events(void)
+{
+    char buf[256];
+    if (spawnDevFd >= 0)
+    {
+        while (recv(spawnDevFd, buf, sizeof(buf), MSG_DONTWAIT) > 0) { }
+    }
+}
+
+static void bench_handshake_expired(int sig)
+{
+    (void)sig;
+    static const char msg[] = "no handshake from Control\n";
+    (void)!write(STDERR_FILENO, msg, sizeof(msg) - 1);
+    _exit(1);
+}
+
+/*******************************************************************************
+ *                         Measurements                                        *
+ *******************************************************************************/
+
+static COMM_RequestHandle bench_send(uint8_t cmd, const uint8_t *payload, uint8_t len)
+{
+    return retransmit ? COMM_RequestSendReliable(cmd, payload, len, timeoutMs)
+                      : COMM_RequestSend(cmd, payload, len, timeoutMs);
+}
+
+static uint32_t bench_retries(void)
+{
+    COMM_Stats stats;
+    COMM_GetStats(&stats);
+    return stats.retries;
+}
+
+/* A payload Control accepts for cmd, returns its length */
+static uint8_t bench_payload(uint8_t cmd, uint8_t *payload)
+{
+    switch (cmd)
+    {
+        case CMD_SEND_PASSWORD:
+        case CMD_CHANGE_PASSWORD:
+        case CMD_VERIFY_AND_UNLOCK:
+            memcpy(payload, password, COMM_PASSWORD_LENGTH);
+            return COMM_PASSWORD_LENGTH;
+        case CMD_VERIFY_AND_SET_TIMEOUT:
+            memcpy(payload, password, COMM_PASSWORD_LENGTH);
+            payload[COMM_PASSWORD_LENGTH] = autolock;
+            return COMM_VERIFY_AND_SET_TIMEOUT_LEN;
+        case CMD_VERIFY_AND_CHANGE:
+            /* change to the same password, the board stays usable */
+            memcpy(payload, password, COMM_PASSWORD_LENGTH);
+            memcpy(&payload[COMM_PASSWORD_LENGTH], password, COMM_PASSWORD_LENGTH);
+            return COMM_VERIFY_AND_CHANGE_LEN;
+        default:
+            return 0;
+    }
+}
+
+static int bench_compare(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of a sorted array */
+static uint32_t bench_percentile(const uint32_t *sorted, uint32_t n, uint32_t pct)
+{
+    uint32_t rank = (pct * n + 99) / 100;
+    return sorted[(rank > 0) ? rank - 1 : 0];
+}
+
+static void bench_latency(BenchResult *result, uint32_t *us)
+{
+    uint8_t payload[COMM_MAX_PAYLOAD];
+    uint8_t len = bench_payload(result->cmd, payload);
+    uint32_t missed = 0;
+    COMM_Frame reply;
+
+    for (int r = 0; r < rounds && missed < BENCH_GIVE_UP_TIMEOUTS; r++)
+    {
+        uint64_t start = SIM_NowNs();
+        COMM_RequestHandle request = bench_send(result->cmd, payload, len);
+        result->sent++;
+        COMM_RequestState state = COMM_RequestWait(request, &reply);
+        uint64_t end = SIM_NowNs();
+        COMM_RequestRelease(request);
+
+        if (state != COMM_REQ_DONE)
+        {
+            result->timeouts++;
+            missed++;
+            continue;
+        }
+        missed = 0;
+        result->reply = reply.cmd;
+        us[result->samples++] = (uint32_t)((end - start) / 1000);
+    }
+
+    if (result->samples > 0)
+    {
+        qsort(us, result->samples, sizeof(us[0]), bench_compare);
+        result->minUs = us[0];
+        result->p50Us = bench_percentile(us, result->samples, 50);
+        result->p95Us = bench_percentile(us, result->samples, 95);
+        result->p99Us = bench_percentile(us, result->samples, 99);
+        result->maxUs = us[result->samples - 1];
+    }
+}
+
+static void bench_load(BenchResult *result)
+{
+    uint8_t payload[COMM_MAX_PAYLOAD];
+    uint8_t len = bench_payload(result->cmd, payload);
+    COMM_RequestHandle inFlight[COMM_MAX_PENDING];
+    int sent = 0, finished = 0, answered = 0;
+
+    for (int i = 0; i < window; i++)
+    {
+        inFlight[i] = COMM_REQUEST_NONE;
+    }
+
+    uint64_t start = SIM_NowNs();
+    while (finished < load)
+    {
+        for (int i = 0; i < window; i++)
+        {
+            if (inFlight[i] == COMM_REQUEST_NONE)
+            {
+                if (sent < load)
+                {
+                    inFlight[i] = bench_send(result->cmd, payload, len);
+                    sent += (inFlight[i] != COMM_REQUEST_NONE);
+                    result->sent += (inFlight[i] != COMM_REQUEST_NONE);
+                }
+                continue;
+            }
+
+            COMM_RequestState state = COMM_RequestGetState(inFlight[i]);
+            if (state == COMM_REQ_DONE || state == COMM_REQ_TIMEOUT)
+            {
+                answered += (state == COMM_REQ_DONE);
+                result->timeouts += (state == COMM_REQ_TIMEOUT);
+                COMM_RequestRelease(inFlight[i]);
+                inFlight[i] = COMM_REQUEST_NONE;
+                finished++;
+            }
+        }
+        COMM_RequestPoll();
+        CPU_Idle();
+    }
+    uint64_t elapsed = SIM_NowNs() - start;
+
+    result->msgsPerSec = elapsed ? answered * 1e9 / (double)elapsed : 0.0;
+}
+
+/*******************************************************************************
+ *                         Output                                              *
+ *******************************************************************************/
+
+static void bench_write_stats_json(FILE *out, const char *name, const COMM_Stats *st)
+{
+    fprintf(out, "  \"%s\": {\"bytes_in\": %u, \"bytes_out\": %u, \"frames_in\": %u, "
+                 "\"frames_out\": %u, \"crc_errors\": %u, \"framing_errors\": %u, "
+                 "\"overrun_errors\": %u, \"retries\": %u, \"timeouts\": %u, "
+                 "\"max_rtt_ms\": %u},\n",
+            name, st->bytesIn, st->bytesOut, st->framesIn, st->framesOut, st->crcErrors,
+            st->framingErrors, st->overrunErrors, st->retries, st->timeouts, st->maxRttMs);
+}
+
+static void bench_print_stats(const char *name, const COMM_Stats *st)
+{
+    fprintf(stderr, "%-8s %u/%u bytes, %u/%u frames in/out, %u crc, %u framing, %u overrun, "
+                    "%u retries, %u timeouts, max rtt %u ms\n",
+            name, st->bytesIn, st->bytesOut, st->framesIn, st->framesOut, st->crcErrors,
+            st->framingErrors, st->overrunErrors, st->retries, st->timeouts, st->maxRttMs);
+}
+
+static void bench_write_csv(FILE *out, uint32_t baud)
+{
+    fprintf(out, "command,code,reply,baud,samples,timeouts,retries,min_us,p50_us,p95_us,p99_us,max_us,msgs_per_s,"
+                 "handler_runs,handler_rejected,min_cycles,avg_cycles,max_cycles\n");
+    for (int i = 0; i < BENCH_CMD_COUNT; i++)
+    {
+        const BenchResult *r = &results[i];
+        const COMM_Profile *p = &r->profile;
+        fprintf(out, "%s,0x%02X,%s,%u,%u,%u,%u,%u,%u,%u,%u,%u,%.1f,%u,%u,%u,%u,%u\n",
+                bench_name(r->cmd), r->cmd, bench_name(r->reply), baud, r->samples, r->timeouts,
+                r->retries, r->minUs, r->p50Us, r->p95Us, r->p99Us, r->maxUs, r->msgsPerSec,
+                p->count, p->rejected, p->minCycles, p->avgCycles, p->maxCycles);
+    }
+}
+
+static void bench_write_json(FILE *out, uint32_t baud, const COMM_Stats *local,
+                             const COMM_Stats *peer)
+{
+    fprintf(out, "{\n  \"baud\": %u,\n  \"rounds\": %d,\n  \"load\": %d,\n  \"window\": %d,\n"
+                 "  \"retransmit\": %s,\n  \"loss_pct\": %s,\n",
+            baud, rounds, load, window, retransmit ? "true" : "false", loss);
+    bench_write_stats_json(out, "bench_stats", local);
+    if (peer)
+    {
+        bench_write_stats_json(out, "control_stats", peer);
+    }
+    fprintf(out, "  \"commands\": [\n");
+    for (int i = 0; i < BENCH_CMD_COUNT; i++)
+    {
+        const BenchResult *r = &results[i];
+        const COMM_Profile *p = &r->profile;
+        fprintf(out, "    {\"command\": \"%s\", \"code\": %u, \"reply\": \"%s\", \"samples\": %u, "
+                     "\"timeouts\": %u, \"retries\": %u, \"min_us\": %u, \"p50_us\": %u, "
+                     "\"p95_us\": %u, \"p99_us\": %u, \"max_us\": %u, \"msgs_per_s\": %.1f, "
+                     "\"handler_runs\": %u, \"handler_rejected\": %u, \"min_cycles\": %u, "
+                     "\"avg_cycles\": %u, \"max_cycles\": %u}%s\n",
+                bench_name(r->cmd), r->cmd, bench_name(r->reply), r->samples, r->timeouts,
+                r->retries, r->minUs, r->p50Us, r->p95Us, r->p99Us, r->maxUs, r->msgsPerSec,
+                p->count, p->rejected, p->minCycles, p->avgCycles, p->maxCycles,
+                (i + 1 < BENCH_CMD_COUNT) ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+/*******************************************************************************
+ *                         Main                                                *
+ *******************************************************************************/
+
+int main(int argc, char **argv)
+{
+    const char *link = NULL, *spawn = NULL, *format = "csv", *outPath = NULL;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const char *opt = argv[i], *val = argv[i + 1];
+        if (strcmp(opt, "--link") == 0)            link = val;
+        else if (strcmp(opt, "--spawn") == 0)      spawn = val;
+        else if (strcmp(opt, "--rounds") == 0)     rounds = atoi(val);
+        else if (strcmp(opt, "--load") == 0)       load = atoi(val);
+        else if (strcmp(opt, "--window") == 0)     window = atoi(val);
+        else if (strcmp(opt, "--timeout-ms") == 0) timeoutMs = (uint32_t)atoi(val);
+        else if (strcmp(opt, "--autolock") == 0)   autolock = (uint8_t)atoi(val);
+        else if (strcmp(opt, "--retransmit") == 0) retransmit = (strcmp(val, "off") != 0);
+        else if (strcmp(opt, "--loss") == 0)       loss = val;
+        else if (strcmp(opt, "--format") == 0)     format = val;
+        else if (strcmp(opt, "--out") == 0)        outPath = val;
+        else if (strcmp(opt, "--password") == 0 && strlen(val) == COMM_PASSWORD_LENGTH)
+            memcpy(password, val, COMM_PASSWORD_LENGTH);
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", opt);
+            return 2;
+        }
+    }
+    if ((link == NULL) == (spawn == NULL) || rounds < 1 || load < 0 ||
+        window < 1 || window > COMM_MAX_PENDING)
+    {
+        fprintf(stderr, "usage: %s (--link fd:N|pty|PATH | --spawn PROGRAM) [--rounds N] "
+                        "[--load N] [--window 1-%d] [--password D] [--autolock S] "
+                        "[--timeout-ms N] [--retransmit on|off] [--loss PCT] "
+                        "[--format csv|json] [--out FILE]\n",
+                argv[0], COMM_MAX_PENDING);
+        return 2;
+    }
+
+    char linkArg[16];
+    if (spawn)
+    {
+        snprintf(linkArg, sizeof(linkArg), "fd:%d", bench_spawn(spawn));
+        link = linkArg;
+    }
+    char *boardArgv[] = { argv[0], "--link", (char *)link, "--dev", "none",
+                          "--loss", (char *)loss, NULL };
+    BOARD_SIM_Init("bench", 7, boardArgv, NULL);
+    BOARD_SIM_AddPoll(bench_drain_peer_events);
+
+    COMM_Init();
+    CPU_EnableInterrupts();
+
+    signal(SIGALRM, bench_handshake_expired);
+    alarm(BENCH_HANDSHAKE_TIMEOUT_S);
+    uint8_t status;
+    uint32_t baud = COMM_HandshakeRespond(&status);
+    alarm(0);
+    COMM_RequestInit();
+
+    /* A blank board wants the password first, like the HMI's first boot */
+    if (status == CMD_INIT)
+    {
+        COMM_Frame reply;
+        COMM_RequestHandle request = bench_send(CMD_CHANGE_PASSWORD, password,
+                                                COMM_PASSWORD_LENGTH);
+        if (COMM_RequestWait(request, &reply) != COMM_REQ_DONE || reply.cmd != CMD_ACK)
+        {
+            fprintf(stderr, "could not set the password up\n");
+            return 1;
+        }
+        COMM_RequestRelease(request);
+    }
+    fprintf(stderr, "linked at %u baud, %d rounds, load %d, window %d, retransmit %s, loss %s%%\n",
+            baud, rounds, load, window, retransmit ? "on" : "off", loss);
+
+    uint32_t *us = malloc(sizeof(uint32_t) * (size_t)rounds);
+    bool anyReply = false;
+    for (int i = 0; i < BENCH_CMD_COUNT; i++)
+    {
+        BenchResult *result = &results[i];
+        result->cmd = (uint8_t)(BENCH_FIRST_CMD + i);
+        if (result->cmd == CMD_ALARM)
+        {
+            continue;   /* would sound the alarm and lock passwords out for a minute */
+        }
+        uint32_t retriesBefore = bench_retries();
+        bench_latency(result, us);
+        if (result->samples > 0 && load > 0)
+        {
+            bench_load(result);
+        }
+        result->retries = bench_retries() - retriesBefore;
+        anyReply |= (result->samples > 0);
+        fprintf(stderr, "%-28s p50 %6u us  p99 %6u us  %8.1f msg/s  %5.1f%% answered  %u retries\n",
+                bench_name(result->cmd), result->p50Us, result->p99Us, result->msgsPerSec,
+                result->sent ? 100.0 * (result->sent - result->timeouts) / result->sent : 0.0,
+                result->retries);
+    }
+    free(us);
+
+    /* Link counters on both ends after the run */
+    COMM_Stats local, peer;
+    COMM_Frame reply;
+    COMM_RequestHandle query = bench_send(CMD_STATS, NULL, 0);
+    bool havePeer = COMM_RequestWait(query, &reply) == COMM_REQ_DONE &&
+                    reply.cmd == CMD_STATS && COMM_DecodeStats(reply.payload, reply.len, &peer);
+    COMM_RequestRelease(query);
+
+    /* Control's dispatcher: handler runs and cycles of every command */
+    for (int i = 0; i < BENCH_CMD_COUNT && COMM_PeerSupports(CMD_PROFILE); i++)
+    {
+        BenchResult *result = &results[i];
+        query = bench_send(CMD_PROFILE, &result->cmd, COMM_PROFILE_QUERY_LEN);
+        if (COMM_RequestWait(query, &reply) == COMM_REQ_DONE && reply.cmd == CMD_PROFILE &&
+            COMM_DecodeProfile(reply.payload, reply.len, &result->profile) &&
+            (result->profile.count > 0 || result->profile.rejected > 0))
+        {
+            fprintf(stderr, "%-28s %6u runs  %6u rejected  cycles min %8u avg %8u max %8u\n",
+                    bench_name(result->cmd), result->profile.count, result->profile.rejected,
+                    result->profile.minCycles, result->profile.avgCycles,
+                    result->profile.maxCycles);
+        }
+        COMM_RequestRelease(query);
+    }
+    COMM_GetStats(&local);
+    bench_print_stats("bench", &local);
+    if (havePeer)
+    {
+        bench_print_stats("control", &peer);
+    }
+
+    FILE *out = outPath ? fopen(outPath, "w") : stdout;
+    if (out == NULL)
+    {
+        perror(outPath);
+        return 2;
+    }
+    if (strcmp(format, "json") == 0)
+    {
+        bench_write_json(out, baud, &local, havePeer ? &peer : NULL);
+    }
+    else
+    {
+        bench_write_csv(out, baud);
+    }
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+    return anyReply ? 0 : 1;
+}
@@ -0,0 +1,211 @@
+/*
+    Host benchmark for the request/response layer on the open-door path.
+    The simulated UART2 is paced in real time at the fallback rate (9600) and
+    the Control ECU is played from the SIM idle hook: it reads frames off the
+    TX pin, checks the password, answers with the request's SEQ and records
+    when the motor would start. Latency is measured from the moment the
+    password has been typed to the motor start, for:
+      - stop-and-wait: password, reply, ACK, 50 ms guard delay, DOOR_UNLOCK
+        (the flow the HMI used before the request layer)
+      - pipelined: password and DOOR_UNLOCK sent back to back as two requests
+      - compound: one CMD_VERIFY_AND_UNLOCK request, one reply
+    Control_ECU only accepts the compound form now; the first two are kept
+    in the simulated Control as the baseline.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../Common/HAL/comm_interface.h"
+#include "../../Common/HAL/comm_request.h"
+#include "../../Common/MCAL/cpu.h"
+#include "../../Common/MCAL/tick.h"
+#include "../MCAL/uart_sim.h"
+#include "../MCAL/sim.h"
+
+#define BENCH_DEFAULT_ROUNDS    10
+#define BENCH_BAUD              9600
+#define BENCH_GUARD_DELAY_MS    50      /* DelayMs(50) the old HMI flow used */
+#define BENCH_REPLY_TIMEOUT_MS  1000
+
+static const uint8_t password[COMM_PASSWORD_LENGTH] = { '1', '2', '3', '4', '5' };
+
+/*******************************************************************************
+ *                         Simulated Control ECU                               *
+ *******************************************************************************/
+
+static COMM_Parser controlParser;
+static bool unlockAuthorized;
+static uint64_t motorStartNs;
+
+static void control_reply(uint8_t seq, uint8_t cmd)
+{
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+    uint8_t n = COMM_EncodeFrame(wire, cmd, seq, NULL, 0);
+    UART_SIM_Inject(wire, n);
+}
+
+/* Same decisions as Control_ECU/ECU_COMM.c, the door cycle itself is skipped */
+static void control_handle(const COMM_Frame *frame)
+{
+    bool authorized = unlockAuthorized;
+    unlockAuthorized = false;
+
+    switch (frame->cmd)
+    {
+        case CMD_SEND_PASSWORD:
+            unlockAuthorized = (frame->len == COMM_PASSWORD_LENGTH) &&
+                               memcmp(frame->payload, password, COMM_PASSWORD_LENGTH) == 0;
+            control_reply(frame->seq, unlockAuthorized ? CMD_PASSWORD_CORRECT : CMD_PASSWORD_WRONG);
+            break;
+
+        case CMD_DOOR_UNLOCK:
+            if (authorized)
+            {
+                motorStartNs = SIM_NowNs();
+            }
+            control_reply(frame->seq, authorized ? CMD_ACK : CMD_FAIL);
+            break;
+
+        case CMD_VERIFY_AND_UNLOCK:
+            if (frame->len == COMM_VERIFY_AND_UNLOCK_LEN &&
+                memcmp(frame->payload, password, COMM_PASSWORD_LENGTH) == 0)
+            {
+                control_reply(frame->seq, CMD_SUCCESS);
+                motorStartNs = SIM_NowNs();
+            }
+            else
+            {
+                control_reply(frame->seq, CMD_PASSWORD_WRONG);
+            }
+            break;
+
+        case CMD_ACK:
+            /* the old flow acknowledged the password reply, keep the grant */
+            unlockAuthorized = authorized;
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void control_idle_hook(void)
+{
+    uint8_t wire[64];
+    uint16_t n = UART_SIM_Drain(wire, sizeof(wire));
+    for (uint16_t i = 0; i < n; i++)
+    {
+        if (COMM_ParseByte(&controlParser, wire[i]) == COMM_PARSE_FRAME)
+        {
+            control_handle(&controlParser.frame);
+        }
+    }
+}
+
+/*******************************************************************************
+ *                         HMI Flows                                           *
+ *******************************************************************************/
+
+static void bench_delay_ms(uint32_t ms)
+{
+    uint64_t end = SIM_NowNs() + (uint64_t)ms * 1000000ULL;
+    while (SIM_NowNs() < end)
+    {
+        CPU_Idle();
+    }
+}
+
+static bool open_door_stop_and_wait(void)
+{
+    COMM_Frame frame;
+
+    COMM_SendFrame(CMD_SEND_PASSWORD, password, COMM_PASSWORD_LENGTH);
+    if (COMM_ReceiveFrameUntil(&frame, Tick_Deadline(BENCH_REPLY_TIMEOUT_MS)) != COMM_OK ||
+        frame.cmd != CMD_PASSWORD_CORRECT)
+    {
+        return false;
+    }
+    COMM_SendCommand(CMD_ACK);
+    bench_delay_ms(BENCH_GUARD_DELAY_MS);
+    COMM_SendCommand(CMD_DOOR_UNLOCK);
+    return COMM_ReceiveFrameUntil(&frame, Tick_Deadline(BENCH_REPLY_TIMEOUT_MS)) == COMM_OK &&
+           frame.cmd == CMD_ACK;
+}
+
+static bool open_door_pipelined(void)
+{
+    COMM_Frame reply;
+
+    COMM_RequestHandle check = COMM_RequestSend(CMD_SEND_PASSWORD, password,
+                                                COMM_PASSWORD_LENGTH, BENCH_REPLY_TIMEOUT_MS);
+    COMM_RequestHandle unlock = COMM_RequestSend(CMD_DOOR_UNLOCK, NULL, 0, BENCH_REPLY_TIMEOUT_MS);
+
+    bool ok = COMM_RequestWait(check, &reply) == COMM_REQ_DONE && reply.cmd == CMD_PASSWORD_CORRECT &&
+              COMM_RequestWait(unlock, &reply) == COMM_REQ_DONE && reply.cmd == CMD_ACK;
+    COMM_RequestRelease(check);
+    COMM_RequestRelease(unlock);
+    return ok;
+}
+
+static bool open_door_compound(void)
+{
+    COMM_Frame reply;
+
+    COMM_RequestHandle request = COMM_RequestSend(CMD_VERIFY_AND_UNLOCK, password,
+                                                  COMM_VERIFY_AND_UNLOCK_LEN, BENCH_REPLY_TIMEOUT_MS);
+    bool ok = COMM_RequestWait(request, &reply) == COMM_REQ_DONE && reply.cmd == CMD_SUCCESS;
+    COMM_RequestRelease(request);
+    return ok;
+}
+
+static double bench_flow(const char *label, bool (*flow)(void), int rounds, unsigned long *errors)
+{
+    uint64_t minNs = UINT64_MAX, maxNs = 0, totalNs = 0;
+
+    UART_SIM_Reset();
+    COMM_Init();
+    COMM_RequestInit();
+    (void)UART_SetBaudRate(BENCH_BAUD);
+    UART_SIM_SetPacing(true);
+    COMM_ParserReset(&controlParser);
+    unlockAuthorized = false;
+    SIM_SetIdleHook(control_idle_hook);
+
+    for (int r = 0; r < rounds; r++)
+    {
+        motorStartNs = 0;
+        uint64_t start = SIM_NowNs();
+        if (!flow() || motorStartNs == 0)
+        {
+            (*errors)++;
+            continue;
+        }
+        uint64_t latency = motorStartNs - start;
+        totalNs += latency;
+        if (latency < minNs) minNs = latency;
+        if (latency > maxNs) maxNs = latency;
+    }
+    SIM_SetIdleHook(NULL);
+
+    double avgMs = (double)totalNs / rounds / 1e6;
+    printf("%-14s %10.3f %10.3f %10.3f\n", label, minNs / 1e6, avgMs, maxNs / 1e6);
+    return avgMs;
+}
+
+int main(int argc, char **argv)
+{
+    int rounds = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_ROUNDS;
+    unsigned long errors = 0;
+
+    printf("keypad -> motor start at %d baud, %d rounds\n", BENCH_BAUD, rounds);
+    printf("%-14s %10s %10s %10s\n", "flow", "min ms", "avg ms", "max ms");
+    double before = bench_flow("stop-and-wait", open_door_stop_and_wait, rounds, &errors);
+    (void)bench_flow("pipelined", open_door_pipelined, rounds, &errors);
+    double after = bench_flow("compound", open_door_compound, rounds, &errors);
+    printf("reduction      %10.3f ms (%.0f%%) stop-and-wait -> compound\n",
+           before - after, 100.0 * (before - after) / before);
+    printf("errors         %lu\n", errors);
+
+    return errors ? 1 : 0;
+}
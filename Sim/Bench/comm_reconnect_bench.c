@@ -0,0 +1,270 @@
+/*
+    Mean time to recover after a peer reset. The bench plays the HMI with the
+    same link supervision (comm_link.h) against a Sim_Control_ECU it starts
+    on a socketpair, and keeps requests going the whole time:
+      - control: Control is killed and started again on the same link
+        (cold boot: EEPROM read, handshake)
+      - warm: Control's "reset" device command, a software reset that keeps
+        its state and the link in no-init RAM (software_reset.h)
+      - hmi: the bench restarts itself (COMM_Init, handshake as at boot)
+        while Control keeps running in its old session
+    Recovery is the time from the reset until a CMD_STATS request is answered
+    again. Each scenario runs --resets times with --settle ms of traffic in
+    between. Times are simulated ms, --speed runs both boards faster.
+
+    Usage: Comm_Reconnect_Bench --spawn PROGRAM [options]
+      --resets N        resets per scenario (default 5)
+      --settle MS       traffic between two resets (default 1000)
+      --speed N         simulated time N times faster (default 1)
+    The HMI's own boot (splash screen) is not part of the hmi figure.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "../../Common/HAL/comm_interface.h"
+#include "../../Common/HAL/comm_request.h"
+#include "../../Common/HAL/comm_link.h"
+#include "../../Common/MCAL/cpu.h"
+#include "../Board/board_sim.h"
+#include "../MCAL/sim.h"
+
+#define BENCH_DEFAULT_RESETS        5
+#define BENCH_DEFAULT_SETTLE_MS     1000
+#define BENCH_REQUEST_MS            100     /* deadline of each CMD_STATS probe */
+#define BENCH_RECOVER_TIMEOUT_S     60      /* host seconds before giving up */
+
+static const char *program;
+static const char *speedArg = "1";
+static int peerLink = -1;           /* Control's end, kept open across resets */
+static int peerDev = -1;            /* Control's device channel, same */
+static int benchDev = -1;           /* our end of it */
+static pid_t peerPid;
+
+typedef struct {
+    const char *name;
+    uint32_t count;
+    double sumMs, minMs, maxMs;
+} BenchResult;
+
+/*******************************************************************************
+ *                         Peer                                                *
+ *******************************************************************************/
+
+static void bench_start_peer(void)
+{
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        perror("fork");
+        exit(2);
+    }
+    if (pid == 0)
+    {
+        (void)prctl(PR_SET_PDEATHSIG, SIGKILL);
+        dup2(peerLink, 3);
+        dup2(peerDev, 4);
+        for (int fd = 5; fd < 64; fd++)
+        {
+            close(fd);
+        }
+        execl(program, program, "--link", "fd:3", "--dev", "fd:4", "--speed", speedArg,
+              (char *)NULL);
+        perror(program);
+        _exit(127);
+    }
+    peerPid = pid;
+}
+
+/* Power cycle: whatever Control was about to send is lost with it */
+static void bench_reset_peer(void)
+{
+    kill(peerPid, SIGKILL);
+    waitpid(peerPid, NULL, 0);
+    bench_start_peer();
+}
+
+/* Warm reset: Control keeps its process, state and link (the device command) */
+static void bench_warm_reset_peer(void)
+{
+    static const char cmd[] = "reset\n";
+    (void)!write(benchDev, cmd, sizeof(cmd) - 1);
+}
+
+/* Control's device events are not needed, only kept from filling the socket */
+static void bench_drain_dev(void)
+{
+    char discard[256];
+    while (read(benchDev, discard, sizeof(discard)) > 0) { }
+}
+
+static void bench_recover_expired(int sig)
+{
+    (void)sig;
+    static const char msg[] = "link did not recover\n";
+    (void)!write(STDERR_FILENO, msg, sizeof(msg) - 1);
+    _exit(1);
+}
+
+/*******************************************************************************
+ *                         Measurements                                        *
+ *******************************************************************************/
+
+/* One CMD_STATS round trip while the link is not known to be down, retransmitted as the HMI's requests are */
+static bool bench_probe(void)
+{
+    uint8_t status;
+    if (COMM_LinkService(&status) == COMM_LINK_DOWN)
+    {
+        return false;
+    }
+    COMM_RequestHandle request = COMM_RequestSendReliable(CMD_STATS, NULL, 0, BENCH_REQUEST_MS);
+    if (request == COMM_REQUEST_NONE)
+    {
+        return false;
+    }
+    COMM_RequestState state = COMM_RequestWait(request, NULL);
+    COMM_RequestRelease(request);
+    return state == COMM_REQ_DONE;
+}
+
+static void bench_wait_answered(void)
+{
+    alarm(BENCH_RECOVER_TIMEOUT_S);
+    while (!bench_probe())
+    {
+        CPU_Idle();
+    }
+    alarm(0);
+}
+
+static void bench_settle(uint32_t ms)
+{
+    uint64_t end = SIM_NowNs() + (uint64_t)ms * 1000000ULL;
+    while (SIM_NowNs() < end)
+    {
+        bench_drain_dev();
+        (void)bench_probe();
+        CPU_Idle();
+    }
+}
+
+/* Boot of the HMI side, as in HMI_Connect */
+static void bench_connect(void)
+{
+    uint8_t status;
+    COMM_Init();
+    alarm(BENCH_RECOVER_TIMEOUT_S);
+    (void)COMM_HandshakeRespond(&status);
+    alarm(0);
+    COMM_RequestInit();
+    COMM_LinkInit();
+}
+
+static void bench_record(BenchResult *result, uint64_t startNs)
+{
+    double ms = (double)(SIM_NowNs() - startNs) / 1e6;
+    result->sumMs += ms;
+    result->minMs = (result->count == 0 || ms < result->minMs) ? ms : result->minMs;
+    result->maxMs = (ms > result->maxMs) ? ms : result->maxMs;
+    result->count++;
+}
+
+/*******************************************************************************
+ *                         Main                                                *
+ *******************************************************************************/
+
+int main(int argc, char **argv)
+{
+    int resets = BENCH_DEFAULT_RESETS;
+    uint32_t settleMs = BENCH_DEFAULT_SETTLE_MS;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const char *opt = argv[i], *val = argv[i + 1];
+        if (strcmp(opt, "--spawn") == 0)       program = val;
+        else if (strcmp(opt, "--resets") == 0) resets = atoi(val);
+        else if (strcmp(opt, "--settle") == 0) settleMs = (uint32_t)atoi(val);
+        else if (strcmp(opt, "--speed") == 0)  speedArg = val;
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", opt);
+            return 2;
+        }
+    }
+    if (program == NULL || resets < 1)
+    {
+        fprintf(stderr, "usage: %s --spawn PROGRAM [--resets N] [--settle MS] [--speed N]\n",
+                argv[0]);
+        return 2;
+    }
+
+    int link[2], dev[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, link) != 0 ||
+        socketpair(AF_UNIX, SOCK_STREAM, 0, dev) != 0)
+    {
+        perror("socketpair");
+        return 2;
+    }
+    peerLink = link[1];
+    peerDev = dev[1];
+    benchDev = dev[0];
+    (void)fcntl(benchDev, F_SETFL, O_NONBLOCK);
+    bench_start_peer();
+
+    char linkArg[16];
+    snprintf(linkArg, sizeof(linkArg), "fd:%d", link[0]);
+    char *boardArgv[] = { argv[0], "--link", linkArg, "--dev", "none",
+                          "--speed", (char *)speedArg, NULL };
+    BOARD_SIM_Init("bench", 7, boardArgv, NULL);
+    signal(SIGALRM, bench_recover_expired);
+
+    CPU_EnableInterrupts();
+    bench_connect();
+    bench_settle(settleMs);
+
+    BenchResult results[3] = { { .name = "control" }, { .name = "warm" }, { .name = "hmi" } };
+    for (int i = 0; i < resets; i++)
+    {
+        uint64_t start = SIM_NowNs();
+        bench_reset_peer();
+        bench_wait_answered();
+        bench_record(&results[0], start);
+        bench_settle(settleMs);
+    }
+    for (int i = 0; i < resets; i++)
+    {
+        uint64_t start = SIM_NowNs();
+        bench_warm_reset_peer();
+        bench_wait_answered();
+        bench_record(&results[1], start);
+        bench_settle(settleMs);
+    }
+    for (int i = 0; i < resets; i++)
+    {
+        uint64_t start = SIM_NowNs();
+        bench_connect();
+        bench_wait_answered();
+        bench_record(&results[2], start);
+        bench_settle(settleMs);
+    }
+
+    printf("heartbeat %u ms, link timeout %u ms, %d resets each\n",
+           COMM_HEARTBEAT_MS, COMM_LINK_TIMEOUT_MS, resets);
+    printf("%-8s %10s %10s %10s\n", "reset", "mttr_ms", "min_ms", "max_ms");
+    for (int i = 0; i < 3; i++)
+    {
+        const BenchResult *r = &results[i];
+        printf("%-8s %10.1f %10.1f %10.1f\n", r->name, r->sumMs / r->count, r->minMs, r->maxMs);
+    }
+
+    kill(peerPid, SIGKILL);
+    waitpid(peerPid, NULL, 0);
+    return 0;
+}
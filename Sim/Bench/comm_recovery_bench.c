@@ -0,0 +1,292 @@
+/*
+    Host benchmark for how the framing recovers from errors on the wire.
+    A stream of frames (random commands, 0..16 random payload bytes) is encoded,
+    damaged and fed byte by byte through the receive parser. Two error models:
+      - flip: every bit flips with the given probability (line noise)
+      - drop: every byte is lost with the given probability (RX FIFO overrun)
+    A frame is "damaged" when one of its own wire bytes was hit, "collateral"
+    when it arrived intact but was still lost because the parser had not found
+    the frame boundary yet, and "false" when a frame that was never sent passed
+    the CRC.
+    Two formats are compared:
+      - sof : SOF 0x7E | CMD | SEQ | LEN | PAYLOAD | CRC16, hunt for SOF after
+              an error (the format COBS replaced, kept here as the baseline)
+      - cobs: COBS-stuffed CMD | SEQ | LEN | PAYLOAD | CRC16, 0x00 delimiter
+              (COMM_EncodeFrame / COMM_ParseByte)
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../Common/HAL/comm_interface.h"
+#include "../../Common/Utils/crc16.h"
+
+#define BENCH_DEFAULT_FRAMES    100000
+#define BENCH_DEFAULT_SEED      1
+#define BENCH_MAX_PAYLOAD       16
+#define BENCH_MATCH_WINDOW      8       /* how far back a delivered frame is looked up */
+
+#define SOF_BYTE                0x7E
+#define SOF_WIRE_SIZE(len)      (4 + (len) + 2)
+
+static const double rates[] = { 1e-5, 1e-4, 1e-3, 1e-2 };
+
+typedef struct
+{
+    uint8_t cmd;
+    uint8_t seq;
+    uint8_t len;
+    uint8_t payload[BENCH_MAX_PAYLOAD];
+    bool damaged;
+    bool delivered;
+} BenchFrame;
+
+typedef struct
+{
+    unsigned long damaged;
+    unsigned long delivered;
+    unsigned long collateral;
+    unsigned long falseFrames;
+    unsigned long bytes;
+} BenchResult;
+
+static BenchFrame *frames;
+static unsigned long frameCount;
+static unsigned long matchNext;     /* first frame not yet delivered or skipped */
+static uint64_t rng;
+
+/* xorshift64*, reproducible across hosts */
+static uint32_t bench_random(void)
+{
+    rng ^= rng >> 12;
+    rng ^= rng << 25;
+    rng ^= rng >> 27;
+    return (uint32_t)((rng * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+/* Flip each bit, or drop each byte, with probability rate; true if anything changed */
+static bool bench_corrupt(uint8_t *wire, uint8_t *n, double rate, bool drop)
+{
+    bool damaged = false;
+    uint32_t threshold = (uint32_t)(rate * 4294967296.0);
+    uint8_t kept = 0;
+
+    for (uint8_t i = 0; i < *n; i++)
+    {
+        if (drop)
+        {
+            if (bench_random() < threshold)
+            {
+                damaged = true;
+                continue;
+            }
+            wire[kept++] = wire[i];
+            continue;
+        }
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            if (bench_random() < threshold)
+            {
+                wire[i] ^= (uint8_t)(1u << bit);
+                damaged = true;
+            }
+        }
+    }
+    if (drop)
+    {
+        *n = kept;
+    }
+    return damaged;
+}
+
+/* Delivered frames come out in order, at the latest while frame current is on the wire */
+static void bench_deliver(unsigned long current, uint8_t cmd, uint8_t seq, uint8_t len,
+                          const uint8_t *payload, BenchResult *result)
+{
+    if (current >= BENCH_MATCH_WINDOW && matchNext < current - BENCH_MATCH_WINDOW)
+    {
+        matchNext = current - BENCH_MATCH_WINDOW;
+    }
+    for (unsigned long i = matchNext; i <= current; i++)
+    {
+        BenchFrame *f = &frames[i];
+        if (f->cmd == cmd && f->seq == seq && f->len == len && memcmp(f->payload, payload, len) == 0)
+        {
+            f->delivered = true;
+            matchNext = i + 1;
+            result->delivered++;
+            return;
+        }
+    }
+    result->falseFrames++;
+}
+
+/*******************************************************************************
+ *                         SOF baseline                                        *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint8_t state;      /* 0 hunt, 1 cmd, 2 seq, 3 len, 4 payload, 5 crc hi, 6 crc lo */
+    uint8_t cmd, seq, len, index;
+    uint8_t payload[COMM_MAX_PAYLOAD];
+    uint16_t crc, rxCrc;
+} SofParser;
+
+static uint8_t sof_encode(uint8_t *wire, const BenchFrame *f)
+{
+    wire[0] = SOF_BYTE;
+    wire[1] = f->cmd;
+    wire[2] = f->seq;
+    wire[3] = f->len;
+    memcpy(&wire[4], f->payload, f->len);
+    uint16_t crc = CRC16_Compute(CRC16_INIT, &wire[1], 3 + f->len);
+    wire[4 + f->len] = (uint8_t)(crc >> 8);
+    wire[5 + f->len] = (uint8_t)crc;
+    return SOF_WIRE_SIZE(f->len);
+}
+
+/* Same state machine as the parser before COBS; true on a CRC-checked frame */
+static bool sof_parse(SofParser *p, uint8_t byte)
+{
+    switch (p->state)
+    {
+        case 0:
+            if (byte == SOF_BYTE)
+            {
+                p->crc = CRC16_INIT;
+                p->index = 0;
+                p->state = 1;
+            }
+            return false;
+        case 1:
+            p->cmd = byte;
+            break;
+        case 2:
+            p->seq = byte;
+            break;
+        case 3:
+            if (byte > COMM_MAX_PAYLOAD)
+            {
+                p->state = 0;
+                return false;
+            }
+            p->len = byte;
+            p->crc = CRC16_Update(p->crc, byte);
+            p->state = (byte == 0) ? 5 : 4;
+            return false;
+        case 4:
+            p->payload[p->index++] = byte;
+            p->crc = CRC16_Update(p->crc, byte);
+            if (p->index == p->len)
+            {
+                p->state = 5;
+            }
+            return false;
+        case 5:
+            p->rxCrc = (uint16_t)(byte << 8);
+            p->state = 6;
+            return false;
+        default:
+            p->rxCrc |= byte;
+            p->state = 0;
+            return p->rxCrc == p->crc;
+    }
+    p->crc = CRC16_Update(p->crc, byte);
+    p->state++;
+    return false;
+}
+
+/*******************************************************************************
+ *                         Runs                                                *
+ *******************************************************************************/
+
+static void bench_generate(uint64_t seed)
+{
+    rng = seed;
+    for (unsigned long i = 0; i < frameCount; i++)
+    {
+        BenchFrame *f = &frames[i];
+        f->cmd = (uint8_t)bench_random();
+        f->seq = (uint8_t)i;
+        f->len = (uint8_t)(bench_random() % (BENCH_MAX_PAYLOAD + 1));
+        for (uint8_t j = 0; j < f->len; j++)
+        {
+            f->payload[j] = (uint8_t)bench_random();
+        }
+    }
+}
+
+static void bench_run(bool cobs, bool drop, double rate, uint64_t seed, BenchResult *result)
+{
+    uint8_t wire[COMM_MAX_WIRE_SIZE];
+    COMM_Parser parser;
+    SofParser sof = {0};
+
+    COMM_ParserReset(&parser);
+    *result = (BenchResult){0};
+    matchNext = 0;
+    rng = seed ^ 0x9E3779B97F4A7C15ULL;
+
+    for (unsigned long i = 0; i < frameCount; i++)
+    {
+        BenchFrame *f = &frames[i];
+        uint8_t n = cobs ? COMM_EncodeFrame(wire, f->cmd, f->seq, f->payload, f->len)
+                         : sof_encode(wire, f);
+        result->bytes += n;
+        f->damaged = bench_corrupt(wire, &n, rate, drop);
+        f->delivered = false;
+        result->damaged += f->damaged;
+
+        for (uint8_t j = 0; j < n; j++)
+        {
+            if (cobs && COMM_ParseByte(&parser, wire[j]) == COMM_PARSE_FRAME)
+            {
+                bench_deliver(i, parser.frame.cmd, parser.frame.seq, parser.frame.len,
+                              parser.frame.payload, result);
+            }
+            else if (!cobs && sof_parse(&sof, wire[j]))
+            {
+                bench_deliver(i, sof.cmd, sof.seq, sof.len, sof.payload, result);
+            }
+        }
+    }
+
+    for (unsigned long i = 0; i < frameCount; i++)
+    {
+        result->collateral += !frames[i].damaged && !frames[i].delivered;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    frameCount = (argc > 1) ? strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_FRAMES;
+    uint64_t seed = (argc > 2) ? strtoull(argv[2], NULL, 10) : BENCH_DEFAULT_SEED;
+    frames = calloc(frameCount ? frameCount : 1, sizeof(BenchFrame));
+    if (!frames)
+    {
+        return 1;
+    }
+    bench_generate(seed);
+
+    printf("%-5s %-8s %-5s %9s %9s %9s %10s %6s %12s\n", "error", "rate", "frame", "bytes",
+           "damaged", "delivered", "collateral", "false", "lost/damaged");
+    for (int drop = 0; drop <= 1; drop++)
+    {
+        for (unsigned i = 0; i < sizeof(rates) / sizeof(rates[0]); i++)
+        {
+            for (int cobs = 0; cobs <= 1; cobs++)
+            {
+                BenchResult r;
+                bench_run(cobs, drop, rates[i], seed, &r);
+                double lost = r.damaged ? (double)(r.damaged + r.collateral) / r.damaged : 0.0;
+                printf("%-5s %-8.0e %-5s %9lu %9lu %9lu %10lu %6lu %12.3f\n",
+                       drop ? "drop" : "flip", rates[i], cobs ? "cobs" : "sof", r.bytes,
+                       r.damaged, r.delivered, r.collateral, r.falseFrames, lost);
+            }
+        }
+    }
+
+    free(frames);
+    return 0;
+}
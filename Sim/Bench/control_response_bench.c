@@ -0,0 +1,378 @@
+/*
+    Worst-case command response of the Control ECU while it is busy with
+    the door and the alarm. The bench plays the HMI against a
+    Sim_Control_ECU it starts on a socketpair. A CMD_HEARTBEAT probe goes
+    out every --probe ms, one at a time, and its round trip is recorded
+    per phase:
+      - idle: nothing else going on
+      - door: right after CMD_VERIFY_AND_UNLOCK, for the whole door cycle
+      - both: wrong passwords right after the unlock, until one sounds the
+        alarm while the door moves
+      - lockout: a password sent during the lockout that follows
+    command_ms is the slowest reply to the commands that start a phase,
+    worst_ms the slowest reply of the phase overall. During the lockout the
+    password must be refused at once with CMD_ALARM. Control sleeps between
+    probes, so each round trip includes its wake-up; asleep_% is the share
+    of the phase it slept (its "power" device command).
+    Times are simulated ms, --speed runs both boards faster.
+
+    Usage: Control_Response_Bench --spawn PROGRAM [options]
+      --probe MS        gap between two probes (default 20)
+      --phase MS        length of the idle and lockout phases (default 4000)
+      --autolock S      auto-lock time set before the door phases (default 5)
+      --speed N         simulated time N times faster (default 1)
+      --budget MS       exit 1 if the p99 of a phase is above MS
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "../../Common/HAL/comm_interface.h"
+#include "../../Common/HAL/comm_request.h"
+#include "../../Common/MCAL/cpu.h"
+#include "../../Control_ECU/Drivers/Motor/motor.h"
+#include "../Board/board_sim.h"
+#include "../MCAL/sim.h"
+
+#define BENCH_DEFAULT_PROBE_MS      20
+#define BENCH_DEFAULT_PHASE_MS      4000
+#define BENCH_DEFAULT_AUTOLOCK      5
+#define BENCH_REPLY_MS              20000   /* long enough to see a blocked Control answer */
+#define BENCH_HANDSHAKE_TIMEOUT_S   10
+#define BENCH_MAX_SAMPLES           4096
+#define BENCH_POWER_TIMEOUT_MS      2000    /* host ms for the "power" event */
+
+static const uint8_t password[COMM_PASSWORD_LENGTH] = { '1', '2', '3', '4', '5' };
+static const uint8_t wrongPassword[COMM_PASSWORD_LENGTH] = { '5', '4', '3', '2', '1' };
+
+static const char *speedArg = "1";
+static uint32_t probeMs = BENCH_DEFAULT_PROBE_MS;
+static pid_t peerPid;
+static int peerDevFd = -1;
+
+typedef struct {
+    const char *name;
+    uint32_t count;
+    uint32_t timeouts;
+    uint32_t us[BENCH_MAX_SAMPLES];
+    uint32_t commandUs;     /* slowest reply to the commands that started the phase */
+    uint32_t asleepMs;      /* Control's time asleep and awake during the phase */
+    uint32_t awakeMs;
+} BenchPhase;
+
+typedef struct {
+    uint32_t asleepMs;
+    uint32_t awakeMs;
+} BenchPower;
+
+/*******************************************************************************
+ *                         Peer                                                *
+ *******************************************************************************/
+
+static int bench_spawn(const char *program)
+{
+    int link[2], dev[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, link) != 0 ||
+        socketpair(AF_UNIX, SOCK_STREAM, 0, dev) != 0)
+    {
+        perror("socketpair");
+        exit(2);
+    }
+    peerPid = fork();
+    if (peerPid < 0)
+    {
+        perror("fork");
+        exit(2);
+    }
+    if (peerPid == 0)
+    {
+        (void)prctl(PR_SET_PDEATHSIG, SIGKILL);
+        dup2(link[1], 3);
+        dup2(dev[1], 4);
+        for (int fd = 5; fd < 64; fd++)
+        {
+            close(fd);
+        }
+        execl(program, program, "--link", "fd:3", "--dev", "fd:4", "--speed", speedArg,
+              (char *)NULL);
+        perror(program);
+        _exit(127);
+    }
+    close(link[1]);
+    close(dev[1]);
+    peerDevFd = dev[0];
+    return link[0];
+}
+
+/* Control's "power" device command; other device events on the way are skipped */
+static bool bench_power(BenchPower *power)
+{
+    static const char cmd[] = "power\n";
+    if (write(peerDevFd, cmd, sizeof(cmd) - 1) != (ssize_t)(sizeof(cmd) - 1))
+    {
+        return false;
+    }
+
+    char line[256];
+    size_t len = 0;
+    struct pollfd pfd = { .fd = peerDevFd, .events = POLLIN };
+    while (poll(&pfd, 1, BENCH_POWER_TIMEOUT_MS) > 0)
+    {
+        char c;
+        if (read(peerDevFd, &c, 1) != 1)
+        {
+            return false;
+        }
+        if (c != '\n')
+        {
+            if (len < sizeof(line) - 1)
+            {
+                line[len++] = c;
+            }
+            continue;
+        }
+        line[len] = '\0';
+        len = 0;
+        unsigned long long ns;
+        unsigned sleeps, asleep, awake;
+        if (sscanf(line, "%llu power sleeps %u asleep %u ms awake %u ms",
+                   &ns, &sleeps, &asleep, &awake) == 4)
+        {
+            power->asleepMs = asleep;
+            power->awakeMs = awake;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Charge the time since *start to phase, *start becomes now */
+static void bench_power_phase(BenchPhase *phase, BenchPower *start)
+{
+    BenchPower now;
+    if (bench_power(&now))
+    {
+        phase->asleepMs += now.asleepMs - start->asleepMs;
+        phase->awakeMs += now.awakeMs - start->awakeMs;
+        *start = now;
+    }
+}
+
+static void bench_handshake_expired(int sig)
+{
+    (void)sig;
+    static const char msg[] = "no handshake from Control\n";
+    (void)!write(STDERR_FILENO, msg, sizeof(msg) - 1);
+    _exit(1);
+}
+
+/*******************************************************************************
+ *                         Measurements                                        *
+ *******************************************************************************/
+
+/* One request, its reply command (0 if none) and round trip in us */
+static uint8_t bench_request(uint8_t cmd, const uint8_t *payload, uint8_t len, uint32_t *us)
+{
+    COMM_Frame reply;
+    uint64_t start = SIM_NowNs();
+    COMM_RequestHandle request = COMM_RequestSend(cmd, payload, len, BENCH_REPLY_MS);
+    if (request == COMM_REQUEST_NONE)
+    {
+        return 0;
+    }
+    COMM_RequestState state = COMM_RequestWait(request, &reply);
+    COMM_RequestRelease(request);
+    *us = (uint32_t)((SIM_NowNs() - start) / 1000);
+    return (state == COMM_REQ_DONE) ? reply.cmd : 0;
+}
+
+static void bench_sleep(uint32_t ms)
+{
+    uint64_t end = SIM_NowNs() + (uint64_t)ms * 1000000ULL;
+    while (SIM_NowNs() < end)
+    {
+        COMM_RequestPoll();
+        CPU_Idle();
+    }
+}
+
+/* Probe Control's response time for ms from now */
+static void bench_probe(BenchPhase *phase, uint32_t ms)
+{
+    uint64_t end = SIM_NowNs() + (uint64_t)ms * 1000000ULL;
+    while (SIM_NowNs() < end)
+    {
+        uint32_t us;
+        if (bench_request(CMD_HEARTBEAT, NULL, 0, &us) != CMD_HEARTBEAT)
+        {
+            phase->timeouts++;
+        }
+        else if (phase->count < BENCH_MAX_SAMPLES)
+        {
+            phase->us[phase->count++] = us;
+        }
+        bench_sleep(probeMs);
+    }
+}
+
+/* A command that starts a phase, its reply time counts for the phase. Returns the reply */
+static uint8_t bench_command(BenchPhase *phase, uint8_t cmd, const uint8_t *payload, uint8_t len)
+{
+    uint32_t us = 0;
+    uint8_t reply = bench_request(cmd, payload, len, &us);
+    phase->commandUs = (us > phase->commandUs) ? us : phase->commandUs;
+    return reply;
+}
+
+static int bench_compare(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Print the phase, return its p99 in us */
+static uint32_t bench_report(BenchPhase *phase)
+{
+    uint32_t totalMs = phase->asleepMs + phase->awakeMs;
+    double asleep = totalMs ? (100.0 * phase->asleepMs) / totalMs : 0.0;
+    if (phase->count == 0)
+    {
+        printf("%-7s %6u %10s %10s %10s %8u %12.1f %10.1f %9.1f\n", phase->name, 0u, "-", "-",
+               "-", phase->timeouts, phase->commandUs / 1000.0, phase->commandUs / 1000.0,
+               asleep);
+        return 0;
+    }
+    qsort(phase->us, phase->count, sizeof(uint32_t), bench_compare);
+    uint32_t maxUs = phase->us[phase->count - 1];
+    uint32_t p99Us = phase->us[(phase->count * 99) / 100];
+    printf("%-7s %6u %10.1f %10.1f %10.1f %8u %12.1f %10.1f %9.1f\n", phase->name,
+           phase->count, phase->us[phase->count / 2] / 1000.0, p99Us / 1000.0,
+           maxUs / 1000.0, phase->timeouts, phase->commandUs / 1000.0,
+           ((maxUs > phase->commandUs) ? maxUs : phase->commandUs) / 1000.0, asleep);
+    return p99Us;
+}
+
+/*******************************************************************************
+ *                         Main                                                *
+ *******************************************************************************/
+
+int main(int argc, char **argv)
+{
+    const char *program = NULL;
+    uint32_t phaseMs = BENCH_DEFAULT_PHASE_MS;
+    uint8_t autolock = BENCH_DEFAULT_AUTOLOCK;
+    uint32_t budgetMs = 0;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const char *opt = argv[i], *val = argv[i + 1];
+        if (strcmp(opt, "--spawn") == 0)         program = val;
+        else if (strcmp(opt, "--probe") == 0)    probeMs = (uint32_t)atoi(val);
+        else if (strcmp(opt, "--phase") == 0)    phaseMs = (uint32_t)atoi(val);
+        else if (strcmp(opt, "--autolock") == 0) autolock = (uint8_t)atoi(val);
+        else if (strcmp(opt, "--speed") == 0)    speedArg = val;
+        else if (strcmp(opt, "--budget") == 0)   budgetMs = (uint32_t)atoi(val);
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", opt);
+            return 2;
+        }
+    }
+    if (program == NULL)
+    {
+        fprintf(stderr, "usage: %s --spawn PROGRAM [--probe MS] [--phase MS] [--autolock S] "
+                        "[--speed N] [--budget MS]\n", argv[0]);
+        return 2;
+    }
+
+    char linkArg[16];
+    snprintf(linkArg, sizeof(linkArg), "fd:%d", bench_spawn(program));
+    char *boardArgv[] = { argv[0], "--link", linkArg, "--dev", "none",
+                          "--speed", (char *)speedArg, NULL };
+    BOARD_SIM_Init("bench", 7, boardArgv, NULL);
+
+    COMM_Init();
+    CPU_EnableInterrupts();
+    signal(SIGALRM, bench_handshake_expired);
+    alarm(BENCH_HANDSHAKE_TIMEOUT_S);
+    uint8_t status;
+    (void)COMM_HandshakeRespond(&status);
+    alarm(0);
+    COMM_RequestInit();
+
+    uint32_t us;
+    uint8_t setup[COMM_VERIFY_AND_SET_TIMEOUT_LEN];
+    memcpy(setup, password, COMM_PASSWORD_LENGTH);
+    setup[COMM_PASSWORD_LENGTH] = autolock;
+    if ((status == CMD_INIT &&
+         bench_request(CMD_CHANGE_PASSWORD, password, COMM_PASSWORD_LENGTH, &us) != CMD_ACK) ||
+        bench_request(CMD_VERIFY_AND_SET_TIMEOUT, setup, sizeof(setup), &us) != CMD_SUCCESS)
+    {
+        fprintf(stderr, "could not set the board up\n");
+        return 1;
+    }
+    /* Door cycle: both moves and the auto-lock time, with some slack */
+    uint32_t doorMs = 2 * MOTOR_MOVE_MS + autolock * 1000u + 500;
+
+    static BenchPhase phases[4] = { { .name = "idle" }, { .name = "door" },
+                                    { .name = "both" }, { .name = "lockout" } };
+    BenchPower power = { 0, 0 };
+    (void)bench_power(&power);
+    bench_probe(&phases[0], phaseMs);
+    bench_power_phase(&phases[0], &power);
+
+    bench_command(&phases[1], CMD_VERIFY_AND_UNLOCK, password, COMM_PASSWORD_LENGTH);
+    bench_probe(&phases[1], doorMs);
+    bench_power_phase(&phases[1], &power);
+
+    /* The unlock cleared the attempts: MAX_ATTEMPTS wrong ones, then the alarm */
+    bench_command(&phases[2], CMD_VERIFY_AND_UNLOCK, password, COMM_PASSWORD_LENGTH);
+    uint8_t reply = 0;
+    for (int i = 0; i < 8 && reply != CMD_ALARM; i++)
+    {
+        reply = bench_command(&phases[2], CMD_SEND_PASSWORD, wrongPassword,
+                              sizeof(wrongPassword));
+    }
+    if (reply != CMD_ALARM)
+    {
+        fprintf(stderr, "no lockout after wrong passwords\n");
+        return 1;
+    }
+    bench_probe(&phases[2], doorMs);
+    bench_power_phase(&phases[2], &power);
+
+    if (bench_command(&phases[3], CMD_SEND_PASSWORD, password, COMM_PASSWORD_LENGTH) != CMD_ALARM)
+    {
+        fprintf(stderr, "password accepted during the lockout\n");
+        return 1;
+    }
+    bench_probe(&phases[3], phaseMs);
+    bench_power_phase(&phases[3], &power);
+
+    printf("probe every %u ms, door cycle %u ms\n", probeMs, doorMs);
+    printf("%-7s %6s %10s %10s %10s %8s %12s %10s %9s\n", "phase", "probes", "p50_ms",
+           "p99_ms", "max_ms", "timeouts", "command_ms", "worst_ms", "asleep_%");
+    int result = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        uint32_t p99Us = bench_report(&phases[i]);
+        if (budgetMs && (p99Us > budgetMs * 1000u || phases[i].timeouts))
+        {
+            result = 1;
+        }
+    }
+    if (result)
+    {
+        printf("over the %u ms budget\n", budgetMs);
+    }
+
+    kill(peerPid, SIGKILL);
+    waitpid(peerPid, NULL, 0);
+    return result;
+}
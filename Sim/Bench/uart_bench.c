@@ -0,0 +1,107 @@
+/*
+    Host benchmark for the interrupt-driven UART driver.
+    Pushes a large block through the simulated UART2 in loopback and reports
+    how fast the driver moves bytes and what each UART2_Handler call costs.
+    The line itself is not paced, so the numbers are pure driver overhead.
+    A second pass compares a bulk push through the TX ring with the same push
+    handed to the uDMA (UART_SendBufferAsync).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../../Common/MCAL/uart.h"
+#include "../MCAL/uart_sim.h"
+#include "../MCAL/sim.h"
+
+#define BENCH_BLOCK_SIZE    200
+#define BENCH_DEFAULT_BYTES (4UL * 1024UL * 1024UL)
+#define BENCH_BULK_SIZE     4096
+#define BENCH_BULK_ROUNDS   256
+
+static uint8_t bulk[BENCH_BULK_SIZE];
+static uint8_t sink[BENCH_BULK_SIZE];
+
+/* Push BENCH_BULK_ROUNDS x 4 KB out of the TX pin and report the CPU cost */
+static void bench_bulk(const char *label, int useDma)
+{
+    UART_SIM_Stats stats;
+
+    UART_SIM_Reset();
+    UART_Init();
+
+    uint64_t start = SIM_NowNs();
+    for (int round = 0; round < BENCH_BULK_ROUNDS; round++)
+    {
+        if (useDma)
+        {
+            UART_SendBufferAsync(bulk, BENCH_BULK_SIZE, NULL);
+        }
+        else
+        {
+            UART_SendBuffer(bulk, BENCH_BULK_SIZE);
+        }
+        UART_Flush();
+        UART_SIM_Service();
+        (void)UART_SIM_Drain(sink, BENCH_BULK_SIZE);
+    }
+    uint64_t elapsed = SIM_NowNs() - start;
+
+    UART_SIM_GetStats(&stats);
+    printf("%-16s : %lu bytes, %lu isr calls, %.1f bytes/isr, %.2f ms total, %.2f ms in isr\n",
+           label, (unsigned long)stats.bytesOut, (unsigned long)stats.isrCalls,
+           (double)stats.bytesOut / stats.isrCalls,
+           (double)elapsed / 1e6, (double)stats.isrNs / 1e6);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long total = (argc > 1) ? strtoul(argv[1], NULL, 0) : BENCH_DEFAULT_BYTES;
+    uint8_t block[BENCH_BLOCK_SIZE];
+    unsigned long errors = 0;
+
+    for (int i = 0; i < BENCH_BLOCK_SIZE; i++)
+    {
+        block[i] = (uint8_t)(i * 13 + 1);
+    }
+
+    UART_SIM_Reset();
+    UART_SIM_SetLoopback(true);
+    UART_Init();
+
+    uint64_t start = SIM_NowNs();
+    for (unsigned long sent = 0; sent < total; sent += BENCH_BLOCK_SIZE)
+    {
+        UART_SendBuffer(block, BENCH_BLOCK_SIZE);
+        for (int i = 0; i < BENCH_BLOCK_SIZE; i++)
+        {
+            if (UART_ReceiveByte() != block[i])
+            {
+                errors++;
+            }
+        }
+    }
+    uint64_t elapsed = SIM_NowNs() - start;
+
+    UART_SIM_Stats stats;
+    UART_SIM_GetStats(&stats);
+
+    double seconds = (double)elapsed / 1e9;
+    printf("bytes            : %lu\n", (unsigned long)stats.bytesIn);
+    printf("errors           : %lu\n", errors);
+    printf("throughput       : %.2f MB/s\n", (double)stats.bytesIn / seconds / 1e6);
+    printf("isr calls        : %lu (rx %lu, rt %lu, tx %lu)\n",
+           (unsigned long)stats.isrCalls, (unsigned long)stats.rxInterrupts,
+           (unsigned long)stats.rtInterrupts, (unsigned long)stats.txInterrupts);
+    printf("bytes per isr    : %.2f\n", (double)(stats.bytesIn + stats.bytesOut) / stats.isrCalls);
+    printf("ns per isr       : %.1f\n", (double)stats.isrNs / stats.isrCalls);
+
+    for (int i = 0; i < BENCH_BULK_SIZE; i++)
+    {
+        bulk[i] = (uint8_t)i;
+    }
+    printf("\n");
+    bench_bulk("bulk via ring", 0);
+    bench_bulk("bulk via uDMA", 1);
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,378 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "board_sim.h"
+#include "../MCAL/sim.h"
+#include "../MCAL/uart_sim.h"
+#include "../../Common/HAL/comm_interface.h"
+
+#define BOARD_LINE_SIZE         256
+#define BOARD_IO_CHUNK          256
+#define BOARD_IDLE_SLEEP_NS     200000L     /* host time slept while nothing moves */
+
+static const char *boardName;
+static int boardArgc;
+static char **boardArgv;
+static uint32_t speed = 1;
+
+static int linkFd = -1;
+static uint32_t linkBaud;               /* rate the link tty is set to, 0 if not a tty */
+static double lossPct;                  /* frames arriving on the link that are corrupted */
+static unsigned int lossSeed;
+static bool lossAtStart = true;         /* next link byte starts a frame */
+static int devInFd = STDIN_FILENO;
+static int devOutFd = STDOUT_FILENO;
+
+static BOARD_SIM_CommandHandler commandHandler;
+static BOARD_SIM_Poll polls[BOARD_SIM_MAX_POLLS];
+static uint8_t pollCount;
+
+static char line[BOARD_LINE_SIZE];
+static uint16_t lineLen;
+
+/*******************************************************************************
+ *                         Private Functions                                   *
+ *******************************************************************************/
+
+static int BOARD_SIM_ParseFd(const char *spec)
+{
+    return (strncmp(spec, "fd:", 3) == 0) ? atoi(spec + 3) : -1;
+}
+
+static void BOARD_SIM_SetRaw(int fd)
+{
+    struct termios tio;
+    if (isatty(fd) && tcgetattr(fd, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        (void)tcsetattr(fd, TCSANOW, &tio);
+    }
+}
+
+static speed_t BOARD_SIM_TtySpeed(uint32_t baud)
+{
+    switch (baud)
+    {
+        case 9600:    return B9600;
+        case 19200:   return B19200;
+        case 38400:   return B38400;
+        case 57600:   return B57600;
+        case 115200:  return B115200;
+        case 230400:  return B230400;
+        case 460800:  return B460800;
+        case 921600:  return B921600;
+        case 1000000: return B1000000;
+        default:      return B0;
+    }
+}
+
+/* A real serial port has to follow the rate the firmware programs into UART2 */
+static void BOARD_SIM_FollowBaud(void)
+{
+    struct termios tio;
+    uint32_t baud = UART_SIM_GetBaudRate();
+    speed_t ttySpeed = BOARD_SIM_TtySpeed(baud);
+
+    if (linkBaud == 0 || baud == linkBaud || ttySpeed == B0 || tcgetattr(linkFd, &tio) != 0)
+    {
+        return;
+    }
+    /* Let the bytes sent at the old rate leave first */
+    (void)tcdrain(linkFd);
+    cfsetispeed(&tio, ttySpeed);
+    cfsetospeed(&tio, ttySpeed);
+    (void)tcsetattr(linkFd, TCSANOW, &tio);
+    linkBaud = baud;
+}
+
+static int BOARD_SIM_OpenLink(const char *spec)
+{
+    int fd = BOARD_SIM_ParseFd(spec);
+    if (fd >= 0)
+    {
+        return fd;
+    }
+
+    if (strcmp(spec, "pty") == 0)
+    {
+        fd = posix_openpt(O_RDWR | O_NOCTTY);
+        if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0)
+        {
+            perror("posix_openpt");
+            exit(1);
+        }
+        /* Hold the slave open so reads do not fail with EIO until a peer attaches */
+        const char *slave = ptsname(fd);
+        BOARD_SIM_SetRaw(open(slave, O_RDWR | O_NOCTTY));
+        BOARD_SIM_Event("link", "pty %s", slave);
+        return fd;
+    }
+
+    fd = open(spec, O_RDWR | O_NOCTTY);
+    if (fd < 0)
+    {
+        perror(spec);
+        exit(1);
+    }
+    BOARD_SIM_SetRaw(fd);
+    if (isatty(fd))
+    {
+        linkBaud = 1;   /* not a rate, forces the first BOARD_SIM_FollowBaud */
+    }
+    return fd;
+}
+
+static bool BOARD_SIM_Readable(int fd)
+{
+    struct pollfd p = { .fd = fd, .events = POLLIN };
+    return poll(&p, 1, 0) > 0 && (p.revents & (POLLIN | POLLHUP));
+}
+
+/*
+ * Flip one bit in lossPct percent of the frames coming off the wire, the
+ * receiver's CRC then rejects them. Frames are told apart by the COBS
+ * delimiter, the flipped bit never turns a byte into one.
+ */
+static void BOARD_SIM_Loss(uint8_t *data, ssize_t n)
+{
+    for (ssize_t i = 0; i < n; i++)
+    {
+        if (data[i] == COMM_DELIMITER)
+        {
+            lossAtStart = true;
+            continue;
+        }
+        if (lossAtStart && rand_r(&lossSeed) < lossPct / 100.0 * ((double)RAND_MAX + 1.0))
+        {
+            data[i] ^= (data[i] == 0x01) ? 0x02 : 0x01;
+        }
+        lossAtStart = false;
+    }
+}
+
+/* TX pin -> wire, wire -> RX pin */
+static bool BOARD_SIM_PumpLink(void)
+{
+    uint8_t buf[BOARD_IO_CHUNK];
+    uint16_t n = UART_SIM_Drain(buf, sizeof(buf));
+    bool moved = (n > 0);
+
+    if (linkFd < 0)
+    {
+        return moved;
+    }
+
+    BOARD_SIM_FollowBaud();
+    for (uint16_t done = 0; done < n; )
+    {
+        ssize_t w = write(linkFd, &buf[done], n - done);
+        if (w <= 0)
+        {
+            break;
+        }
+        done += (uint16_t)w;
+    }
+
+    if (BOARD_SIM_Readable(linkFd))
+    {
+        ssize_t r = read(linkFd, buf, sizeof(buf));
+        if (r > 0)
+        {
+            BOARD_SIM_Loss(buf, r);
+            UART_SIM_Inject(buf, (uint16_t)r);
+            moved = true;
+        }
+        else
+        {
+            BOARD_SIM_Event("link", "down");
+            close(linkFd);
+            linkFd = -1;
+        }
+    }
+    return moved;
+}
+
+static void BOARD_SIM_Dispatch(char *text)
+{
+    char *arg = strchr(text, ' ');
+    if (arg)
+    {
+        *arg++ = '\0';
+    }
+    else
+    {
+        arg = "";
+    }
+
+    if (text[0] == '\0')
+    {
+        return;
+    }
+    if (strcmp(text, "quit") == 0)
+    {
+        exit(0);
+    }
+    if (!commandHandler || !commandHandler(text, arg))
+    {
+        BOARD_SIM_Event("board", "unknown command %s", text);
+    }
+}
+
+static bool BOARD_SIM_PumpDevices(void)
+{
+    if (devInFd < 0 || !BOARD_SIM_Readable(devInFd))
+    {
+        return false;
+    }
+
+    char buf[BOARD_IO_CHUNK];
+    ssize_t r = read(devInFd, buf, sizeof(buf));
+    if (r <= 0)
+    {
+        exit(0);    /* whoever drives the devices went away */
+    }
+
+    for (ssize_t i = 0; i < r; i++)
+    {
+        if (buf[i] == '\n' || lineLen == BOARD_LINE_SIZE - 1)
+        {
+            line[lineLen] = '\0';
+            lineLen = 0;
+            BOARD_SIM_Dispatch(line);
+        }
+        else if (buf[i] != '\r')
+        {
+            line[lineLen++] = buf[i];
+        }
+    }
+    return true;
+}
+
+/* Installed as the SIM idle hook: runs whenever the firmware waits */
+static void BOARD_SIM_Service(void)
+{
+    bool moved = BOARD_SIM_PumpLink();
+    moved |= BOARD_SIM_PumpDevices();
+
+    for (uint8_t i = 0; i < pollCount; i++)
+    {
+        polls[i]();
+    }
+
+    /* Nothing in flight: give the host CPU back until the wire or a command wakes us */
+    if (!moved && UART_SIM_LineIdle())
+    {
+        struct pollfd p[2] = {
+            { .fd = devInFd, .events = POLLIN },
+            { .fd = linkFd, .events = POLLIN },
+        };
+        struct timespec timeout = { 0, BOARD_IDLE_SLEEP_NS / speed };
+        (void)ppoll(p, 2, &timeout, NULL);   /* negative fds are skipped */
+    }
+}
+
+/*******************************************************************************
+ *                         Functions Definitions                               *
+ *******************************************************************************/
+
+const char *BOARD_SIM_GetOption(const char *option)
+{
+    for (int i = 1; i + 1 < boardArgc; i++)
+    {
+        if (strcmp(boardArgv[i], option) == 0)
+        {
+            return boardArgv[i + 1];
+        }
+    }
+    return NULL;
+}
+
+void BOARD_SIM_Init(const char *name, int argc, char **argv, BOARD_SIM_CommandHandler handler)
+{
+    const char *option;
+
+    boardName = name;
+    boardArgc = argc;
+    boardArgv = argv;
+    commandHandler = handler;
+
+    if ((option = BOARD_SIM_GetOption("--speed")) != NULL && atoi(option) > 0)
+    {
+        speed = (uint32_t)atoi(option);
+    }
+    SIM_SetSpeed(speed);
+
+    if ((option = BOARD_SIM_GetOption("--loss")) != NULL)
+    {
+        lossPct = atof(option);
+    }
+    /* Each board draws its own losses, reproducibly */
+    for (const char *c = name; *c; c++)
+    {
+        lossSeed = lossSeed * 31u + (unsigned char)*c;
+    }
+
+    if ((option = BOARD_SIM_GetOption("--dev")) != NULL)
+    {
+        /* "none" (or anything but fd:N) leaves the board without devices */
+        devInFd = devOutFd = BOARD_SIM_ParseFd(option);
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    UART_SIM_Reset();
+    UART_SIM_SetPacing(true);
+    if ((option = BOARD_SIM_GetOption("--link")) != NULL)
+    {
+        linkFd = BOARD_SIM_OpenLink(option);
+    }
+
+    SIM_SetIdleHook(BOARD_SIM_Service);
+    BOARD_SIM_Event("board", "%s up", boardName);
+}
+
+void BOARD_SIM_AddPoll(BOARD_SIM_Poll poll)
+{
+    if (pollCount < BOARD_SIM_MAX_POLLS)
+    {
+        polls[pollCount++] = poll;
+    }
+}
+
+void BOARD_SIM_Event(const char *device, const char *fmt, ...)
+{
+    char text[BOARD_LINE_SIZE];
+    char out[BOARD_LINE_SIZE + 64];
+    va_list args;
+
+    va_start(args, fmt);
+    vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
+
+    /* One write per event so lines from a pipe are never interleaved */
+    int n = snprintf(out, sizeof(out), "%llu %s %s\n",
+                     (unsigned long long)SIM_NowNs(), device, text);
+    if (n > (int)sizeof(out))
+    {
+        n = sizeof(out);
+    }
+    if (devOutFd >= 0)
+    {
+        (void)!write(devOutFd, out, (size_t)n);
+    }
+}
+
+void BOARD_SIM_Reset(void)
+{
+    BOARD_SIM_Event("board", "%s reset", boardName);
+    execv("/proc/self/exe", boardArgv);
+    perror("board reset");
+    exit(1);
+}
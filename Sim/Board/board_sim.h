@@ -0,0 +1,56 @@
+#ifndef BOARD_SIM_H_
+#define BOARD_SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ *                         Simulated Board (one ECU process)                   *
+ *******************************************************************************/
+
+/*
+ * Runs one ECU's unmodified firmware as a Linux process. The firmware's main
+ * is compiled as HMI_main / Control_main and called from the board's main
+ * after BOARD_SIM_Init.
+ *
+ * UART2 is bridged to a file descriptor (socketpair end, pty or serial device)
+ * and the virtual devices (keypad, LCD, motor, ...) talk over a line-based
+ * device channel:
+ *   in : "<command> [argument]"          e.g. "key 12345", "pot 40"
+ *   out: "<sim ns> <device> <text>"      e.g. "1234567 lcd Enter Password|"
+ *
+ * Options:
+ *   --link fd:N | pty | PATH   UART2 wire (default: none, TX is discarded);
+ *                              a serial port follows the rate programmed into UART2
+ *   --dev fd:N | none          device channel (default: stdin / stdout)
+ *   --speed N                  run simulated time N times faster
+ *   --loss PCT                 corrupt PCT percent of the frames arriving on the link
+ * Anything else is left for the board (see BOARD_SIM_GetOption).
+ */
+
+/* Device command from the channel; return false if cmd is not known */
+typedef bool (*BOARD_SIM_CommandHandler)(const char *cmd, const char *arg);
+
+/* Periodic device work, run from every SIM_Idle */
+typedef void (*BOARD_SIM_Poll)(void);
+
+#define BOARD_SIM_MAX_POLLS     8
+
+void BOARD_SIM_Init(const char *name, int argc, char **argv, BOARD_SIM_CommandHandler handler);
+
+/* Value following option on the command line, NULL if absent */
+const char *BOARD_SIM_GetOption(const char *option);
+
+void BOARD_SIM_AddPoll(BOARD_SIM_Poll poll);
+
+/* Report a device event on the channel, stamped with SIM_NowNs */
+void BOARD_SIM_Event(const char *device, const char *fmt, ...);
+
+/*
+ * The reset line: run the board's program again from main, same process and
+ * command line. The link and device channel survive when they are fd:N
+ * (the wire and the bench stay connected), all memory is lost.
+ */
+void BOARD_SIM_Reset(void);
+
+#endif /* BOARD_SIM_H_ */
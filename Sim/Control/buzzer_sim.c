@@ -0,0 +1,31 @@
+#include "../../Control_ECU/Drivers/Buzzer/buzzer.h"
+#include "../../Common/Utils/swtimer.h"
+#include "../Board/board_sim.h"
+
+/* buzzer.c beeps 600/700/850 ms, each followed by 300 ms of silence */
+#define BUZZER_PATTERN_MS   (600 + 300 + 700 + 300 + 850 + 300)
+
+static void BUZZER_SIM_End(void *arg);
+
+static volatile uint8_t buzzer_is_working;
+static SWTIMER_Timer silentTimer = SWTIMER_TIMER(BUZZER_SIM_End, 0);
+
+void Buzzer_Start(void)
+{
+    buzzer_is_working = 1;
+    SWTIMER_Start(&silentTimer, BUZZER_PATTERN_MS, 0);
+    BOARD_SIM_Event("buzzer", "on");
+}
+
+uint8_t buzzer_State(void)
+{
+    return buzzer_is_working;
+}
+
+/* The whole pattern as one timer, the board runs one per beep and pause */
+static void BUZZER_SIM_End(void *arg)
+{
+    (void)arg;
+    buzzer_is_working = 0;
+    BOARD_SIM_Event("buzzer", "off");
+}
@@ -0,0 +1,102 @@
+/*
+    Control ECU on the host. Control_ECU/ECU_COMM.c is built with main renamed
+    to Control_main; this main sets up the simulated board and then runs it.
+
+    Extra option:
+      --eeprom PATH       keep the EEPROM (password, auto-lock time) in a file;
+                          without it the EEPROM is blank at every start of the
+                          program, but survives the warm reset below
+    Control has no input devices, it only reports motor, buzzer and LED events.
+
+    Device commands:
+      power               report time asleep and awake since boot
+      boot                report the boot marks of both ECUs (ms after reset),
+                          the HMI's as it sent them in CMD_BOOT
+      reset               warm reset (ResetTiva): the program starts over and
+                          carries on with the state it kept, link included
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "../Board/board_sim.h"
+#include "../../Common/MCAL/power.h"
+#include "../../Common/Utils/boot_profile.h"
+#include "control_sim.h"
+
+int Control_main(void);
+void RequestWarmReset(void);
+
+static bool CONTROL_SIM_Command(const char *cmd, const char *arg)
+{
+    (void)arg;
+    if (strcmp(cmd, "power") == 0)
+    {
+        POWER_Stats stats;
+        POWER_GetStats(&stats);
+        BOARD_SIM_Event("power", "sleeps %u asleep %u ms awake %u ms",
+                        stats.sleeps, stats.asleepMs, stats.awakeMs);
+        return true;
+    }
+    if (strcmp(cmd, "boot") == 0)
+    {
+        BOOT_Profile profile;
+        char text[160];
+        BOOT_Get(&profile);
+        BOOT_Format(&profile, text, sizeof(text));
+        BOARD_SIM_Event("boot", "control %s", text);
+        if (BOOT_GetPeer(&profile))
+        {
+            BOOT_Format(&profile, text, sizeof(text));
+            BOARD_SIM_Event("boot", "hmi %s", text);
+        }
+        return true;
+    }
+    if (strcmp(cmd, "reset") == 0)
+    {
+        RequestWarmReset();
+        return true;
+    }
+    return false;
+}
+
+/*
+ * The EEPROM is non-volatile, BOARD_SIM_Reset must not lose it: back it with
+ * an anonymous file that the reset inherits, found again through the
+ * environment. A fresh start of the program gets a new one, blank.
+ */
+static const char *CONTROL_SIM_ResetSafeEeprom(void)
+{
+    static char path[32];
+    const char *inherited = getenv("SIM_EEPROM");
+    if (inherited)
+    {
+        return inherited;
+    }
+    int fd = memfd_create("eeprom", 0);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+    snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+    setenv("SIM_EEPROM", path, 1);
+    return path;
+}
+
+int main(int argc, char **argv)
+{
+    BOARD_SIM_Init("control", argc, argv, CONTROL_SIM_Command);
+    const char *eeprom = BOARD_SIM_GetOption("--eeprom");
+    if (!eeprom)
+    {
+        eeprom = CONTROL_SIM_ResetSafeEeprom();
+    }
+    if (eeprom)
+    {
+        EEPROM_SIM_Attach(eeprom);
+    }
+    return Control_main();
+}
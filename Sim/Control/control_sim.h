@@ -0,0 +1,18 @@
+#ifndef CONTROL_SIM_H_
+#define CONTROL_SIM_H_
+
+/*******************************************************************************
+ *                         Control Board Devices                               *
+ *******************************************************************************/
+
+/*
+ * motor.c, buzzer.c and the DelayMs helper program GPIO and registers directly,
+ * so they are replaced at their API (the motor and buzzer on software timers,
+ * like the board); the EEPROM keeps eeprom.c and swaps the
+ * eeprom_hw.h layer. All of them report what the hardware would do as events.
+ */
+
+/* Keep the EEPROM contents in a file, loaded now and rewritten on every write */
+void EEPROM_SIM_Attach(const char *path);
+
+#endif /* CONTROL_SIM_H_ */
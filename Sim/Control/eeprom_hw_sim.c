@@ -0,0 +1,58 @@
+#include <stdio.h>
+#include "../../Control_ECU/Drivers/Eeprom/eeprom_hw.h"
+#include "control_sim.h"
+
+/* TM4C123 EEPROM: 32 blocks of 16 words */
+#define SIM_EEPROM_BLOCKS   32
+#define SIM_EEPROM_WORDS    16
+
+static uint32_t words[SIM_EEPROM_BLOCKS][SIM_EEPROM_WORDS];
+static const char *backingPath;
+
+static void EEPROM_SIM_Save(void)
+{
+    FILE *file = backingPath ? fopen(backingPath, "wb") : NULL;
+    if (file)
+    {
+        (void)fwrite(words, sizeof(words), 1, file);
+        fclose(file);
+    }
+}
+
+void EEPROM_SIM_Attach(const char *path)
+{
+    backingPath = path;
+    FILE *file = fopen(path, "rb");
+    if (file)
+    {
+        (void)!fread(words, sizeof(words), 1, file);
+        fclose(file);
+    }
+}
+
+void EEPROM_HW_Init(void) {}
+
+uint32_t EEPROM_HW_ReadWord(uint32_t block, uint32_t offset)
+{
+    if (block >= SIM_EEPROM_BLOCKS || offset >= SIM_EEPROM_WORDS)
+    {
+        return 0;
+    }
+    return words[block][offset];
+}
+
+bool EEPROM_HW_WriteWord(uint32_t block, uint32_t offset, uint32_t value)
+{
+    if (block >= SIM_EEPROM_BLOCKS || offset >= SIM_EEPROM_WORDS)
+    {
+        return false;
+    }
+    words[block][offset] = value;
+    EEPROM_SIM_Save();
+    return true;
+}
+
+uint32_t EEPROM_HW_GetStatus(void)
+{
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include "../../Control_ECU/Drivers/Motor/motor.h"
+#include "../../Common/Utils/swtimer.h"
+#include "../Board/board_sim.h"
+
+static void MOTOR_SIM_Lock(void *arg);
+
+static volatile uint8_t Door_State;    /* 0 = closed, 1 = open */
+static SWTIMER_Timer lockTimer = SWTIMER_TIMER(MOTOR_SIM_Lock, 0);
+
+uint8_t motor_state(void)
+{
+    return Door_State;
+}
+
+void init_LEDs(void)
+{
+}
+
+/* Same effect as the board: all of PF1-PF3 off, then the given one on */
+void toggle_LED(uint8_t led_pin)
+{
+    BOARD_SIM_Event("led", "%s", (led_pin & (1 << 1)) ? "red" :
+                                 (led_pin & (1 << 2)) ? "blue" :
+                                 (led_pin & (1 << 3)) ? "green" : "off");
+}
+
+/* Opens, stays open, closes: the three software timer phases of motor.c in one */
+void start_Motor(int auto_lockoutSeconds)
+{
+    Door_State = 1;
+    SWTIMER_Start(&lockTimer, 2 * MOTOR_MOVE_MS + (uint32_t)auto_lockoutSeconds * 1000u, 0);
+    BOARD_SIM_Event("motor", "unlock %d", auto_lockoutSeconds);
+}
+
+/* Only the closing phase, the door stood open when the board reset */
+void lock_Motor(void)
+{
+    Door_State = 1;
+    SWTIMER_Start(&lockTimer, MOTOR_MOVE_MS, 0);
+    BOARD_SIM_Event("motor", "close");
+}
+
+/* The end of the closing phase on the board */
+static void MOTOR_SIM_Lock(void *arg)
+{
+    (void)arg;
+    Door_State = 0;
+    BOARD_SIM_Event("motor", "lock");
+}
@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../../Control_ECU/Helpers/reset_hw.h"
+#include "../Board/board_sim.h"
+
+/*
+ * A reset on the host runs the program again (BOARD_SIM_Reset), which loses
+ * all memory. The no-init region goes across in the environment as hex, the
+ * variable being there says the reset was a software one.
+ */
+
+#define SIM_NOINIT_ENV  "SIM_NOINIT"
+
+static uint32_t region[RESET_HW_REGION_SIZE / sizeof(uint32_t)];
+static bool loaded, software;
+
+static void RESET_SIM_Load(void)
+{
+    if (loaded)
+    {
+        return;
+    }
+    loaded = true;
+    const char *hex = getenv(SIM_NOINIT_ENV);
+    if (!hex)
+    {
+        return;
+    }
+    uint8_t *bytes = (uint8_t *)region;
+    for (uint32_t i = 0; i < RESET_HW_REGION_SIZE && hex[0] && hex[1]; i++, hex += 2)
+    {
+        unsigned int value;
+        if (sscanf(hex, "%2x", &value) != 1)
+        {
+            break;
+        }
+        bytes[i] = (uint8_t)value;
+    }
+    software = true;
+    unsetenv(SIM_NOINIT_ENV);   /* a later reset is cold unless saved again */
+}
+
+uint8_t *RESET_HW_Region(void)
+{
+    RESET_SIM_Load();
+    return (uint8_t *)region;
+}
+
+bool RESET_HW_WasSoftware(void)
+{
+    RESET_SIM_Load();
+    bool was = software;
+    software = false;
+    return was;
+}
+
+void RESET_HW_Reset(void)
+{
+    static char hex[2 * RESET_HW_REGION_SIZE + 1];
+    const uint8_t *bytes = (const uint8_t *)region;
+    for (uint32_t i = 0; i < RESET_HW_REGION_SIZE; i++)
+    {
+        snprintf(&hex[2 * i], 3, "%02x", bytes[i]);
+    }
+    setenv(SIM_NOINIT_ENV, hex, 1);
+    BOARD_SIM_Reset();
+}
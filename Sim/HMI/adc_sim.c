@@ -0,0 +1,24 @@
+#include "../../HMI_ECU/MCAL/adc/adc.h"
+#include "hmi_sim.h"
+
+static uint16_t potRaw;
+
+void ADC_Init(uint8_t channel)
+{
+    (void)channel;
+}
+
+uint16_t ADC_Read(void)
+{
+    return potRaw;
+}
+
+uint32_t ADC_ToMillivolts(uint16_t adcValue)
+{
+    return (adcValue * 3300UL) / 4095UL;
+}
+
+void ADC_SIM_SetRaw(uint16_t raw)
+{
+    potRaw = (raw > ADC_MAX_VALUE) ? ADC_MAX_VALUE : raw;
+}
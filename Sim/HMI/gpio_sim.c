@@ -0,0 +1,250 @@
+#include <stdio.h>
+#include <string.h>
+#include "../../HMI_ECU/MCAL/gpio/gpio.h"
+#include "../../HMI_ECU/HAL/keypad/keypad.h"
+#include "../Board/board_sim.h"
+#include "../MCAL/sim.h"
+#include "hmi_sim.h"
+
+#define SIM_PORTS               6
+#define SIM_KEY_QUEUE           64
+#define SIM_KEY_HOLD_MS         250     /* the timeout screen polls every 200 ms */
+#define SIM_KEY_GAP_MS          400     /* longer than the HMI's 300 ms debounce */
+
+/* Board wiring */
+#define KEYPAD_ROW_PORT         PORTA_ID
+#define KEYPAD_ROW_FIRST_PIN    PIN2_ID
+#define KEYPAD_COL_PORT         PORTC_ID
+#define KEYPAD_COL_FIRST_PIN    PIN4_ID
+#define LED_PORT                PORTF_ID
+#define LED_RED_MASK            (1U << PIN1_ID)
+#define LED_BLUE_MASK           (1U << PIN2_ID)
+#define LED_GREEN_MASK          (1U << PIN3_ID)
+
+static uint8_t latch[SIM_PORTS];        /* output data register */
+static uint8_t pullUp[SIM_PORTS];
+static uint8_t intMask[SIM_PORTS];      /* GPIOIM */
+static uint8_t intRising[SIM_PORTS];    /* GPIOIEV */
+static uint8_t intStatus[SIM_PORTS];    /* GPIORIS */
+static uint8_t lastLevel[SIM_PORTS];    /* input levels at the last edge check */
+
+static char keyQueue[SIM_KEY_QUEUE];
+static uint8_t keyHead, keyCount;
+static char pressedKey;                 /* 0 while no key is down */
+static uint8_t pressedRow, pressedCol;
+static uint64_t releaseNs, nextPressNs;
+static uint64_t holdNs = SIM_KEY_HOLD_MS * 1000000ULL;
+static uint64_t gapNs = SIM_KEY_GAP_MS * 1000000ULL;
+
+static uint8_t shownLeds = 0xFF;
+
+/*******************************************************************************
+ *                         Keypad Matrix                                       *
+ *******************************************************************************/
+
+static void GPIO_SIM_UpdateKeypad(void)
+{
+    uint64_t now = SIM_NowNs();
+
+    if (pressedKey && now >= releaseNs)
+    {
+        pressedKey = 0;
+    }
+    if (pressedKey || keyCount == 0 || now < nextPressNs)
+    {
+        return;
+    }
+
+    char key = keyQueue[keyHead];
+    keyHead = (keyHead + 1) % SIM_KEY_QUEUE;
+    keyCount--;
+
+    for (uint8_t row = 0; row < KEYPAD_ROWS; row++)
+    {
+        for (uint8_t col = 0; col < KEYPAD_COLS; col++)
+        {
+            if (keypad_codes[row][col] == key)
+            {
+                pressedKey = key;
+                pressedRow = row;
+                pressedCol = col;
+            }
+        }
+    }
+    releaseNs = now + holdNs;
+    nextPressNs = releaseNs + gapNs;
+    BOARD_SIM_Event("keypad", "%c", key);
+}
+
+/* A row reads low while the pressed key connects it to a column driven low */
+static uint8_t GPIO_SIM_KeypadRow(uint8_t pin)
+{
+    GPIO_SIM_UpdateKeypad();
+    if (pressedKey && pin == KEYPAD_ROW_FIRST_PIN + pressedRow &&
+        !(latch[KEYPAD_COL_PORT] & (1U << (KEYPAD_COL_FIRST_PIN + pressedCol))))
+    {
+        return LOW;
+    }
+    return (pullUp[KEYPAD_ROW_PORT] >> pin) & 1U;
+}
+
+void GPIO_SIM_PressKeys(const char *keys)
+{
+    for (; *keys && keyCount < SIM_KEY_QUEUE; keys++)
+    {
+        if (*keys != ' ')
+        {
+            keyQueue[(keyHead + keyCount) % SIM_KEY_QUEUE] = *keys;
+            keyCount++;
+        }
+    }
+}
+
+void GPIO_SIM_SetKeyTiming(uint32_t holdMs, uint32_t gapMs)
+{
+    holdNs = holdMs * 1000000ULL;
+    gapNs = gapMs * 1000000ULL;
+}
+
+/* Edge interrupts exist on the keypad rows only, the one input that changes */
+static void GPIO_SIM_CheckEdges(void)
+{
+    uint8_t port = KEYPAD_ROW_PORT;
+    for (uint8_t pin = KEYPAD_ROW_FIRST_PIN; pin < KEYPAD_ROW_FIRST_PIN + KEYPAD_ROWS; pin++)
+    {
+        uint8_t bit = (uint8_t)(1U << pin);
+        uint8_t level = GPIO_SIM_KeypadRow(pin) ? bit : 0;
+        if ((intMask[port] & bit) && level != (lastLevel[port] & bit) &&
+            ((intRising[port] & bit) ? level : !level))
+        {
+            intStatus[port] |= bit;
+        }
+        lastLevel[port] = (uint8_t)((lastLevel[port] & ~bit) | level);
+    }
+    if ((intStatus[port] & intMask[port]) && SIM_InterruptsEnabled())
+    {
+        GPIOA_Handler();
+    }
+}
+
+void GPIO_SIM_Poll(void)
+{
+    GPIO_SIM_UpdateKeypad();
+    GPIO_SIM_CheckEdges();
+
+    uint8_t leds = latch[LED_PORT] & (LED_RED_MASK | LED_BLUE_MASK | LED_GREEN_MASK);
+    if (leds != shownLeds)
+    {
+        shownLeds = leds;
+        /* Skip the leading space of the first colour */
+        char text[24];
+        snprintf(text, sizeof(text), "%s%s%s",
+                 (leds & LED_RED_MASK) ? " red" : "",
+                 (leds & LED_GREEN_MASK) ? " green" : "",
+                 (leds & LED_BLUE_MASK) ? " blue" : "");
+        BOARD_SIM_Event("led", "%s", leds ? &text[1] : "off");
+    }
+}
+
+/*******************************************************************************
+ *                         gpio.h implementation                               *
+ *******************************************************************************/
+
+void GPIO_Init(uint8_t port_num, uint8_t pin_num, uint8_t direction)
+{
+    (void)direction;
+    if (port_num < SIM_PORTS)
+    {
+        latch[port_num] &= (uint8_t)~(1U << pin_num);
+    }
+}
+
+void GPIO_WritePin(uint8_t port_num, uint8_t pin_num, uint8_t value)
+{
+    if (port_num >= SIM_PORTS)
+    {
+        return;
+    }
+    if (value == HIGH)
+    {
+        latch[port_num] |= (uint8_t)(1U << pin_num);
+    }
+    else
+    {
+        latch[port_num] &= (uint8_t)~(1U << pin_num);
+    }
+}
+
+uint8_t GPIO_ReadPin(uint8_t port_num, uint8_t pin_num)
+{
+    if (port_num == KEYPAD_ROW_PORT && pin_num >= KEYPAD_ROW_FIRST_PIN &&
+        pin_num < KEYPAD_ROW_FIRST_PIN + KEYPAD_ROWS)
+    {
+        return GPIO_SIM_KeypadRow(pin_num);
+    }
+    return (port_num < SIM_PORTS) ? ((latch[port_num] >> pin_num) & 1U) : LOW;
+}
+
+void GPIO_TogglePin(uint8_t port_num, uint8_t pin_num)
+{
+    GPIO_WritePin(port_num, pin_num, !GPIO_ReadPin(port_num, pin_num));
+}
+
+void GPIO_SetPullUp(uint8_t port_num, uint8_t pin_num, uint8_t enable)
+{
+    if (port_num >= SIM_PORTS)
+    {
+        return;
+    }
+    if (enable)
+    {
+        pullUp[port_num] |= (uint8_t)(1U << pin_num);
+    }
+    else
+    {
+        pullUp[port_num] &= (uint8_t)~(1U << pin_num);
+    }
+}
+
+void GPIO_EnableEdgeInterrupt(uint8_t port_num, uint8_t pin_num, uint8_t edge)
+{
+    if (port_num >= SIM_PORTS)
+    {
+        return;
+    }
+    uint8_t bit = (uint8_t)(1U << pin_num);
+    if (edge == GPIO_EDGE_RISING)
+    {
+        intRising[port_num] |= bit;
+    }
+    else
+    {
+        intRising[port_num] &= (uint8_t)~bit;
+    }
+    intStatus[port_num] &= (uint8_t)~bit;
+    intMask[port_num] |= bit;
+    /* Only changes from now on are edges */
+    uint8_t level = GPIO_ReadPin(port_num, pin_num) ? bit : 0;
+    lastLevel[port_num] = (uint8_t)((lastLevel[port_num] & ~bit) | level);
+}
+
+void GPIO_DisableInterrupt(uint8_t port_num, uint8_t pin_num)
+{
+    if (port_num < SIM_PORTS)
+    {
+        intMask[port_num] &= (uint8_t)~(1U << pin_num);
+    }
+}
+
+uint8_t GPIO_GetInterruptStatus(uint8_t port_num)
+{
+    return (port_num < SIM_PORTS) ? (uint8_t)(intStatus[port_num] & intMask[port_num]) : 0;
+}
+
+void GPIO_ClearInterrupt(uint8_t port_num, uint8_t mask)
+{
+    if (port_num < SIM_PORTS)
+    {
+        intStatus[port_num] &= (uint8_t)~mask;
+    }
+}
@@ -0,0 +1,72 @@
+/*
+    HMI ECU on the host. HMI_ECU/main.c is built with main renamed to HMI_main;
+    this main sets up the simulated board and then runs it.
+
+    Device commands:
+      key <keys>          type keys on the keypad, e.g. "key 12345", "key A"
+      keytiming <h> <g>   hold each key h ms, wait g ms before the next
+      pot <raw>           potentiometer reading, 0-4095
+      power               report time asleep and awake since boot
+      boot                report the boot marks of both ECUs (ms after reset),
+                          Control's as it answered CMD_BOOT
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "../Board/board_sim.h"
+#include "../../Common/MCAL/power.h"
+#include "../../Common/Utils/boot_profile.h"
+#include "hmi_sim.h"
+
+int HMI_main(void);
+
+static bool HMI_SIM_Command(const char *cmd, const char *arg)
+{
+    if (strcmp(cmd, "key") == 0)
+    {
+        GPIO_SIM_PressKeys(arg);
+    }
+    else if (strcmp(cmd, "keytiming") == 0)
+    {
+        char *end;
+        uint32_t hold = (uint32_t)strtoul(arg, &end, 0);
+        GPIO_SIM_SetKeyTiming(hold, (uint32_t)strtoul(end, NULL, 0));
+    }
+    else if (strcmp(cmd, "pot") == 0)
+    {
+        ADC_SIM_SetRaw((uint16_t)strtoul(arg, NULL, 0));
+    }
+    else if (strcmp(cmd, "power") == 0)
+    {
+        POWER_Stats stats;
+        POWER_GetStats(&stats);
+        BOARD_SIM_Event("power", "sleeps %u asleep %u ms awake %u ms",
+                        stats.sleeps, stats.asleepMs, stats.awakeMs);
+    }
+    else if (strcmp(cmd, "boot") == 0)
+    {
+        BOOT_Profile profile;
+        char text[160];
+        BOOT_Get(&profile);
+        BOOT_Format(&profile, text, sizeof(text));
+        BOARD_SIM_Event("boot", "hmi %s", text);
+        if (BOOT_GetPeer(&profile))
+        {
+            BOOT_Format(&profile, text, sizeof(text));
+            BOARD_SIM_Event("boot", "control %s", text);
+        }
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    BOARD_SIM_Init("hmi", argc, argv, HMI_SIM_Command);
+    BOARD_SIM_AddPoll(GPIO_SIM_Poll);
+    BOARD_SIM_AddPoll(LCD_SIM_Poll);
+    return HMI_main();
+}
@@ -0,0 +1,35 @@
+#ifndef HMI_SIM_H_
+#define HMI_SIM_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+ *                         HMI Board Devices                                   *
+ *******************************************************************************/
+
+/*
+ * The HMI's GPIO and ADC (MCAL) are simulated, so keypad.c, led.c and pot.c
+ * run unchanged on top of them; the I2C LCD is replaced at its API.
+ *
+ * Wiring modelled by gpio_sim.c (same as the board):
+ *   keypad columns PC4-PC7 (driven low one at a time), rows PA2-PA5 (pull-up,
+ *   edge interrupts raise GPIOA_Handler from GPIO_SIM_Poll)
+ *   RGB LED PF1 red, PF2 blue, PF3 green
+ */
+
+/* Queue key presses ("12345", "A", ...), typed one after another */
+void GPIO_SIM_PressKeys(const char *keys);
+
+/* How long each key is held and the pause before the next one (sim ms) */
+void GPIO_SIM_SetKeyTiming(uint32_t holdMs, uint32_t gapMs);
+
+/* Report key presses and LED colour changes, deliver row edge interrupts */
+void GPIO_SIM_Poll(void);
+
+/* Potentiometer position as a raw 12-bit conversion result (0-4095) */
+void ADC_SIM_SetRaw(uint16_t raw);
+
+/* Report the 2x16 screen once it changed */
+void LCD_SIM_Poll(void);
+
+#endif /* HMI_SIM_H_ */
@@ -0,0 +1,91 @@
+#include <string.h>
+#include "../../HMI_ECU/HAL/lcd/lcd.h"
+#include "../Board/board_sim.h"
+#include "hmi_sim.h"
+
+#define LCD_ROWS    2
+#define LCD_COLS    16
+
+static char screen[LCD_ROWS][LCD_COLS + 1];
+static uint8_t cursorRow, cursorCol;
+static char shown[LCD_ROWS][LCD_COLS + 1];
+static bool dirty;
+
+/* Row text without the trailing blanks */
+static int LCD_SIM_Length(const char *row)
+{
+    int len = LCD_COLS;
+    while (len > 0 && row[len - 1] == ' ')
+    {
+        len--;
+    }
+    return len;
+}
+
+void LCD_SIM_Poll(void)
+{
+    /* Reported at the next idle, so a Clear + two lines appear as one screen */
+    if (dirty)
+    {
+        dirty = false;
+        /* A redraw of the same text is not an event */
+        if (memcmp(shown, screen, sizeof(screen)) == 0)
+        {
+            return;
+        }
+        memcpy(shown, screen, sizeof(screen));
+        BOARD_SIM_Event("lcd", "%.*s|%.*s", LCD_SIM_Length(screen[0]), screen[0],
+                        LCD_SIM_Length(screen[1]), screen[1]);
+    }
+}
+
+void LCD_I2C_Init(void)
+{
+    LCD_I2C_Clear();
+}
+
+void LCD_I2C_Clear(void)
+{
+    for (uint8_t row = 0; row < LCD_ROWS; row++)
+    {
+        memset(screen[row], ' ', LCD_COLS);
+        screen[row][LCD_COLS] = '\0';
+    }
+    cursorRow = cursorCol = 0;
+    dirty = true;
+}
+
+void LCD_I2C_SetCursor(uint8_t row, uint8_t col)
+{
+    cursorRow = (row < LCD_ROWS) ? row : LCD_ROWS - 1;
+    cursorCol = col;
+}
+
+void LCD_I2C_WriteChar(char c)
+{
+    /* Past column 16 the HD44780 writes to DDRAM that is not displayed */
+    if (cursorCol < LCD_COLS)
+    {
+        screen[cursorRow][cursorCol] = c;
+        dirty = true;
+    }
+    cursorCol++;
+}
+
+void LCD_I2C_WriteString(const char *str)
+{
+    while (*str)
+    {
+        LCD_I2C_WriteChar(*str++);
+    }
+}
+
+void LCD_I2C_ClearLine(uint8_t row)
+{
+    LCD_I2C_SetCursor(row, 0);
+    for (uint8_t i = 0; i < LCD_COLS; i++)
+    {
+        LCD_I2C_WriteChar(' ');
+    }
+    LCD_I2C_SetCursor(row, 0);
+}
@@ -0,0 +1,32 @@
+#include "../../Common/MCAL/clock.h"
+#include "sim.h"
+
+/*
+ * The host clock, shared by all sim processes like SIM_NowNs. GetTicks stays
+ * in tick_sim.c, which the unit tests link without this file. The host's WFI
+ * (SIM_Idle) returns on its own within a fraction of a millisecond, so the
+ * alarm is not modelled.
+ */
+
+void CLOCK_Init(void)
+{
+}
+
+uint64_t CLOCK_NowUs(void)
+{
+    return SIM_NowNs() / 1000u;
+}
+
+uint64_t CLOCK_NowMs(void)
+{
+    return SIM_NowNs() / 1000000u;
+}
+
+void CLOCK_SetAlarm(uint64_t atUs)
+{
+    (void)atUs;
+}
+
+void CLOCK_CancelAlarm(void)
+{
+}
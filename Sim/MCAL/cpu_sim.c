@@ -0,0 +1,51 @@
+#define _POSIX_C_SOURCE 199309L
+#include <time.h>
+#include "sim.h"
+#include "uart_sim.h"
+#include "../../Common/MCAL/cpu.h"
+
+static int interruptsEnabled = 1;
+static SIM_IdleHook idleHook;
+static uint32_t speed = 1;
+
+void SIM_Idle(void)
+{
+    UART_SIM_Service();
+    if (idleHook)
+    {
+        idleHook();
+    }
+}
+
+void SIM_SetIdleHook(SIM_IdleHook hook)
+{
+    idleHook = hook;
+}
+
+void SIM_SetInterruptsEnabled(int enabled)
+{
+    interruptsEnabled = enabled;
+}
+
+int SIM_InterruptsEnabled(void)
+{
+    return interruptsEnabled;
+}
+
+void SIM_SetSpeed(uint32_t factor)
+{
+    speed = factor ? factor : 1;
+}
+
+uint64_t SIM_NowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec) * speed;
+}
+
+/* DWT stand-in: simulated time on a 16 MHz core */
+uint32_t SIM_Cycles(void)
+{
+    return (uint32_t)(SIM_NowNs() * 16 / 1000);
+}
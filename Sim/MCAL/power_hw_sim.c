@@ -0,0 +1,20 @@
+#include "../../Common/MCAL/power_hw.h"
+#include "../../Common/MCAL/cpu.h"
+#include "sim.h"
+
+/*
+ * WFI on the host: one SIM_Idle pass, which delivers whatever interrupt is
+ * due and otherwise waits for the board's next event (BOARD_SIM_Service).
+ * There is no deep-sleep to model.
+ */
+
+void POWER_HW_Init(bool deepSleep)
+{
+    (void)deepSleep;
+}
+
+void POWER_HW_WaitForInterrupt(void)
+{
+    CPU_EnableInterrupts();
+    SIM_Idle();
+}
@@ -0,0 +1,40 @@
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+ *                         Host Simulation Core                                *
+ *******************************************************************************/
+
+/*
+ * On the host there is no NVIC: every simulated peripheral raises its
+ * interrupt from SIM_Idle(), which the drivers call from each busy-wait via
+ * CPU_Idle(). The ISR then runs to completion on the caller's stack, which is
+ * exactly the "preempt between two instructions" model the firmware assumes.
+ */
+
+/* Service all simulated peripherals and deliver pending interrupts */
+void SIM_Idle(void);
+
+/*
+ * Extra work run on every SIM_Idle, after the peripherals: lets a test or
+ * benchmark play the other ECU while the code under test is busy-waiting.
+ */
+typedef void (*SIM_IdleHook)(void);
+void SIM_SetIdleHook(SIM_IdleHook hook);
+
+/* PRIMASK emulation for CPU_EnableInterrupts / CPU_DisableInterrupts */
+void SIM_SetInterruptsEnabled(int enabled);
+int SIM_InterruptsEnabled(void);
+
+/* Host monotonic clock, used for ISR cost accounting and benchmarks */
+uint64_t SIM_NowNs(void);
+
+/*
+ * Run simulated time factor times faster than the host clock (default 1).
+ * Set it once, before the first SIM_NowNs / GetTicks call.
+ */
+void SIM_SetSpeed(uint32_t factor);
+
+#endif /* SIM_H_ */
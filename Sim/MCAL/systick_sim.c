@@ -0,0 +1,17 @@
+#include "../../Common/MCAL/tick.h"
+#include "../../Common/MCAL/cpu.h"
+
+/*
+ * DelayMs for both ECUs (HMI_ECU/MCAL/timers/systick.h and
+ * Control_ECU/Helpers/timer.h share the API). The millisecond tick comes from
+ * the host clock in tick_sim.c.
+ */
+
+void DelayMs(uint32_t ms)
+{
+    uint32_t deadline = Tick_Deadline(ms);
+    while (!Tick_Expired(deadline))
+    {
+        CPU_Idle();
+    }
+}
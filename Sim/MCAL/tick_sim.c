@@ -0,0 +1,13 @@
+#include "../../Common/MCAL/tick.h"
+#include "sim.h"
+
+/* Host monotonic clock stands in for the WTIMER0 clock (clock_tm4c.c) */
+uint32_t GetTicks(void)
+{
+    static uint64_t startNs;
+    if (startNs == 0)
+    {
+        startNs = SIM_NowNs();
+    }
+    return (uint32_t)((SIM_NowNs() - startNs) / 1000000ULL);
+}
@@ -0,0 +1,314 @@
+#include "../../Common/MCAL/uart_hw.h"
+#include "../../Common/MCAL/uart.h"
+#include "../../Common/MCAL/tm4c123gh6pm.h"
+#include "../../Common/Utils/ring_buffer.h"
+#include "uart_sim.h"
+#include "udma_sim.h"
+#include "sim.h"
+
+#define SIM_FIFO_DEPTH      16
+#define SIM_RX_LEVEL        8      /* UART_IFLS_RX4_8 */
+#define SIM_TX_LEVEL        2      /* UART_IFLS_TX1_8 */
+#define SIM_LINE_SIZE       4096
+#define SIM_MAX_ISR_CHAIN   64     /* guard against an ISR that never clears */
+#define SIM_DEFAULT_CLOCK   16000000UL
+#define SIM_BITS_PER_BYTE   10     /* start + 8 data + stop */
+#define SIM_RT_BITS         32     /* receive timeout after 32 idle bit times */
+
+static uint16_t rxFifo[SIM_FIFO_DEPTH];    /* data + UART_DR_* error bits */
+static uint8_t txFifo[SIM_FIFO_DEPTH];
+static uint8_t rxHead, rxCount;
+static uint8_t txHead, txCount;
+
+static uint32_t regIM;
+static uint32_t regRIS;
+
+static uint8_t rxLineStorage[SIM_LINE_SIZE];
+static uint8_t txLineStorage[SIM_LINE_SIZE];
+static RingBuffer rxLine;   /* bytes on their way to the RX FIFO */
+static RingBuffer txLine;   /* bytes that left the TX FIFO */
+
+static uint32_t rxErrors;      /* error bits for the next byte into the RX FIFO */
+static bool loopback;
+static bool inIsr;
+static UART_SIM_Stats stats;
+
+static uint32_t clockHz = SIM_DEFAULT_CLOCK;
+static uint32_t divisor64;      /* IBRD * 64 + FBRD */
+static bool pacing;
+static uint64_t txReadyNs;      /* when the shift register can take the next byte */
+static uint64_t rxReadyNs;      /* when the injected byte on the wire has fully arrived */
+static bool rxShifting;
+static uint64_t lastRxNs;
+
+/* Time one byte occupies the wire at the programmed rate */
+static uint64_t UART_SIM_ByteNs(void)
+{
+    uint32_t baud = UART_SIM_GetBaudRate();
+    return baud ? (uint64_t)SIM_BITS_PER_BYTE * 1000000000ULL / baud : 0;
+}
+
+/*******************************************************************************
+ *                         uart_hw.h implementation                            *
+ *******************************************************************************/
+
+void UART_HW_Init(uint32_t ibrd, uint32_t fbrd)
+{
+    divisor64 = ibrd * 64 + fbrd;
+    txReadyNs = 0;
+    rxHead = rxCount = 0;
+    txHead = txCount = 0;
+    regIM = 0;
+    regRIS = 0;
+}
+
+bool UART_HW_TxFull(void)
+{
+    return txCount == SIM_FIFO_DEPTH;
+}
+
+bool UART_HW_RxEmpty(void)
+{
+    return rxCount == 0;
+}
+
+void UART_HW_WriteData(uint8_t data)
+{
+    if (txCount < SIM_FIFO_DEPTH)
+    {
+        txFifo[(txHead + txCount) % SIM_FIFO_DEPTH] = data;
+        txCount++;
+    }
+}
+
+uint32_t UART_HW_ReadData(void)
+{
+    if (rxCount == 0)
+    {
+        return 0;
+    }
+    uint32_t data = rxFifo[rxHead];
+    rxHead = (rxHead + 1) % SIM_FIFO_DEPTH;
+    rxCount--;
+
+    /* RXRIS drops once the FIFO is read below the trigger level */
+    if (rxCount < SIM_RX_LEVEL)
+    {
+        regRIS &= ~UART_RIS_RXRIS;
+    }
+    if (rxCount == 0)
+    {
+        regRIS &= ~UART_RIS_RTRIS;
+    }
+    return data;
+}
+
+void UART_HW_EnableInterrupts(uint32_t mask)
+{
+    regIM |= mask;
+}
+
+void UART_HW_DisableInterrupts(uint32_t mask)
+{
+    regIM &= ~mask;
+}
+
+uint32_t UART_HW_GetInterruptStatus(void)
+{
+    return regRIS & regIM;
+}
+
+void UART_HW_ClearInterrupts(uint32_t mask)
+{
+    regRIS &= ~mask;
+}
+
+bool UART_HW_TxBusy(void)
+{
+    return txCount > 0 || (pacing && SIM_NowNs() < txReadyNs);
+}
+
+void UART_HW_SetDivisors(uint32_t ibrd, uint32_t fbrd)
+{
+    divisor64 = ibrd * 64 + fbrd;
+}
+
+uint32_t UART_HW_GetClockHz(void)
+{
+    return clockHz;
+}
+
+/*******************************************************************************
+ *                         Simulation control                                  *
+ *******************************************************************************/
+
+void UART_SIM_Reset(void)
+{
+    RingBuffer_Init(&rxLine, rxLineStorage, SIM_LINE_SIZE);
+    RingBuffer_Init(&txLine, txLineStorage, SIM_LINE_SIZE);
+    clockHz = SIM_DEFAULT_CLOCK;
+    UART_HW_Init(0, 0);
+    UDMA_SIM_Reset();
+    loopback = false;
+    pacing = false;
+    rxShifting = false;
+    rxErrors = 0;
+    inIsr = false;
+    stats = (UART_SIM_Stats){0};
+}
+
+void UART_SIM_SetClockHz(uint32_t hz)
+{
+    clockHz = hz;
+}
+
+void UART_SIM_SetPacing(bool enable)
+{
+    pacing = enable;
+    txReadyNs = 0;
+    rxReadyNs = 0;
+    rxShifting = false;
+}
+
+uint32_t UART_SIM_GetBaudRate(void)
+{
+    return divisor64 ? (uint32_t)((uint64_t)clockHz * 4 / divisor64) : 0;
+}
+
+void UART_SIM_SetLoopback(bool enable)
+{
+    loopback = enable;
+}
+
+void UART_SIM_Inject(const uint8_t *data, uint16_t len)
+{
+    for (uint16_t i = 0; i < len; i++)
+    {
+        (void)RingBuffer_Put(&rxLine, data[i]);
+    }
+}
+
+void UART_SIM_InjectErrors(uint32_t drErrors)
+{
+    rxErrors = drErrors & (UART_DR_OE | UART_DR_BE | UART_DR_PE | UART_DR_FE);
+}
+
+uint16_t UART_SIM_Drain(uint8_t *out, uint16_t max)
+{
+    uint16_t n = 0;
+    while (n < max && RingBuffer_Get(&txLine, &out[n]))
+    {
+        n++;
+    }
+    return n;
+}
+
+bool UART_SIM_LineIdle(void)
+{
+    return txCount == 0 && rxCount == 0 && !UDMA_SIM_Active() &&
+           RingBuffer_IsEmpty(&txLine) && RingBuffer_IsEmpty(&rxLine);
+}
+
+void UART_SIM_GetStats(UART_SIM_Stats *out)
+{
+    *out = stats;
+}
+
+static void UART_SIM_Dispatch(void)
+{
+    for (int chain = 0; chain < SIM_MAX_ISR_CHAIN; chain++)
+    {
+        uint32_t pending = regRIS & regIM;
+        bool dmaDone = UDMA_SIM_InterruptPending();
+        if (inIsr || !SIM_InterruptsEnabled() || (pending == 0 && !dmaDone))
+        {
+            return;
+        }
+
+        stats.isrCalls++;
+        if (pending & UART_MIS_RXMIS) stats.rxInterrupts++;
+        if (pending & UART_MIS_RTMIS) stats.rtInterrupts++;
+        if (pending & UART_MIS_TXMIS) stats.txInterrupts++;
+        if (dmaDone) stats.dmaInterrupts++;
+
+        inIsr = true;
+        uint64_t start = SIM_NowNs();
+        UART2_Handler();
+        stats.isrNs += SIM_NowNs() - start;
+        inIsr = false;
+    }
+}
+
+/*
+ * Shift one byte at a time so interrupts interleave with the traffic the way
+ * they do on the wire: uDMA -> TX FIFO -> line, line -> RX FIFO, then re-evaluate the
+ * trigger levels and run the ISR if anything is pending and unmasked.
+ */
+void UART_SIM_Service(void)
+{
+    bool moved;
+    do
+    {
+        uint64_t now = pacing ? SIM_NowNs() : 0;
+        moved = UDMA_SIM_Step();
+
+        /* With pacing on, a byte leaves only once the previous one is on the wire */
+        if (txCount > 0 && (!pacing || now >= txReadyNs))
+        {
+            if (pacing)
+            {
+                txReadyNs = ((txReadyNs > now) ? txReadyNs : now) + UART_SIM_ByteNs();
+            }
+            uint8_t data = txFifo[txHead];
+            txHead = (txHead + 1) % SIM_FIFO_DEPTH;
+            txCount--;
+            stats.bytesOut++;
+            (void)RingBuffer_Put(loopback ? &rxLine : &txLine, data);
+            if (txCount == SIM_TX_LEVEL)
+            {
+                regRIS |= UART_RIS_TXRIS;   /* level crossed on the way down */
+            }
+            moved = true;
+        }
+
+        /* Injected bytes are paced like the TX pin, looped back ones already were */
+        bool rxPaced = pacing && !loopback;
+        if (rxPaced && !rxShifting && !RingBuffer_IsEmpty(&rxLine))
+        {
+            rxShifting = true;              /* start bit of the next byte */
+            rxReadyNs = now + UART_SIM_ByteNs();
+        }
+        if (rxCount < SIM_FIFO_DEPTH && (!rxPaced || (rxShifting && now >= rxReadyNs)))
+        {
+            uint8_t data;
+            if (RingBuffer_Get(&rxLine, &data))
+            {
+                if (rxPaced)
+                {
+                    /* back-to-back bytes follow without a gap */
+                    rxShifting = !RingBuffer_IsEmpty(&rxLine);
+                    rxReadyNs += UART_SIM_ByteNs();
+                }
+                rxFifo[(rxHead + rxCount) % SIM_FIFO_DEPTH] = (uint16_t)(data | rxErrors);
+                rxErrors = 0;
+                rxCount++;
+                stats.bytesIn++;
+                lastRxNs = now;
+                if (rxCount >= SIM_RX_LEVEL)
+                {
+                    regRIS |= UART_RIS_RXRIS;
+                }
+                moved = true;
+            }
+        }
+
+        /* Line went quiet with a partial burst in the FIFO: receive timeout */
+        if (rxCount > 0 && RingBuffer_IsEmpty(&rxLine) && !(loopback && txCount > 0) &&
+            (!pacing || now - lastRxNs >= UART_SIM_ByteNs() * SIM_RT_BITS / SIM_BITS_PER_BYTE))
+        {
+            regRIS |= UART_RIS_RTRIS;
+        }
+
+        UART_SIM_Dispatch();
+    } while (moved);
+}
@@ -0,0 +1,68 @@
+#ifndef UART_SIM_H_
+#define UART_SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ *                         Simulated UART2                                     *
+ *******************************************************************************/
+
+/*
+ * Host model of the TM4C UART2 behind uart_hw.h: 16-byte RX/TX FIFOs,
+ * IFLS trigger levels, receive timeout and the IM/RIS/MIS/ICR interrupt
+ * registers. The "line" is either looped back (TX -> RX) or exposed to the
+ * test through UART_SIM_Inject / UART_SIM_Drain.
+ */
+
+typedef struct {
+    uint32_t isrCalls;       /* UART2_Handler invocations */
+    uint64_t isrNs;          /* total host time spent inside UART2_Handler */
+    uint32_t rxInterrupts;   /* ISR entries with RX level pending */
+    uint32_t rtInterrupts;   /* ISR entries with receive timeout pending */
+    uint32_t txInterrupts;   /* ISR entries with TX level pending */
+    uint32_t dmaInterrupts;  /* ISR entries with uDMA TX completion pending */
+    uint32_t bytesIn;        /* bytes delivered into the RX FIFO */
+    uint32_t bytesOut;       /* bytes shifted out of the TX FIFO */
+} UART_SIM_Stats;
+
+/* Empty FIFOs and line, clear registers and statistics */
+void UART_SIM_Reset(void);
+
+/* Route transmitted bytes straight back to the receiver */
+void UART_SIM_SetLoopback(bool enable);
+
+/* Bytes arriving on the RX pin */
+void UART_SIM_Inject(const uint8_t *data, uint16_t len);
+
+/*
+ * Line errors for the next byte that reaches the RX FIFO: UART_DR_FE, _PE,
+ * _BE and/or _OE, returned with it by UART_HW_ReadData as the hardware does.
+ */
+void UART_SIM_InjectErrors(uint32_t drErrors);
+
+/* Bytes that left the TX pin (not looped back), returns how many were copied */
+uint16_t UART_SIM_Drain(uint8_t *out, uint16_t max);
+
+/* Advance the line and FIFOs, raising UART2 interrupts as the hardware would */
+void UART_SIM_Service(void);
+
+void UART_SIM_GetStats(UART_SIM_Stats *stats);
+
+/* Nothing queued on either pin, in the FIFOs or in the uDMA: safe to sleep */
+bool UART_SIM_LineIdle(void);
+
+/* System clock reported to the driver (default 16 MHz) */
+void UART_SIM_SetClockHz(uint32_t hz);
+
+/*
+ * Pace the TX pin and injected RX bytes at the programmed baud rate in host
+ * real time (10 bits per byte) instead of moving bytes instantly.
+ * Off after UART_SIM_Reset.
+ */
+void UART_SIM_SetPacing(bool enable);
+
+/* Rate produced by the divisors the driver wrote, 0 before UART_HW_Init */
+uint32_t UART_SIM_GetBaudRate(void);
+
+#endif /* UART_SIM_H_ */
@@ -0,0 +1,72 @@
+#include "../../Common/MCAL/udma_hw.h"
+#include "../../Common/MCAL/uart_hw.h"
+#include "udma_sim.h"
+
+static const uint8_t *src;
+static uint16_t remaining;
+static bool active;
+static bool donePending;
+static uint32_t bytesMoved;
+
+void UDMA_HW_Init(void)
+{
+    UDMA_SIM_Reset();
+}
+
+void UDMA_HW_StartUartTx(const uint8_t *data, uint16_t count)
+{
+    src = data;
+    remaining = count;
+    active = (count > 0);
+}
+
+bool UDMA_HW_UartTxDone(void)
+{
+    if (donePending)
+    {
+        donePending = false;
+        return true;
+    }
+    return false;
+}
+
+bool UDMA_SIM_Step(void)
+{
+    if (!active || UART_HW_TxFull())
+    {
+        return false;
+    }
+
+    UART_HW_WriteData(*src++);
+    bytesMoved++;
+    if (--remaining == 0)
+    {
+        active = false;
+        donePending = true;
+    }
+    return true;
+}
+
+bool UDMA_SIM_Active(void)
+{
+    return active || donePending;
+}
+
+bool UDMA_SIM_InterruptPending(void)
+{
+    return donePending;
+}
+
+uint32_t UDMA_SIM_BytesMoved(void)
+{
+    return bytesMoved;
+}
+
+void UDMA_SIM_Reset(void)
+{
+    src = 0;
+    remaining = 0;
+    active = false;
+    donePending = false;
+    bytesMoved = 0;
+}
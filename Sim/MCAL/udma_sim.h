@@ -0,0 +1,26 @@
+#ifndef UDMA_SIM_H_
+#define UDMA_SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ *                         Simulated uDMA (UART2 TX channel)                   *
+ *******************************************************************************/
+
+/* Move one byte into the simulated TX FIFO if a transfer is active and the
+   FIFO has room; returns true if a byte moved. Driven by UART_SIM_Service. */
+bool UDMA_SIM_Step(void);
+
+/* A transfer is running or its completion is not yet acknowledged */
+bool UDMA_SIM_Active(void);
+
+/* Completion interrupt raised and not yet acknowledged by UART2_Handler */
+bool UDMA_SIM_InterruptPending(void);
+
+/* Bytes moved by the engine since the last UART_SIM_Reset */
+uint32_t UDMA_SIM_BytesMoved(void);
+
+void UDMA_SIM_Reset(void);
+
+#endif /* UDMA_SIM_H_ */
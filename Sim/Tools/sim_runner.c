@@ -0,0 +1,501 @@
+/*
+    Runs both ECUs on the host and drives their virtual devices from a script.
+
+    Sim_HMI_ECU and Sim_Control_ECU (next to this program) are started with
+    UART2 joined by a socketpair and one device channel each, see
+    Sim/Board/board_sim.h for the channel format.
+
+    Usage: Sim_Door_Locker [-v] [--speed N] [--eeprom PATH] [--control NAME] SCRIPT
+      -v              print every device event, not only the matched ones
+      --speed N       run simulated time N times faster (default 1)
+      --eeprom PATH   keep Control's EEPROM in a file (default: blank each run)
+      --control NAME  Control program next to this one (default Sim_Control_ECU),
+                      e.g. Sim_Control_ECU_Base without optional protocol features
+
+    Script lines (times in simulated ms):
+      hmi <command>                     send a device command to the HMI, e.g. "hmi key 12345"
+      control <command>                 same for Control
+      wait <ecu> <device> [text]        block until <ecu> reports an event from <device>
+                                        whose text contains [text]
+      timeout <ms>                      limit for each following wait (default 10000)
+      sleep <ms>                        let simulated time pass
+      reset <ecu>                       power-cycle an ECU: kill it and start it again on the
+                                        same UART link (Control's EEPROM is blank again
+                                        unless --eeprom is given)
+      echo <text>                       print text
+      # ...                             comment
+    Events are matched in the order of their time stamps, which both ECUs take
+    from the same host clock, so a device event that reaches the runner a little
+    after a newer one of the other ECU still matches first; anything older than
+    the last match is skipped. The exit code is non-zero if a wait times out.
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <libgen.h>
+#include <limits.h>
+#include <sys/socket.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+
+#define RUNNER_LINE_SIZE        256
+#define RUNNER_BACKLOG          256     /* events held until a wait consumes them */
+#define RUNNER_DEFAULT_WAIT_MS  10000
+#define RUNNER_LINK_FD          3
+#define RUNNER_DEV_FD           4
+
+typedef enum {
+    ECU_HMI,
+    ECU_CONTROL,
+    ECU_COUNT
+} RunnerEcu;
+
+typedef struct {
+    const char *name;
+    const char *program;
+    pid_t pid;
+    int linkFd;                 /* kept open so the peer never sees the link close */
+    int devFd;
+    char partial[RUNNER_LINE_SIZE];
+    uint16_t partialLen;
+} RunnerChild;
+
+typedef struct {
+    RunnerEcu ecu;
+    uint64_t ns;
+    char device[32];
+    char text[RUNNER_LINE_SIZE];
+} RunnerEvent;
+
+static RunnerChild children[ECU_COUNT] = {
+    [ECU_HMI]     = { .name = "hmi",     .program = "Sim_HMI_ECU",     .linkFd = -1, .devFd = -1 },
+    [ECU_CONTROL] = { .name = "control", .program = "Sim_Control_ECU", .linkFd = -1, .devFd = -1 },
+};
+
+static RunnerEvent backlog[RUNNER_BACKLOG];
+static uint16_t backlogHead, backlogCount;
+static uint64_t lastMatchNs;            /* time stamp of the last matched event */
+
+static bool verbose;
+static uint32_t speed = 1;
+static uint64_t startNs;
+static const char *programDir;
+static const char *eepromPath;
+
+/*******************************************************************************
+ *                         Time                                                *
+ *******************************************************************************/
+
+/* Same clock the boards stamp their events with (SIM_NowNs) */
+static uint64_t Runner_NowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec) * speed;
+}
+
+static double Runner_SimMs(uint64_t ns)
+{
+    return (ns > startNs) ? (double)(ns - startNs) / 1e6 : 0.0;
+}
+
+/*******************************************************************************
+ *                         Children                                            *
+ *******************************************************************************/
+
+static void Runner_Spawn(RunnerChild *child, int devFd)
+{
+    char path[PATH_MAX];
+    char speedArg[16];
+    snprintf(path, sizeof(path), "%s/%s", programDir, child->program);
+    snprintf(speedArg, sizeof(speedArg), "%u", speed);
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        perror("fork");
+        exit(1);
+    }
+    if (pid > 0)
+    {
+        child->pid = pid;
+        return;
+    }
+
+    /* Do not outlive the runner, even if it is killed */
+    (void)prctl(PR_SET_PDEATHSIG, SIGKILL);
+
+    /* Move both ends out of the way first, the targets may be taken */
+    int link = fcntl(child->linkFd, F_DUPFD, 10);
+    int dev = fcntl(devFd, F_DUPFD, 10);
+    dup2(link, RUNNER_LINK_FD);
+    dup2(dev, RUNNER_DEV_FD);
+    for (int fd = RUNNER_DEV_FD + 1; fd < 64; fd++)
+    {
+        close(fd);
+    }
+
+    char *argv[] = {
+        path, "--link", "fd:3", "--dev", "fd:4", "--speed", speedArg,
+        eepromPath ? "--eeprom" : NULL, (char *)eepromPath, NULL
+    };
+    execv(path, argv);
+    perror(path);
+    _exit(127);
+}
+
+/* Start an ECU with a fresh device channel, its link end stays where it is */
+static void Runner_Start(RunnerChild *child)
+{
+    int dev[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, dev) != 0)
+    {
+        perror("socketpair");
+        exit(2);
+    }
+    Runner_Spawn(child, dev[1]);
+    close(dev[1]);
+    child->devFd = dev[0];
+    child->partialLen = 0;
+}
+
+/* Power cycle: no chance to finish what it was sending, like pulling the plug */
+static void Runner_Reset(RunnerChild *child)
+{
+    if (child->pid > 0)
+    {
+        kill(child->pid, SIGKILL);
+        waitpid(child->pid, NULL, 0);
+        child->pid = 0;
+    }
+    if (child->devFd >= 0)
+    {
+        close(child->devFd);
+        child->devFd = -1;
+    }
+    Runner_Start(child);
+}
+
+static void Runner_Stop(void)
+{
+    for (int i = 0; i < ECU_COUNT; i++)
+    {
+        if (children[i].pid > 0)
+        {
+            kill(children[i].pid, SIGTERM);
+            waitpid(children[i].pid, NULL, 0);
+            children[i].pid = 0;
+        }
+    }
+}
+
+/*******************************************************************************
+ *                         Events                                              *
+ *******************************************************************************/
+
+static void Runner_Print(const RunnerEvent *event)
+{
+    printf("%10.1f ms  %-7s %-7s %s\n", Runner_SimMs(event->ns),
+           children[event->ecu].name, event->device, event->text);
+    fflush(stdout);
+}
+
+/* "<ns> <device> <text>" */
+static void Runner_AddEvent(RunnerEcu ecu, const char *line)
+{
+    RunnerEvent event = { .ecu = ecu };
+    int textAt = 0;
+
+    if (sscanf(line, "%llu %31s %n", (unsigned long long *)&event.ns, event.device, &textAt) < 2)
+    {
+        return;
+    }
+    snprintf(event.text, sizeof(event.text), "%s", line + textAt);
+
+    if (verbose)
+    {
+        Runner_Print(&event);
+    }
+    if (event.ns < lastMatchNs)
+    {
+        return;     /* came in late, the script is past it */
+    }
+    if (backlogCount == RUNNER_BACKLOG)
+    {
+        backlogHead = (backlogHead + 1) % RUNNER_BACKLOG;    /* drop the oldest */
+        backlogCount--;
+    }
+    /* Keep the backlog in time stamp order, the other ECU's events may be newer */
+    uint16_t at = backlogCount;
+    while (at > 0 && backlog[(backlogHead + at - 1) % RUNNER_BACKLOG].ns > event.ns)
+    {
+        backlog[(backlogHead + at) % RUNNER_BACKLOG] = backlog[(backlogHead + at - 1) % RUNNER_BACKLOG];
+        at--;
+    }
+    backlog[(backlogHead + at) % RUNNER_BACKLOG] = event;
+    backlogCount++;
+}
+
+static void Runner_ReadChild(RunnerEcu ecu)
+{
+    RunnerChild *child = &children[ecu];
+    char buf[RUNNER_LINE_SIZE];
+    ssize_t r = read(child->devFd, buf, sizeof(buf));
+
+    if (r <= 0)
+    {
+        fprintf(stderr, "%s exited\n", child->name);
+        close(child->devFd);
+        child->devFd = -1;
+        return;
+    }
+    for (ssize_t i = 0; i < r; i++)
+    {
+        if (buf[i] == '\n' || child->partialLen == RUNNER_LINE_SIZE - 1)
+        {
+            child->partial[child->partialLen] = '\0';
+            child->partialLen = 0;
+            Runner_AddEvent(ecu, child->partial);
+        }
+        else
+        {
+            child->partial[child->partialLen++] = buf[i];
+        }
+    }
+}
+
+/* Collect events until hostDeadlineNs (host clock, unscaled) */
+static void Runner_Pump(uint64_t hostDeadlineNs)
+{
+    struct pollfd p[ECU_COUNT];
+    uint64_t now = Runner_NowNs() / speed;
+    int timeoutMs = (hostDeadlineNs > now) ? (int)((hostDeadlineNs - now + 999999) / 1000000) : 0;
+
+    for (int i = 0; i < ECU_COUNT; i++)
+    {
+        p[i] = (struct pollfd){ .fd = children[i].devFd, .events = POLLIN };
+    }
+    if (poll(p, ECU_COUNT, timeoutMs) <= 0)
+    {
+        return;
+    }
+    for (int i = 0; i < ECU_COUNT; i++)
+    {
+        if (p[i].revents & (POLLIN | POLLHUP))
+        {
+            Runner_ReadChild((RunnerEcu)i);
+        }
+    }
+}
+
+/* Events stay in the backlog until a match: one of the other ECU may still arrive before them */
+static bool Runner_TakeMatch(RunnerEcu ecu, const char *device, const char *text)
+{
+    for (uint16_t i = 0; i < backlogCount; i++)
+    {
+        RunnerEvent *event = &backlog[(backlogHead + i) % RUNNER_BACKLOG];
+        if (event->ecu == ecu && strcmp(event->device, device) == 0 &&
+            strstr(event->text, text) != NULL)
+        {
+            lastMatchNs = event->ns;
+            if (!verbose)
+            {
+                Runner_Print(event);
+            }
+            backlogHead = (backlogHead + i + 1) % RUNNER_BACKLOG;
+            backlogCount -= i + 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*******************************************************************************
+ *                         Script                                              *
+ *******************************************************************************/
+
+static bool Runner_FindEcu(const char *name, RunnerEcu *ecu)
+{
+    for (int i = 0; i < ECU_COUNT; i++)
+    {
+        if (strcmp(children[i].name, name) == 0)
+        {
+            *ecu = (RunnerEcu)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void Runner_Send(RunnerEcu ecu, const char *command)
+{
+    char line[RUNNER_LINE_SIZE + 1];
+    int n = snprintf(line, sizeof(line), "%s\n", command);
+    if (children[ecu].devFd < 0 || write(children[ecu].devFd, line, (size_t)n) != n)
+    {
+        fprintf(stderr, "cannot send to %s\n", children[ecu].name);
+    }
+}
+
+/* Returns false if the script failed at this line */
+static bool Runner_Step(char *line, uint32_t *waitMs, int lineNo)
+{
+    char *cmd = strtok(line, " \t\r\n");
+    char *rest = strtok(NULL, "\r\n");
+    RunnerEcu ecu;
+
+    if (cmd == NULL || cmd[0] == '#')
+    {
+        return true;
+    }
+    rest = rest ? rest : "";
+
+    if (Runner_FindEcu(cmd, &ecu))
+    {
+        Runner_Send(ecu, rest);
+    }
+    else if (strcmp(cmd, "wait") == 0)
+    {
+        char ecuName[16] = "", device[32] = "";
+        int textAt = 0;
+        if (sscanf(rest, "%15s %31s %n", ecuName, device, &textAt) < 2 ||
+            !Runner_FindEcu(ecuName, &ecu))
+        {
+            fprintf(stderr, "line %d: wait <hmi|control> <device> [text]\n", lineNo);
+            return false;
+        }
+        const char *text = (textAt > 0) ? rest + textAt : "";
+
+        uint64_t deadline = Runner_NowNs() / speed + (uint64_t)*waitMs * 1000000ULL / speed;
+        while (!Runner_TakeMatch(ecu, device, text))
+        {
+            if (Runner_NowNs() / speed >= deadline)
+            {
+                fprintf(stderr, "line %d: timed out waiting for %s %s \"%s\"\n",
+                        lineNo, ecuName, device, text);
+                return false;
+            }
+            Runner_Pump(deadline);
+        }
+    }
+    else if (strcmp(cmd, "timeout") == 0)
+    {
+        *waitMs = (uint32_t)strtoul(rest, NULL, 0);
+    }
+    else if (strcmp(cmd, "sleep") == 0)
+    {
+        uint64_t deadline = (Runner_NowNs() + strtoull(rest, NULL, 0) * 1000000ULL) / speed;
+        while (Runner_NowNs() / speed < deadline)
+        {
+            Runner_Pump(deadline);
+        }
+    }
+    else if (strcmp(cmd, "reset") == 0)
+    {
+        if (!Runner_FindEcu(rest, &ecu))
+        {
+            fprintf(stderr, "line %d: reset <hmi|control>\n", lineNo);
+            return false;
+        }
+        printf("%10.1f ms  reset %s\n", Runner_SimMs(Runner_NowNs()), rest);
+        fflush(stdout);
+        Runner_Reset(&children[ecu]);
+    }
+    else if (strcmp(cmd, "echo") == 0)
+    {
+        printf("%10.1f ms  %s\n", Runner_SimMs(Runner_NowNs()), rest);
+        fflush(stdout);
+    }
+    else
+    {
+        fprintf(stderr, "line %d: unknown command %s\n", lineNo, cmd);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const char *scriptPath = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-v") == 0)
+        {
+            verbose = true;
+        }
+        else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc)
+        {
+            speed = (uint32_t)strtoul(argv[++i], NULL, 0);
+            speed = speed ? speed : 1;
+        }
+        else if (strcmp(argv[i], "--eeprom") == 0 && i + 1 < argc)
+        {
+            eepromPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--control") == 0 && i + 1 < argc)
+        {
+            children[ECU_CONTROL].program = argv[++i];
+        }
+        else
+        {
+            scriptPath = argv[i];
+        }
+    }
+
+    FILE *script = scriptPath ? fopen(scriptPath, "r") : NULL;
+    if (script == NULL)
+    {
+        fprintf(stderr, "usage: %s [-v] [--speed N] [--eeprom PATH] [--control NAME] SCRIPT\n",
+                argv[0]);
+        return 2;
+    }
+
+    /* The ECU programs are built next to this one */
+    char self[PATH_MAX];
+    ssize_t n = readlink("/proc/self/exe", self, sizeof(self) - 1);
+    if (n <= 0)
+    {
+        perror("/proc/self/exe");
+        return 2;
+    }
+    self[n] = '\0';
+    programDir = dirname(self);
+
+    signal(SIGPIPE, SIG_IGN);
+    startNs = Runner_NowNs();
+
+    int link[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, link) != 0)
+    {
+        perror("socketpair");
+        return 2;
+    }
+    for (int i = 0; i < ECU_COUNT; i++)
+    {
+        children[i].linkFd = link[i];
+        Runner_Start(&children[i]);
+    }
+
+    char line[RUNNER_LINE_SIZE];
+    uint32_t waitMs = RUNNER_DEFAULT_WAIT_MS;
+    int lineNo = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), script))
+    {
+        ok = Runner_Step(line, &waitMs, ++lineNo);
+    }
+    fclose(script);
+
+    Runner_Stop();
+    return ok ? 0 : 1;
+}